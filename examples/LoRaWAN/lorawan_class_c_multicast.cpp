@@ -82,7 +82,8 @@ static void applicationTask(void* p_Parameter)
             ESP_LOGI(TAG, " SNR: %i", Message.SNR);
             ESP_LOGI(TAG, " Port: %u", Message.Port);
             ESP_LOGI(TAG, "Channel: %u", Message.Group);
-            ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+            ESP_LOGI(TAG, " Length: %u", Message.Length);
+            ESP_LOG_BUFFER_HEX(TAG, Message.Data, Message.Length);
         }
 
         vTaskDelay(10000 / portTICK_PERIOD_MS);
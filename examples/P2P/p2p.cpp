@@ -58,7 +58,8 @@ static void applicationTask(void* p_Parameter)
     {
         ESP_LOGI(TAG, " RSSI: %i", Message.RSSI);
         ESP_LOGI(TAG, " SNR: %i", Message.SNR);
-        ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+        ESP_LOGI(TAG, " Length: %u", Message.Length);
+        ESP_LOG_BUFFER_HEX(TAG, Message.Data, Message.Length);
     }
 
     Error = RAK3172_P2P_Listen(_Device, 60000);
@@ -77,7 +78,8 @@ static void applicationTask(void* p_Parameter)
             {
                 ESP_LOGI(TAG, " RSSI: %i", Message.RSSI);
                 ESP_LOGI(TAG, " SNR: %i", Message.SNR);
-                ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+                ESP_LOGI(TAG, " Length: %u", Message.Length);
+                ESP_LOG_BUFFER_HEX(TAG, Message.Data, Message.Length);
             }
         }
         else
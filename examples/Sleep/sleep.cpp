@@ -12,7 +12,9 @@
 
 #include "settings/LoRaWAN_Default.h"
 
-static RTC_NOINIT_ATTR RAK3172_t _Device;
+static RAK3172_t _Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, GPIO_NUM_12, GPIO_NUM_14, 9600);
+
+static RTC_NOINIT_ATTR RAK3172_Snapshot_t _Snapshot;
 
 static StackType_t _applicationStack[8192];
 
@@ -29,7 +31,6 @@ static void applicationTask(void* p_Parameter)
         RAK3172_Error_t Error;
         RAK3172_Info_t Info;
 
-		_Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, GPIO_NUM_12, GPIO_NUM_14, 9600);
         _Device.Info = &Info;
 
         Error = RAK3172_Init(_Device);
@@ -52,9 +53,10 @@ static void applicationTask(void* p_Parameter)
     {
         RAK3172_Error_t Error;
 
-        RAK3172_WakeUp(_Device);
+        // Restore the driver state from the RTC memory instead of reading it from the module.
+        RAK3172_WakeUp(_Device, &_Snapshot);
 
-        if(RAK3172_LoRaWAN_isJoined(_Device) == false)
+        if(RAK3172_LoRaWAN_isJoined(_Device, false) == false)
         {
             ESP_LOGI(TAG, "Not joined. Rejoin...");
 
@@ -91,13 +93,15 @@ static void applicationTask(void* p_Parameter)
                     ESP_LOGI(TAG, " RSSI: %i", Message.RSSI);
                     ESP_LOGI(TAG, " SNR: %i", Message.SNR);
                     ESP_LOGI(TAG, " Port: %u", Message.Port);
-                    ESP_LOGI(TAG, " Payload: %s", Message.Payload.c_str());
+                    ESP_LOGI(TAG, " Length: %u", Message.Length);
+                    ESP_LOG_BUFFER_HEX(TAG, Message.Data, Message.Length);
                 }
             }
         }
     }
 
 	// Prepare the driver for entering sleep mode.
+    RAK3172_SaveSnapshot(_Device, &_Snapshot);
     RAK3172_Deinit(_Device);
 
     // Disable the RTC fast memory during sleep.
@@ -35,6 +35,8 @@
                                                                                                         .Rx = static_cast<gpio_num_t>(Rx_Pin),          \
                                                                                                         .Tx = static_cast<gpio_num_t>(Tx_Pin),          \
                                                                                                         .Baudrate = static_cast<RAK3172_Baud_t>(Baud),  \
+                                                                                                        .Restore = static_cast<RAK3172_Baud_t>(Baud),   \
+                                                                                                        .BurstCounter = 0,                              \
                                                                                                     },                                                  \
                                                                                                     .Reset = static_cast<gpio_num_t>(Reset_Pin),        \
                                                                                                     .Mode = RAK_MODE_P2P,                               \
@@ -43,17 +45,30 @@
                                                                                                         .Handle = NULL,                                 \
                                                                                                         .isInitialized = false,                         \
                                                                                                         .isBusy = false,                                \
-                                                                                                        .RxBuffer = NULL,                               \
+                                                                                                        .Lines = NULL,                                  \
+                                                                                                        .FreeQueue = NULL,                              \
                                                                                                         .MessageQueue = NULL,                           \
+                                                                                                        .Commands = NULL,                               \
+                                                                                                        .CommandFreeQueue = NULL,                       \
+                                                                                                        .CommandQueue = NULL,                           \
+                                                                                                        .CommandLock = NULL,                            \
+                                                                                                        .CommandDone = NULL,                            \
                                                                                                         .EventQueue = NULL,                             \
                                                                                                         .ReceiveQueue = NULL,                           \
-                                                                                                        .isJoinEvent = false,                           \
+                                                                                                        .Events = NULL,                                 \
+                                                                                                        .Waiter = NULL,                                 \
+                                                                                                        .Wakeups = 0,                                   \
                                                                                                     },                                                  \
                                                                                                     .LoRaWAN = {                                        \
                                                                                                         .Join = RAK_JOIN_ABP,                           \
                                                                                                         .isJoined = false,                              \
                                                                                                         .ConfirmError = false,                          \
                                                                                                         .AttemptCounter = 0,                            \
+                                                                                                        .Config = {},                                   \
+                                                                                                        .Uplinks = NULL,                                \
+                                                                                                        .UplinkLock = NULL,                             \
+                                                                                                        .ActiveUplink = 0,                              \
+                                                                                                        .NextFrame = 0,                                 \
                                                                                                     },                                                  \
                                                                                                     .P2P = {                                            \
                                                                                                         .Active = false,                                \
@@ -77,6 +92,8 @@
                                                                                     .Rx = static_cast<gpio_num_t>(Rx_Pin),                          \
                                                                                     .Tx = static_cast<gpio_num_t>(Tx_Pin),                          \
                                                                                     .Baudrate = static_cast<RAK3172_Baud_t>(Baud),                  \
+                                                                                    .Restore = static_cast<RAK3172_Baud_t>(Baud),                   \
+                                                                                    .BurstCounter = 0,                                              \
                                                                                 },                                                                  \
                                                                                 .Mode = RAK_MODE_P2P,                                               \
                                                                                 .Info = NULL,                                                       \
@@ -84,17 +101,30 @@
                                                                                     .Handle = NULL,                                                 \
                                                                                     .isInitialized = false,                                         \
                                                                                     .isBusy = false,                                                \
-                                                                                    .RxBuffer = NULL,                                               \
+                                                                                    .Lines = NULL,                                                  \
+                                                                                    .FreeQueue = NULL,                                              \
                                                                                     .MessageQueue = NULL,                                           \
+                                                                                    .Commands = NULL,                                               \
+                                                                                    .CommandFreeQueue = NULL,                                       \
+                                                                                    .CommandQueue = NULL,                                           \
+                                                                                    .CommandLock = NULL,                                            \
+                                                                                    .CommandDone = NULL,                                            \
                                                                                     .EventQueue = NULL,                                             \
                                                                                     .ReceiveQueue = NULL,                                           \
-                                                                                    .isJoinEvent = false,                                           \
+                                                                                    .Events = NULL,                                                 \
+                                                                                    .Waiter = NULL,                                                 \
+                                                                                    .Wakeups = 0,                                                   \
                                                                                 },                                                                  \
                                                                                 .LoRaWAN = {                                                        \
                                                                                     .Join = RAK_JOIN_ABP,                                           \
                                                                                     .isJoined = false,                                              \
                                                                                     .ConfirmError = false,                                          \
                                                                                     .AttemptCounter = 0,                                            \
+                                                                                    .Config = {},                                                   \
+                                                                                    .Uplinks = NULL,                                                \
+                                                                                    .UplinkLock = NULL,                                             \
+                                                                                    .ActiveUplink = 0,                                              \
+                                                                                    .NextFrame = 0,                                                 \
                                                                                 },                                                                  \
                                                                                 .P2P = {                                                            \
                                                                                     .Active = false,                                                \
@@ -27,7 +27,9 @@
 #include <freertos/task.h>
 #include <freertos/event_groups.h>
 #include <freertos/queue.h>
+#include <freertos/semphr.h>
 
+#include <atomic>
 #include <string>
 #include <stdint.h>
 #include <stdbool.h>
@@ -45,10 +47,87 @@
  */
 #define RAK3172_NO_TIMEOUT                                      0
 
+/** @brief Layout version of the device state snapshot. Increase the version when the snapshot layout changes.
+ */
+#define RAK3172_SNAPSHOT_VERSION                                1
+
+/** @brief Interval in milliseconds for the custom wait callback while the driver waits for an event.
+ */
+#define RAK3172_WAIT_INTERVAL                                   20
+
+/** @brief Maximum length of a decoded receive payload in bytes.
+ */
+#define RAK3172_RX_PAYLOAD_SIZE                                 255
+
+/** @brief Event bit for a successful join.
+ */
+#define RAK3172_EVENT_JOINED                                    (0x01 << 0)
+
+/** @brief Event bit for a failed join after all join attempts.
+ */
+#define RAK3172_EVENT_JOIN_FAILED                               (0x01 << 1)
+
+/** @brief Event bit for a failed join attempt, which has to be repeated by the driver.
+ *         NOTE: Only used for module firmware without RUI3 interface!
+ */
+#define RAK3172_EVENT_JOIN_RETRY                                (0x01 << 2)
+
 /** @brief Hook for a custom wait callback.
  */
 typedef void (*RAK3172_Wait_t)(void);
 
+/** @brief Expected response of an AT command.
+ */
+typedef enum
+{
+    RAK_RESPONSE_STATUS     = 0,        /**< The module only responds with a status line. */
+    RAK_RESPONSE_VALUE,                 /**< The module responds with a value line and a status line. */
+} RAK3172_Response_t;
+
+/** @brief Types of AT command fragments.
+ */
+typedef enum
+{
+    RAK_FRAGMENT_TEXT       = 0,        /**< Text with a given length. */
+    RAK_FRAGMENT_NUMBER,                /**< Unsigned decimal number. */
+    RAK_FRAGMENT_HEX,                   /**< Binary data, which is encoded into upper case hex characters. */
+} RAK3172_Fragment_Type_t;
+
+/** @brief AT command fragment. A command is written as a list of fragments, which are streamed into the UART without building a string.
+ */
+typedef struct
+{
+    RAK3172_Fragment_Type_t Type;       /**< Type of the fragment. */
+    const void* Data;                   /**< Pointer to text or binary data. Unused for numbers. */
+    size_t Length;                      /**< Length of the text or binary data in bytes. Unused for numbers. */
+    uint32_t Value;                     /**< Value of a number. */
+} RAK3172_Fragment_t;
+
+/** @brief          Hook for a command completion callback. The callback is called from the receive task.
+ *  @param Error    RAK3172_ERR_OK when the module responds with "OK"
+ *  @param p_Value  Received value or an empty string when no value was received
+ *  @param p_Status Received status line
+ *  @param p_Arg    Callback argument
+ */
+typedef void (*RAK3172_Command_Callback_t)(RAK3172_Error_t Error, const char* p_Value, const char* p_Status, void* p_Arg);
+
+/** @brief          Hook for an uplink completion callback. The callback is called from the receive task.
+ *  @param Frame    Frame number of the uplink
+ *  @param Error    RAK3172_ERR_OK when the uplink was transmitted and confirmed (when requested)
+ *  @param Latency  Time between the transmission and the confirmation in milliseconds
+ *  @param p_Arg    Callback argument
+ */
+typedef void (*RAK3172_Uplink_Callback_t)(uint32_t Frame, RAK3172_Error_t Error, uint32_t Latency, void* p_Arg);
+
+/** @brief          Hook for a firmware image reader. The reader is called by the updater for each block of the image.
+ *  @param Offset   Offset of the block in the image in bytes
+ *  @param p_Buffer Pointer to block buffer
+ *  @param Length   Number of bytes to read
+ *  @param p_Arg    Reader argument
+ *  @return         RAK3172_ERR_OK when successful
+ */
+typedef RAK3172_Error_t (*RAK3172_Update_Reader_t)(uint32_t Offset, uint8_t* p_Buffer, uint16_t Length, void* p_Arg);
+
 /** @brief  Encryption key definition.
  *          NOTE: Only used with RUI3 API support enabled.
  */
@@ -154,6 +233,140 @@ typedef enum
                                              NOTE: Can only used with band CN470! */
 } RAK3172_SubBand_t;
 
+/** @brief Settings of a LoRaWAN configuration object.
+ */
+typedef enum
+{
+    RAK_LORAWAN_CFG_CLASS       = (1 << 0), /**< Device class. */
+    RAK_LORAWAN_CFG_ADR         = (1 << 1), /**< Adaptive data rate. */
+    RAK_LORAWAN_CFG_BAND        = (1 << 2), /**< Frequency band. */
+    RAK_LORAWAN_CFG_SUB_BAND    = (1 << 3), /**< Sub band. */
+    RAK_LORAWAN_CFG_TX_PWR      = (1 << 4), /**< Tx power. */
+    RAK_LORAWAN_CFG_OTAA        = (1 << 5), /**< OTAA join mode and keys. */
+    RAK_LORAWAN_CFG_ABP         = (1 << 6), /**< ABP join mode and keys. */
+} RAK3172_LoRaWAN_Setting_t;
+
+/** @brief LoRaWAN configuration object. Used for configuration transactions and as cache for the module configuration.
+ */
+typedef struct
+{
+    uint32_t Valid;                     /**< Valid settings. Combination of #RAK3172_LoRaWAN_Setting_t. */
+    RAK3172_Class_t Class;              /**< Device class. */
+    bool UseADR;                        /**< Adaptive data rate. */
+    RAK3172_Band_t Band;                /**< Frequency band. */
+    RAK3172_SubBand_t SubBand;          /**< Sub band. */
+    uint8_t TxPwr;                      /**< Tx power in dBm. */
+    uint8_t Key1[16];                   /**< OTAA: DEVEUI (8 bytes)
+                                             ABP: APPSKEY (16 bytes) */
+    uint8_t Key2[16];                   /**< OTAA: APPEUI (8 bytes)
+                                             ABP: NWKSKEY (16 bytes) */
+    uint8_t Key3[16];                   /**< OTAA: APPKEY (16 bytes)
+                                             ABP: DEVADDR (4 bytes) */
+} RAK3172_LoRaWAN_Config_t;
+
+/** @brief LoRaWAN join completion handle.
+ */
+typedef struct
+{
+    TickType_t Start;                   /**< Start time of the join process in ticks. */
+    TickType_t Timeout;                 /**< Join timeout in ticks. Set to 0 when the timeout is disabled. */
+    uint8_t Attempts;                   /**< No. of join attempts. */
+    bool EnableAutoJoin;                /**< Enable auto join after power up. */
+    uint8_t Interval;                   /**< Reattempt interval. */
+    bool isActive;                      /**< #true when the join process is in progress. */
+    RAK3172_Error_t Error;              /**< Result of the join process. */
+} RAK3172_Join_t;
+
+/** @brief LoRaWAN uplink states.
+ */
+typedef enum
+{
+    RAK_UPLINK_PENDING      = 0,        /**< The uplink waits for the transmission. */
+    RAK_UPLINK_SENDING,                 /**< The uplink command was transmitted. */
+    RAK_UPLINK_WAIT_ACK,                /**< The uplink waits for the confirmation. */
+    RAK_UPLINK_QUEUED,                  /**< The uplink waits in the queue of the scheduler. */
+    RAK_UPLINK_FREE,                    /**< The uplink object is unused. */
+} RAK3172_Uplink_State_t;
+
+/** @brief LoRaWAN uplink priorities.
+ */
+typedef enum
+{
+    RAK_UPLINK_PRIO_LOW     = 0,        /**< Low priority. The uplink is dropped when it expires or when a queued uplink with a higher priority needs space. */
+    RAK_UPLINK_PRIO_NORMAL,             /**< Normal priority. The uplink is dropped when it expires or when a queued uplink with a higher priority needs space. */
+    RAK_UPLINK_PRIO_HIGH,               /**< High priority. The uplink is transmitted even when it has expired. */
+} RAK3172_Uplink_Priority_t;
+
+/** @brief Application record for the uplink packer.
+ */
+typedef struct
+{
+    const void* Data;                   /**< Pointer to record data. */
+    uint16_t Length;                    /**< Record length in bytes. */
+} RAK3172_Record_t;
+
+/** @brief LoRaWAN uplink scheduler statistics.
+ */
+typedef struct
+{
+    uint8_t Depth;                      /**< Number of queued uplinks without the active uplink. */
+    uint8_t MaxDepth;                   /**< Maximum number of queued uplinks. */
+    uint32_t Dropped;                   /**< Number of queued uplinks dropped for an uplink with a higher priority. */
+    uint32_t Expired;                   /**< Number of queued uplinks dropped after the deadline. */
+    uint32_t Coalesced;                 /**< Number of payloads appended to a queued uplink. */
+    uint32_t WaitTime;                  /**< Queue time of the last transmitted uplink in milliseconds. */
+    uint32_t MaxWaitTime;               /**< Maximum queue time of an uplink in milliseconds. */
+} RAK3172_Uplink_Stats_t;
+
+/** @brief Size of the payload buffer of a queued LoRaWAN uplink in bytes. This is the largest maximum payload of all bands and data rates.
+ *         Longer payloads aren´t copied.
+ */
+#define RAK3172_UPLINK_MAX_PAYLOAD                              242
+
+/** @brief LoRaWAN uplink object.
+ */
+typedef struct
+{
+    uint32_t Frame;                     /**< Frame number of the uplink. */
+    uint8_t Port;                       /**< LoRaWAN port. */
+    bool Confirmed;                     /**< Message confirmation enabled. */
+    bool isLong;                        /**< Long payload used. */
+    bool isCoalescing;                  /**< Payloads of later submissions with the same settings can be appended. */
+    uint16_t Length;                    /**< Payload length in bytes. */
+    RAK3172_Uplink_Priority_t Priority; /**< Priority of the uplink. */
+    TickType_t Queued;                  /**< Time of the submission in ticks. */
+    TickType_t Deadline;                /**< Maximum queue time in ticks. 0 when the uplink doesn´t expire. */
+    uint8_t Retries;                    /**< Number of confirmed payload retransmissions. */
+    uint8_t BusyCounter;                /**< Number of transmissions rejected by the busy module. */
+    uint8_t Step;                       /**< Next command of the transmission. The commands are transmitted one after another. */
+    RAK3172_Uplink_State_t State;       /**< Current state of the uplink. */
+    TickType_t Start;                   /**< Time of the last state change in ticks. */
+    RAK3172_Uplink_Callback_t Callback; /**< (Optional) Completion callback. */
+    void* Arg;                          /**< Argument for the completion callback. */
+    const uint8_t* Data;                /**< Pointer to the binary payload. Points to \ref Payload or to the buffer of the application for payloads,
+                                             which don´t fit into \ref Payload. The payload is encoded when the uplink is transmitted. */
+    uint8_t Payload[RAK3172_UPLINK_MAX_PAYLOAD];    /**< Copy of the binary payload. */
+} RAK3172_Uplink_t;
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+    /** @brief Maximum number of regulatory sub bands per frequency band.
+     */
+    #define RAK3172_DUTY_SUB_BANDS                              6
+
+    /** @brief Number of time slots of the duty cycle window.
+     */
+    #define RAK3172_DUTY_SLOTS                                  30
+
+    /** @brief Duty cycle ledger of a device. The ledger stores the airtime of the last hour for each sub band of the frequency band
+     *         in time slots of two minutes.
+     */
+    typedef struct
+    {
+        uint32_t Airtime[RAK3172_DUTY_SUB_BANDS][RAK3172_DUTY_SLOTS];   /**< Airtime per sub band and time slot in microseconds. */
+        unsigned long Slot;                                             /**< Number of the current time slot since boot. */
+    } RAK3172_Duty_t;
+#endif
+
 /** @brief LoRaWAN receive group definitions
  */
 typedef enum
@@ -238,6 +451,86 @@ typedef struct
     std::string RepoInfo;               /**< Firmware repo information. */
 } RAK3172_Info_t;
 
+/** @brief RAK3172 receive line object.
+ *         NOTE: Managed by the driver.
+ */
+typedef struct
+{
+    uint16_t Length;                                /**< Length of the line without CR and LF. */
+    char Data[CONFIG_RAK3172_UART_BUFFER_SIZE];     /**< Zero terminated line content. */
+} RAK3172_Line_t;
+
+/** @brief RAK3172 message receive object.
+ */
+typedef struct
+{
+    uint8_t Data[RAK3172_RX_PAYLOAD_SIZE];  /**< Decoded payload. Use the first \ref Length bytes. */
+    uint16_t Length;                    /**< Length of the decoded payload in bytes. */
+    int8_t RSSI;                        /**< Receiving RSSI value. */
+    int8_t SNR;                         /**< Receiving SNR value. */
+    uint8_t Port;                       /**< Port number.
+                                             NOTE: Only used in LoRaWAN mode! */
+    RAK3172_Rx_Group_t Group;           /**< Receive group.
+                                             NOTE: Only used in LoRaWAN mode! */
+    #ifdef CONFIG_RAK3172_RX_PAYLOAD_STRING
+        std::string Payload;            /**< Hex string of the payload.
+                                             NOTE: Deprecated! Only set by the copying receive functions. Use \ref Data and \ref Length instead. */
+    #endif
+} RAK3172_Rx_t;
+
+/** @brief RAK3172 receive queue statistics.
+ */
+typedef struct
+{
+    uint32_t Received;                  /**< Number of messages stored in the receive queue. */
+    uint32_t Overflows;                 /**< Number of messages dropped, because all receive slots were in use. */
+    uint8_t Used;                       /**< Number of receive slots in use by the queue and by the consumers. */
+    uint8_t MaxUsed;                    /**< Maximum number of receive slots in use. */
+} RAK3172_Rx_Stats_t;
+
+/** @brief RAK3172 AT command request object.
+ *         NOTE: Managed by the driver.
+ */
+typedef struct
+{
+    RAK3172_Response_t Response;                    /**< Expected response of the module. */
+    RAK3172_Command_Callback_t Callback;            /**< (Optional) Completion callback. The request is released by the driver after the callback. */
+    void* Arg;                                      /**< Argument for the completion callback. */
+    TickType_t Timeout;                             /**< Maximum time between two response lines in ticks. */
+    TickType_t Start;                               /**< Start of the current response timeout in ticks. */
+    RAK3172_Line_t* Value;                          /**< Received value line or NULL. */
+    char Status[32];                                /**< Zero terminated status line. */
+    RAK3172_Error_t Error;                          /**< Result of the request. */
+} RAK3172_Command_t;
+
+/** @brief Time spent asleep and awake by the host during a blocking operation of the driver.
+ */
+typedef struct
+{
+    uint64_t Asleep;                    /**< Time in light sleep in microseconds. */
+    uint64_t Awake;                     /**< Time awake in microseconds. */
+} RAK3172_Sleep_t;
+
+/** @brief Summary of a sleep cycle of host and module. A cycle starts when the previous cycle has ended.
+ */
+typedef struct
+{
+    uint32_t Duration;                  /**< Duration of the cycle in milliseconds. */
+    uint32_t HostAsleep;                /**< Time the host spent in light sleep in milliseconds. */
+    uint32_t ModuleAsleep;              /**< Time the module spent in sleep mode in milliseconds. */
+    uint64_t Energy;                    /**< Estimated energy of host and module during the cycle in microjoule. */
+} RAK3172_Cycle_t;
+
+/** @brief Lock free message ring of the driver.
+ *         NOTE: Managed by the driver.
+ */
+struct RAK3172_Ring_t;
+
+/** @brief Receive queue of the driver.
+ *         NOTE: Managed by the driver.
+ */
+struct RAK3172_RxQueue_t;
+
 /** @brief RAK3172 device object definition.
  */
 typedef struct
@@ -248,6 +541,10 @@ typedef struct
         gpio_num_t Rx;                  /**< Rx pin number (MCU). */
         gpio_num_t Tx;                  /**< Tx pin number (MCU). */
 	    RAK3172_Baud_t Baudrate;		/**< Baud rate for the module communication. */
+        RAK3172_Baud_t Restore;         /**< Baud rate which is restored after the burst mode.
+                                             NOTE: Managed by the driver. */
+        uint8_t BurstCounter;           /**< Nesting counter for the burst mode.
+                                             NOTE: Managed by the driver. */
     } UART;
     #ifdef CONFIG_RAK3172_RESET_USE_HW
         gpio_num_t Reset;               /**< Reset pin number. */
@@ -256,33 +553,103 @@ typedef struct
     RAK3172_Info_t* Info;               /**< (Optional) Pointer to device information object. */
     struct
     {
-        TaskHandle_t Handle;            /**< Handle for the UART receive task.
+        TaskHandle_t Handle;            /**< Handle for the UART receive task. #NULL when the shared receive task is used.
                                              NOTE: Managed by the driver. */
         bool isInitialized;             /**< #true when the device driver is initialized.
                                              NOTE: Managed by the driver. */
-        bool isBusy;                    /**< #true when the device is busy.
+        std::atomic<bool> isBusy;       /**< #true when the device is busy. Changed by the application tasks and the receive task.
+                                             NOTE: Managed by the driver. */
+        RAK3172_Line_t* Lines;          /**< Pointer to the preallocated receive line pool.
+                                             NOTE: Managed by the driver. */
+        QueueHandle_t FreeQueue;        /**< Indices of the unused slots in the line pool.
                                              NOTE: Managed by the driver. */
-        uint8_t* RxBuffer;              /**< Pointer to receive buffer.
+        QueueHandle_t MessageQueue;     /**< Module Rx message queue used by the receiving task. Holds line pool indices.
                                              NOTE: Managed by the driver. */
-        QueueHandle_t MessageQueue;     /**< Module Rx message queue used by the receiving task.
+        RAK3172_Command_t* Commands;    /**< Pointer to the preallocated AT command requests.
+                                             NOTE: Managed by the driver. */
+        QueueHandle_t CommandFreeQueue; /**< Indices of the unused AT command requests.
+                                             NOTE: Managed by the driver. */
+        QueueHandle_t CommandQueue;     /**< Indices of the AT command requests in flight in the order of transmission.
+                                             NOTE: Managed by the driver. */
+        SemaphoreHandle_t CommandLock;  /**< Lock for the transmission of AT commands.
+                                             NOTE: Managed by the driver. */
+        SemaphoreHandle_t CompleteLock; /**< Lock for the completion of AT commands. Taken before the command lock.
+                                             NOTE: Managed by the driver. */
+        EventGroupHandle_t CommandDone; /**< Completion flags for the AT command requests.
                                              NOTE: Managed by the driver. */
         QueueHandle_t EventQueue;       /**< Event queue used by the UART driver for the pattern detection.
                                              NOTE: Managed by the driver. */
-        QueueHandle_t ReceiveQueue;     /**< Receive message queue.
+        SemaphoreHandle_t WakeSignal;   /**< Wakes up the receive task without any UART activity. Member of the queue set of the receive task.
+                                             NOTE: Managed by the driver. */
+        SemaphoreHandle_t BurstLock;    /**< Lock for the nesting counter and the baud rate changes of the burst mode.
+                                             NOTE: Managed by the driver. */
+        #ifndef CONFIG_RAK3172_TASK_SHARED
+            QueueSetHandle_t EventSet;  /**< Queue set of the receive task with the UART event queue and the wake signal.
+                                             NOTE: Managed by the driver. */
+            std::atomic<bool> isStopping;   /**< #true when the receive task must terminate itself.
+                                                 NOTE: Managed by the driver. */
+        #endif
+        RAK3172_RxQueue_t* ReceiveQueue;    /**< Receive slots and lock free message ring between the receive task and the application.
+                                                 NOTE: Managed by the driver. */
+        EventGroupHandle_t Events;      /**< Event flags set by the receive task.
+                                             NOTE: Managed by the driver. */
+        TaskHandle_t Waiter;            /**< Task which waits for the termination of a driver task.
                                              NOTE: Managed by the driver. */
-        bool isJoinEvent;               /**< #true when a join event has occured.
-                                             NOTE: Only used for module firmware without RUI3 interface! */
+        std::atomic<uint32_t> Wakeups;  /**< Number of wake ups of the driver tasks. The shared receive task counts for all devices.
+                                             Changed by the receive task and the listen task.
+                                             NOTE: Managed by the driver. */
+        #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+            RAK3172_Sleep_t Sleep;      /**< Time spent asleep and awake during the last join or transmission.
+                                             NOTE: Managed by the driver. */
+            uint64_t SleepStart;        /**< Start of the current operation in microseconds.
+                                             NOTE: Managed by the driver. */
+            std::atomic<bool> isWoken;  /**< #true when the host was woken up by the UART and the first line must be restored.
+                                             NOTE: Managed by the driver. */
+            uint64_t CycleStart;        /**< Start of the current sleep cycle in microseconds. 0 before the first cycle.
+                                             NOTE: Managed by the driver. */
+        #endif
+        #ifdef CONFIG_RAK3172_USE_RUI3
+            mutable std::atomic<bool> isModuleAsleep;   /**< #true when the module is in sleep mode. Cleared when the first command after the sleep is transmitted.
+                                                             Changed by the application tasks and the receive task.
+                                                             NOTE: Managed by the driver. */
+            unsigned long ModuleSleepStart; /**< Start of the module sleep in milliseconds.
+                                                 NOTE: Managed by the driver. */
+            uint32_t ModuleSleepTime;       /**< Duration of the module sleep in milliseconds. 0 when the module sleeps until it is woken up.
+                                                 NOTE: Managed by the driver. */
+            SemaphoreHandle_t WakeLock;     /**< Lock for the wake up of the module. Serializes the wake up without the command lock.
+                                                 NOTE: Managed by the driver. */
+        #endif
     } Internal;
     struct
     {
         RAK3172_JoinMode_t Join;        /**< Join mode used by the device.
                                              NOTE: Managed by the driver. */
-        bool isJoined;                  /**< Join status of the device.
+        std::atomic<bool> isJoined;     /**< Join status of the device. Changed by the application tasks and the receive task.
                                              NOTE: Managed by the driver. */
         bool ConfirmError;              /**< Message confirmation failed.
                                              NOTE: Managed by the driver. */
-        uint8_t AttemptCounter;         /**< Attempt counter for the join process.
-                                             NOTE: Managed by the driver and only used when RUI3 isn´t used. */
+        std::atomic<uint8_t> AttemptCounter;    /**< Attempt counter for the join process. Decremented by the receive task.
+                                                     NOTE: Managed by the driver and only used when RUI3 isn´t used. */
+        RAK3172_LoRaWAN_Config_t Config; /**< Cached configuration of the module.
+                                             NOTE: Managed by the driver. */
+        RAK3172_Uplink_t* Uplinks;      /**< Pointer to the preallocated uplinks.
+                                             NOTE: Managed by the driver. */
+        SemaphoreHandle_t UplinkLock;   /**< Lock for the active uplink.
+                                             NOTE: Managed by the driver. */
+        uint8_t ActiveUplink;           /**< Index of the active uplink.
+                                             NOTE: Managed by the driver. */
+        uint32_t NextFrame;             /**< Frame number for the next uplink.
+                                             NOTE: Managed by the driver. */
+        RAK3172_Uplink_Stats_t UplinkStats; /**< Statistics of the uplink scheduler.
+                                             NOTE: Managed by the driver. */
+        RAK3172_DataRate_t DataRate;    /**< Data rate set with #RAK3172_LoRaWAN_SetDataRate.
+                                             NOTE: Managed by the driver. */
+        bool isDataRateValid;           /**< #true when the data rate is known.
+                                             NOTE: Managed by the driver. */
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+            RAK3172_Duty_t Duty;        /**< Duty cycle ledger of the uplinks.
+                                             NOTE: Managed by the driver. */
+        #endif
     } LoRaWAN;
     struct
     {
@@ -290,29 +657,47 @@ typedef struct
                                              NOTE: Managed by the driver. */
         bool isEncryptionEnabled;       /**< LoRa P2P encryption status.
                                              NOTE: Managed by the driver. */
-        bool isRxTimeout;               /**< LoRa P2P receive timeout.
+        std::atomic<bool> isRxTimeout;  /**< LoRa P2P receive timeout. Set by the receive task and read by the application tasks and the listen task.
                                              NOTE: Managed by the driver. */
         uint16_t Timeout;               /**< Receive timeout.
                                              NOTE: Managed by the driver. */
         TaskHandle_t ListenHandle;      /**< Task handle for the P2P receive task from the "RAK3172_P2P_Listen" function.
                                              NOTE: Managed by the driver. */
-        QueueHandle_t ListenQueue;      /**< Listen queue used by the "RAK3172_P2P_Listen" function.
+        RAK3172_Ring_t* ListenQueue;    /**< Lock free listen queue with receive slot indices used by the "RAK3172_P2P_Listen" function.
                                              NOTE: Managed by the driver. */
     } P2P;
 } RAK3172_t;
 
-/** @brief RAK3172 message receive object.
+/** @brief RAK3172 device state snapshot. Used to restore the driver state after a deep sleep without querying the module.
+ *         NOTE: Place the snapshot in the RTC memory (i. e. with RTC_NOINIT_ATTR) to keep it during deep sleep.
  */
 typedef struct
 {
-    std::string Payload;                /**< Received payload. */
-    int8_t RSSI;                        /**< Receiving RSSI value. */
-    int8_t SNR;                         /**< Receiving SNR value. */
-    uint8_t Port;                       /**< Port number.
-                                             NOTE: Only used in LoRaWAN mode! */
-    RAK3172_Rx_Group_t Group;           /**< Receive group.
-                                             NOTE: Only used in LoRaWAN mode! */
-} RAK3172_Rx_t;
+    uint16_t Version;                   /**< Snapshot layout version. */
+    uint16_t Size;                      /**< Snapshot size in bytes. */
+    RAK3172_Baud_t Baudrate;            /**< Baud rate for the module communication. */
+    RAK3172_Mode_t Mode;                /**< Current device mode. */
+    RAK3172_JoinMode_t Join;            /**< Join mode used by the device. */
+    bool isJoined;                      /**< Join status of the device. */
+    RAK3172_LoRaWAN_Config_t Config;    /**< Cached LoRaWAN configuration of the module.
+                                             NOTE: The keys are only included with CONFIG_RAK3172_SNAPSHOT_WITH_KEYS. */
+    char Firmware[48];                  /**< Firmware version string. */
+    char Serial[32];                    /**< Serial number string. */
+    uint32_t CRC;                       /**< CRC32 of the snapshot without the CRC field. */
+} RAK3172_Snapshot_t;
+
+/** @brief RAK3172 firmware update statistics object.
+ */
+typedef struct
+{
+    uint32_t Bytes;                     /**< Number of acknowledged firmware bytes. */
+    uint32_t Packets;                   /**< Number of transmitted data packets including retransmissions. */
+    uint32_t Retries;                   /**< Number of retransmitted data packets. */
+    uint32_t NAKs;                      /**< Number of data packets rejected by the module. */
+    uint32_t Timeouts;                  /**< Number of data packets without response from the module. */
+    uint32_t Duration;                  /**< Duration of the transmission in milliseconds. */
+    uint32_t Throughput;                /**< Average throughput in bytes per second. */
+} RAK3172_Update_Stats_t;
 
 /** @brief RAK3172 multicast group configuration object.
  */
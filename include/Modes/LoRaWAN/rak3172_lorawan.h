@@ -21,6 +21,8 @@
 #define RAK3172_LORAWAN_H_
 
 #include "rak3172_defs.h"
+#include "rak3172_lorawan_config.h"
+#include "rak3172_lorawan_packer.h"
 
 #ifdef CONFIG_RAK3172_USE_RUI3
     #include "rak3172_lorawan_rui3.h"
@@ -34,6 +36,10 @@
     #include "rak3172_lorawan_class_b.h"
 #endif
 
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+    #include "rak3172_lorawan_duty.h"
+#endif
+
 /** @brief          Initialize the RAK3172 SoM in LoRaWAN mode.
  *  @param p_Device RAK3172 device object
  *  @param TxPwr    Tx power in dB
@@ -68,7 +74,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_Init(RAK3172_t& p_Device, uint8_t TxPwr, RAK3172
  *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(const RAK3172_t& p_Device, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY);
+RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(RAK3172_t& p_Device, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY);
 
 /** @brief              Set the keys for ABP mode.
  *  @param p_Device     RAK3172 device object
@@ -79,7 +85,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(const RAK3172_t& p_Device, const uin
  *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint8_t* const p_APPSKEY, const uint8_t* const p_NWKSKEY, const uint8_t* const p_DEVADDR);
+RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(RAK3172_t& p_Device, const uint8_t* const p_APPSKEY, const uint8_t* const p_NWKSKEY, const uint8_t* const p_DEVADDR);
 
 /** @brief                  Start the joining process.
  *                          NOTE: This is a blocking function!
@@ -95,6 +101,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
  *  @param EnableAutoJoin   (Optional) Enable auto join after power up
  *  @param Interval         (Optional) Reattempt interval
  *  @param on_Wait          (Optional) Hook for a custom wait function
+ *                          NOTE: The function is called every \ref RAK3172_WAIT_INTERVAL milliseconds. Without a hook the task is blocked until the join process has finished.
  *                          NOTE: The function call is time critical. Prevent delay periods.
  *  @return                 RAK3172_ERR_OK when joined
  *                          RAK3172_ERR_FAIL when the device has not joined the network and a join timeout has occured
@@ -104,6 +111,37 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
  */
 RAK3172_Error_t RAK3172_LoRaWAN_StartJoin(RAK3172_t& p_Device, uint8_t Attempts = 5, uint32_t Timeout = 0, bool Block = true, bool EnableAutoJoin = false, uint8_t Interval = 10, RAK3172_Wait_t on_Wait = NULL);
 
+/** @brief                  Start the joining process without waiting for the result.
+ *                          Use \ref RAK3172_LoRaWAN_WaitJoin to get the result of the join process.
+ *                          NOTE: Module firmware without RUI3 interface needs \ref RAK3172_LoRaWAN_WaitJoin to repeat failed join attempts.
+ *  @param p_Device         RAK3172 device object
+ *  @param p_Join           Pointer to join handle
+ *  @param Attempts         (Optional) No. of join attempts
+ *  @param Timeout          (Optional) Timeout in seconds
+ *                          NOTE: Set to 0 to disable the timeout function.
+ *  @param EnableAutoJoin   (Optional) Enable auto join after power up
+ *  @param Interval         (Optional) Reattempt interval
+ *  @return                 RAK3172_ERR_OK when the join process was started or the device has already joined
+ *                          RAK3172_ERR_BUSY when the device is busy
+ *                          RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                          RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_StartJoinAsync(RAK3172_t& p_Device, RAK3172_Join_t* p_Join, uint8_t Attempts = 5, uint32_t Timeout = 0, bool EnableAutoJoin = false, uint8_t Interval = 10);
+
+/** @brief                  Wait for the result of a join process.
+ *  @param p_Device         RAK3172 device object
+ *  @param p_Join           Pointer to join handle
+ *  @param Block            (Optional) Set to #false to check the join process without waiting
+ *  @param on_Wait          (Optional) Hook for a custom wait function
+ *                          NOTE: The function is called every \ref RAK3172_WAIT_INTERVAL milliseconds. Without a hook the task is blocked until the join process has finished.
+ *  @return                 RAK3172_ERR_OK when joined
+ *                          RAK3172_ERR_BUSY when the join process is still in progress
+ *                          RAK3172_ERR_FAIL when the device has not joined the network
+ *                          RAK3172_ERR_TIMEOUT when a join timeout has occured
+ *                          RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_WaitJoin(RAK3172_t& p_Device, RAK3172_Join_t* p_Join, bool Block = true, RAK3172_Wait_t on_Wait = NULL);
+
 /** @brief          Stop the joining process.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -148,7 +186,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
  *  @param Retries      Number of confirmed payload retransmissions
  *  @param Confirmed    (Optional) Enable message confirmation
  *                      NOTE: Only neccessary when payload is greater than 1024 bytes (long payload)
- *  @param Wait         (Optional) Hook for a custom wait function that is called during each sleep iteration
+ *  @param Wait         (Optional) Hook for a custom wait function that is called periodically while waiting for the completion
  *                      NOTE: The function call is time critical. Prevent long wait periods!
  *  @return             RAK3172_ERR_OK when successful
  *                      RAK3172_ERR_BUSY when the device is busy
@@ -160,7 +198,69 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
  */
 RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, uint8_t Retries, bool Confirmed = false, RAK3172_Wait_t Wait = NULL);
 
+/** @brief              Queue a LoRaWAN data transmission. The uplink is transmitted when all previously queued uplinks are completed,
+ *                      so the next payload can be queued while the current uplink waits for the acknowledgement.
+ *                      The uplink is queued with normal priority, without deadline and without coalescing. See \ref RAK3172_LoRaWAN_Schedule for details.
+ *                      NOTE: The callback is called from the receive task. Don´t call blocking driver functions from the callback!
+ *                      NOTE: Payloads with more than #RAK3172_UPLINK_MAX_PAYLOAD bytes aren´t copied and need a callback.
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Buffer     Pointer to data buffer
+ *  @param Length       Data buffer length
+ *  @param Retries      Number of confirmed payload retransmissions
+ *  @param Confirmed    Enable message confirmation
+ *  @param Callback     (Optional) Callback for the completion of the uplink
+ *  @param p_Arg        (Optional) Argument for the callback
+ *  @param p_Frame      (Optional) Pointer to the frame number assigned to the uplink by the driver
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_BUSY when the device is busy or when the uplink queue is full
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_NOT_CONNECTED when the device is not joined
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_TransmitAsync(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, uint8_t Retries, bool Confirmed, RAK3172_Uplink_Callback_t Callback = NULL, void* p_Arg = NULL, uint32_t* p_Frame = NULL);
+
+/** @brief              Queue a LoRaWAN data transmission with a priority and a deadline. Queued uplinks are transmitted by the receive task
+ *                      in the order of their priority as soon as the module is free. Uplinks with the same priority are transmitted in the order of submission.
+ *                      With coalescing, the payload is appended to a queued coalescing uplink with the same port, settings and callback when both payloads
+ *                      fit into the maximum payload of the current data rate. A full queue drops the newest uplink with the lowest priority when the new uplink has a higher priority.
+ *                      NOTE: The callback is called from the receive task. Don´t call blocking driver functions from the callback!
+ *                      NOTE: Dropped uplinks are completed with RAK3172_ERR_BUSY and expired uplinks with RAK3172_ERR_TIMEOUT.
+ *                      NOTE: Payloads with more than #RAK3172_UPLINK_MAX_PAYLOAD bytes aren´t copied. The buffer must be valid until the callback is called.
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Buffer     Pointer to data buffer
+ *  @param Length       Data buffer length
+ *  @param Priority     Priority of the uplink
+ *  @param Deadline     (Optional) Maximum queue time in milliseconds. 0 when the uplink doesn´t expire.
+ *                      NOTE: Uplinks with a high priority are transmitted after the deadline.
+ *  @param Retries      (Optional) Number of confirmed payload retransmissions
+ *  @param Confirmed    (Optional) Enable message confirmation
+ *  @param Callback     (Optional) Callback for the completion of the uplink
+ *  @param p_Arg        (Optional) Argument for the callback
+ *  @param p_Frame      (Optional) Pointer to the frame number assigned to the uplink by the driver
+ *  @param Coalesce     (Optional) Combine the payload with other coalescing payloads. The payloads are concatenated without framing,
+ *                      so the application must be able to split them
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_BUSY when the device is busy or when the uplink queue is full
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function or when a payload, which isn´t copied, has no callback
+ *                      RAK3172_ERR_NOT_CONNECTED when the device is not joined
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Schedule(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, RAK3172_Uplink_Priority_t Priority, uint32_t Deadline = 0, uint8_t Retries = 0, bool Confirmed = false, RAK3172_Uplink_Callback_t Callback = NULL, void* p_Arg = NULL, uint32_t* p_Frame = NULL, bool Coalesce = false);
+
+/** @brief              Get the statistics of the uplink scheduler.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Stats      Pointer to statistics
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_GetUplinkStats(RAK3172_t& p_Device, RAK3172_Uplink_Stats_t* const p_Stats);
+
 /** @brief              Check if a downlink message was received during the last uplink and pop one message from the stack.
+ *                      NOTE: The received messages are passed through a lock free queue. Only one task must wait for messages.
  *  @param p_Device     RAK3172 device object
  *  @param p_Message    Pointer to RAK3172 message object
  *  @param Timeout      (Optional) Wait timeout in seconds
@@ -170,6 +270,18 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
  */
 RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_Message, uint32_t Timeout = 3);
 
+/** @brief              Pop one received downlink message from the stack without copying it. The message stays in the receive slot of the driver.
+ *                      NOTE: The received messages are passed through a lock free queue. Only one task must wait for messages.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to the returned message. The message must be returned with \ref RAK3172_ReleaseMessage
+ *  @param Timeout      (Optional) Wait timeout in seconds
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_TIMEOUT when no message is available
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Borrow(RAK3172_t& p_Device, const RAK3172_Rx_t** p_Message, uint32_t Timeout = 3);
+
 /** @brief          Set the number of confirmed payload retransmissions.
  *                  NOTE: This function also activates the confirmed transmission mode!
  *  @param p_Device RAK3172 device object
@@ -233,7 +345,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(const RAK3172_t& p_Device, bool*
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetBand(const RAK3172_t& p_Device, RAK3172_Band_t Band);
+RAK3172_Error_t RAK3172_LoRaWAN_SetBand(RAK3172_t& p_Device, RAK3172_Band_t Band);
 
 /** @brief          Get the used frequency band.
  *  @param p_Device RAK3172 device object
@@ -252,7 +364,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_
  *                  RAK3172_ERR_INVALID_RESPONSE when the device is operating in the wrong frequency band
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t Band);
+RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(RAK3172_t& p_Device, RAK3172_SubBand_t Band);
 
 /** @brief          Get the sub band for the LoRaWAN communication.
  *  @param p_Device RAK3172 device object
@@ -272,7 +384,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_Su
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(const RAK3172_t& p_Device, uint8_t TxPwr);
+RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(RAK3172_t& p_Device, uint8_t TxPwr);
 
 /** @brief          Set the join delay on the RX window 1.
  *  @param p_Device RAK3172 device object
@@ -419,7 +531,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* cons
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t DR);
+RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t DR);
 
 /** @brief          Get the data rate of the LoRa module.
  *  @param p_Device RAK3172 device object
@@ -431,6 +543,15 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_D
  */
 RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR);
 
+/** @brief          Get the maximum application payload of a data rate.
+ *  @param Band     Frequency band
+ *  @param DR       Data rate
+ *  @param p_Length Pointer to maximum payload length in bytes
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed or the data rate isn´t defined for the band
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_GetMaxPayload(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint8_t* const p_Length);
+
 /** @brief          Enable / Disable the adaptive data rate.
  *  @param p_Device RAK3172 device object
  *  @param Enable   Enable / Disable ADR
@@ -439,7 +560,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_D
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetADR(const RAK3172_t& p_Device, bool Enable);
+RAK3172_Error_t RAK3172_LoRaWAN_SetADR(RAK3172_t& p_Device, bool Enable);
 
 /** @brief          Get the status of the adaptive data rate option.
  *  @param p_Device RAK3172 device object
@@ -459,7 +580,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
  */
-RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(const RAK3172_t& p_Device, RAK3172_JoinMode_t Mode);
+RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(RAK3172_t& p_Device, RAK3172_JoinMode_t Mode);
 
 /** @brief          Get the current LoRaWAN join mode.
  *  @param p_Device RAK3172 device object
@@ -0,0 +1,95 @@
+ /*
+ * rak3172_lorawan_config.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LORAWAN_CONFIG_H_
+#define RAK3172_LORAWAN_CONFIG_H_
+
+#include "rak3172_defs.h"
+
+/** @brief          Start a new LoRaWAN configuration transaction.
+ *  @param p_Config Pointer to configuration object
+ */
+void RAK3172_LoRaWAN_Config_Begin(RAK3172_LoRaWAN_Config_t* p_Config);
+
+/** @brief          Add the device class to a configuration transaction.
+ *  @param p_Config Pointer to configuration object
+ *  @param Class    LoRaWAN device class
+ */
+void RAK3172_LoRaWAN_Config_SetClass(RAK3172_LoRaWAN_Config_t* p_Config, RAK3172_Class_t Class);
+
+/** @brief          Add the adaptive data rate option to a configuration transaction.
+ *  @param p_Config Pointer to configuration object
+ *  @param Enable   Enable / Disable ADR
+ */
+void RAK3172_LoRaWAN_Config_SetADR(RAK3172_LoRaWAN_Config_t* p_Config, bool Enable);
+
+/** @brief          Add the frequency band to a configuration transaction.
+ *  @param p_Config Pointer to configuration object
+ *  @param Band     LoRaWAN frequency band
+ */
+void RAK3172_LoRaWAN_Config_SetBand(RAK3172_LoRaWAN_Config_t* p_Config, RAK3172_Band_t Band);
+
+/** @brief          Add the sub band to a configuration transaction.
+ *  @param p_Config Pointer to configuration object
+ *  @param Band     Sub band
+ *                  NOTE: Ignored when set to RAK_SUB_BAND_NONE!
+ */
+void RAK3172_LoRaWAN_Config_SetSubBand(RAK3172_LoRaWAN_Config_t* p_Config, RAK3172_SubBand_t Band);
+
+/** @brief          Add the Tx power to a configuration transaction.
+ *  @param p_Config Pointer to configuration object
+ *  @param TxPwr    Tx power in dBm
+ */
+void RAK3172_LoRaWAN_Config_SetTxPwr(RAK3172_LoRaWAN_Config_t* p_Config, uint8_t TxPwr);
+
+/** @brief              Add the OTAA join mode and the OTAA keys to a configuration transaction.
+ *  @param p_Config     Pointer to configuration object
+ *  @param p_DEVEUI     Pointer to LoRaWAN DEVEUI (8 Bytes)
+ *  @param p_APPEUI     Pointer to LoRaWAN APPEUI (8 Bytes)
+ *  @param p_APPKEY     Pointer to LoRaWAN APPKEY (16 Bytes)
+ */
+void RAK3172_LoRaWAN_Config_SetOTAAKeys(RAK3172_LoRaWAN_Config_t* p_Config, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY);
+
+/** @brief              Add the ABP join mode and the ABP keys to a configuration transaction.
+ *  @param p_Config     Pointer to configuration object
+ *  @param p_APPSKEY    Pointer to LoRaWAN APPSKEY (16 Bytes)
+ *  @param p_NWKSKEY    Pointer to LoRaWAN NWKSKEY (16 Bytes)
+ *  @param p_DEVADDR    Pointer to LoRaWAN DEVADDR (4 Bytes)
+ */
+void RAK3172_LoRaWAN_Config_SetABPKeys(RAK3172_LoRaWAN_Config_t* p_Config, const uint8_t* const p_APPSKEY, const uint8_t* const p_NWKSKEY, const uint8_t* const p_DEVADDR);
+
+/** @brief          Apply a configuration transaction. Only the settings that differ from the cached module configuration are transmitted.
+ *                  All commands are transmitted as one pipelined burst.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Config Pointer to configuration object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                  RAK3172_ERR_FAIL when the module rejects a setting
+ *                  RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Config_Commit(RAK3172_t& p_Device, const RAK3172_LoRaWAN_Config_t* p_Config);
+
+/** @brief          Drop settings from the cached module configuration. The next transaction transmits these settings again.
+ *                  NOTE: Call this function when the module configuration was changed without the driver (i. e. by a factory reset).
+ *  @param p_Device RAK3172 device object
+ *  @param Settings Settings to drop
+ */
+void RAK3172_LoRaWAN_Config_Invalidate(RAK3172_t& p_Device, uint32_t Settings = UINT32_MAX);
+
+#endif /* RAK3172_LORAWAN_CONFIG_H_ */
@@ -0,0 +1,85 @@
+ /*
+ * rak3172_lorawan_duty.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LORAWAN_DUTY_H_
+#define RAK3172_LORAWAN_DUTY_H_
+
+#include "rak3172_defs.h"
+
+/** @brief              Calculate the time on air of a LoRa packet. The packet uses an explicit header and a CRC.
+ *                      The low data rate optimization is used for symbol times of 16 ms and more.
+ *  @param SF           Spreading factor (5 - 12)
+ *  @param Bandwidth    Bandwidth in Hz
+ *  @param CR           Coding rate (1 = 4/5, 2 = 4/6, 3 = 4/7, 4 = 4/8)
+ *  @param Preamble     Preamble length in symbols
+ *  @param Length       Length of the physical payload in bytes
+ *  @param p_Airtime    Pointer to time on air in microseconds
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ */
+RAK3172_Error_t RAK3172_LoRa_GetAirtime(uint8_t SF, uint32_t Bandwidth, uint8_t CR, uint16_t Preamble, uint16_t Length, uint32_t* const p_Airtime);
+
+/** @brief              Calculate the time on air of a LoRaWAN uplink. The 13 bytes of the LoRaWAN frame header, port and MIC are added to the payload.
+ *  @param Band         Frequency band
+ *  @param DR           Data rate
+ *  @param Length       Length of the application payload in bytes
+ *  @param p_Airtime    Pointer to time on air in microseconds
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed or the data rate isn´t defined for the band
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_GetAirtime(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint16_t Length, uint32_t* const p_Airtime);
+
+/** @brief              Calculate the time on air of an uplink with the settings of a device. The data rate set by #RAK3172_LoRaWAN_SetDataRate is used.
+ *                      The worst case data rate DR0 is used when the data rate is unknown or ADR is enabled.
+ *  @param p_Device     RAK3172 device object
+ *  @param Length       Length of the application payload in bytes
+ *  @param p_Airtime    Pointer to time on air in microseconds
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                      RAK3172_ERR_INVALID_STATE when the frequency band is unknown
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Duty_GetAirtime(const RAK3172_t& p_Device, uint16_t Length, uint32_t* const p_Airtime);
+
+/** @brief              Add a transmission to the duty cycle ledger of a device. The driver records each uplink automatically.
+ *                      Use this function for transmissions the driver doesn´t know about.
+ *  @param p_Device     RAK3172 device object
+ *  @param Airtime      Time on air in microseconds
+ *  @param Frequency    (Optional) Frequency of the transmission in Hz. Use 0 for the default channels of the band.
+ *                      NOTE: Transmissions outside of a regulated sub band are ignored.
+ */
+void RAK3172_LoRaWAN_Duty_Record(RAK3172_t& p_Device, uint32_t Airtime, uint32_t Frequency = 0);
+
+/** @brief              Get the time until the next uplink fits into the duty cycle of the band. The time on air is calculated with
+ *                      #RAK3172_LoRaWAN_Duty_GetAirtime.
+ *  @param p_Device     RAK3172 device object
+ *  @param Length       Length of the application payload in bytes
+ *  @param p_Delay      Pointer to delay in milliseconds. 0 when the uplink can be transmitted now
+ *  @param Frequency    (Optional) Frequency of the uplink in Hz. Use 0 for the default channels of the band.
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed or the uplink exceeds the duty cycle of a whole hour
+ *                      RAK3172_ERR_INVALID_STATE when the device isn´t initialized or the frequency band is unknown
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Duty_GetNext(RAK3172_t& p_Device, uint16_t Length, uint32_t* const p_Delay, uint32_t Frequency = 0);
+
+/** @brief              Clear the duty cycle ledger of a device.
+ *  @param p_Device     RAK3172 device object
+ */
+void RAK3172_LoRaWAN_Duty_Reset(RAK3172_t& p_Device);
+
+#endif /* RAK3172_LORAWAN_DUTY_H_ */
@@ -0,0 +1,68 @@
+ /*
+ * rak3172_lorawan_packer.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#ifndef RAK3172_LORAWAN_PACKER_H_
+#define RAK3172_LORAWAN_PACKER_H_
+
+#include "rak3172_defs.h"
+
+/** @brief Maximum number of records for the uplink packer.
+ */
+#define RAK3172_PACK_MAX_RECORDS                                32
+
+/** @brief Frame index of a record without remaining part.
+ */
+#define RAK3172_PACK_NONE                                       0xFF
+
+/** @brief              Assign application records to frames with a maximum payload size. Records larger than the maximum payload are split.
+ *                      Their full size parts get their own frames and only the remaining part is packed. The remaining parts are packed
+ *                      with a first fit decreasing strategy, so records are never split across packed frames.
+ *  @param p_Records    Pointer to records
+ *  @param Count        Number of records (1 - #RAK3172_PACK_MAX_RECORDS)
+ *  @param MaxPayload   Maximum payload of a frame in bytes
+ *  @param p_Frames     Pointer to packed frame index for each record.
+ *                      #RAK3172_PACK_NONE when the record has no remaining part
+ *  @param p_FrameCount Pointer to number of packed frames without the frames of the full size parts
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_Pack(const RAK3172_Record_t* const p_Records, uint8_t Count, uint8_t MaxPayload, uint8_t* const p_Frames, uint8_t* const p_FrameCount);
+
+/** @brief              Pack application records into frames, which fit into the maximum payload of the current data rate, and queue the frames.
+ *                      The records of a frame are concatenated in the order of the records. The worst case data rate DR0 is used when the
+ *                      data rate is unknown or ADR is enabled.
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Records    Pointer to records
+ *  @param Count        Number of records (1 - #RAK3172_PACK_MAX_RECORDS)
+ *  @param Priority     (Optional) Priority of the uplinks
+ *  @param Deadline     (Optional) Maximum queue time in milliseconds. 0 when the uplinks don´t expire.
+ *  @param Retries      (Optional) Number of confirmed payload retransmissions
+ *  @param Confirmed    (Optional) Enable message confirmation
+ *  @param p_Uplinks    (Optional) Pointer to number of queued uplinks
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_BUSY when the device is busy or when the uplink queue is full
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the frequency band is unknown
+ *                      RAK3172_ERR_NOT_CONNECTED when the device is not joined
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as LoRaWAN device. Please call \ref RAK3172_LoRaWAN_Init first
+ */
+RAK3172_Error_t RAK3172_LoRaWAN_TransmitRecords(RAK3172_t& p_Device, uint8_t Port, const RAK3172_Record_t* const p_Records, uint8_t Count, RAK3172_Uplink_Priority_t Priority = RAK_UPLINK_PRIO_NORMAL, uint32_t Deadline = 0, uint8_t Retries = 0, bool Confirmed = false, uint8_t* const p_Uplinks = NULL);
+
+#endif /* RAK3172_LORAWAN_PACKER_H_ */
@@ -204,13 +204,27 @@ RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const uint8_t* c
  */
 RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_Message, uint16_t Timeout);
 
+/** @brief              Receive a LoRa P2P message without copying it. The message stays in the receive slot of the driver.
+ *                      NOTE: This is a blocking fuction!
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to the returned message. The message must be returned with \ref RAK3172_ReleaseMessage
+ *  @param Timeout      Receive timeout in milliseconds
+ *                      NOTE: Only values below 65534 are allowed!
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_TIMEOUT when no message was received
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as P2P device. Please call \ref RAK3172_P2P_Init first
+ */
+RAK3172_Error_t RAK3172_P2P_Borrow(RAK3172_t& p_Device, const RAK3172_Rx_t** p_Message, uint16_t Timeout);
+
 /** @brief              Start the listening mode to receive LoRa P2P message.
  *  @param p_Device     RAK3172 device object
  *  @param Timeout      (Optional) Timeout in milliseconds.
  *                      NOTE: 0 will stop the receiving, 65534 will disable the timeout (only with firmware v1.0.3 and later) and 65535 will disable the timeout and the device stops when a packet was received.
  *  @param CoreID       (Optional) Core ID for the listening task
  *  @param Priority     (Optional) Listening task priority
- *  @param QueueSize    (Optional) Size of the receive queue
+ *  @param QueueSize    (Optional) Size of the receive queue. Must be between 1 and 254
+ *                      NOTE: The number of unread messages is also limited by the receive slots of the driver (CONFIG_RAK3172_RX_QUEUE_LENGTH).
  *  @return             RAK3172_ERR_OK when successful
  *                      RAK3172_ERR_INVALID_STATE when the receive task can´t get started
  *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
@@ -219,6 +233,7 @@ RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_M
 RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout = RAK_REC_REPEAT, uint8_t CoreID = 1, uint8_t Priority = 16, uint8_t QueueSize = 8);
 
 /** @brief              Pop an item from the message queue.
+ *                      NOTE: The message queue is lock free and must only be read by one task.
  *  @param p_Device     RAK3172 device object
  *  @param p_Message    Pointer to message object
  *  @return             RAK3172_ERR_OK when successful
@@ -228,6 +243,17 @@ RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout = RAK_R
  */
 RAK3172_Error_t RAK3172_P2P_PopItem(const RAK3172_t& p_Device, RAK3172_Rx_t* const p_Message);
 
+/** @brief              Pop an item from the message queue without copying it. The message stays in the receive slot of the driver.
+ *                      NOTE: The message queue is lock free and must only be read by one task.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to the returned message. The message must be returned with \ref RAK3172_ReleaseMessage
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_FAIL when no item was poped from the queue
+ *                      RAK3172_ERR_INVALID_MODE when the device is not initialized as P2P device. Please call \ref RAK3172_P2P_Init first
+ */
+RAK3172_Error_t RAK3172_P2P_BorrowItem(const RAK3172_t& p_Device, const RAK3172_Rx_t** p_Message);
+
 /** @brief          Stop the listening mode.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -22,13 +22,36 @@
 
 #include "Definitions/rak3172_defs.h"
 
-/** @brief          Deinitialize the RAK3172 driver.
+/** @brief          Run a firmware update with a firmware image from memory.
  *  @param p_Device RAK3172 device object
  *  @param p_Data   Pointer to firmware data
  *  @param Length   Length of firmware data
+ *  @param p_Stats  (Optional) Pointer to update statistics
  *  @return         RAK3172_ERR_OK when successful
- *                  RAK3172_ERR_INVALID_STATE when the device was not initialized before
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                  RAK3172_ERR_BUSY when the device is busy
+ *                  RAK3172_ERR_INVALID_RESPONSE when the module rejects a block too often
+ *                  RAK3172_ERR_TIMEOUT when the module doesn´t acknowledge a block
+ *                  RAK3172_ERR_FAIL when the module cancels the update
  */
-RAK3172_Error_t RAK3172_RunUpdate(RAK3172_t& p_Device, const uint8_t* const p_Data, uint32_t Length);
+RAK3172_Error_t RAK3172_RunUpdate(RAK3172_t& p_Device, const uint8_t* const p_Data, uint32_t Length, RAK3172_Update_Stats_t* p_Stats = NULL);
+
+/** @brief          Run a firmware update and read the firmware image block by block with a reader (i. e. from a flash partition, a file or a socket).
+ *                  NOTE: Two blocks of the image are kept in memory, because the next block is read while the current block is transmitted.
+ *  @param p_Device RAK3172 device object
+ *  @param Size     Size of the firmware image
+ *  @param Reader   Reader for the firmware image
+ *  @param p_Arg    (Optional) Reader argument
+ *  @param p_Stats  (Optional) Pointer to update statistics
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                  RAK3172_ERR_NO_MEM when the block buffers can´t be allocated
+ *                  RAK3172_ERR_BUSY when the device is busy
+ *                  RAK3172_ERR_INVALID_RESPONSE when the module rejects a block too often
+ *                  RAK3172_ERR_TIMEOUT when the module doesn´t acknowledge a block
+ *                  RAK3172_ERR_FAIL when the module cancels the update
+ *                  Error of the reader when the reader fails
+ */
+RAK3172_Error_t RAK3172_RunUpdate(RAK3172_t& p_Device, uint32_t Size, RAK3172_Update_Reader_t Reader, void* p_Arg = NULL, RAK3172_Update_Stats_t* p_Stats = NULL);
 
 #endif /* RAK3172_YMODEM_H_ */
\ No newline at end of file
@@ -62,12 +62,32 @@ inline __attribute__((always_inline)) RAK3172_Baud_t RAK3172_GetBaud(const RAK31
     return p_Device.UART.Baudrate;
 }
 
+/** @brief  Get the number of wake ups of the driver tasks of the device. Sample the counter periodically to get the wake ups per second.
+ *  @return Number of wake ups
+ */
+inline __attribute__((always_inline)) uint32_t RAK3172_GetWakeups(const RAK3172_t& p_Device)
+{
+    return p_Device.Internal.Wakeups.load();
+}
+
+#ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+    /** @brief  Get the time spent asleep and awake by the host during the last blocking join or transmission of the device.
+     *  @return Sleep statistics
+     */
+    inline __attribute__((always_inline)) RAK3172_Sleep_t RAK3172_GetSleepStats(const RAK3172_t& p_Device)
+    {
+        return p_Device.Internal.Sleep;
+    }
+#endif
+
 /** @brief          Initialize the driver and the RAK3172 module.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
  *                  RAK3172_ERR_INVALID_STATE when the serial interface Cannot initialized
  *                  RAK3172_ERR_TIMEOUT when the driver isn´t able to communicate with the device (i. e. wrong UART settings)
+ *                  NOTE: The configured baud rate is replaced by the detected baud rate when the baud rate detection is enabled
+ *                  and the module isn´t switched to the configured baud rate.
  */
 RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device);
 
@@ -76,15 +96,37 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device);
  */
 void RAK3172_Deinit(RAK3172_t& p_Device);
 
-/** @brief          Set the baudrate of the module.
+/** @brief          Set the baudrate of the module. The UART interface is reconfigured without reinstalling the driver and the link is
+ *                  verified with an "AT" command. The previous baud rate is restored when the module doesn´t respond.
+ *                  Commands in flight are completed before the baud rate is changed and new commands are rejected until the link is verified.
  *  @param p_Device RAK3172 device object
  *  @param Baudrate Module baudrate
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
- *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
+ *                  RAK3172_ERR_BUSY when the device is busy, commands are still in flight or an uplink is transmitted
+ *                  RAK3172_ERR_INVALID_RESPONSE when the module doesn´t respond with the new baud rate and the previous baud rate was restored
+ *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized or when the module doesn´t respond anymore
  */
 RAK3172_Error_t RAK3172_SetBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate);
 
+/** @brief          Enter the burst mode and raise the baud rate temporarily for traffic heavy operations. The burst mode can be nested.
+ *                  NOTE: The module stores the baud rate. The module keeps the burst baud rate when the MCU is reset during a burst.
+ *  @param p_Device RAK3172 device object
+ *  @param Baudrate (Optional) Baud rate for the burst
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_BUSY when the device is busy, commands are still in flight or an uplink is transmitted
+ *                  RAK3172_ERR_INVALID_RESPONSE when the module doesn´t respond with the new baud rate and the previous baud rate was restored
+ *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized or when the module doesn´t respond anymore
+ */
+RAK3172_Error_t RAK3172_BeginBurst(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate = RAK_BAUD_115200);
+
+/** @brief          Leave the burst mode and restore the baud rate which was used before the burst.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_STATE the when no burst is active or when the module doesn´t respond anymore
+ */
+RAK3172_Error_t RAK3172_EndBurst(RAK3172_t& p_Device);
+
 /** @brief          Use this function to perform a quick initialization of the driver after leaving the sleep mode.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -93,6 +135,24 @@ RAK3172_Error_t RAK3172_SetBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate
  */
 RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device);
 
+/** @brief              Save the driver state into a snapshot. Call this function before the device enters the deep sleep mode.
+ *                      NOTE: The LoRaWAN keys are removed from the snapshot unless CONFIG_RAK3172_SNAPSHOT_WITH_KEYS is set.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Snapshot   Pointer to snapshot
+ */
+void RAK3172_SaveSnapshot(const RAK3172_t& p_Device, RAK3172_Snapshot_t* p_Snapshot);
+
+/** @brief              Initialize the driver after leaving the deep sleep mode and restore the driver state from a snapshot.
+ *                      The module is only queried when the snapshot is invalid.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Snapshot   Pointer to snapshot
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the serial interface Cannot initialized
+ *                      RAK3172_ERR_TIMEOUT when the driver isn´t able to communicate with the device
+ */
+RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device, const RAK3172_Snapshot_t* p_Snapshot);
+
 /** @brief          Perform a factory reset of the device.
  *  @param p_Device RAK3172 device object
  *  @return         RAK3172_ERR_OK when successful
@@ -129,7 +189,100 @@ RAK3172_Error_t RAK3172_SoftReset(RAK3172_t& p_Device, uint32_t Timeout = 10);
  *                  RAK3172_ERR_FAIL when an event happens, when the status is not "OK" or when the device is busy
  *                  RAK3172_ERR_TIMEOUT when a receive timeout occurs
  */
-RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Command, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
+RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, const std::string& Command, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
+
+/** @brief          Transmit an AT command to the RAK3172 module without waiting for the response.
+ *                  The response is passed to the completion callback in the order of transmission.
+ *  @param p_Device RAK3172 device object
+ *  @param Command  RAK3172 command
+ *  @param Response (Optional) Expected response of the module
+ *  @param Callback (Optional) Completion callback. The callback is called from the receive task.
+ *  @param p_Arg    (Optional) Argument for the completion callback
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ *                  RAK3172_ERR_BUSY when the device is busy or when too many commands are in flight
+ */
+RAK3172_Error_t RAK3172_SendCommandAsync(const RAK3172_t& p_Device, const std::string& Command, RAK3172_Response_t Response = RAK_RESPONSE_STATUS, RAK3172_Command_Callback_t Callback = NULL, void* p_Arg = NULL);
+
+/** @brief              Transmit an AT command, which is assembled from fragments, to the RAK3172 module.
+ *                      The fragments are written straight to the serial interface, so no memory is allocated for the command.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Fragments  Pointer to fragments of the RAK3172 command
+ *  @param Count        Number of fragments
+ *  @param p_Value      (Optional) Pointer to returned value.
+ *  @param p_Status     (Optional) Pointer to status string
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ *                      RAK3172_ERR_FAIL when an event happens, when the status is not "OK" or when the device is busy
+ *                      RAK3172_ERR_TIMEOUT when a receive timeout occurs
+ */
+RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
+
+/** @brief              Transmit an AT command, which is assembled from fragments, to the RAK3172 module without waiting for the response.
+ *                      The fragments are written before the function returns, so they can be placed on the stack of the caller.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Fragments  Pointer to fragments of the RAK3172 command
+ *  @param Count        Number of fragments
+ *  @param Response     (Optional) Expected response of the module
+ *  @param Callback     (Optional) Completion callback. The callback is called from the receive task.
+ *  @param p_Arg        (Optional) Argument for the completion callback
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ *                      RAK3172_ERR_BUSY when the device is busy or when too many commands are in flight
+ */
+RAK3172_Error_t RAK3172_SendCommandAsync(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count, RAK3172_Response_t Response = RAK_RESPONSE_STATUS, RAK3172_Command_Callback_t Callback = NULL, void* p_Arg = NULL);
+
+/** @brief              Transmit an AT command to the RAK3172 module without waiting for the response.
+ *                      The request must be completed with #RAK3172_WaitCommand.
+ *  @param p_Device     RAK3172 device object
+ *  @param Command      RAK3172 command
+ *  @param Response     Expected response of the module
+ *  @param p_Command    Pointer to the returned request
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ *                      RAK3172_ERR_BUSY when the device is busy or when too many commands are in flight
+ */
+RAK3172_Error_t RAK3172_SubmitCommand(const RAK3172_t& p_Device, const std::string& Command, RAK3172_Response_t Response, RAK3172_Command_t** p_Command);
+
+/** @brief              Wait for the response of a command from #RAK3172_SubmitCommand.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Command    Pointer to request
+ *  @param p_Value      (Optional) Pointer to returned value
+ *  @param p_Status     (Optional) Pointer to status string
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument is passed into the function
+ *                      RAK3172_ERR_FAIL when the status is not "OK"
+ *                      RAK3172_ERR_TIMEOUT when a receive timeout occurs
+ */
+RAK3172_Error_t RAK3172_WaitCommand(const RAK3172_t& p_Device, RAK3172_Command_t* p_Command, std::string* const p_Value = NULL, std::string* const p_Status = NULL);
+
+/** @brief          Wait until all commands in flight are completed.
+ *  @param p_Device RAK3172 device object
+ *  @param Timeout  (Optional) Timeout in milliseconds
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ *                  RAK3172_ERR_TIMEOUT when the commands aren´t completed within the timeout
+ */
+RAK3172_Error_t RAK3172_WaitForCommands(const RAK3172_t& p_Device, uint32_t Timeout = 10000);
+
+/** @brief              Return a message from #RAK3172_LoRaWAN_Borrow, #RAK3172_P2P_Borrow or #RAK3172_P2P_BorrowItem to the receive queue.
+ *                      NOTE: The message must not be used after the release.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to message
+ */
+void RAK3172_ReleaseMessage(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message);
+
+/** @brief              Get the statistics of the receive queue.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Stats      Pointer to statistics object
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+ *                      RAK3172_ERR_INVALID_STATE when the driver isn´t initialized
+ */
+RAK3172_Error_t RAK3172_GetReceiveStats(const RAK3172_t& p_Device, RAK3172_Rx_Stats_t* const p_Stats);
 
 /** @brief              Get the firmware version of the RAK3172 module.
  *  @param p_Device     RAK3172 device object
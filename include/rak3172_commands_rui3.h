@@ -76,15 +76,30 @@ RAK3172_Error_t RAK3172_GetModel(const RAK3172_t& p_Device, std::string* const p
  */
 RAK3172_Error_t RAK3172_GetHWID(const RAK3172_t& p_Device, std::string* const p_ID);
 
-/** @brief          Put the device into sleep mode.
- *                  NOTE: Use any command to wake up the module.
+/** @brief          Put the device into sleep mode. The driver tracks the sleep of the module and wakes up the module before the next command
+ *                  or holds the command until the module wakes up by itself (\ref CONFIG_RAK3172_SLEEP_WAKE_DEFER).
  *  @param p_Device RAK3172 device object
- *  @param Duration Sleep duration in milliseconds
+ *  @param Duration Sleep duration in milliseconds. Use 0 to sleep until the next command.
  *  @return         RAK3172_ERR_OK when successful
  *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
  *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
  */
-RAK3172_Error_t RAK3172_Sleep(const RAK3172_t& p_Device, uint32_t Duration);
+RAK3172_Error_t RAK3172_Sleep(RAK3172_t& p_Device, uint32_t Duration);
+
+#ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+    /** @brief          Put the module into sleep mode and the host into light sleep until the next uplink is due.
+     *                  The energy of each cycle is estimated with the currents from the power management configuration.
+     *                  NOTE: The function returns after the interval. A cycle ends with each call of this function.
+     *  @param p_Device RAK3172 device object
+     *  @param Interval Time in milliseconds until the next uplink
+     *  @param p_Cycle  (Optional) Pointer to the summary of the finished cycle
+     *  @return         RAK3172_ERR_OK when successful
+     *                  RAK3172_ERR_INVALID_ARG when an invalid argument was passed
+     *                  RAK3172_ERR_INVALID_STATE the when the interface is not initialized
+     *                  RAK3172_ERR_BUSY when the pending commands don´t finish
+     */
+    RAK3172_Error_t RAK3172_SleepCycle(RAK3172_t& p_Device, uint32_t Interval, RAK3172_Cycle_t* const p_Cycle = NULL);
+#endif
 
 /** @brief          Lock the device UART.
  *  @param p_Device RAK3172 device object
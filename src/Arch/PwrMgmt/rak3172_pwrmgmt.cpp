@@ -21,22 +21,313 @@
 
 #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
 
+#include <atomic>
+#include <string.h>
+#include <algorithm>
+
+#include <esp_pm.h>
 #include <esp_sleep.h>
+#include <esp_timer.h>
 
 #include <driver/gpio.h>
 #include <driver/uart.h>
 
 #include "rak3172_pwrmgmt.h"
+#include "../Logging/rak3172_logging.h"
+#include "../../Core/rak3172_uplink.h"
+#include "../../Core/rak3172_registry.h"
+
+/** @brief Number of positive edges on the Rx line which wake up the host.
+ */
+#define RAK3172_PWRMGMT_WAKEUP_THRESHOLD                        3
+
+/** @brief Time in milliseconds the host stays awake after a wake up to receive the remaining characters of a line.
+ */
+#define RAK3172_PWRMGMT_AWAKE_TIME                              100
+
+/** @brief Maximum time in milliseconds for a single light sleep.
+ */
+#define RAK3172_PWRMGMT_MAX_SLEEP                               10000
+
+/** @brief Prefix of the module events.
+ */
+#define RAK3172_PWRMGMT_EVENT_PREFIX                            "+EVT:"
+
+static const char* TAG = "RAK3172_PwrMgmt";
+
+/** @brief Number of active serial transfers of all devices.
+ */
+static std::atomic<uint32_t> _RAK3172_PwrMgmt_Traffic(0);
+
+/** @brief  Get the time since boot from the ESP timer.
+ *  @return Time since boot in microseconds
+ */
+static uint64_t RAK3172_PwrMgmt_GetTimerTime(void)
+{
+    return static_cast<uint64_t>(esp_timer_get_time());
+}
+
+/** @brief          Enter the light sleep of the ESP32.
+ *  @param p_Device RAK3172 device object
+ *  @param Timeout  Maximum sleep time in microseconds
+ *  @return         #true when the host was woken up by the UART
+ */
+static bool RAK3172_PwrMgmt_LightSleep(const RAK3172_t& p_Device, uint64_t Timeout)
+{
+    esp_sleep_enable_timer_wakeup(Timeout);
+
+    if(esp_light_sleep_start() != ESP_OK)
+    {
+        return false;
+    }
+
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UART;
+}
+
+static const RAK3172_PwrMgmt_Clock_t _RAK3172_PwrMgmt_DefaultClock = {
+    .GetTime    = RAK3172_PwrMgmt_GetTimerTime,
+    .Sleep      = RAK3172_PwrMgmt_LightSleep,
+};
+
+static const RAK3172_PwrMgmt_Clock_t* _RAK3172_PwrMgmt_Clock = &_RAK3172_PwrMgmt_DefaultClock;
+
+#ifdef CONFIG_PM_ENABLE
+    /** @brief  Get the power management lock which prevents the automatic light sleep during serial traffic.
+     *  @return Lock handle or #NULL when the lock can not be created
+     */
+    static esp_pm_lock_handle_t RAK3172_PwrMgmt_GetLock(void)
+    {
+        static esp_pm_lock_handle_t Lock = []() {
+            esp_pm_lock_handle_t Handle = NULL;
+
+            if(esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "RAK3172", &Handle) != ESP_OK)
+            {
+                RAK3172_LOGE(TAG, "Can not create power management lock!");
+            }
+
+            return Handle;
+        }();
+
+        return Lock;
+    }
+#endif
+
+/** @brief          Check if the device has no serial traffic.
+ *  @param p_Device RAK3172 device object
+ *  @return         #true when the host can sleep
+ */
+static bool RAK3172_PwrMgmt_isIdle(RAK3172_t& p_Device)
+{
+    size_t BufferedSize;
+
+    if(_RAK3172_PwrMgmt_Traffic > 0)
+    {
+        return false;
+    }
+
+    // Wait until a partially received line is completed.
+    if((uart_get_buffered_data_len(p_Device.UART.Interface, &BufferedSize) != ESP_OK) || (BufferedSize > 0))
+    {
+        return false;
+    }
+
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+        bool isPending = false;
+
+        // A rejected uplink is transmitted again by the receive task.
+        if(p_Device.LoRaWAN.UplinkLock != NULL)
+        {
+            xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+            isPending = (p_Device.LoRaWAN.ActiveUplink != RAK3172_UPLINK_NONE) &&
+                        (p_Device.LoRaWAN.Uplinks[p_Device.LoRaWAN.ActiveUplink].State == RAK_UPLINK_PENDING);
+            xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+        }
+
+        if(isPending)
+        {
+            return false;
+        }
+    #endif
+
+    return true;
+}
+
+void RAK3172_PwrMgmt_SetClock(const RAK3172_PwrMgmt_Clock_t* p_Clock)
+{
+    _RAK3172_PwrMgmt_Clock = (p_Clock != NULL) ? p_Clock : &_RAK3172_PwrMgmt_DefaultClock;
+}
+
+uint64_t RAK3172_PwrMgmt_GetTime(void)
+{
+    return _RAK3172_PwrMgmt_Clock->GetTime();
+}
 
-void RAK3172_PwrMagnt_EnterLightSleep(RAK3172_t& p_Device)
+void RAK3172_PwrMgmt_Init(const RAK3172_t& p_Device)
 {
-    /*
-    gpio_sleep_set_direction(static_cast<gpio_num_t>(p_Device.UART.Rx), GPIO_MODE_INPUT);
-    gpio_sleep_set_pull_mode(static_cast<gpio_num_t>(p_Device.UART.Rx), GPIO_PULLUP_ONLY);
-    uart_set_wakeup_threshold(static_cast<uart_port_t>(p_Device.UART.Interface), 1);
-    esp_sleep_enable_uart_wakeup(static_cast<uart_port_t>(p_Device.UART.Interface));
-    esp_light_sleep_start();
-    */
+    #ifdef CONFIG_RAK3172_PWRMGMT_LIGHT_SLEEP
+        gpio_sleep_set_direction(p_Device.UART.Rx, GPIO_MODE_INPUT);
+        gpio_sleep_set_pull_mode(p_Device.UART.Rx, GPIO_PULLUP_ONLY);
+
+        // Only some UART interfaces can wake up the host.
+        if((uart_set_wakeup_threshold(p_Device.UART.Interface, RAK3172_PWRMGMT_WAKEUP_THRESHOLD) != ESP_OK) ||
+           (esp_sleep_enable_uart_wakeup(p_Device.UART.Interface) != ESP_OK))
+        {
+            RAK3172_LOGW(TAG, "UART%u can not wake up the host!", static_cast<unsigned int>(p_Device.UART.Interface));
+        }
+    #endif
+}
+
+void RAK3172_PwrMgmt_Acquire(void)
+{
+    _RAK3172_PwrMgmt_Traffic++;
+
+    #ifdef CONFIG_PM_ENABLE
+        esp_pm_lock_acquire(RAK3172_PwrMgmt_GetLock());
+    #endif
+}
+
+void RAK3172_PwrMgmt_Release(void)
+{
+    #ifdef CONFIG_PM_ENABLE
+        esp_pm_lock_release(RAK3172_PwrMgmt_GetLock());
+    #endif
+
+    _RAK3172_PwrMgmt_Traffic--;
+}
+
+void RAK3172_PwrMgmt_Begin(RAK3172_t& p_Device)
+{
+    p_Device.Internal.SleepStart = _RAK3172_PwrMgmt_Clock->GetTime();
+    p_Device.Internal.Sleep.Asleep = 0;
+    p_Device.Internal.Sleep.Awake = 0;
+}
+
+void RAK3172_PwrMgmt_End(RAK3172_t& p_Device)
+{
+    uint64_t Elapsed;
+
+    Elapsed = _RAK3172_PwrMgmt_Clock->GetTime() - p_Device.Internal.SleepStart;
+    p_Device.Internal.Sleep.Awake = Elapsed - std::min(Elapsed, p_Device.Internal.Sleep.Asleep);
+
+    RAK3172_LOGD(TAG, "Operation finished. Asleep: %llu us / Awake: %llu us", static_cast<unsigned long long>(p_Device.Internal.Sleep.Asleep),
+                                                                                   static_cast<unsigned long long>(p_Device.Internal.Sleep.Awake));
+}
+
+TickType_t RAK3172_PwrMgmt_Sleep(RAK3172_t& p_Device, TickType_t Timeout)
+{
+    uint64_t Start;
+    uint64_t Duration;
+
+    if(Timeout == 0)
+    {
+        return 0;
+    }
+
+    if(RAK3172_PwrMgmt_isIdle(p_Device))
+    {
+        Duration = static_cast<uint64_t>(std::min(Timeout, static_cast<TickType_t>(RAK3172_PWRMGMT_MAX_SLEEP / portTICK_PERIOD_MS))) * portTICK_PERIOD_MS * 1000ULL;
+
+        Start = _RAK3172_PwrMgmt_Clock->GetTime();
+        p_Device.Internal.isWoken.store(_RAK3172_PwrMgmt_Clock->Sleep(p_Device, Duration), std::memory_order_release);
+        p_Device.Internal.Sleep.Asleep += _RAK3172_PwrMgmt_Clock->GetTime() - Start;
+
+        // The FreeRTOS tick doesn´t advance during the light sleep. Let the receive task check the deadlines again.
+        RAK3172_Registry_Wake(p_Device);
+    }
+
+    // Stay awake for a short time to receive the line which has woken up the host or to finish the serial traffic.
+    return std::min(Timeout, static_cast<TickType_t>(RAK3172_PWRMGMT_AWAKE_TIME / portTICK_PERIOD_MS));
+}
+
+uint64_t RAK3172_PwrMgmt_SleepFor(RAK3172_t& p_Device, uint64_t Duration)
+{
+    bool isWoken;
+    uint64_t Start;
+    uint64_t Now;
+    uint64_t Elapsed;
+    uint64_t Asleep;
+    uint64_t Delayed;
+
+    Start = _RAK3172_PwrMgmt_Clock->GetTime();
+    Elapsed = 0;
+    Asleep = 0;
+    Delayed = 0;
+    while(Elapsed < Duration)
+    {
+        Now = _RAK3172_PwrMgmt_Clock->GetTime();
+        isWoken = _RAK3172_PwrMgmt_Clock->Sleep(p_Device, Duration - Elapsed);
+        Asleep += _RAK3172_PwrMgmt_Clock->GetTime() - Now;
+        Elapsed = _RAK3172_PwrMgmt_Clock->GetTime() - Start;
+
+        if(Elapsed >= Duration)
+        {
+            break;
+        }
+
+        if(isWoken)
+        {
+            // Hand the line which has woken up the host to the receive task before the host goes back into the light sleep.
+            p_Device.Internal.isWoken.store(true, std::memory_order_release);
+            RAK3172_Registry_Wake(p_Device);
+            vTaskDelay(std::min(static_cast<TickType_t>(((Duration - Elapsed) / 1000ULL / portTICK_PERIOD_MS) + 1),
+                                static_cast<TickType_t>(RAK3172_PWRMGMT_AWAKE_TIME / portTICK_PERIOD_MS)));
+        }
+        else
+        {
+            // Fall back to a task delay when the host can not enter the light sleep.
+            Now = _RAK3172_PwrMgmt_Clock->GetTime();
+            vTaskDelay(((Duration - Elapsed) / 1000ULL / portTICK_PERIOD_MS) + 1);
+            Delayed += _RAK3172_PwrMgmt_Clock->GetTime() - Now;
+        }
+
+        Elapsed = _RAK3172_PwrMgmt_Clock->GetTime() - Start;
+    }
+
+    p_Device.Internal.Sleep.Asleep += Asleep;
+
+    return Asleep + Delayed;
+}
+
+void RAK3172_PwrMgmt_Restore(RAK3172_Line_t* p_Line)
+{
+    size_t Skip;
+    size_t Missing;
+    const size_t Prefix = sizeof(RAK3172_PWRMGMT_EVENT_PREFIX) - 1;
+
+    // Remove the garbage of a character which was only partially received during the wake up.
+    Skip = 0;
+    while((Skip < p_Line->Length) && ((p_Line->Data[Skip] < ' ') || (p_Line->Data[Skip] > '~')))
+    {
+        Skip++;
+    }
+
+    memmove(p_Line->Data, &p_Line->Data[Skip], p_Line->Length - Skip + 1);
+    p_Line->Length -= Skip;
+
+    if(strncmp(p_Line->Data, RAK3172_PWRMGMT_EVENT_PREFIX, Prefix) == 0)
+    {
+        return;
+    }
+
+    // Find the longest end of the prefix which starts the line. At least "T:" must be received to identify an event.
+    for(Missing = 1; Missing < (Prefix - 1); Missing++)
+    {
+        if(strncmp(p_Line->Data, &RAK3172_PWRMGMT_EVENT_PREFIX[Missing], Prefix - Missing) == 0)
+        {
+            break;
+        }
+    }
+
+    if((Missing == (Prefix - 1)) || ((p_Line->Length + Missing) >= sizeof(p_Line->Data)))
+    {
+        return;
+    }
+
+    memmove(&p_Line->Data[Missing], p_Line->Data, p_Line->Length + 1);
+    memcpy(p_Line->Data, RAK3172_PWRMGMT_EVENT_PREFIX, Missing);
+    p_Line->Length += Missing;
+
+    RAK3172_LOGD(TAG, "Restored line after wake up: %s", p_Line->Data);
 }
 
 #endif
\ No newline at end of file
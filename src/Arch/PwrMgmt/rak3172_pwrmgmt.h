@@ -22,9 +22,71 @@
 
 #include "rak3172_defs.h"
 
-/** @brief          
+/** @brief Clock and sleep functions used by the power management. The default functions use the ESP timer and the light sleep of the ESP32.
+ *         A host build can replace them with a simulated sleep clock.
+ */
+typedef struct
+{
+    uint64_t (*GetTime)(void);                                  /**< Get the time since boot in microseconds. */
+    bool (*Sleep)(const RAK3172_t& p_Device, uint64_t Timeout); /**< Sleep until UART activity of the device or until the timeout in microseconds expires.
+                                                                     Returns #true when the sleep was left by UART activity. */
+} RAK3172_PwrMgmt_Clock_t;
+
+/** @brief          Replace the clock and sleep functions of the power management.
+ *  @param p_Clock  Pointer to clock functions. Use #NULL to restore the default functions.
+ *                  NOTE: The object must be valid as long as it is used.
+ */
+void RAK3172_PwrMgmt_SetClock(const RAK3172_PwrMgmt_Clock_t* p_Clock);
+
+/** @brief  Get the time since boot from the clock of the power management.
+ *  @return Time since boot in microseconds
+ */
+uint64_t RAK3172_PwrMgmt_GetTime(void);
+
+/** @brief          Configure the UART of a device as wake up source for the light sleep.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_PwrMgmt_Init(const RAK3172_t& p_Device);
+
+/** @brief  Mark the start of serial traffic. Automatic and manual light sleep are blocked until the traffic is released.
+ *          NOTE: The calls are counted and must be balanced with #RAK3172_PwrMgmt_Release.
+ */
+void RAK3172_PwrMgmt_Acquire(void);
+
+/** @brief  Mark the end of serial traffic.
+ */
+void RAK3172_PwrMgmt_Release(void);
+
+/** @brief          Start the sleep statistics for a blocking operation of a device.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_PwrMgmt_Begin(RAK3172_t& p_Device);
+
+/** @brief          Finish the sleep statistics for a blocking operation of a device.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_PwrMgmt_End(RAK3172_t& p_Device);
+
+/** @brief          Put the host into light sleep while the device waits for module events. The host only sleeps when no serial traffic is active.
+ *  @param p_Device RAK3172 device object
+ *  @param Timeout  Maximum wait time in ticks
+ *  @return         Time in ticks the caller should wait for the module event before the function is called again
+ */
+TickType_t RAK3172_PwrMgmt_Sleep(RAK3172_t& p_Device, TickType_t Timeout);
+
+/** @brief          Put the host into light sleep for a fixed time. Wake ups by the UART don´t end the sleep.
+ *                  The host stays awake for a short time after a wake up by the UART to process the received line.
+ *                  A task delay is used when the host can not enter the light sleep.
  *  @param p_Device RAK3172 device object
+ *  @param Duration Sleep duration in microseconds
+ *  @return         Time spent asleep or in the fallback task delay in microseconds
+ */
+uint64_t RAK3172_PwrMgmt_SleepFor(RAK3172_t& p_Device, uint64_t Duration);
+
+/** @brief          Restore the first line after a wake up by UART activity. The characters which wake up the host are lost,
+ *                  so the "+EVT:" prefix of the line is restored and leading garbage is removed.
+ *  @param p_Line   Pointer to received line
  */
-void RAK3172_PwrMagnt_EnterLightSleep(RAK3172_t& p_Device);
+void RAK3172_PwrMgmt_Restore(RAK3172_Line_t* p_Line);
 
 #endif /* RAK3172_PWRMGMT_H_ */
\ No newline at end of file
@@ -17,17 +17,63 @@
  * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
  */
 
+#include <string.h>
+
 #include "rak3172.h"
 
+#include "../Core/rak3172_cmdqueue.h"
+#include "../Core/rak3172_linepool.h"
+#include "../Core/rak3172_parser.h"
+#include "../Core/rak3172_rxqueue.h"
+#include "../Core/rak3172_sleep.h"
 #include "../Arch/Logging/rak3172_logging.h"
 
 static const char* TAG = "RAK3172";
 
-RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Command, std::string* const p_Value, std::string* const p_Status)
+/** @brief          Check if a baud rate is supported by the module.
+ *  @param Baudrate Baud rate
+ *  @return         #true when the baud rate is supported
+ */
+static bool RAK3172_IsBaudrate(RAK3172_Baud_t Baudrate)
 {
-    std::string* Response = NULL;
-    RAK3172_Error_t Error = RAK3172_ERR_OK;
+    switch(Baudrate)
+    {
+        case RAK_BAUD_4800:
+        case RAK_BAUD_9600:
+        case RAK_BAUD_19200:
+        case RAK_BAUD_38400:
+        case RAK_BAUD_57600:
+        case RAK_BAUD_115200:
+        {
+            return true;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, const std::string& Command, std::string* const p_Value, std::string* const p_Status)
+{
+    RAK3172_Error_t Error;
+    RAK3172_Command_t* Request;
+
+    RAK3172_ERROR_CHECK(RAK3172_SubmitCommand(p_Device, Command, (p_Value != NULL) ? RAK_RESPONSE_VALUE : RAK_RESPONSE_STATUS, &Request));
 
+    Error = RAK3172_CmdQueue_Wait(p_Device, Request, p_Value, p_Status);
+
+    if(p_Value != NULL)
+    {
+        RAK3172_LOGI(TAG, "     Value: %s", p_Value->c_str());
+    }
+    RAK3172_LOGD(TAG, "    Error: 0x%X", static_cast<int>(Error));
+
+    return Error;
+}
+
+RAK3172_Error_t RAK3172_SendCommandAsync(const RAK3172_t& p_Device, const std::string& Command, RAK3172_Response_t Response, RAK3172_Command_Callback_t Callback, void* p_Arg)
+{
     if(p_Device.Internal.isBusy)
     {
         RAK3172_LOGE(TAG, "Device busy!");
@@ -39,69 +85,134 @@ RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, std::string Comma
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    // Clear the queue and drop all items.
-    xQueueReset(p_Device.Internal.MessageQueue);
-
-    // Transmit the command.
     RAK3172_LOGI(TAG, "Transmit command: %s", Command.c_str());
-    uart_write_bytes(p_Device.UART.Interface, static_cast<const char*>(Command.c_str()), Command.length());
-    uart_write_bytes(p_Device.UART.Interface, "\r\n", 2);
 
-    // Copy the value if needed.
-    if(p_Value != NULL)
+    return RAK3172_CmdQueue_Submit(p_Device, Command, Response, Callback, p_Arg, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS, NULL);
+}
+
+RAK3172_Error_t RAK3172_SendCommand(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count, std::string* const p_Value, std::string* const p_Status)
+{
+    RAK3172_Error_t Error;
+    RAK3172_Command_t* Request;
+
+    if((p_Fragments == NULL) || (Count == 0))
     {
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
-        {
-            return RAK3172_ERR_TIMEOUT;
-        }
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isBusy)
+    {
+        RAK3172_LOGE(TAG, "Device busy!");
+
+        return RAK3172_ERR_BUSY;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
 
-        #ifdef CONFIG_RAK3172_USE_RUI3
-            // Remove the command from the response.
-            size_t Index;
+    RAK3172_LOGI(TAG, "Transmit command with %u fragments", Count);
 
-            Index = Response->find("=");
-            *Response = Response->substr(Index + 1);
-        #endif
+    RAK3172_ERROR_CHECK(RAK3172_CmdQueue_Submit(p_Device, p_Fragments, Count, (p_Value != NULL) ? RAK_RESPONSE_VALUE : RAK_RESPONSE_STATUS, NULL, NULL, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS, &Request));
 
-        *p_Value = *Response;
-        delete Response;
+    Error = RAK3172_CmdQueue_Wait(p_Device, Request, p_Value, p_Status);
 
+    if(p_Value != NULL)
+    {
         RAK3172_LOGI(TAG, "     Value: %s", p_Value->c_str());
     }
+    RAK3172_LOGD(TAG, "    Error: 0x%X", static_cast<int>(Error));
 
-    #ifndef CONFIG_RAK3172_USE_RUI3
-        // Receive the line feed before the status.
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
-        {
-            return RAK3172_ERR_TIMEOUT;
-        }
-        delete Response;
-    #endif
+    return Error;
+}
 
-    // Receive the trailing status code.
-    if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+RAK3172_Error_t RAK3172_SendCommandAsync(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count, RAK3172_Response_t Response, RAK3172_Command_Callback_t Callback, void* p_Arg)
+{
+    if((p_Fragments == NULL) || (Count == 0))
     {
-        return RAK3172_ERR_TIMEOUT;
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isBusy)
+    {
+        RAK3172_LOGE(TAG, "Device busy!");
+
+        return RAK3172_ERR_BUSY;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
     }
 
-    RAK3172_LOGI(TAG, "     Status: %s", Response->c_str());
+    RAK3172_LOGI(TAG, "Transmit command with %u fragments", Count);
+
+    return RAK3172_CmdQueue_Submit(p_Device, p_Fragments, Count, Response, Callback, p_Arg, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS, NULL);
+}
 
-    // Transmission is without error when 'OK' as status code and when no event data are received.
-    if(Response->find("OK") == std::string::npos)
+RAK3172_Error_t RAK3172_SubmitCommand(const RAK3172_t& p_Device, const std::string& Command, RAK3172_Response_t Response, RAK3172_Command_t** p_Command)
+{
+    if(p_Command == NULL)
     {
-        Error = RAK3172_ERR_FAIL;
+        return RAK3172_ERR_INVALID_ARG;
     }
+    else if(p_Device.Internal.isBusy)
+    {
+        RAK3172_LOGE(TAG, "Device busy!");
 
-    // Copy the status string if needed.
-    if(p_Status != NULL)
+        return RAK3172_ERR_BUSY;
+    }
+    else if(p_Device.Internal.isInitialized == false)
     {
-        *p_Status = *Response;
+        return RAK3172_ERR_INVALID_STATE;
     }
-    RAK3172_LOGD(TAG, "    Error: 0x%X", static_cast<int>(Error));
 
-    delete Response;
+    RAK3172_LOGI(TAG, "Transmit command: %s", Command.c_str());
 
-    return Error;
+    return RAK3172_CmdQueue_Submit(p_Device, Command, Response, NULL, NULL, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS, p_Command);
+}
+
+RAK3172_Error_t RAK3172_WaitCommand(const RAK3172_t& p_Device, RAK3172_Command_t* p_Command, std::string* const p_Value, std::string* const p_Status)
+{
+    if(p_Command == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    return RAK3172_CmdQueue_Wait(p_Device, p_Command, p_Value, p_Status);
+}
+
+RAK3172_Error_t RAK3172_WaitForCommands(const RAK3172_t& p_Device, uint32_t Timeout)
+{
+    if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    if(RAK3172_CmdQueue_WaitIdle(p_Device, Timeout / portTICK_PERIOD_MS) == false)
+    {
+        return RAK3172_ERR_TIMEOUT;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_ReleaseMessage(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message)
+{
+    RAK3172_RxQueue_Release(p_Device, p_Message);
+}
+
+RAK3172_Error_t RAK3172_GetReceiveStats(const RAK3172_t& p_Device, RAK3172_Rx_Stats_t* const p_Stats)
+{
+    if(p_Stats == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    RAK3172_RxQueue_GetStats(p_Device, p_Stats);
+
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_GetFWVersion(const RAK3172_t& p_Device, std::string* const p_Version)
@@ -127,7 +238,7 @@ RAK3172_Error_t RAK3172_GetSerialNumber(const RAK3172_t& p_Device, std::string*
 RAK3172_Error_t RAK3172_SetMode(RAK3172_t& p_Device, RAK3172_Mode_t Mode)
 {
     std::string Command;
-    std::string* Response;
+    RAK3172_Line_t* Response;
     RAK3172_Error_t Error = RAK3172_ERR_OK;
 
     if(p_Device.Internal.isInitialized == false)
@@ -141,47 +252,64 @@ RAK3172_Error_t RAK3172_SetMode(RAK3172_t& p_Device, RAK3172_Mode_t Mode)
 
     p_Device.Internal.isBusy = true;
 
+    // The mode change bypasses the command queue, because the module responds with the splash screen.
+    // Wait for the commands in flight and drop all unread lines.
+    if(RAK3172_CmdQueue_WaitIdle(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
+    {
+        Error = RAK3172_ERR_BUSY;
+        goto RAK3172_SetMode_Exit;
+    }
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        Error = RAK3172_Sleep_Wake(p_Device);
+        if(Error != RAK3172_ERR_OK)
+        {
+            goto RAK3172_SetMode_Exit;
+        }
+    #endif
+
+    RAK3172_LinePool_Flush(p_Device);
+
     // Transmit the command.
     Command = "AT+NWM=" + std::to_string(static_cast<uint32_t>(Mode)) + "\r\n";
     uart_write_bytes(p_Device.UART.Interface, static_cast<const char*>(Command.c_str()), Command.length());
 
     #ifndef CONFIG_RAK3172_USE_RUI3
         // Receive the line feed before the status.
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+        if(RAK3172_LinePool_Receive(p_Device, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
         {
             Error = RAK3172_ERR_TIMEOUT;
             goto RAK3172_SetMode_Exit;
         }
-        delete Response;
+        RAK3172_LinePool_Release(p_Device, Response);
     #endif
 
     // Receive the trailing status code.
-    if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+    if(RAK3172_LinePool_Receive(p_Device, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
     {
         Error = RAK3172_ERR_TIMEOUT;
         goto RAK3172_SetMode_Exit;
     }
 
     // 'OK' received, so the mode wasn´t change. Leave the function.
-    if(Response->find("OK") != std::string::npos)
+    if(strstr(Response->Data, "OK") != NULL)
     {
-        delete Response;
+        RAK3172_LinePool_Release(p_Device, Response);
 
         Error = RAK3172_ERR_OK;
         goto RAK3172_SetMode_Exit;
     }
 
     // Otherwise the mode has changed and we have to receive the splash screen.
-    delete Response;
+    RAK3172_LinePool_Release(p_Device, Response);
     do
     {
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == pdFAIL)
+        if(RAK3172_LinePool_Receive(p_Device, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
         {
             p_Device.Internal.isBusy = false;
         }
         else
         {
-            delete Response;
+            RAK3172_LinePool_Release(p_Device, Response);
         }
     } while(p_Device.Internal.isBusy);
 
@@ -199,9 +327,7 @@ RAK3172_Error_t RAK3172_GetMode(RAK3172_t& p_Device)
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NWM=?", &Value));
 
-    p_Device.Mode = static_cast<RAK3172_Mode_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, &p_Device.Mode, RAK_MODE_P2P, RAK_MODE_P2P_FSK);
 }
 
 RAK3172_Error_t RAK3172_GetBaudrateFromDevice(const RAK3172_t& p_Device, RAK3172_Baud_t* p_Baudrate)
@@ -210,7 +336,5 @@ RAK3172_Error_t RAK3172_GetBaudrateFromDevice(const RAK3172_t& p_Device, RAK3172
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAUD=?", &Value));
 
-    *p_Baudrate = static_cast<RAK3172_Baud_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Baudrate, RAK3172_IsBaudrate);
 }
\ No newline at end of file
@@ -21,8 +21,33 @@
 
 #ifdef CONFIG_RAK3172_USE_RUI3
 
+#include <algorithm>
+
 #include "rak3172.h"
 
+#include "../Core/rak3172_sleep.h"
+#include "../Core/rak3172_cmdqueue.h"
+#include "../Arch/PwrMgmt/rak3172_pwrmgmt.h"
+
+#ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+    /** @brief              Estimate the energy of host and module.
+     *  @param Duration     Duration in milliseconds
+     *  @param HostAsleep   Time the host spent in light sleep in milliseconds
+     *  @param ModuleAsleep Time the module spent in sleep mode in milliseconds
+     *  @return             Energy in microjoule
+     */
+    static uint64_t RAK3172_EstimateEnergy(uint64_t Duration, uint64_t HostAsleep, uint64_t ModuleAsleep)
+    {
+        uint64_t Charge;
+
+        // Milliseconds multiplied with microampere result in nanoampere seconds.
+        Charge = ((Duration - HostAsleep) * CONFIG_RAK3172_PWRMGMT_HOST_ACTIVE_CURRENT) + (HostAsleep * CONFIG_RAK3172_PWRMGMT_HOST_SLEEP_CURRENT) +
+                 ((Duration - ModuleAsleep) * CONFIG_RAK3172_PWRMGMT_MODULE_ACTIVE_CURRENT) + (ModuleAsleep * CONFIG_RAK3172_PWRMGMT_MODULE_SLEEP_CURRENT);
+
+        return (Charge * CONFIG_RAK3172_PWRMGMT_VOLTAGE) / 1000000ULL;
+    }
+#endif
+
 RAK3172_Error_t RAK3172_GetCLIVersion(const RAK3172_t& p_Device, std::string* const p_Version)
 {
     if(p_Version == NULL)
@@ -83,11 +108,75 @@ RAK3172_Error_t RAK3172_GetHWID(const RAK3172_t& p_Device, std::string* const p_
     return RAK3172_SendCommand(p_Device, "AT+HWID=?", p_ID);
 }
 
-RAK3172_Error_t RAK3172_Sleep(const RAK3172_t& p_Device, uint32_t Duration)
+RAK3172_Error_t RAK3172_Sleep(RAK3172_t& p_Device, uint32_t Duration)
 {
-    return RAK3172_SendCommand(p_Device, "AT+SLEEP=" + std::to_string(Duration));
+    std::string Command;
+
+    Command = "AT+SLEEP";
+    if(Duration > 0)
+    {
+        Command += "=" + std::to_string(Duration);
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, Command));
+
+    // The module enters the sleep mode after the status code.
+    RAK3172_Sleep_Enter(p_Device, Duration);
+
+    return RAK3172_ERR_OK;
 }
 
+#ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+    RAK3172_Error_t RAK3172_SleepCycle(RAK3172_t& p_Device, uint32_t Interval, RAK3172_Cycle_t* const p_Cycle)
+    {
+        uint64_t Now;
+        uint64_t Start;
+        uint64_t Asleep;
+        uint64_t Duration;
+
+        if(Interval == 0)
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
+        else if(p_Device.Internal.isInitialized == false)
+        {
+            return RAK3172_ERR_INVALID_STATE;
+        }
+
+        // The module must not sleep while responses are pending.
+        if(RAK3172_CmdQueue_WaitIdle(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
+        {
+            return RAK3172_ERR_BUSY;
+        }
+
+        Start = RAK3172_PwrMgmt_GetTime();
+        if(p_Device.Internal.CycleStart == 0)
+        {
+            p_Device.Internal.CycleStart = Start;
+        }
+
+        RAK3172_ERROR_CHECK(RAK3172_Sleep(p_Device, Interval));
+
+        RAK3172_PwrMgmt_Begin(p_Device);
+        Asleep = RAK3172_PwrMgmt_SleepFor(p_Device, static_cast<uint64_t>(Interval) * 1000ULL) / 1000ULL;
+        RAK3172_PwrMgmt_End(p_Device);
+
+        Now = RAK3172_PwrMgmt_GetTime();
+        Duration = (Now - p_Device.Internal.CycleStart) / 1000ULL;
+        p_Device.Internal.CycleStart = Now;
+
+        if(p_Cycle != NULL)
+        {
+            p_Cycle->Duration = static_cast<uint32_t>(Duration);
+            p_Cycle->HostAsleep = static_cast<uint32_t>(std::min(Asleep, Duration));
+            p_Cycle->ModuleAsleep = static_cast<uint32_t>(std::min(static_cast<uint64_t>(Interval), Duration));
+            p_Cycle->Energy = RAK3172_EstimateEnergy(Duration, p_Cycle->HostAsleep, p_Cycle->ModuleAsleep);
+        }
+
+        return RAK3172_ERR_OK;
+    }
+#endif
+
 RAK3172_Error_t RAK3172_Lock(const RAK3172_t& p_Device, std::string Password)
 {
     if((Password.length() < 1) || (Password.length() > 8))
@@ -0,0 +1,516 @@
+ /*
+ * rak3172_cmdqueue.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Pipelined AT command queue for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <stdlib.h>
+
+#include "rak3172_cmdqueue.h"
+#include "rak3172_linepool.h"
+#include "rak3172_sleep.h"
+#include "rak3172_registry.h"
+#include "rak3172_writer.h"
+#include "../Arch/Logging/rak3172_logging.h"
+#include "../Arch/PwrMgmt/rak3172_pwrmgmt.h"
+
+#include "rak3172.h"
+
+/** @brief Completion flag of the command queue, which is set while no command is in flight. The flags below are used by the requests.
+ */
+#define RAK3172_CMDQUEUE_IDLE                                   BIT(CONFIG_RAK3172_COMMAND_QUEUE_LENGTH)
+
+static const char* TAG = "RAK3172_CmdQueue";
+
+/** @brief          Get the value of a completed request.
+ *  @param p_Command Pointer to request
+ *  @return         Pointer to the value or an empty string when no value was received
+ */
+static const char* RAK3172_CmdQueue_GetValue(const RAK3172_Command_t* p_Command)
+{
+    const char* Value;
+
+    if(p_Command->Value == NULL)
+    {
+        return "";
+    }
+
+    Value = p_Command->Value->Data;
+
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        const char* Index;
+
+        // Remove the command from the response.
+        Index = strchr(Value, '=');
+        if(Index != NULL)
+        {
+            Value = Index + 1;
+        }
+    #endif
+
+    return Value;
+}
+
+/** @brief          Complete the oldest command in flight.
+ *                  NOTE: The completion lock must be held!
+ *  @param p_Device RAK3172 device object
+ *  @param Error    Result of the command
+ */
+static void RAK3172_CmdQueue_Complete(const RAK3172_t& p_Device, RAK3172_Error_t Error)
+{
+    uint8_t Index;
+    RAK3172_Command_t* Command;
+
+    if(xQueuePeek(p_Device.Internal.CommandQueue, &Index, 0) != pdPASS)
+    {
+        return;
+    }
+
+    Command = &p_Device.Internal.Commands[Index];
+    Command->Error = Error;
+
+    RAK3172_LOGD(TAG, "Request %u completed with status: %s", Index, Command->Status);
+
+    // The request stays in flight until the callback returns, so that a wait for the idle state includes the callback.
+    if(Command->Callback != NULL)
+    {
+        Command->Callback(Error, RAK3172_CmdQueue_GetValue(Command), Command->Status, Command->Arg);
+
+        RAK3172_LinePool_Release(p_Device, Command->Value);
+        Command->Value = NULL;
+
+        xQueueReceive(p_Device.Internal.CommandQueue, &Index, 0);
+        xQueueSend(p_Device.Internal.CommandFreeQueue, &Index, 0);
+    }
+    else
+    {
+        xQueueReceive(p_Device.Internal.CommandQueue, &Index, 0);
+        xEventGroupSetBits(p_Device.Internal.CommandDone, BIT(Index));
+    }
+
+    // New requests are queued with the command lock, so the idle state can´t change during the check.
+    xSemaphoreTake(p_Device.Internal.CommandLock, portMAX_DELAY);
+    if(uxQueueMessagesWaiting(p_Device.Internal.CommandQueue) == 0)
+    {
+        xEventGroupSetBits(p_Device.Internal.CommandDone, RAK3172_CMDQUEUE_IDLE);
+    }
+    xSemaphoreGive(p_Device.Internal.CommandLock);
+
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_Release();
+    #endif
+
+    // The response timeout of the next request starts now.
+    if(xQueuePeek(p_Device.Internal.CommandQueue, &Index, 0) == pdPASS)
+    {
+        p_Device.Internal.Commands[Index].Start = xTaskGetTickCount();
+    }
+}
+
+/** @brief          Complete all commands in flight with an error.
+ *                  NOTE: The completion lock must be held!
+ *  @param p_Device RAK3172 device object
+ *  @param Error    Error code for the commands
+ */
+static void RAK3172_CmdQueue_AbortLocked(const RAK3172_t& p_Device, RAK3172_Error_t Error)
+{
+    while(uxQueueMessagesWaiting(p_Device.Internal.CommandQueue) > 0)
+    {
+        RAK3172_CmdQueue_Complete(p_Device, Error);
+    }
+}
+
+/** @brief          Complete the oldest command of a batch.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Batch  Pointer to batch
+ */
+static void RAK3172_Batch_CompleteOldest(const RAK3172_t& p_Device, RAK3172_Batch_t* p_Batch)
+{
+    uint8_t Index;
+    RAK3172_Error_t Error;
+
+    Index = p_Batch->First;
+
+    Error = RAK3172_CmdQueue_Wait(p_Device, p_Batch->Commands[Index], p_Batch->Values[Index], NULL);
+    if(Error != RAK3172_ERR_OK)
+    {
+        p_Batch->Failed |= p_Batch->Tags[Index];
+
+        if(p_Batch->Error == RAK3172_ERR_OK)
+        {
+            p_Batch->Error = Error;
+        }
+    }
+
+    p_Batch->First = (p_Batch->First + 1) % CONFIG_RAK3172_COMMAND_QUEUE_LENGTH;
+    p_Batch->Count--;
+}
+
+/** @brief          Delete the command requests, the queues and the locks of a device.
+ *                  NOTE: No request must be in use!
+ *  @param p_Device RAK3172 device object
+ */
+static void RAK3172_CmdQueue_Delete(RAK3172_t& p_Device)
+{
+    if(p_Device.Internal.CommandQueue != NULL)
+    {
+        vQueueDelete(p_Device.Internal.CommandQueue);
+        p_Device.Internal.CommandQueue = NULL;
+    }
+
+    if(p_Device.Internal.CommandFreeQueue != NULL)
+    {
+        vQueueDelete(p_Device.Internal.CommandFreeQueue);
+        p_Device.Internal.CommandFreeQueue = NULL;
+    }
+
+    if(p_Device.Internal.CommandLock != NULL)
+    {
+        vSemaphoreDelete(p_Device.Internal.CommandLock);
+        p_Device.Internal.CommandLock = NULL;
+    }
+
+    if(p_Device.Internal.CompleteLock != NULL)
+    {
+        vSemaphoreDelete(p_Device.Internal.CompleteLock);
+        p_Device.Internal.CompleteLock = NULL;
+    }
+
+    if(p_Device.Internal.CommandDone != NULL)
+    {
+        vEventGroupDelete(p_Device.Internal.CommandDone);
+        p_Device.Internal.CommandDone = NULL;
+    }
+
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        if(p_Device.Internal.WakeLock != NULL)
+        {
+            vSemaphoreDelete(p_Device.Internal.WakeLock);
+            p_Device.Internal.WakeLock = NULL;
+        }
+    #endif
+
+    free(p_Device.Internal.Commands);
+    p_Device.Internal.Commands = NULL;
+}
+
+RAK3172_Error_t RAK3172_CmdQueue_Init(RAK3172_t& p_Device)
+{
+    p_Device.Internal.Commands = (RAK3172_Command_t*)calloc(CONFIG_RAK3172_COMMAND_QUEUE_LENGTH, sizeof(RAK3172_Command_t));
+    p_Device.Internal.CommandFreeQueue = xQueueCreate(CONFIG_RAK3172_COMMAND_QUEUE_LENGTH, sizeof(uint8_t));
+    p_Device.Internal.CommandQueue = xQueueCreate(CONFIG_RAK3172_COMMAND_QUEUE_LENGTH, sizeof(uint8_t));
+    p_Device.Internal.CommandLock = xSemaphoreCreateMutex();
+    p_Device.Internal.CompleteLock = xSemaphoreCreateMutex();
+    p_Device.Internal.CommandDone = xEventGroupCreate();
+
+    if((p_Device.Internal.Commands == NULL) || (p_Device.Internal.CommandFreeQueue == NULL) || (p_Device.Internal.CommandQueue == NULL) ||
+       (p_Device.Internal.CommandLock == NULL) || (p_Device.Internal.CompleteLock == NULL) || (p_Device.Internal.CommandDone == NULL))
+    {
+        RAK3172_CmdQueue_Delete(p_Device);
+
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        p_Device.Internal.WakeLock = xSemaphoreCreateMutex();
+        if(p_Device.Internal.WakeLock == NULL)
+        {
+            RAK3172_CmdQueue_Delete(p_Device);
+
+            return RAK3172_ERR_NO_MEM;
+        }
+    #endif
+
+    for(uint8_t i = 0; i < CONFIG_RAK3172_COMMAND_QUEUE_LENGTH; i++)
+    {
+        xQueueSend(p_Device.Internal.CommandFreeQueue, &i, 0);
+    }
+
+    xEventGroupSetBits(p_Device.Internal.CommandDone, RAK3172_CMDQUEUE_IDLE);
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_CmdQueue_Deinit(RAK3172_t& p_Device)
+{
+    uint8_t Index;
+    uint8_t Returned;
+
+    if(p_Device.Internal.CommandFreeQueue == NULL)
+    {
+        return;
+    }
+
+    // The waiters which are woken up by the abort still use their requests, so all requests must be returned before the queues are deleted.
+    // A request which was taken by a submitter in the meantime is aborted with the next attempt.
+    Returned = 0;
+    while(Returned < CONFIG_RAK3172_COMMAND_QUEUE_LENGTH)
+    {
+        RAK3172_CmdQueue_Abort(p_Device, RAK3172_ERR_INVALID_STATE);
+
+        if(xQueueReceive(p_Device.Internal.CommandFreeQueue, &Index, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == pdPASS)
+        {
+            Returned++;
+        }
+        else
+        {
+            RAK3172_LOGW(TAG, "%u command requests are still in use. Wait for the release...", CONFIG_RAK3172_COMMAND_QUEUE_LENGTH - Returned);
+        }
+    }
+
+    RAK3172_CmdQueue_Delete(p_Device);
+}
+
+RAK3172_Error_t RAK3172_CmdQueue_Submit(const RAK3172_t& p_Device, const std::string& Command, RAK3172_Response_t Response, RAK3172_Command_Callback_t Callback, void* p_Arg, TickType_t Timeout, RAK3172_Command_t** p_Command)
+{
+    RAK3172_Fragment_t Fragment;
+
+    Fragment = RAK3172_Fragment_Text(Command.c_str(), Command.length());
+
+    return RAK3172_CmdQueue_Submit(p_Device, &Fragment, 1, Response, Callback, p_Arg, Timeout, p_Command);
+}
+
+RAK3172_Error_t RAK3172_CmdQueue_Submit(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count, RAK3172_Response_t Response, RAK3172_Command_Callback_t Callback, void* p_Arg, TickType_t Timeout, RAK3172_Command_t** p_Command)
+{
+    uint8_t Index;
+    TickType_t Wait;
+    RAK3172_Command_t* Request;
+
+    // A sleeping module loses the first characters of the command. The wake up uses a request and may wait for the module,
+    // so it must be done before a request is taken and without the command lock.
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        RAK3172_ERROR_CHECK(RAK3172_Sleep_Wake(p_Device));
+    #endif
+
+    // Only the receive task releases requests, so the receive task must not wait for a free request.
+    Wait = Timeout;
+    if(RAK3172_Registry_isDriverTask(p_Device))
+    {
+        Wait = 0;
+    }
+
+    if(xQueueReceive(p_Device.Internal.CommandFreeQueue, &Index, Wait) != pdPASS)
+    {
+        RAK3172_LOGE(TAG, "No free command request available!");
+
+        return RAK3172_ERR_BUSY;
+    }
+
+    Request = &p_Device.Internal.Commands[Index];
+    Request->Response = Response;
+    Request->Callback = Callback;
+    Request->Arg = p_Arg;
+    Request->Timeout = Timeout;
+    Request->Value = NULL;
+    Request->Status[0] = '\0';
+    Request->Error = RAK3172_ERR_OK;
+
+    xEventGroupClearBits(p_Device.Internal.CommandDone, BIT(Index));
+
+    // The request must be in flight before the command is written, because the response can arrive before the write returns.
+    // The lock keeps the order of the queue and the order on the wire in sync.
+    // The host must stay awake until the response is received.
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_Acquire();
+    #endif
+
+    xSemaphoreTake(p_Device.Internal.CommandLock, portMAX_DELAY);
+    Request->Start = xTaskGetTickCount();
+    xEventGroupClearBits(p_Device.Internal.CommandDone, RAK3172_CMDQUEUE_IDLE);
+    xQueueSend(p_Device.Internal.CommandQueue, &Index, 0);
+    RAK3172_Writer_Write(p_Device, p_Fragments, Count);
+    xSemaphoreGive(p_Device.Internal.CommandLock);
+
+    // Start the response timeout of the receive task.
+    RAK3172_Registry_Wake(p_Device);
+
+    if(p_Command != NULL)
+    {
+        *p_Command = Request;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_CmdQueue_Wait(const RAK3172_t& p_Device, RAK3172_Command_t* p_Command, std::string* const p_Value, std::string* const p_Status)
+{
+    uint8_t Index;
+    TickType_t Wait;
+    RAK3172_Error_t Error;
+
+    Index = static_cast<uint8_t>(p_Command - p_Device.Internal.Commands);
+
+    // The receive task completes each request at the latest after its response timeout. The caller expires the requests by itself
+    // when the receive task doesn´t (i. e. while the receive task is suspended during a firmware update).
+    Wait = (p_Command->Timeout == portMAX_DELAY) ? portMAX_DELAY : (p_Command->Timeout + 1);
+    while((xEventGroupWaitBits(p_Device.Internal.CommandDone, BIT(Index), pdTRUE, pdTRUE, Wait) & BIT(Index)) == 0)
+    {
+        RAK3172_CmdQueue_Poll(p_Device);
+    }
+
+    if(p_Value != NULL)
+    {
+        p_Value->assign(RAK3172_CmdQueue_GetValue(p_Command));
+    }
+
+    if(p_Status != NULL)
+    {
+        p_Status->assign(p_Command->Status);
+    }
+
+    Error = p_Command->Error;
+
+    RAK3172_LinePool_Release(p_Device, p_Command->Value);
+    p_Command->Value = NULL;
+
+    xQueueSend(p_Device.Internal.CommandFreeQueue, &Index, 0);
+
+    return Error;
+}
+
+bool RAK3172_CmdQueue_WaitIdle(const RAK3172_t& p_Device, TickType_t Timeout)
+{
+    return (xEventGroupWaitBits(p_Device.Internal.CommandDone, RAK3172_CMDQUEUE_IDLE, pdFALSE, pdTRUE, Timeout) & RAK3172_CMDQUEUE_IDLE) != 0;
+}
+
+bool RAK3172_CmdQueue_Feed(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line)
+{
+    uint8_t Index;
+    RAK3172_Command_t* Command;
+
+    xSemaphoreTake(p_Device.Internal.CompleteLock, portMAX_DELAY);
+
+    if(xQueuePeek(p_Device.Internal.CommandQueue, &Index, 0) != pdPASS)
+    {
+        xSemaphoreGive(p_Device.Internal.CompleteLock);
+
+        return false;
+    }
+
+    Command = &p_Device.Internal.Commands[Index];
+    Command->Start = xTaskGetTickCount();
+
+    if(RAK3172_CmdQueue_isStatus(p_Line))
+    {
+        strncpy(Command->Status, p_Line->Data, sizeof(Command->Status) - 1);
+        Command->Status[sizeof(Command->Status) - 1] = '\0';
+
+        RAK3172_LinePool_Release(p_Device, p_Line);
+        RAK3172_CmdQueue_Complete(p_Device, (strcmp(Command->Status, "OK") == 0) ? RAK3172_ERR_OK : RAK3172_ERR_FAIL);
+    }
+    // Keep the first line as value. Empty lines (firmware without RUI3) and any other lines are dropped.
+    else if((Command->Response == RAK_RESPONSE_VALUE) && (Command->Value == NULL) && (p_Line->Length > 0))
+    {
+        Command->Value = p_Line;
+    }
+    else
+    {
+        RAK3172_LinePool_Release(p_Device, p_Line);
+    }
+
+    xSemaphoreGive(p_Device.Internal.CompleteLock);
+
+    return true;
+}
+
+TickType_t RAK3172_CmdQueue_Poll(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+    TickType_t Elapsed;
+    TickType_t Remaining;
+    RAK3172_Command_t* Command;
+
+    xSemaphoreTake(p_Device.Internal.CompleteLock, portMAX_DELAY);
+
+    Remaining = portMAX_DELAY;
+    if(xQueuePeek(p_Device.Internal.CommandQueue, &Index, 0) == pdPASS)
+    {
+        Command = &p_Device.Internal.Commands[Index];
+        Elapsed = xTaskGetTickCount() - Command->Start;
+        if(Elapsed > Command->Timeout)
+        {
+            RAK3172_LOGE(TAG, "Response timeout for request %u!", Index);
+
+            // The responses can´t be assigned to the requests anymore when a response is missing.
+            RAK3172_CmdQueue_AbortLocked(p_Device, RAK3172_ERR_TIMEOUT);
+        }
+        else
+        {
+            // The timeout expires one tick after the timeout period.
+            Remaining = Command->Timeout - Elapsed + 1;
+        }
+    }
+
+    xSemaphoreGive(p_Device.Internal.CompleteLock);
+
+    return Remaining;
+}
+
+void RAK3172_CmdQueue_Abort(const RAK3172_t& p_Device, RAK3172_Error_t Error)
+{
+    xSemaphoreTake(p_Device.Internal.CompleteLock, portMAX_DELAY);
+    RAK3172_CmdQueue_AbortLocked(p_Device, Error);
+    xSemaphoreGive(p_Device.Internal.CompleteLock);
+}
+
+void RAK3172_Batch_Begin(RAK3172_Batch_t* p_Batch)
+{
+    p_Batch->First = 0;
+    p_Batch->Count = 0;
+    p_Batch->Failed = 0;
+    p_Batch->Error = RAK3172_ERR_OK;
+}
+
+void RAK3172_Batch_Add(const RAK3172_t& p_Device, RAK3172_Batch_t* p_Batch, const std::string& Command, uint32_t Tag, std::string* p_Value)
+{
+    uint8_t Index;
+    RAK3172_Error_t Error;
+
+    // All requests of the command queue can be in use by this batch. Complete the oldest command to get a free request.
+    if(p_Batch->Count == CONFIG_RAK3172_COMMAND_QUEUE_LENGTH)
+    {
+        RAK3172_Batch_CompleteOldest(p_Device, p_Batch);
+    }
+
+    Index = (p_Batch->First + p_Batch->Count) % CONFIG_RAK3172_COMMAND_QUEUE_LENGTH;
+
+    Error = RAK3172_SubmitCommand(p_Device, Command, (p_Value != NULL) ? RAK_RESPONSE_VALUE : RAK_RESPONSE_STATUS, &p_Batch->Commands[Index]);
+    if(Error != RAK3172_ERR_OK)
+    {
+        p_Batch->Failed |= Tag;
+
+        if(p_Batch->Error == RAK3172_ERR_OK)
+        {
+            p_Batch->Error = Error;
+        }
+
+        return;
+    }
+
+    p_Batch->Tags[Index] = Tag;
+    p_Batch->Values[Index] = p_Value;
+    p_Batch->Count++;
+}
+
+RAK3172_Error_t RAK3172_Batch_End(const RAK3172_t& p_Device, RAK3172_Batch_t* p_Batch)
+{
+    while(p_Batch->Count > 0)
+    {
+        RAK3172_Batch_CompleteOldest(p_Device, p_Batch);
+    }
+
+    return p_Batch->Error;
+}
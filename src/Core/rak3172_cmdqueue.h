@@ -0,0 +1,151 @@
+ /*
+ * rak3172_cmdqueue.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Pipelined AT command queue for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_CMDQUEUE_H_
+#define RAK3172_CMDQUEUE_H_
+
+#include <string.h>
+
+#include "rak3172_defs.h"
+
+/** @brief Pipelined command batch. Keeps the requests of a caller in flight and collects the results.
+ */
+typedef struct
+{
+    RAK3172_Command_t* Commands[CONFIG_RAK3172_COMMAND_QUEUE_LENGTH];  /**< Requests in flight in the order of transmission. */
+    uint32_t Tags[CONFIG_RAK3172_COMMAND_QUEUE_LENGTH];                 /**< Caller defined tags of the requests. */
+    std::string* Values[CONFIG_RAK3172_COMMAND_QUEUE_LENGTH];           /**< Value pointers of the requests. */
+    uint8_t First;                                                      /**< Index of the oldest request. */
+    uint8_t Count;                                                      /**< Number of requests in flight. */
+    uint32_t Failed;                                                    /**< Tags of all failed requests. */
+    RAK3172_Error_t Error;                                              /**< First error of the batch. */
+} RAK3172_Batch_t;
+
+/** @brief          Check if a line is the status line of an AT command.
+ *  @param p_Line   Pointer to line
+ *  @return         #true when the line contains a status code
+ */
+inline __attribute__((always_inline)) bool RAK3172_CmdQueue_isStatus(const RAK3172_Line_t* p_Line)
+{
+    return (strcmp(p_Line->Data, "OK") == 0) || (strncmp(p_Line->Data, "AT_", 3) == 0);
+}
+
+/** @brief          Allocate the command requests, the queues and the lock for a device.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the requests, the queues or the lock cannot be created
+ */
+RAK3172_Error_t RAK3172_CmdQueue_Init(RAK3172_t& p_Device);
+
+/** @brief          Abort all pending commands and release the command requests of a device. The function waits until all waiters
+ *                  have returned their requests.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_CmdQueue_Deinit(RAK3172_t& p_Device);
+
+/** @brief          Transmit an AT command without waiting for the response of the module.
+ *  @param p_Device RAK3172 device object
+ *  @param Command  AT command without CR and LF
+ *  @param Response Expected response of the module
+ *  @param Callback (Optional) Completion callback. The request is released by the driver after the callback
+ *  @param p_Arg    (Optional) Argument for the completion callback
+ *  @param Timeout  Timeout in ticks for a free request and for each response line. The receive task doesn´t wait for a free request
+ *  @param p_Command (Optional) Pointer to the request. Must be passed to #RAK3172_CmdQueue_Wait when no callback is used
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_BUSY when no free request is available
+ */
+RAK3172_Error_t RAK3172_CmdQueue_Submit(const RAK3172_t& p_Device, const std::string& Command, RAK3172_Response_t Response, RAK3172_Command_Callback_t Callback, void* p_Arg, TickType_t Timeout, RAK3172_Command_t** p_Command);
+
+/** @brief              Transmit an AT command, which is assembled from fragments, without waiting for the response of the module.
+ *                      The fragments are written straight to the UART, so no memory is allocated for the command.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Fragments  Pointer to fragments of the AT command without CR and LF. Must be valid until the function returns
+ *  @param Count        Number of fragments
+ *  @param Response     Expected response of the module
+ *  @param Callback     (Optional) Completion callback. The request is released by the driver after the callback
+ *  @param p_Arg        (Optional) Argument for the completion callback
+ *  @param Timeout      Timeout in ticks for a free request and for each response line. The receive task doesn´t wait for a free request
+ *  @param p_Command    (Optional) Pointer to the request. Must be passed to #RAK3172_CmdQueue_Wait when no callback is used
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_BUSY when no free request is available
+ */
+RAK3172_Error_t RAK3172_CmdQueue_Submit(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count, RAK3172_Response_t Response, RAK3172_Command_Callback_t Callback, void* p_Arg, TickType_t Timeout, RAK3172_Command_t** p_Command);
+
+/** @brief          Wait for the completion of a request without callback and release the request. The wait is bounded by the response
+ *                  timeout of the request. The caller expires the request when the receive task doesn´t.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Command Pointer to request
+ *  @param p_Value  (Optional) Pointer to returned value
+ *  @param p_Status (Optional) Pointer to status string
+ *  @return         RAK3172_ERR_OK when the module responds with "OK"
+ *                  RAK3172_ERR_FAIL when the module responds with another status
+ *                  RAK3172_ERR_TIMEOUT when the module doesn´t respond
+ */
+RAK3172_Error_t RAK3172_CmdQueue_Wait(const RAK3172_t& p_Device, RAK3172_Command_t* p_Command, std::string* const p_Value, std::string* const p_Status);
+
+/** @brief          Wait until all commands in flight are completed.
+ *  @param p_Device RAK3172 device object
+ *  @param Timeout  Timeout in ticks
+ *  @return         #true when no command is in flight
+ */
+bool RAK3172_CmdQueue_WaitIdle(const RAK3172_t& p_Device, TickType_t Timeout);
+
+/** @brief          Pass a line from the receive task to the oldest command in flight.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Line   Pointer to line slot
+ *  @return         #true when the line was consumed. The line belongs to the caller otherwise
+ */
+bool RAK3172_CmdQueue_Feed(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line);
+
+/** @brief          Check the response timeout of the oldest command in flight. Must be called by the receive task after each event and
+ *                  when the returned time has elapsed. Can be called from any task.
+ *  @param p_Device RAK3172 device object
+ *  @return         Time in ticks until the response timeout of the oldest command in flight expires
+ *                  or portMAX_DELAY when no command is in flight
+ */
+TickType_t RAK3172_CmdQueue_Poll(const RAK3172_t& p_Device);
+
+/** @brief          Complete all commands in flight with an error.
+ *  @param p_Device RAK3172 device object
+ *  @param Error    Error code for the commands
+ */
+void RAK3172_CmdQueue_Abort(const RAK3172_t& p_Device, RAK3172_Error_t Error);
+
+/** @brief          Start a new command batch.
+ *  @param p_Batch  Pointer to batch
+ */
+void RAK3172_Batch_Begin(RAK3172_Batch_t* p_Batch);
+
+/** @brief          Transmit a command as part of a batch. The oldest command of the batch is completed first when the command queue is full.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Batch  Pointer to batch
+ *  @param Command  AT command without CR and LF
+ *  @param Tag      Tag for the command. The tag is added to the failed tags of the batch when the command fails
+ *  @param p_Value  (Optional) Pointer to returned value. Must be valid until #RAK3172_Batch_End returns
+ */
+void RAK3172_Batch_Add(const RAK3172_t& p_Device, RAK3172_Batch_t* p_Batch, const std::string& Command, uint32_t Tag, std::string* p_Value = NULL);
+
+/** @brief          Wait for all commands of a batch.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Batch  Pointer to batch
+ *  @return         RAK3172_ERR_OK when all commands were successful or the error of the first failed command
+ */
+RAK3172_Error_t RAK3172_Batch_End(const RAK3172_t& p_Device, RAK3172_Batch_t* p_Batch);
+
+#endif /* RAK3172_CMDQUEUE_H_ */
@@ -0,0 +1,185 @@
+ /*
+ * rak3172_events.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Event classifier for the RAK3172 receive path.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <string.h>
+
+#include <sdkconfig.h>
+
+#include "rak3172_events.h"
+
+/** @brief Event keyword definition. The keywords follow the "+EVT:" prefix.
+ */
+typedef struct
+{
+    const char* Keyword;                /**< Event keyword. */
+    RAK3172_Event_t Event;              /**< Event for this keyword. */
+} RAK3172_EventKeyword_t;
+
+/** @brief Trie node. Children are stored as a first child / next sibling list. Index 0 is the root node.
+ */
+typedef struct
+{
+    char Character;                     /**< Character of this node. */
+    uint8_t Child;                      /**< Index of the first child or 0. */
+    uint8_t Sibling;                    /**< Index of the next sibling or 0. */
+    uint8_t Event;                      /**< Event when the keyword ends at this node. */
+} RAK3172_EventNode_t;
+
+static constexpr RAK3172_EventKeyword_t _RAK3172_Event_Keywords[] = {
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        {"JOINED",                      RAK3172_EVT_JOINED},
+        {"JOIN_FAILED_RX_TIMEOUT",      RAK3172_EVT_JOIN_FAILED},
+        {"SEND_CONFIRMED_OK",           RAK3172_EVT_CONFIRMED_OK},
+        {"SEND_CONFIRMED_FAILED",       RAK3172_EVT_CONFIRMED_FAILED},
+    #else
+        {"JOINED",                      RAK3172_EVT_JOINED},
+        {"JOIN FAILED",                 RAK3172_EVT_JOIN_FAILED},
+        {"SEND CONFIRMED OK",           RAK3172_EVT_CONFIRMED_OK},
+        {"SEND CONFIRMED FAILED",       RAK3172_EVT_CONFIRMED_FAILED},
+    #endif
+    {"RX_1",                            RAK3172_EVT_RX_1},
+    {"RX_2",                            RAK3172_EVT_RX_2},
+    {"RX_B",                            RAK3172_EVT_RX_B},
+    {"RX_C",                            RAK3172_EVT_RX_C},
+    {"RXP2P",                           RAK3172_EVT_RXP2P},
+    {"RXP2P RECEIVE TIMEOUT",           RAK3172_EVT_RXP2P_TIMEOUT},
+};
+
+/** @brief  Get the maximum number of trie nodes needed for the keyword list.
+ *  @return Number of nodes
+ */
+static constexpr size_t RAK3172_Events_MaxNodes(void)
+{
+    size_t Nodes = 1;
+
+    for(const RAK3172_EventKeyword_t& Keyword : _RAK3172_Event_Keywords)
+    {
+        for(const char* c = Keyword.Keyword; *c != '\0'; c++)
+        {
+            Nodes++;
+        }
+    }
+
+    return Nodes;
+}
+
+static_assert(RAK3172_Events_MaxNodes() <= UINT8_MAX, "Too many event keywords for the event trie!");
+
+/** @brief Event trie object.
+ */
+typedef struct
+{
+    RAK3172_EventNode_t Nodes[RAK3172_Events_MaxNodes()];
+    uint8_t Used;
+} RAK3172_EventTrie_t;
+
+/** @brief  Build the event trie from the keyword list.
+ *  @return Event trie
+ */
+static constexpr RAK3172_EventTrie_t RAK3172_Events_Build(void)
+{
+    RAK3172_EventTrie_t Trie = {};
+
+    Trie.Used = 1;
+
+    for(const RAK3172_EventKeyword_t& Keyword : _RAK3172_Event_Keywords)
+    {
+        uint8_t Node = 0;
+
+        for(const char* c = Keyword.Keyword; *c != '\0'; c++)
+        {
+            uint8_t Previous = 0;
+            uint8_t Child = Trie.Nodes[Node].Child;
+
+            while((Child != 0) && (Trie.Nodes[Child].Character != *c))
+            {
+                Previous = Child;
+                Child = Trie.Nodes[Child].Sibling;
+            }
+
+            // Character not found. Append a new node to the child list.
+            if(Child == 0)
+            {
+                Child = Trie.Used++;
+                Trie.Nodes[Child].Character = *c;
+
+                if(Previous == 0)
+                {
+                    Trie.Nodes[Node].Child = Child;
+                }
+                else
+                {
+                    Trie.Nodes[Previous].Sibling = Child;
+                }
+            }
+
+            Node = Child;
+        }
+
+        Trie.Nodes[Node].Event = Keyword.Event;
+    }
+
+    return Trie;
+}
+
+static constexpr RAK3172_EventTrie_t _RAK3172_Event_Trie = RAK3172_Events_Build();
+
+RAK3172_Event_t RAK3172_Events_Classify(const char* p_Line, const char** p_Args)
+{
+    uint8_t Node;
+    const char* Start;
+    RAK3172_Event_t Event;
+
+    Start = strstr(p_Line, "+EVT:");
+    if(Start == NULL)
+    {
+        return RAK3172_EVT_NONE;
+    }
+
+    Start += sizeof("+EVT:") - 1;
+    Node = 0;
+    Event = RAK3172_EVT_UNKNOWN;
+    *p_Args = Start;
+
+    // Walk the trie and keep the longest matching keyword.
+    for(const char* c = Start; *c != '\0'; c++)
+    {
+        uint8_t Child;
+
+        Child = _RAK3172_Event_Trie.Nodes[Node].Child;
+        while((Child != 0) && (_RAK3172_Event_Trie.Nodes[Child].Character != *c))
+        {
+            Child = _RAK3172_Event_Trie.Nodes[Child].Sibling;
+        }
+
+        if(Child == 0)
+        {
+            break;
+        }
+
+        Node = Child;
+        if(_RAK3172_Event_Trie.Nodes[Node].Event != RAK3172_EVT_NONE)
+        {
+            Event = static_cast<RAK3172_Event_t>(_RAK3172_Event_Trie.Nodes[Node].Event);
+            *p_Args = c + 1;
+        }
+    }
+
+    return Event;
+}
@@ -0,0 +1,50 @@
+ /*
+ * rak3172_events.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Event classifier for the RAK3172 receive path.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_EVENTS_H_
+#define RAK3172_EVENTS_H_
+
+#include <stdint.h>
+
+/** @brief Module events recognized by the receive task.
+ */
+typedef enum
+{
+    RAK3172_EVT_NONE        = 0,        /**< The line doesn´t contain an event. */
+    RAK3172_EVT_UNKNOWN,                /**< The line contains an unsupported event. */
+    RAK3172_EVT_JOINED,                 /**< LoRaWAN join successful. */
+    RAK3172_EVT_JOIN_FAILED,            /**< LoRaWAN join failed. */
+    RAK3172_EVT_CONFIRMED_OK,           /**< LoRaWAN confirmed transmission successful. */
+    RAK3172_EVT_CONFIRMED_FAILED,       /**< LoRaWAN confirmed transmission failed. */
+    RAK3172_EVT_RX_1,                   /**< LoRaWAN downlink in receive window 1. */
+    RAK3172_EVT_RX_2,                   /**< LoRaWAN downlink in receive window 2. */
+    RAK3172_EVT_RX_B,                   /**< LoRaWAN class B downlink. */
+    RAK3172_EVT_RX_C,                   /**< LoRaWAN class C downlink. */
+    RAK3172_EVT_RXP2P,                  /**< LoRa P2P message received. */
+    RAK3172_EVT_RXP2P_TIMEOUT,          /**< LoRa P2P receive timeout. */
+} RAK3172_Event_t;
+
+/** @brief          Classify a received line in a single pass.
+ *  @param p_Line   Zero terminated line
+ *  @param p_Args   Pointer to the first character after the event keyword
+ *  @return         Recognized event
+ */
+RAK3172_Event_t RAK3172_Events_Classify(const char* p_Line, const char** p_Args);
+
+#endif /* RAK3172_EVENTS_H_ */
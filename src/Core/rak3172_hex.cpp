@@ -0,0 +1,190 @@
+ /*
+ * rak3172_hex.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Table driven hex codec for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <string.h>
+
+#include "rak3172_hex.h"
+
+/** @brief Marker for invalid characters in the decoding table.
+ */
+#define RAK3172_HEX_INVALID                                     0xFF
+
+/** @brief Encoding table. Each entry contains the two characters of a byte in memory order.
+ */
+typedef struct
+{
+    uint16_t Pairs[256];                /**< Character pairs for each byte value. */
+} RAK3172_Hex_EncodeTable_t;
+
+/** @brief Decoding table. Each entry contains the nibble value of a character or #RAK3172_HEX_INVALID.
+ */
+typedef struct
+{
+    uint8_t Nibbles[256];               /**< Nibble value for each character. */
+} RAK3172_Hex_DecodeTable_t;
+
+/** @brief  Build the encoding table.
+ *  @return Encoding table
+ */
+static constexpr RAK3172_Hex_EncodeTable_t RAK3172_Hex_BuildEncodeTable(void)
+{
+    constexpr char Digits[] = "0123456789ABCDEF";
+    RAK3172_Hex_EncodeTable_t Table = {};
+
+    for(uint16_t i = 0; i < 256; i++)
+    {
+        uint16_t High = static_cast<uint8_t>(Digits[i >> 4]);
+        uint16_t Low = static_cast<uint8_t>(Digits[i & 0x0F]);
+
+        #if(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            Table.Pairs[i] = (Low << 8) | High;
+        #else
+            Table.Pairs[i] = (High << 8) | Low;
+        #endif
+    }
+
+    return Table;
+}
+
+/** @brief  Build the decoding table.
+ *  @return Decoding table
+ */
+static constexpr RAK3172_Hex_DecodeTable_t RAK3172_Hex_BuildDecodeTable(void)
+{
+    RAK3172_Hex_DecodeTable_t Table = {};
+
+    for(uint16_t i = 0; i < 256; i++)
+    {
+        if((i >= '0') && (i <= '9'))
+        {
+            Table.Nibbles[i] = i - '0';
+        }
+        else if((i >= 'A') && (i <= 'F'))
+        {
+            Table.Nibbles[i] = i - 'A' + 10;
+        }
+        else if((i >= 'a') && (i <= 'f'))
+        {
+            Table.Nibbles[i] = i - 'a' + 10;
+        }
+        else
+        {
+            Table.Nibbles[i] = RAK3172_HEX_INVALID;
+        }
+    }
+
+    return Table;
+}
+
+static constexpr RAK3172_Hex_EncodeTable_t _RAK3172_Hex_Encode = RAK3172_Hex_BuildEncodeTable();
+static constexpr RAK3172_Hex_DecodeTable_t _RAK3172_Hex_Decode = RAK3172_Hex_BuildDecodeTable();
+
+void RAK3172_Hex_Encode(const void* p_Input, size_t Length, char* p_Output)
+{
+    const uint8_t* Input = static_cast<const uint8_t*>(p_Input);
+
+    // Encode four bytes with one 64 bit store.
+    for(; Length >= 4; Length -= 4)
+    {
+        uint64_t Word;
+
+        #if(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+            Word = (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[0]]) << 0) |
+                   (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[1]]) << 16) |
+                   (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[2]]) << 32) |
+                   (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[3]]) << 48);
+        #else
+            Word = (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[0]]) << 48) |
+                   (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[1]]) << 32) |
+                   (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[2]]) << 16) |
+                   (static_cast<uint64_t>(_RAK3172_Hex_Encode.Pairs[Input[3]]) << 0);
+        #endif
+
+        memcpy(p_Output, &Word, sizeof(Word));
+
+        Input += 4;
+        p_Output += 8;
+    }
+
+    // Encode the remaining bytes.
+    for(; Length > 0; Length--)
+    {
+        memcpy(p_Output, &_RAK3172_Hex_Encode.Pairs[*Input], sizeof(uint16_t));
+
+        Input++;
+        p_Output += 2;
+    }
+}
+
+void RAK3172_Hex_Append(std::string* p_Output, const void* p_Input, size_t Length)
+{
+    size_t Offset;
+
+    if((p_Output == NULL) || (p_Input == NULL) || (Length == 0))
+    {
+        return;
+    }
+
+    Offset = p_Output->length();
+    p_Output->resize(Offset + (2 * Length));
+    RAK3172_Hex_Encode(p_Input, Length, &(*p_Output)[Offset]);
+}
+
+RAK3172_Error_t RAK3172_Hex_Decode(std::string_view Input, uint8_t* p_Output, size_t Size, size_t* p_Length)
+{
+    uint8_t Invalid = 0;
+    size_t Length;
+    const uint8_t* Characters;
+
+    if((p_Length == NULL) || ((p_Output == NULL) && (Input.length() > 0)))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(Input.length() % 2)
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    Length = Input.length() / 2;
+    if(Length > Size)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    // Decode without branches and check all characters at once. Invalid characters set the upper nibble.
+    Characters = reinterpret_cast<const uint8_t*>(Input.data());
+    for(size_t i = 0; i < Length; i++)
+    {
+        uint8_t High = _RAK3172_Hex_Decode.Nibbles[Characters[0]];
+        uint8_t Low = _RAK3172_Hex_Decode.Nibbles[Characters[1]];
+
+        Invalid |= High | Low;
+        p_Output[i] = (High << 4) | (Low & 0x0F);
+        Characters += 2;
+    }
+
+    if(Invalid & 0xF0)
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    *p_Length = Length;
+
+    return RAK3172_ERR_OK;
+}
@@ -0,0 +1,56 @@
+ /*
+ * rak3172_hex.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Table driven hex codec for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_HEX_H_
+#define RAK3172_HEX_H_
+
+#include <string>
+#include <string_view>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "rak3172_errors.h"
+
+/** @brief          Encode binary data into upper case hex characters. The output isn´t terminated.
+ *  @param p_Input  Pointer to input data
+ *  @param Length   Input length in bytes
+ *  @param p_Output Pointer to output buffer with space for 2 * Length characters
+ */
+void RAK3172_Hex_Encode(const void* p_Input, size_t Length, char* p_Output);
+
+/** @brief          Encode binary data and append the hex characters to a string.
+ *  @param p_Output Pointer to output string
+ *  @param p_Input  Pointer to input data
+ *  @param Length   Input length in bytes
+ */
+void RAK3172_Hex_Append(std::string* p_Output, const void* p_Input, size_t Length);
+
+/** @brief          Decode hex characters into binary data.
+ *  @param Input    Input string
+ *  @param p_Output Pointer to output buffer
+ *  @param Size     Size of the output buffer in bytes
+ *  @param p_Length Pointer to decoded length in bytes
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_ARG when the output buffer is too small
+ *                  RAK3172_ERR_INVALID_RESPONSE when the input contains an odd number of characters or no hex characters
+ */
+RAK3172_Error_t RAK3172_Hex_Decode(std::string_view Input, uint8_t* p_Output, size_t Size, size_t* p_Length);
+
+#endif /* RAK3172_HEX_H_ */
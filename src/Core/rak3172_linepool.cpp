@@ -0,0 +1,128 @@
+ /*
+ * rak3172_linepool.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Preallocated line pool for the RAK3172 receive path.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <stdlib.h>
+
+#include "rak3172_linepool.h"
+
+RAK3172_Error_t RAK3172_LinePool_Init(RAK3172_t& p_Device)
+{
+    p_Device.Internal.Lines = (RAK3172_Line_t*)malloc(sizeof(RAK3172_Line_t) * RAK3172_LINEPOOL_SIZE);
+    if(p_Device.Internal.Lines == NULL)
+    {
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    p_Device.Internal.FreeQueue = xQueueCreate(RAK3172_LINEPOOL_SIZE, sizeof(uint8_t));
+    if(p_Device.Internal.FreeQueue == NULL)
+    {
+        free(p_Device.Internal.Lines);
+        p_Device.Internal.Lines = NULL;
+
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    for(uint8_t i = 0; i < RAK3172_LINEPOOL_SIZE; i++)
+    {
+        xQueueSend(p_Device.Internal.FreeQueue, &i, 0);
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_LinePool_Deinit(RAK3172_t& p_Device)
+{
+    if(p_Device.Internal.FreeQueue != NULL)
+    {
+        vQueueDelete(p_Device.Internal.FreeQueue);
+        p_Device.Internal.FreeQueue = NULL;
+    }
+
+    free(p_Device.Internal.Lines);
+    p_Device.Internal.Lines = NULL;
+}
+
+RAK3172_Line_t* RAK3172_LinePool_Acquire(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+
+    // Recycle the oldest unread line when the pool is exhausted, because a new line from the module is more important.
+    if((xQueueReceive(p_Device.Internal.FreeQueue, &Index, 0) != pdPASS) &&
+       (xQueueReceive(p_Device.Internal.MessageQueue, &Index, 0) != pdPASS))
+    {
+        return NULL;
+    }
+
+    p_Device.Internal.Lines[Index].Length = 0;
+    p_Device.Internal.Lines[Index].Data[0] = '\0';
+
+    return &p_Device.Internal.Lines[Index];
+}
+
+bool RAK3172_LinePool_Send(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line)
+{
+    uint8_t Index;
+
+    Index = static_cast<uint8_t>(p_Line - p_Device.Internal.Lines);
+    if(xQueueSend(p_Device.Internal.MessageQueue, &Index, 0) != pdPASS)
+    {
+        xQueueSend(p_Device.Internal.FreeQueue, &Index, 0);
+
+        return false;
+    }
+
+    return true;
+}
+
+bool RAK3172_LinePool_Receive(const RAK3172_t& p_Device, RAK3172_Line_t** p_Line, TickType_t Timeout)
+{
+    uint8_t Index;
+
+    if(xQueueReceive(p_Device.Internal.MessageQueue, &Index, Timeout) != pdPASS)
+    {
+        return false;
+    }
+
+    *p_Line = &p_Device.Internal.Lines[Index];
+
+    return true;
+}
+
+void RAK3172_LinePool_Release(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line)
+{
+    uint8_t Index;
+
+    if(p_Line == NULL)
+    {
+        return;
+    }
+
+    Index = static_cast<uint8_t>(p_Line - p_Device.Internal.Lines);
+    xQueueSend(p_Device.Internal.FreeQueue, &Index, 0);
+}
+
+void RAK3172_LinePool_Flush(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+
+    while(xQueueReceive(p_Device.Internal.MessageQueue, &Index, 0) == pdPASS)
+    {
+        xQueueSend(p_Device.Internal.FreeQueue, &Index, 0);
+    }
+}
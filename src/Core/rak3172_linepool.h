@@ -0,0 +1,78 @@
+ /*
+ * rak3172_linepool.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Preallocated line pool for the RAK3172 receive path.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_LINEPOOL_H_
+#define RAK3172_LINEPOOL_H_
+
+#include "rak3172_defs.h"
+
+/** @brief Number of line slots in the pool. Two slots more than the message queue can hold,
+ *         so that the receive task always finds a free slot while a consumer is still working on a line.
+ *         Each AT command request can hold one additional line for its value.
+ */
+#define RAK3172_LINEPOOL_SIZE                                   (CONFIG_RAK3172_UART_QUEUE_LENGTH + CONFIG_RAK3172_COMMAND_QUEUE_LENGTH + 2)
+
+// The slots are addressed with 8 bit indices in the queues.
+static_assert(RAK3172_LINEPOOL_SIZE <= 0xFF, "Too many line slots! Reduce the UART queue length or the command queue length.");
+
+/** @brief          Allocate the line pool and the free list for a device.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the pool or the free list cannot be created
+ */
+RAK3172_Error_t RAK3172_LinePool_Init(RAK3172_t& p_Device);
+
+/** @brief          Release the line pool and the free list of a device.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_LinePool_Deinit(RAK3172_t& p_Device);
+
+/** @brief          Get a free line slot for the receive task. The oldest unread line is recycled when no slot is free.
+ *  @param p_Device RAK3172 device object
+ *  @return         Pointer to the line slot or NULL when all slots are in use by consumers
+ */
+RAK3172_Line_t* RAK3172_LinePool_Acquire(const RAK3172_t& p_Device);
+
+/** @brief          Pass a line slot to the message queue.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Line   Pointer to line slot
+ *  @return         #true when successful. The slot is returned to the pool otherwise
+ */
+bool RAK3172_LinePool_Send(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line);
+
+/** @brief          Receive a line from the message queue.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Line   Pointer to line slot pointer
+ *  @param Timeout  Timeout in ticks
+ *  @return         #true when a line was received
+ */
+bool RAK3172_LinePool_Receive(const RAK3172_t& p_Device, RAK3172_Line_t** p_Line, TickType_t Timeout);
+
+/** @brief          Return a line slot to the pool.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Line   Pointer to line slot
+ */
+void RAK3172_LinePool_Release(const RAK3172_t& p_Device, RAK3172_Line_t* p_Line);
+
+/** @brief          Drop all unread lines and return their slots to the pool.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_LinePool_Flush(const RAK3172_t& p_Device);
+
+#endif /* RAK3172_LINEPOOL_H_ */
@@ -0,0 +1,176 @@
+ /*
+ * rak3172_parser.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Allocation free response parser for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include "rak3172_parser.h"
+
+/** @brief          Convert a string into the magnitude of a number.
+ *  @param Input    Input string without sign
+ *  @param p_Value  Pointer to value
+ *  @param Max      Maximum allowed magnitude
+ *  @param Base     Number base (10 or 16)
+ *  @return         RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t RAK3172_Parser_Magnitude(std::string_view Input, uint32_t* p_Value, uint32_t Max, uint8_t Base)
+{
+    uint32_t Value = 0;
+
+    if(Input.empty() || ((Base != 10) && (Base != 16)))
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    for(char Character : Input)
+    {
+        uint8_t Digit;
+
+        if((Character >= '0') && (Character <= '9'))
+        {
+            Digit = Character - '0';
+        }
+        else if((Base == 16) && (Character >= 'A') && (Character <= 'F'))
+        {
+            Digit = Character - 'A' + 10;
+        }
+        else if((Base == 16) && (Character >= 'a') && (Character <= 'f'))
+        {
+            Digit = Character - 'a' + 10;
+        }
+        else
+        {
+            return RAK3172_ERR_INVALID_RESPONSE;
+        }
+
+        // Check for an overflow before the value is updated.
+        if((Digit > Max) || (Value > ((Max - Digit) / Base)))
+        {
+            return RAK3172_ERR_INVALID_RESPONSE;
+        }
+
+        Value = (Value * Base) + Digit;
+    }
+
+    *p_Value = Value;
+
+    return RAK3172_ERR_OK;
+}
+
+std::string_view RAK3172_Parser_Trim(std::string_view Input)
+{
+    while((Input.empty() == false) && (Input.front() == ' '))
+    {
+        Input.remove_prefix(1);
+    }
+
+    while((Input.empty() == false) && (Input.back() == ' '))
+    {
+        Input.remove_suffix(1);
+    }
+
+    return Input;
+}
+
+bool RAK3172_Parser_Next(std::string_view* p_Input, std::string_view Delimiters, std::string_view* p_Token)
+{
+    size_t Index;
+
+    if((p_Input == NULL) || (p_Token == NULL) || p_Input->empty())
+    {
+        return false;
+    }
+
+    Index = p_Input->find_first_of(Delimiters);
+    if(Index == std::string_view::npos)
+    {
+        *p_Token = *p_Input;
+        p_Input->remove_prefix(p_Input->length());
+    }
+    else
+    {
+        *p_Token = p_Input->substr(0, Index);
+        p_Input->remove_prefix(Index + 1);
+    }
+
+    return true;
+}
+
+bool RAK3172_Parser_SkipPrefix(std::string_view* p_Input, std::string_view Prefix)
+{
+    if((p_Input == NULL) || (p_Input->compare(0, Prefix.length(), Prefix) != 0))
+    {
+        return false;
+    }
+
+    p_Input->remove_prefix(Prefix.length());
+
+    return true;
+}
+
+RAK3172_Error_t RAK3172_Parser_ToInt(std::string_view Input, int32_t* p_Value, int32_t Min, int32_t Max, uint8_t Base)
+{
+    bool isNegative = false;
+    uint32_t Magnitude;
+
+    if((p_Value == NULL) || (Min > Max))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    Input = RAK3172_Parser_Trim(Input);
+
+    if(RAK3172_Parser_SkipPrefix(&Input, "-"))
+    {
+        isNegative = true;
+    }
+    else
+    {
+        RAK3172_Parser_SkipPrefix(&Input, "+");
+    }
+
+    // The magnitude of INT32_MIN is one larger than INT32_MAX.
+    RAK3172_ERROR_CHECK(RAK3172_Parser_Magnitude(Input, &Magnitude, static_cast<uint32_t>(INT32_MAX) + (isNegative ? 1 : 0), Base));
+
+    if(isNegative)
+    {
+        *p_Value = static_cast<int32_t>(0 - Magnitude);
+    }
+    else
+    {
+        *p_Value = static_cast<int32_t>(Magnitude);
+    }
+
+    if((*p_Value < Min) || (*p_Value > Max))
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_Parser_ToUInt(std::string_view Input, uint32_t* p_Value, uint32_t Max, uint8_t Base)
+{
+    if(p_Value == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    Input = RAK3172_Parser_Trim(Input);
+    RAK3172_Parser_SkipPrefix(&Input, "+");
+
+    return RAK3172_Parser_Magnitude(Input, p_Value, Max, Base);
+}
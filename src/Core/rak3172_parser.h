@@ -0,0 +1,161 @@
+ /*
+ * rak3172_parser.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Allocation free response parser for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_PARSER_H_
+#define RAK3172_PARSER_H_
+
+#include <string_view>
+#include <type_traits>
+#include <limits>
+
+#include <stdint.h>
+
+#include "rak3172_errors.h"
+
+/** @brief          Remove leading and trailing spaces from a string.
+ *  @param Input    Input string
+ *  @return         Trimmed string
+ */
+std::string_view RAK3172_Parser_Trim(std::string_view Input);
+
+/** @brief              Split the next token from the input. The input is advanced behind the delimiter.
+ *  @param p_Input      Pointer to input string
+ *  @param Delimiters   List of delimiter characters
+ *  @param p_Token      Pointer to token
+ *  @return             #true when a token is available
+ */
+bool RAK3172_Parser_Next(std::string_view* p_Input, std::string_view Delimiters, std::string_view* p_Token);
+
+/** @brief          Remove a prefix from the input when present.
+ *  @param p_Input  Pointer to input string
+ *  @param Prefix   Prefix
+ *  @return         #true when the prefix was removed
+ */
+bool RAK3172_Parser_SkipPrefix(std::string_view* p_Input, std::string_view Prefix);
+
+/** @brief          Convert a string into a signed integer. Leading and trailing spaces are ignored.
+ *  @param Input    Input string
+ *  @param p_Value  Pointer to value
+ *  @param Min      Minimum allowed value
+ *  @param Max      Maximum allowed value
+ *  @param Base     (Optional) Number base (10 or 16)
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_RESPONSE when the string is no valid number or out of range
+ */
+RAK3172_Error_t RAK3172_Parser_ToInt(std::string_view Input, int32_t* p_Value, int32_t Min, int32_t Max, uint8_t Base = 10);
+
+/** @brief          Convert a string into an unsigned integer. Leading and trailing spaces are ignored.
+ *  @param Input    Input string
+ *  @param p_Value  Pointer to value
+ *  @param Max      Maximum allowed value
+ *  @param Base     (Optional) Number base (10 or 16)
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_RESPONSE when the string is no valid number or out of range
+ */
+RAK3172_Error_t RAK3172_Parser_ToUInt(std::string_view Input, uint32_t* p_Value, uint32_t Max, uint8_t Base = 10);
+
+/** @brief          Convert a string into a number of the type of the output value. The range of the type is checked.
+ *                  Enums need a range or a validator and must use the overloads below.
+ *  @param Input    Input string
+ *  @param p_Value  Pointer to value
+ *  @param Base     (Optional) Number base (10 or 16)
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_RESPONSE when the string is no valid number or out of range
+ */
+template<typename T>
+inline RAK3172_Error_t RAK3172_Parser_ToNumber(std::string_view Input, T* p_Value, uint8_t Base = 10)
+{
+    static_assert(std::is_integral<T>::value && (sizeof(T) <= sizeof(uint32_t)), "Unsupported type for the parser! Use a range or a validator for enums.");
+
+    if constexpr(std::is_signed<T>::value)
+    {
+        int32_t Value;
+
+        RAK3172_ERROR_CHECK(RAK3172_Parser_ToInt(Input, &Value, std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), Base));
+        *p_Value = static_cast<T>(Value);
+    }
+    else
+    {
+        uint32_t Value;
+
+        RAK3172_ERROR_CHECK(RAK3172_Parser_ToUInt(Input, &Value, std::numeric_limits<T>::max(), Base));
+        *p_Value = static_cast<T>(Value);
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+/** @brief          Convert a string into an enum with continuous values.
+ *  @param Input    Input string
+ *  @param p_Value  Pointer to value
+ *  @param Min      Smallest valid enum value
+ *  @param Max      Largest valid enum value
+ *  @param Base     (Optional) Number base (10 or 16)
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_RESPONSE when the string is no valid number or out of range
+ */
+template<typename T>
+inline RAK3172_Error_t RAK3172_Parser_ToNumber(std::string_view Input, T* p_Value, T Min, T Max, uint8_t Base = 10)
+{
+    typedef typename std::underlying_type<T>::type Value_t;
+
+    Value_t Value;
+
+    static_assert(std::is_enum<T>::value, "The range is only used for enums!");
+
+    RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Input, &Value, Base));
+    if((Value < static_cast<Value_t>(Min)) || (Value > static_cast<Value_t>(Max)))
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    *p_Value = static_cast<T>(Value);
+
+    return RAK3172_ERR_OK;
+}
+
+/** @brief              Convert a string into an enum, which is checked with a validator.
+ *  @param Input        Input string
+ *  @param p_Value      Pointer to value
+ *  @param p_Validator  Function, which returns #true for a valid enum value
+ *  @param Base         (Optional) Number base (10 or 16)
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_RESPONSE when the string is no valid number or the validator rejects it
+ */
+template<typename T>
+inline RAK3172_Error_t RAK3172_Parser_ToNumber(std::string_view Input, T* p_Value, bool (*p_Validator)(T), uint8_t Base = 10)
+{
+    typedef typename std::underlying_type<T>::type Value_t;
+
+    Value_t Value;
+
+    static_assert(std::is_enum<T>::value, "The validator is only used for enums!");
+
+    RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Input, &Value, Base));
+    if(p_Validator(static_cast<T>(Value)) == false)
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
+
+    *p_Value = static_cast<T>(Value);
+
+    return RAK3172_ERR_OK;
+}
+
+#endif /* RAK3172_PARSER_H_ */
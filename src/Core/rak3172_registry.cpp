@@ -0,0 +1,352 @@
+ /*
+ * rak3172_registry.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Device registry and shared receive task for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_TASK_SHARED
+
+#include <algorithm>
+
+#include "rak3172_registry.h"
+#include "../Arch/Logging/rak3172_logging.h"
+
+/** @brief Completion flag of the registry, which is set while the shared receive task doesn´t process a device.
+ */
+#define RAK3172_REGISTRY_DONE                                   BIT(0)
+
+/** @brief Registry entry of a device.
+ */
+typedef struct
+{
+    RAK3172_t* Device;                                  /**< Pointer to the device object or #NULL when the entry is unused. */
+    RAK3172_Registry_Handler_t Handler;                 /**< Event handler for the device. */
+    RAK3172_Registry_Poll_t Poll;                       /**< Periodic handler for the device. */
+    bool isPaused;                                      /**< #true when the processing of the device is paused. */
+} RAK3172_Registry_Entry_t;
+
+static RAK3172_Registry_Entry_t _RAK3172_Registry_Entries[CONFIG_RAK3172_TASK_MAX_DEVICES];
+static uint8_t _RAK3172_Registry_Count                  = 0;
+static QueueSetHandle_t _RAK3172_Registry_Set           = NULL;
+static TaskHandle_t _RAK3172_Registry_Task              = NULL;
+static RAK3172_t* _RAK3172_Registry_Current             = NULL;
+static bool _RAK3172_Registry_isExit                    = false;
+
+static const char* TAG = "RAK3172_Registry";
+
+/** @brief  Get the lock of the registry. The lock is created with the first call.
+ *  @return Registry lock
+ */
+static SemaphoreHandle_t RAK3172_Registry_GetLock(void)
+{
+    static StaticSemaphore_t Buffer;
+    static SemaphoreHandle_t Lock = xSemaphoreCreateMutexStatic(&Buffer);
+
+    return Lock;
+}
+
+/** @brief  Get the completion flag of the registry. The flag is cleared while the shared receive task processes a device and
+ *          set when the processing is finished, so any number of tasks can wait for a device. The flag is created with the first call.
+ *  @return Completion flag
+ */
+static EventGroupHandle_t RAK3172_Registry_GetDone(void)
+{
+    static StaticEventGroup_t Buffer;
+    static EventGroupHandle_t Done = xEventGroupCreateStatic(&Buffer);
+
+    return Done;
+}
+
+/** @brief          Find the registry entry of a device. The registry lock must be taken.
+ *  @param p_Device Pointer to RAK3172 device object
+ *  @return         Pointer to registry entry or #NULL when the device isn´t registered
+ */
+static RAK3172_Registry_Entry_t* RAK3172_Registry_Find(const RAK3172_t* p_Device)
+{
+    for(uint8_t i = 0; i < CONFIG_RAK3172_TASK_MAX_DEVICES; i++)
+    {
+        if(_RAK3172_Registry_Entries[i].Device == p_Device)
+        {
+            return &_RAK3172_Registry_Entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief          Release the registry lock and wait until the shared receive task has finished the processing of a device.
+ *                  Returns immediately when called by the shared receive task, because the task processes the device in the caller.
+ *                  NOTE: The registry lock must be taken!
+ *  @param p_Device Pointer to RAK3172 device object
+ */
+static void RAK3172_Registry_Release(const RAK3172_t* p_Device)
+{
+    bool isWaiting;
+
+    isWaiting = (_RAK3172_Registry_Current == p_Device) && (RAK3172_Registry_isTask() == false);
+
+    xSemaphoreGive(RAK3172_Registry_GetLock());
+
+    // The flag isn´t cleared by the waiters, so all waiting tasks are woken up. The task may already process the next device,
+    // which only extends the wait until the next device is finished.
+    if(isWaiting)
+    {
+        xEventGroupWaitBits(RAK3172_Registry_GetDone(), RAK3172_REGISTRY_DONE, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+}
+
+/** @brief          Shared receive task for all registered devices. The task sleeps until a UART event is received
+ *                  or until the earliest timeout of all devices expires.
+ *                  The registry lock is only held to take a snapshot of an entry, so the handlers can use the registry.
+ *  @param p_Arg    Pointer to task arguments
+ */
+static void RAK3172_Registry_Task(void* p_Arg)
+{
+    TickType_t Timeout;
+
+    RAK3172_LOGD(TAG, "Start RAK3172 shared event task");
+
+    Timeout = portMAX_DELAY;
+    while(true)
+    {
+        QueueSetMemberHandle_t Member;
+
+        Member = xQueueSelectFromSet(_RAK3172_Registry_Set, Timeout);
+
+        Timeout = portMAX_DELAY;
+
+        for(uint8_t i = 0; i < CONFIG_RAK3172_TASK_MAX_DEVICES; i++)
+        {
+            bool isEvent;
+            uart_event_t Event;
+            RAK3172_Registry_Entry_t Entry;
+
+            xSemaphoreTake(RAK3172_Registry_GetLock(), portMAX_DELAY);
+
+            Entry = _RAK3172_Registry_Entries[i];
+            if(Entry.Device == NULL)
+            {
+                xSemaphoreGive(RAK3172_Registry_GetLock());
+
+                continue;
+            }
+
+            // The event is always removed from the queue to keep the queue set and the event queue in sync.
+            isEvent = false;
+            if((Member != NULL) && (Member == Entry.Device->Internal.EventQueue))
+            {
+                isEvent = (xQueueReceive(Entry.Device->Internal.EventQueue, &Event, 0) == pdPASS);
+            }
+            else if((Member != NULL) && (Member == Entry.Device->Internal.WakeSignal))
+            {
+                xSemaphoreTake(Entry.Device->Internal.WakeSignal, 0);
+            }
+
+            // A removed or paused device isn´t processed until the task has marked the device as finished.
+            _RAK3172_Registry_Current = Entry.Device;
+            xEventGroupClearBits(RAK3172_Registry_GetDone(), RAK3172_REGISTRY_DONE);
+
+            xSemaphoreGive(RAK3172_Registry_GetLock());
+
+            if(Entry.isPaused == false)
+            {
+                if(isEvent)
+                {
+                    Entry.Handler(Entry.Device, &Event);
+                }
+
+                Entry.Device->Internal.Wakeups++;
+                Timeout = std::min(Timeout, Entry.Poll(Entry.Device));
+            }
+
+            xSemaphoreTake(RAK3172_Registry_GetLock(), portMAX_DELAY);
+
+            _RAK3172_Registry_Current = NULL;
+            xEventGroupSetBits(RAK3172_Registry_GetDone(), RAK3172_REGISTRY_DONE);
+
+            // The last device was removed by a handler. The task can´t be deleted by the handler, so the task deletes itself.
+            if(_RAK3172_Registry_isExit)
+            {
+                RAK3172_LOGD(TAG, "Stop RAK3172 shared event task");
+
+                vQueueDelete(_RAK3172_Registry_Set);
+                _RAK3172_Registry_Set = NULL;
+                _RAK3172_Registry_Task = NULL;
+                _RAK3172_Registry_isExit = false;
+
+                xSemaphoreGive(RAK3172_Registry_GetLock());
+
+                vTaskDelete(NULL);
+            }
+
+            xSemaphoreGive(RAK3172_Registry_GetLock());
+        }
+    }
+}
+
+RAK3172_Error_t RAK3172_Registry_Add(RAK3172_t& p_Device, RAK3172_Registry_Handler_t Handler, RAK3172_Registry_Poll_t Poll)
+{
+    RAK3172_Registry_Entry_t* Entry;
+    RAK3172_Error_t Error = RAK3172_ERR_OK;
+
+    if((Handler == NULL) || (Poll == NULL))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(RAK3172_Registry_GetLock(), portMAX_DELAY);
+
+    Entry = RAK3172_Registry_Find(NULL);
+    if(Entry == NULL)
+    {
+        RAK3172_LOGE(TAG, "No free registry entry!");
+
+        Error = RAK3172_ERR_NO_MEM;
+        goto RAK3172_Registry_Add_Exit;
+    }
+
+    if(_RAK3172_Registry_Set == NULL)
+    {
+        _RAK3172_Registry_Set = xQueueCreateSet(CONFIG_RAK3172_TASK_MAX_DEVICES * (CONFIG_RAK3172_UART_QUEUE_LENGTH + 1));
+        if(_RAK3172_Registry_Set == NULL)
+        {
+            Error = RAK3172_ERR_NO_MEM;
+            goto RAK3172_Registry_Add_Exit;
+        }
+
+        #ifdef CONFIG_RAK3172_TASK_CORE_USE_AFFINITY
+            xTaskCreatePinnedToCore(RAK3172_Registry_Task, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, NULL, CONFIG_RAK3172_TASK_PRIO, &_RAK3172_Registry_Task, CONFIG_RAK3172_TASK_CORE);
+        #else
+            xTaskCreate(RAK3172_Registry_Task, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, NULL, CONFIG_RAK3172_TASK_PRIO, &_RAK3172_Registry_Task);
+        #endif
+
+        if(_RAK3172_Registry_Task == NULL)
+        {
+            vQueueDelete(_RAK3172_Registry_Set);
+            _RAK3172_Registry_Set = NULL;
+
+            Error = RAK3172_ERR_NO_MEM;
+            goto RAK3172_Registry_Add_Exit;
+        }
+    }
+
+    // Only empty queues can be added to a queue set. The queue doesn´t contain any processed event at this point.
+    xQueueReset(p_Device.Internal.EventQueue);
+    xQueueAddToSet(p_Device.Internal.EventQueue, _RAK3172_Registry_Set);
+    xSemaphoreTake(p_Device.Internal.WakeSignal, 0);
+    xQueueAddToSet(p_Device.Internal.WakeSignal, _RAK3172_Registry_Set);
+
+    Entry->Device = &p_Device;
+    Entry->Handler = Handler;
+    Entry->Poll = Poll;
+    Entry->isPaused = false;
+    _RAK3172_Registry_Count++;
+    _RAK3172_Registry_isExit = false;
+
+    RAK3172_LOGD(TAG, "Add device %p. Registered devices: %u", &p_Device, _RAK3172_Registry_Count);
+
+RAK3172_Registry_Add_Exit:
+    xSemaphoreGive(RAK3172_Registry_GetLock());
+
+    return Error;
+}
+
+void RAK3172_Registry_Remove(RAK3172_t& p_Device)
+{
+    RAK3172_Registry_Entry_t* Entry;
+
+    xSemaphoreTake(RAK3172_Registry_GetLock(), portMAX_DELAY);
+
+    Entry = RAK3172_Registry_Find(&p_Device);
+    if(Entry == NULL)
+    {
+        xSemaphoreGive(RAK3172_Registry_GetLock());
+
+        return;
+    }
+
+    // Only empty queues can be removed from a queue set. The UART driver can add new events at any time.
+    do
+    {
+        xQueueReset(p_Device.Internal.EventQueue);
+    } while(xQueueRemoveFromSet(p_Device.Internal.EventQueue, _RAK3172_Registry_Set) != pdPASS);
+
+    do
+    {
+        xSemaphoreTake(p_Device.Internal.WakeSignal, 0);
+    } while(xQueueRemoveFromSet(p_Device.Internal.WakeSignal, _RAK3172_Registry_Set) != pdPASS);
+
+    Entry->Device = NULL;
+    _RAK3172_Registry_Count--;
+
+    RAK3172_LOGD(TAG, "Remove device %p. Registered devices: %u", &p_Device, _RAK3172_Registry_Count);
+
+    RAK3172_Registry_Release(&p_Device);
+
+    xSemaphoreTake(RAK3172_Registry_GetLock(), portMAX_DELAY);
+
+    // The task doesn´t hold the lock, so it can be deleted safely. A task which removes the last device from a handler deletes itself
+    // after the handler has returned.
+    if((_RAK3172_Registry_Count == 0) && (_RAK3172_Registry_Task != NULL))
+    {
+        if(RAK3172_Registry_isTask())
+        {
+            _RAK3172_Registry_isExit = true;
+        }
+        else
+        {
+            vTaskDelete(_RAK3172_Registry_Task);
+            _RAK3172_Registry_Task = NULL;
+
+            vQueueDelete(_RAK3172_Registry_Set);
+            _RAK3172_Registry_Set = NULL;
+        }
+    }
+
+    xSemaphoreGive(RAK3172_Registry_GetLock());
+}
+
+void RAK3172_Registry_Pause(RAK3172_t& p_Device, bool Pause)
+{
+    RAK3172_Registry_Entry_t* Entry;
+
+    xSemaphoreTake(RAK3172_Registry_GetLock(), portMAX_DELAY);
+
+    Entry = RAK3172_Registry_Find(&p_Device);
+    if(Entry != NULL)
+    {
+        Entry->isPaused = Pause;
+    }
+
+    // A paused device must not be processed after the function returns.
+    RAK3172_Registry_Release(&p_Device);
+
+    // The timeouts of a resumed device aren´t known by the task.
+    if(Pause == false)
+    {
+        RAK3172_Registry_Wake(p_Device);
+    }
+}
+
+bool RAK3172_Registry_isTask(void)
+{
+    return (_RAK3172_Registry_Task != NULL) && (xTaskGetCurrentTaskHandle() == _RAK3172_Registry_Task);
+}
+
+#endif
@@ -0,0 +1,93 @@
+ /*
+ * rak3172_registry.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Device registry and shared receive task for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+
+#ifndef RAK3172_REGISTRY_H_
+#define RAK3172_REGISTRY_H_
+
+#include "rak3172_defs.h"
+
+/** @brief              Event handler of a registered device. Called from the shared receive task.
+ *  @param p_Device     Pointer to RAK3172 device object
+ *  @param p_Event      Pointer to UART event
+ */
+typedef void (*RAK3172_Registry_Handler_t)(RAK3172_t* p_Device, uart_event_t* p_Event);
+
+/** @brief              Periodic handler of a registered device. Called from the shared receive task after each event and each timeout.
+ *  @param p_Device     Pointer to RAK3172 device object
+ *  @return             Time in ticks until the handler must be called again or portMAX_DELAY when the device is idle
+ */
+typedef TickType_t (*RAK3172_Registry_Poll_t)(RAK3172_t* p_Device);
+
+/** @brief          Add a device to the registry and its UART event queue and wake signal to the queue set of the shared receive task.
+ *                  The shared receive task is created with the first device.
+ *  @param p_Device RAK3172 device object
+ *  @param Handler  Event handler for the device
+ *  @param Poll     Periodic handler for the device
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the registry is full or the queue set or the task cannot be created
+ */
+RAK3172_Error_t RAK3172_Registry_Add(RAK3172_t& p_Device, RAK3172_Registry_Handler_t Handler, RAK3172_Registry_Poll_t Poll);
+
+/** @brief          Remove a device from the registry. The device isn´t processed by the shared receive task after this function returns.
+ *                  The shared receive task is deleted with the last device. The function can be called from a handler.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_Registry_Remove(RAK3172_t& p_Device);
+
+/** @brief          Pause or resume the processing of a device. The UART events of a paused device are dropped.
+ *                  The device isn´t processed by the shared receive task after a pause. The function can be called from a handler.
+ *  @param p_Device RAK3172 device object
+ *  @param Pause    #true to pause the processing
+ */
+void RAK3172_Registry_Pause(RAK3172_t& p_Device, bool Pause);
+
+/** @brief  Check if the function is called by the shared receive task.
+ *  @return #true when called by the shared receive task
+ */
+bool RAK3172_Registry_isTask(void);
+
+/** @brief          Check if the function is called by the receive task of a device. The receive task must never wait for a command request,
+ *                  because only the receive task releases the requests.
+ *  @param p_Device RAK3172 device object
+ *  @return         #true when called by the shared receive task or by the receive task of the device
+ */
+inline __attribute__((always_inline)) bool RAK3172_Registry_isDriverTask(const RAK3172_t& p_Device)
+{
+    #ifdef CONFIG_RAK3172_TASK_SHARED
+        return RAK3172_Registry_isTask();
+    #else
+        return (p_Device.Internal.Handle != NULL) && (xTaskGetCurrentTaskHandle() == p_Device.Internal.Handle);
+    #endif
+}
+
+/** @brief          Wake up the receive task of a device to recalculate the timeouts of the device. Used for the shared receive task
+ *                  and for the receive task of each device.
+ *                  The wake signal is a binary semaphore, so multiple wake ups are merged and the UART event queue is never used.
+ *  @param p_Device RAK3172 device object
+ */
+inline __attribute__((always_inline)) void RAK3172_Registry_Wake(const RAK3172_t& p_Device)
+{
+    if(p_Device.Internal.WakeSignal != NULL)
+    {
+        xSemaphoreGive(p_Device.Internal.WakeSignal);
+    }
+}
+
+#endif /* RAK3172_REGISTRY_H_ */
@@ -0,0 +1,174 @@
+ /*
+ * rak3172_ring.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Lock free single producer single consumer ring for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include "rak3172_ring.h"
+
+/** @brief          Get the index of the next entry.
+ *  @param p_Ring   Pointer to ring
+ *  @param Index    Current index
+ *  @return         Next index
+ */
+static inline uint8_t RAK3172_Ring_Next(const RAK3172_Ring_t* p_Ring, uint8_t Index)
+{
+    return ((Index + 1) == p_Ring->Size) ? 0 : (Index + 1);
+}
+
+RAK3172_Ring_t* RAK3172_Ring_Create(uint8_t Length)
+{
+    RAK3172_Ring_t* Ring;
+
+    if((Length == 0) || (Length == 0xFF))
+    {
+        return NULL;
+    }
+
+    Ring = new RAK3172_Ring_t();
+    Ring->Data = new uint8_t[Length + 1];
+    Ring->Size = Length + 1;
+    Ring->Head = 0;
+    Ring->Tail = 0;
+    Ring->Consumer = NULL;
+    Ring->isWoken = false;
+
+    return Ring;
+}
+
+void RAK3172_Ring_Delete(RAK3172_Ring_t* p_Ring)
+{
+    if(p_Ring == NULL)
+    {
+        return;
+    }
+
+    delete[] p_Ring->Data;
+    delete p_Ring;
+}
+
+bool RAK3172_Ring_Push(RAK3172_Ring_t* p_Ring, uint8_t Item)
+{
+    uint8_t Head;
+    uint8_t Tail;
+    TaskHandle_t Consumer;
+
+    Head = p_Ring->Head.load(std::memory_order_relaxed);
+    Tail = p_Ring->Tail.load(std::memory_order_acquire);
+    if(RAK3172_Ring_Next(p_Ring, Head) == Tail)
+    {
+        return false;
+    }
+
+    p_Ring->Data[Head] = Item;
+
+    // The entry is published before the consumer is loaded. Together with the consumer, which registers itself before it checks the ring,
+    // either the consumer sees the entry or the producer sees the consumer. The consumer is only registered after it has found the ring empty,
+    // so the doorbell only rings on the change from empty to non-empty. The tail loaded above can be outdated and must not be used for this decision.
+    p_Ring->Head.store(RAK3172_Ring_Next(p_Ring, Head), std::memory_order_seq_cst);
+    Consumer = p_Ring->Consumer.load(std::memory_order_seq_cst);
+    if(Consumer != NULL)
+    {
+        xTaskNotifyGive(Consumer);
+    }
+
+    return true;
+}
+
+bool RAK3172_Ring_Pop(RAK3172_Ring_t* p_Ring, uint8_t* p_Item)
+{
+    uint8_t Tail;
+
+    Tail = p_Ring->Tail.load(std::memory_order_relaxed);
+    if(p_Ring->Head.load(std::memory_order_seq_cst) == Tail)
+    {
+        return false;
+    }
+
+    *p_Item = p_Ring->Data[Tail];
+    p_Ring->Tail.store(RAK3172_Ring_Next(p_Ring, Tail), std::memory_order_release);
+
+    return true;
+}
+
+bool RAK3172_Ring_Wait(RAK3172_Ring_t* p_Ring, uint8_t* p_Item, TickType_t Timeout)
+{
+    bool Result;
+    TickType_t Start;
+    TickType_t Elapsed;
+
+    // Fast path without a task notification.
+    if(RAK3172_Ring_Pop(p_Ring, p_Item))
+    {
+        return true;
+    }
+
+    Start = xTaskGetTickCount();
+    p_Ring->Consumer.store(xTaskGetCurrentTaskHandle(), std::memory_order_seq_cst);
+
+    while(true)
+    {
+        Result = RAK3172_Ring_Pop(p_Ring, p_Item);
+        if(Result || p_Ring->isWoken.exchange(false, std::memory_order_seq_cst))
+        {
+            break;
+        }
+
+        // Notifications from an earlier wait only cause another check of the ring.
+        if(Timeout == portMAX_DELAY)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        else
+        {
+            Elapsed = xTaskGetTickCount() - Start;
+            if(Elapsed >= Timeout)
+            {
+                break;
+            }
+
+            ulTaskNotifyTake(pdTRUE, Timeout - Elapsed);
+        }
+    }
+
+    p_Ring->Consumer.store(NULL, std::memory_order_seq_cst);
+
+    return Result;
+}
+
+void RAK3172_Ring_Wake(RAK3172_Ring_t* p_Ring)
+{
+    TaskHandle_t Consumer;
+
+    p_Ring->isWoken.store(true, std::memory_order_seq_cst);
+
+    Consumer = p_Ring->Consumer.load(std::memory_order_seq_cst);
+    if(Consumer != NULL)
+    {
+        xTaskNotifyGive(Consumer);
+    }
+}
+
+uint8_t RAK3172_Ring_Count(const RAK3172_Ring_t* p_Ring)
+{
+    uint8_t Head;
+    uint8_t Tail;
+
+    Head = p_Ring->Head.load(std::memory_order_acquire);
+    Tail = p_Ring->Tail.load(std::memory_order_acquire);
+
+    return (Head >= Tail) ? (Head - Tail) : (p_Ring->Size - Tail + Head);
+}
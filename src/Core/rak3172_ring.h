@@ -0,0 +1,87 @@
+ /*
+ * rak3172_ring.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Lock free single producer single consumer ring for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_RING_H_
+#define RAK3172_RING_H_
+
+#include <atomic>
+
+#include "rak3172_defs.h"
+
+/** @brief Lock free ring for one producer task and one consumer task. The producer wakes up a waiting consumer with a task notification,
+ *         but only when the ring changes from empty to non-empty.
+ *         NOTE: Managed by the driver.
+ */
+struct RAK3172_Ring_t
+{
+    uint8_t* Data;                                  /**< Ring storage with one unused entry to distinguish a full from an empty ring. */
+    uint8_t Size;                                   /**< Number of entries in the ring storage. */
+    std::atomic<uint8_t> Head;                      /**< Next entry written by the producer. */
+    std::atomic<uint8_t> Tail;                      /**< Next entry read by the consumer. */
+    std::atomic<TaskHandle_t> Consumer;             /**< Consumer task, which waits for the ring. NULL when no task is waiting. */
+    std::atomic<bool> isWoken;                      /**< #true when the consumer was woken up without a new entry. */
+};
+
+/** @brief          Create a ring.
+ *  @param Length   Maximum number of entries. Must be between 1 and 254
+ *  @return         Pointer to the ring or NULL when the length is invalid
+ */
+RAK3172_Ring_t* RAK3172_Ring_Create(uint8_t Length);
+
+/** @brief          Delete a ring.
+ *  @param p_Ring   Pointer to ring
+ */
+void RAK3172_Ring_Delete(RAK3172_Ring_t* p_Ring);
+
+/** @brief          Add an entry to the ring. Must only be called by the producer task.
+ *  @param p_Ring   Pointer to ring
+ *  @param Item     Entry
+ *  @return         #true when successful
+ *                  #false when the ring is full
+ */
+bool RAK3172_Ring_Push(RAK3172_Ring_t* p_Ring, uint8_t Item);
+
+/** @brief          Remove the oldest entry from the ring without waiting. Must only be called by the consumer task.
+ *  @param p_Ring   Pointer to ring
+ *  @param p_Item   Pointer to entry
+ *  @return         #true when an entry was removed
+ */
+bool RAK3172_Ring_Pop(RAK3172_Ring_t* p_Ring, uint8_t* p_Item);
+
+/** @brief          Wait for the oldest entry of the ring. Must only be called by the consumer task.
+ *  @param p_Ring   Pointer to ring
+ *  @param p_Item   Pointer to entry
+ *  @param Timeout  Timeout in ticks
+ *  @return         #true when an entry was removed
+ *                  #false when the timeout has expired or when the consumer was woken up with #RAK3172_Ring_Wake
+ */
+bool RAK3172_Ring_Wait(RAK3172_Ring_t* p_Ring, uint8_t* p_Item, TickType_t Timeout);
+
+/** @brief          Wake up a waiting consumer without a new entry. A consumer, which doesn´t wait, returns from the next wait immediately.
+ *  @param p_Ring   Pointer to ring
+ */
+void RAK3172_Ring_Wake(RAK3172_Ring_t* p_Ring);
+
+/** @brief          Get the number of entries in the ring.
+ *  @param p_Ring   Pointer to ring
+ *  @return         Number of entries
+ */
+uint8_t RAK3172_Ring_Count(const RAK3172_Ring_t* p_Ring);
+
+#endif /* RAK3172_RING_H_ */
@@ -0,0 +1,155 @@
+ /*
+ * rak3172_rxqueue.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Receive message queue for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include "rak3172_rxqueue.h"
+#include "rak3172_hex.h"
+
+/** @brief Bit mask with all receive slots.
+ */
+#define RAK3172_RXQUEUE_ALL                                     (0xFFFFFFFFUL >> (32 - CONFIG_RAK3172_RX_QUEUE_LENGTH))
+
+RAK3172_Error_t RAK3172_RxQueue_Init(RAK3172_t& p_Device)
+{
+    RAK3172_RxQueue_t* Queue;
+
+    Queue = new RAK3172_RxQueue_t();
+    Queue->Ring = RAK3172_Ring_Create(CONFIG_RAK3172_RX_QUEUE_LENGTH);
+    if(Queue->Ring == NULL)
+    {
+        delete Queue;
+
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    p_Device.Internal.ReceiveQueue = Queue;
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_RxQueue_Deinit(RAK3172_t& p_Device)
+{
+    if(p_Device.Internal.ReceiveQueue == NULL)
+    {
+        return;
+    }
+
+    RAK3172_Ring_Delete(p_Device.Internal.ReceiveQueue->Ring);
+    delete p_Device.Internal.ReceiveQueue;
+    p_Device.Internal.ReceiveQueue = NULL;
+}
+
+RAK3172_Rx_t* RAK3172_RxQueue_Acquire(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+    uint8_t Used;
+    uint32_t Mask;
+    RAK3172_RxQueue_t* Queue = p_Device.Internal.ReceiveQueue;
+
+    // Claim the lowest free slot. The mask only changes when a consumer releases a slot in the meantime.
+    // Unread messages and borrowed slots are never recycled. So the new message is dropped when all slots are in use.
+    Mask = Queue->Used.load();
+    do
+    {
+        if((Mask & RAK3172_RXQUEUE_ALL) == RAK3172_RXQUEUE_ALL)
+        {
+            Queue->Overflows++;
+
+            return NULL;
+        }
+
+        Index = __builtin_ctz(~Mask);
+    } while(Queue->Used.compare_exchange_weak(Mask, Mask | (0x01UL << Index)) == false);
+
+    Used = __builtin_popcount(Mask) + 1;
+    if(Used > Queue->MaxUsed)
+    {
+        Queue->MaxUsed = Used;
+    }
+
+    Queue->Slots[Index].Length = 0;
+
+    return &Queue->Slots[Index];
+}
+
+void RAK3172_RxQueue_Send(const RAK3172_t& p_Device, RAK3172_Rx_t* p_Message)
+{
+    if(RAK3172_Ring_Push(p_Device.Internal.ReceiveQueue->Ring, RAK3172_RxQueue_GetIndex(p_Device, p_Message)) == false)
+    {
+        RAK3172_RxQueue_Drop(p_Device, p_Message);
+
+        return;
+    }
+
+    p_Device.Internal.ReceiveQueue->Received++;
+}
+
+void RAK3172_RxQueue_Signal(const RAK3172_t& p_Device)
+{
+    RAK3172_Ring_Wake(p_Device.Internal.ReceiveQueue->Ring);
+}
+
+bool RAK3172_RxQueue_Receive(const RAK3172_t& p_Device, RAK3172_Rx_t** p_Message, TickType_t Timeout)
+{
+    uint8_t Index;
+
+    if(RAK3172_Ring_Wait(p_Device.Internal.ReceiveQueue->Ring, &Index, Timeout) == false)
+    {
+        return false;
+    }
+
+    *p_Message = RAK3172_RxQueue_GetSlot(p_Device, Index);
+
+    return true;
+}
+
+void RAK3172_RxQueue_Release(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message)
+{
+    if(p_Message == NULL)
+    {
+        return;
+    }
+
+    p_Device.Internal.ReceiveQueue->Used.fetch_and(~(0x01UL << RAK3172_RxQueue_GetIndex(p_Device, p_Message)));
+}
+
+void RAK3172_RxQueue_Drop(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message)
+{
+    RAK3172_RxQueue_Release(p_Device, p_Message);
+    p_Device.Internal.ReceiveQueue->Overflows++;
+}
+
+void RAK3172_RxQueue_GetStats(const RAK3172_t& p_Device, RAK3172_Rx_Stats_t* p_Stats)
+{
+    RAK3172_RxQueue_t* Queue = p_Device.Internal.ReceiveQueue;
+
+    p_Stats->Received = Queue->Received.load();
+    p_Stats->Overflows = Queue->Overflows.load();
+    p_Stats->Used = __builtin_popcount(Queue->Used.load());
+    p_Stats->MaxUsed = Queue->MaxUsed;
+}
+
+void RAK3172_RxQueue_Copy(RAK3172_Rx_t* p_Message, const RAK3172_Rx_t* p_Slot)
+{
+    *p_Message = *p_Slot;
+
+    #ifdef CONFIG_RAK3172_RX_PAYLOAD_STRING
+        p_Message->Payload.resize(2 * p_Slot->Length);
+        RAK3172_Hex_Encode(p_Slot->Data, p_Slot->Length, &p_Message->Payload[0]);
+    #endif
+}
@@ -0,0 +1,125 @@
+ /*
+ * rak3172_rxqueue.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Receive message queue for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_RXQUEUE_H_
+#define RAK3172_RXQUEUE_H_
+
+#include <atomic>
+
+#include "rak3172_defs.h"
+#include "rak3172_ring.h"
+
+/** @brief Receive queue of a device. The receive task is the only producer and the task, which reads the messages, is the only consumer
+ *         of the message ring. The slots are owned by the receive task, the ring or a consumer and can be released by any task.
+ *         NOTE: Managed by the driver.
+ */
+struct RAK3172_RxQueue_t
+{
+    RAK3172_Rx_t Slots[CONFIG_RAK3172_RX_QUEUE_LENGTH];     /**< Receive slots. */
+    std::atomic<uint32_t> Used;                             /**< Bit mask of the slots in use. */
+    std::atomic<uint32_t> Received;                         /**< Number of messages passed to the ring. */
+    std::atomic<uint32_t> Overflows;                        /**< Number of dropped messages. */
+    uint8_t MaxUsed;                                        /**< Maximum number of slots in use. Only written by the receive task. */
+    RAK3172_Ring_t* Ring;                                   /**< Slot indices of the unread messages in the order of reception. */
+};
+
+/** @brief          Allocate the receive slots and the message ring for a device.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the slots or the ring cannot be created
+ */
+RAK3172_Error_t RAK3172_RxQueue_Init(RAK3172_t& p_Device);
+
+/** @brief          Release the receive slots and the message ring of a device.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_RxQueue_Deinit(RAK3172_t& p_Device);
+
+/** @brief          Get a free receive slot for the receive task. The overflow counter is increased when no slot is free.
+ *  @param p_Device RAK3172 device object
+ *  @return         Pointer to the receive slot or NULL when all slots are in use
+ */
+RAK3172_Rx_t* RAK3172_RxQueue_Acquire(const RAK3172_t& p_Device);
+
+/** @brief              Pass a filled receive slot to the message ring. Must only be called by the receive task.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to receive slot
+ */
+void RAK3172_RxQueue_Send(const RAK3172_t& p_Device, RAK3172_Rx_t* p_Message);
+
+/** @brief              Wake up the task, which waits for a message, without a message.
+ *  @param p_Device     RAK3172 device object
+ */
+void RAK3172_RxQueue_Signal(const RAK3172_t& p_Device);
+
+/** @brief              Borrow the oldest message from the message ring. The slot must be returned with #RAK3172_RxQueue_Release.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to receive slot pointer
+ *  @param Timeout      Timeout in ticks
+ *  @return             #true when a message was received
+ *                      #false when the timeout has expired or when the task was woken up with #RAK3172_RxQueue_Signal
+ */
+bool RAK3172_RxQueue_Receive(const RAK3172_t& p_Device, RAK3172_Rx_t** p_Message, TickType_t Timeout);
+
+/** @brief              Return a receive slot.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to receive slot
+ */
+void RAK3172_RxQueue_Release(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message);
+
+/** @brief              Return a receive slot and count the message as overflow.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to receive slot
+ */
+void RAK3172_RxQueue_Drop(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message);
+
+/** @brief              Get the statistics of the receive queue.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Stats      Pointer to statistics
+ */
+void RAK3172_RxQueue_GetStats(const RAK3172_t& p_Device, RAK3172_Rx_Stats_t* p_Stats);
+
+/** @brief              Copy a receive slot into a message of the application. The deprecated hex string payload is created here,
+ *                      so the receive task doesn´t allocate memory.
+ *  @param p_Message    Pointer to message
+ *  @param p_Slot       Pointer to receive slot
+ */
+void RAK3172_RxQueue_Copy(RAK3172_Rx_t* p_Message, const RAK3172_Rx_t* p_Slot);
+
+/** @brief              Get the index of a receive slot.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Message    Pointer to receive slot
+ *  @return             Slot index
+ */
+inline __attribute__((always_inline)) uint8_t RAK3172_RxQueue_GetIndex(const RAK3172_t& p_Device, const RAK3172_Rx_t* p_Message)
+{
+    return static_cast<uint8_t>(p_Message - p_Device.Internal.ReceiveQueue->Slots);
+}
+
+/** @brief              Get a receive slot by its index.
+ *  @param p_Device     RAK3172 device object
+ *  @param Index        Slot index
+ *  @return             Pointer to receive slot
+ */
+inline __attribute__((always_inline)) RAK3172_Rx_t* RAK3172_RxQueue_GetSlot(const RAK3172_t& p_Device, uint8_t Index)
+{
+    return &p_Device.Internal.ReceiveQueue->Slots[Index];
+}
+
+#endif /* RAK3172_RXQUEUE_H_ */
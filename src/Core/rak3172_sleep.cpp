@@ -0,0 +1,155 @@
+ /*
+ * rak3172_sleep.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Module sleep state of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_USE_RUI3
+
+#include "rak3172_sleep.h"
+#include "rak3172_cmdqueue.h"
+#include "rak3172_registry.h"
+#include "rak3172_writer.h"
+#include "../Arch/Timer/rak3172_timer.h"
+#include "../Arch/Logging/rak3172_logging.h"
+
+/** @brief Preamble which wakes up the module. The first characters are lost during the wake up of the module.
+ */
+#define RAK3172_SLEEP_WAKE_PREAMBLE                             "AT"
+
+static const char* TAG = "RAK3172_Sleep";
+
+/** @brief          Ignore the response to the preamble, which was transmitted by a driver task.
+ *  @param Error    RAK3172_ERR_OK when the module responds with "OK"
+ *  @param p_Value  Received value or an empty string when no value was received
+ *  @param p_Status Received status line
+ *  @param p_Arg    Not used
+ */
+static void RAK3172_Sleep_OnWake(RAK3172_Error_t Error, const char* p_Value, const char* p_Status, void* p_Arg)
+{
+    RAK3172_LOGD(TAG, "Preamble completed with status: %s", p_Status);
+}
+
+void RAK3172_Sleep_Enter(RAK3172_t& p_Device, uint32_t Duration)
+{
+    p_Device.Internal.ModuleSleepStart = RAK3172_Timer_GetMilliseconds();
+    p_Device.Internal.ModuleSleepTime = Duration;
+    p_Device.Internal.isModuleAsleep = true;
+}
+
+uint32_t RAK3172_Sleep_GetRemaining(const RAK3172_t& p_Device)
+{
+    unsigned long Elapsed;
+
+    if(p_Device.Internal.isModuleAsleep == false)
+    {
+        return 0;
+    }
+    else if(p_Device.Internal.ModuleSleepTime == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    // The timer keeps running during a light sleep of the host, so the deadline is also valid after a light sleep.
+    Elapsed = RAK3172_Timer_GetMilliseconds() - p_Device.Internal.ModuleSleepStart;
+    if(Elapsed >= p_Device.Internal.ModuleSleepTime)
+    {
+        p_Device.Internal.isModuleAsleep = false;
+
+        return 0;
+    }
+
+    return p_Device.Internal.ModuleSleepTime - Elapsed;
+}
+
+RAK3172_Error_t RAK3172_Sleep_Wake(const RAK3172_t& p_Device)
+{
+    bool isDriverTask;
+    uint32_t Remaining;
+    RAK3172_Error_t Error;
+    RAK3172_Command_t* Request;
+    RAK3172_Fragment_t Preamble;
+
+    if(RAK3172_Sleep_GetRemaining(p_Device) == 0)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    // The receive task completes the preamble of the task which holds the wake lock, so it must not wait for the lock.
+    isDriverTask = RAK3172_Registry_isDriverTask(p_Device);
+    if(xSemaphoreTake(p_Device.Internal.WakeLock, isDriverTask ? 0 : portMAX_DELAY) != pdPASS)
+    {
+        return RAK3172_ERR_BUSY;
+    }
+
+    // Another task has woken up the module in the meantime.
+    Remaining = RAK3172_Sleep_GetRemaining(p_Device);
+    if(Remaining == 0)
+    {
+        xSemaphoreGive(p_Device.Internal.WakeLock);
+
+        return RAK3172_ERR_OK;
+    }
+
+    // Hold the command until the module wakes up by itself. The driver tasks must not be blocked, so they always use the preamble.
+    #ifdef CONFIG_RAK3172_SLEEP_WAKE_DEFER
+        if((Remaining != UINT32_MAX) && (isDriverTask == false))
+        {
+            RAK3172_LOGD(TAG, "Wait %u ms for the module", static_cast<unsigned int>(Remaining));
+
+            vTaskDelay((Remaining / portTICK_PERIOD_MS) + 1);
+            p_Device.Internal.isModuleAsleep = false;
+
+            xSemaphoreGive(p_Device.Internal.WakeLock);
+
+            return RAK3172_ERR_OK;
+        }
+    #endif
+
+    RAK3172_LOGD(TAG, "Wake up module");
+
+    // The preamble is a regular command, so the module must be marked as awake before the preamble is transmitted.
+    // The response to the preamble belongs to the preamble request and can´t be fed to the next command. The result is ignored,
+    // because the module loses the first characters of the preamble.
+    Preamble = RAK3172_Fragment_Text(RAK3172_SLEEP_WAKE_PREAMBLE);
+    p_Device.Internal.isModuleAsleep = false;
+    if(isDriverTask)
+    {
+        Error = RAK3172_CmdQueue_Submit(p_Device, &Preamble, 1, RAK_RESPONSE_STATUS, RAK3172_Sleep_OnWake, NULL, CONFIG_RAK3172_SLEEP_WAKE_TIME / portTICK_PERIOD_MS, NULL);
+    }
+    else
+    {
+        Error = RAK3172_CmdQueue_Submit(p_Device, &Preamble, 1, RAK_RESPONSE_STATUS, NULL, NULL, CONFIG_RAK3172_SLEEP_WAKE_TIME / portTICK_PERIOD_MS, &Request);
+        if(Error == RAK3172_ERR_OK)
+        {
+            RAK3172_CmdQueue_Wait(p_Device, Request, NULL, NULL);
+        }
+    }
+
+    // The module is still asleep when no request is available for the preamble.
+    if(Error != RAK3172_ERR_OK)
+    {
+        p_Device.Internal.isModuleAsleep = true;
+    }
+
+    xSemaphoreGive(p_Device.Internal.WakeLock);
+
+    return Error;
+}
+
+#endif
\ No newline at end of file
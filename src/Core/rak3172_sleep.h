@@ -0,0 +1,47 @@
+ /*
+ * rak3172_sleep.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Module sleep state of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_SLEEP_H_
+#define RAK3172_SLEEP_H_
+
+#include "rak3172_defs.h"
+
+/** @brief          Mark the module as sleeping. Call this function after the module has accepted the sleep command.
+ *  @param p_Device RAK3172 device object
+ *  @param Duration Sleep duration in milliseconds. 0 when the module sleeps until it is woken up.
+ */
+void RAK3172_Sleep_Enter(RAK3172_t& p_Device, uint32_t Duration);
+
+/** @brief          Get the remaining sleep time of the module.
+ *  @param p_Device RAK3172 device object
+ *  @return         Remaining sleep time in milliseconds, 0 when the module is awake or UINT32_MAX when the module sleeps until it is woken up
+ */
+uint32_t RAK3172_Sleep_GetRemaining(const RAK3172_t& p_Device);
+
+/** @brief          Make sure that the module is awake before a command is transmitted. A sleeping module is woken up with a preamble command,
+ *                  whose result is ignored, or the function waits until the module wakes up by itself (\ref CONFIG_RAK3172_SLEEP_WAKE_DEFER).
+ *                  The wake up is serialized with the wake lock of the device.
+ *                  NOTE: The function must be called before a command request is taken and without the command lock.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when the module is awake
+ *                  RAK3172_ERR_BUSY when the wake up is done by another task or no request is available for the preamble
+ */
+RAK3172_Error_t RAK3172_Sleep_Wake(const RAK3172_t& p_Device);
+
+#endif /* RAK3172_SLEEP_H_ */
\ No newline at end of file
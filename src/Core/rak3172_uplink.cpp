@@ -0,0 +1,829 @@
+ /*
+ * rak3172_uplink.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: LoRaWAN uplink tracker for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "rak3172_uplink.h"
+#include "rak3172_registry.h"
+#include "rak3172_writer.h"
+#include "../Arch/Logging/rak3172_logging.h"
+
+#include "rak3172.h"
+
+/** @brief Delay in milliseconds before an uplink is transmitted again when the module is busy.
+ */
+#define RAK3172_UPLINK_RETRY_DELAY                              100
+
+/** @brief Maximum number of transmissions rejected by the busy module before the uplink fails.
+ */
+#define RAK3172_UPLINK_BUSY_RETRIES                             50
+
+/** @brief Queued uplink, which was removed by the scheduler. The callback is called after the uplink lock is released.
+ */
+typedef struct
+{
+    uint32_t Frame;                     /**< Frame number of the uplink. */
+    RAK3172_Error_t Error;              /**< Result of the uplink. */
+    RAK3172_Uplink_Callback_t Callback; /**< Completion callback. */
+    void* Arg;                          /**< Argument for the completion callback. */
+} RAK3172_Uplink_Drop_t;
+
+/** @brief Commands of an uplink transmission.
+ */
+typedef enum
+{
+    RAK3172_UPLINK_STEP_RETRIES = 0,    /**< Set the number of retransmissions. */
+    RAK3172_UPLINK_STEP_CONFIRM,        /**< Set the confirmation mode. */
+    RAK3172_UPLINK_STEP_SEND,           /**< Transmit the payload. */
+} RAK3172_Uplink_Step_t;
+
+static const char* TAG = "RAK3172_Uplink";
+
+/** @brief          Get the next command of an uplink transmission, which is needed by the uplink.
+ *  @param p_Uplink Pointer to uplink
+ *  @param Step     Next command of the transmission
+ *  @return         Next needed command of the transmission
+ */
+static uint8_t RAK3172_Uplink_GetStep(const RAK3172_Uplink_t* p_Uplink, uint8_t Step)
+{
+    // Unconfirmed uplinks don´t use retransmissions and the long payload command contains the confirmation mode.
+    if((Step == RAK3172_UPLINK_STEP_RETRIES) && (p_Uplink->Confirmed == false))
+    {
+        Step = RAK3172_UPLINK_STEP_CONFIRM;
+    }
+
+    if((Step == RAK3172_UPLINK_STEP_CONFIRM) && p_Uplink->isLong)
+    {
+        Step = RAK3172_UPLINK_STEP_SEND;
+    }
+
+    return Step;
+}
+
+/** @brief          Remove a queued uplink.
+ *                  NOTE: The uplink lock must be taken!
+ *  @param p_Device RAK3172 device object
+ *  @param Index    Index of the uplink
+ *  @param Error    Result of the uplink
+ *  @param p_Drop   Pointer to removed uplink
+ */
+static void RAK3172_Uplink_Remove(RAK3172_t& p_Device, uint8_t Index, RAK3172_Error_t Error, RAK3172_Uplink_Drop_t* p_Drop)
+{
+    RAK3172_Uplink_t* Uplink;
+
+    Uplink = &p_Device.LoRaWAN.Uplinks[Index];
+    Uplink->State = RAK_UPLINK_FREE;
+
+    p_Drop->Frame = Uplink->Frame;
+    p_Drop->Error = Error;
+    p_Drop->Callback = Uplink->Callback;
+    p_Drop->Arg = Uplink->Arg;
+}
+
+/** @brief          Remove all expired queued uplinks. Uplinks with a high priority don´t expire.
+ *                  NOTE: The uplink lock must be taken!
+ *  @param p_Device RAK3172 device object
+ *  @param p_Drops  Pointer to removed uplinks
+ *  @return         Number of removed uplinks
+ */
+static uint8_t RAK3172_Uplink_Expire(RAK3172_t& p_Device, RAK3172_Uplink_Drop_t* p_Drops)
+{
+    uint8_t Count;
+    TickType_t Now;
+    RAK3172_Uplink_t* Uplink;
+
+    Count = 0;
+    Now = xTaskGetTickCount();
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        Uplink = &p_Device.LoRaWAN.Uplinks[i];
+        if((Uplink->State == RAK_UPLINK_QUEUED) && (Uplink->Priority < RAK_UPLINK_PRIO_HIGH) && (Uplink->Deadline > 0) &&
+           ((Now - Uplink->Queued) >= Uplink->Deadline))
+        {
+            RAK3172_Uplink_Remove(p_Device, i, RAK3172_ERR_TIMEOUT, &p_Drops[Count++]);
+            p_Device.LoRaWAN.UplinkStats.Expired++;
+        }
+    }
+
+    return Count;
+}
+
+/** @brief          Call the completion callbacks of removed uplinks.
+ *  @param p_Drops  Pointer to removed uplinks
+ *  @param Count    Number of removed uplinks
+ */
+static void RAK3172_Uplink_Notify(const RAK3172_Uplink_Drop_t* p_Drops, uint8_t Count)
+{
+    for(uint8_t i = 0; i < Count; i++)
+    {
+        RAK3172_LOGD(TAG, "Uplink %u dropped with error 0x%X", static_cast<unsigned int>(p_Drops[i].Frame), static_cast<unsigned int>(p_Drops[i].Error));
+
+        if(p_Drops[i].Callback != NULL)
+        {
+            p_Drops[i].Callback(p_Drops[i].Frame, p_Drops[i].Error, 0, p_Drops[i].Arg);
+        }
+    }
+}
+
+/** @brief          Get the queued uplink with the highest priority. Uplinks with the same priority are transmitted in the order of submission.
+ *                  NOTE: The uplink lock must be taken!
+ *  @param p_Device RAK3172 device object
+ *  @return         Index of the uplink or #RAK3172_UPLINK_NONE when no uplink is queued
+ */
+static uint8_t RAK3172_Uplink_Next(const RAK3172_t& p_Device)
+{
+    uint8_t Index;
+    const RAK3172_Uplink_t* Uplink;
+    const RAK3172_Uplink_t* Best;
+
+    Index = RAK3172_UPLINK_NONE;
+    Best = NULL;
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        Uplink = &p_Device.LoRaWAN.Uplinks[i];
+        if(Uplink->State != RAK_UPLINK_QUEUED)
+        {
+            continue;
+        }
+
+        if((Best == NULL) || (Uplink->Priority > Best->Priority) ||
+           ((Uplink->Priority == Best->Priority) && (static_cast<int32_t>(Uplink->Frame - Best->Frame) < 0)))
+        {
+            Index = i;
+            Best = Uplink;
+        }
+    }
+
+    return Index;
+}
+
+/** @brief          Complete the active uplink and call the completion callback.
+ *  @param p_Device RAK3172 device object
+ *  @param Error    Result of the uplink
+ */
+static void RAK3172_Uplink_Complete(RAK3172_t& p_Device, RAK3172_Error_t Error)
+{
+    uint8_t Index;
+    uint32_t Frame;
+    uint32_t Latency;
+    void* Arg;
+    RAK3172_Uplink_t* Uplink;
+    RAK3172_Uplink_Callback_t Callback;
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    Index = p_Device.LoRaWAN.ActiveUplink;
+    if(Index == RAK3172_UPLINK_NONE)
+    {
+        xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    Uplink = &p_Device.LoRaWAN.Uplinks[Index];
+    Frame = Uplink->Frame;
+    Callback = Uplink->Callback;
+    Arg = Uplink->Arg;
+    Latency = 0;
+    if(Uplink->State == RAK_UPLINK_WAIT_ACK)
+    {
+        Latency = (xTaskGetTickCount() - Uplink->Start) * portTICK_PERIOD_MS;
+    }
+
+    p_Device.LoRaWAN.ActiveUplink = RAK3172_UPLINK_NONE;
+    Uplink->State = RAK_UPLINK_FREE;
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    RAK3172_LOGD(TAG, "Uplink %u completed with error 0x%X after %u ms", static_cast<unsigned int>(Frame), static_cast<unsigned int>(Error), static_cast<unsigned int>(Latency));
+
+    if(Callback != NULL)
+    {
+        Callback(Frame, Error, Latency, Arg);
+    }
+}
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+    /** @brief          Add a transmitted uplink to the duty cycle ledger. The module doesn´t report the used channel,
+     *                  so the uplink is recorded for the default channels of the band.
+     *  @param p_Device RAK3172 device object
+     *  @param Length   Payload length in bytes
+     */
+    static void RAK3172_Uplink_Record(RAK3172_t& p_Device, uint16_t Length)
+    {
+        uint32_t Airtime;
+
+        if(RAK3172_LoRaWAN_Duty_GetAirtime(p_Device, Length, &Airtime) == RAK3172_ERR_OK)
+        {
+            RAK3172_LoRaWAN_Duty_Record(p_Device, Airtime);
+        }
+    }
+#endif
+
+/** @brief          Handle the status of a settings command of the active uplink.
+ *  @param Error    RAK3172_ERR_OK when the module responds with "OK"
+ *  @param p_Value  Received value or an empty string when no value was received
+ *  @param p_Status Received status line
+ *  @param p_Arg    Pointer to RAK3172 device object
+ */
+static void RAK3172_Uplink_OnSetup(RAK3172_Error_t Error, const char* p_Value, const char* p_Status, void* p_Arg)
+{
+    RAK3172_t* Device = static_cast<RAK3172_t*>(p_Arg);
+    RAK3172_Uplink_t* Uplink;
+
+    xSemaphoreTake(Device->LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    if(Device->LoRaWAN.ActiveUplink == RAK3172_UPLINK_NONE)
+    {
+        xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    Uplink = &Device->LoRaWAN.Uplinks[Device->LoRaWAN.ActiveUplink];
+
+    // The request of this command is released after the callback, so the next command is transmitted with the next poll.
+    if(Error == RAK3172_ERR_OK)
+    {
+        Uplink->Step = RAK3172_Uplink_GetStep(Uplink, Uplink->Step + 1);
+        Uplink->State = RAK_UPLINK_PENDING;
+        Uplink->Start = xTaskGetTickCount() - (RAK3172_UPLINK_RETRY_DELAY / portTICK_PERIOD_MS);
+
+        xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    if((strstr(p_Status, "AT_BUSY_ERROR") != NULL) && (Uplink->BusyCounter < RAK3172_UPLINK_BUSY_RETRIES))
+    {
+        Uplink->BusyCounter++;
+        Uplink->State = RAK_UPLINK_PENDING;
+        Uplink->Start = xTaskGetTickCount();
+
+        xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+    RAK3172_Uplink_Complete(*Device, (strstr(p_Status, "AT_BUSY_ERROR") != NULL) ? RAK3172_ERR_BUSY : Error);
+}
+
+/** @brief          Handle the status of the send command of the active uplink.
+ *  @param Error    RAK3172_ERR_OK when the module responds with "OK"
+ *  @param p_Value  Received value or an empty string when no value was received
+ *  @param p_Status Received status line
+ *  @param p_Arg    Pointer to RAK3172 device object
+ */
+static void RAK3172_Uplink_OnSend(RAK3172_Error_t Error, const char* p_Value, const char* p_Status, void* p_Arg)
+{
+    RAK3172_t* Device = static_cast<RAK3172_t*>(p_Arg);
+    RAK3172_Uplink_t* Uplink;
+
+    xSemaphoreTake(Device->LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    if(Device->LoRaWAN.ActiveUplink == RAK3172_UPLINK_NONE)
+    {
+        xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    Uplink = &Device->LoRaWAN.Uplinks[Device->LoRaWAN.ActiveUplink];
+    Uplink->Start = xTaskGetTickCount();
+
+    if(Error == RAK3172_ERR_OK)
+    {
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+            uint16_t Length;
+
+            Length = Uplink->Length;
+        #endif
+
+        // Unconfirmed uplinks are completed with the status of the send command.
+        if(Uplink->Confirmed)
+        {
+            Uplink->State = RAK_UPLINK_WAIT_ACK;
+
+            xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+            #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+                RAK3172_Uplink_Record(*Device, Length);
+            #endif
+
+            return;
+        }
+
+        xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY
+            RAK3172_Uplink_Record(*Device, Length);
+        #endif
+        RAK3172_Uplink_Complete(*Device, RAK3172_ERR_OK);
+
+        return;
+    }
+
+    // The module is still busy with the previous uplink. Transmit the send command again with the next poll. The settings are kept by the module.
+    if((strstr(p_Status, "AT_BUSY_ERROR") != NULL) && (Uplink->BusyCounter < RAK3172_UPLINK_BUSY_RETRIES))
+    {
+        Uplink->BusyCounter++;
+        Uplink->State = RAK_UPLINK_PENDING;
+
+        xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    xSemaphoreGive(Device->LoRaWAN.UplinkLock);
+
+    if((strstr(p_Value, "Restricted") != NULL) || (strstr(p_Status, "Restricted") != NULL))
+    {
+        Error = RAK3172_ERR_RESTRICTED;
+    }
+    else if(strstr(p_Status, "AT_BUSY_ERROR") != NULL)
+    {
+        Error = RAK3172_ERR_BUSY;
+    }
+
+    RAK3172_Uplink_Complete(*Device, Error);
+}
+
+/** @brief          Transmit the next command of the active uplink or activate the next queued uplink.
+ *                  The settings of the uplink and the send command are chained. Each command is transmitted after the previous command
+ *                  is completed, so the transmission uses only one command request and never waits for a free request.
+ *  @param p_Device RAK3172 device object
+ */
+static void RAK3172_Uplink_Dispatch(RAK3172_t& p_Device)
+{
+    uint8_t Index;
+    uint8_t Count;
+    uint8_t Step;
+    uint32_t Wait;
+    RAK3172_Error_t Error;
+    RAK3172_Uplink_t* Uplink;
+    RAK3172_Fragment_t Fragments[6];
+    RAK3172_Uplink_Drop_t Drops[CONFIG_RAK3172_UPLINK_QUEUE_LENGTH];
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+    Count = RAK3172_Uplink_Expire(p_Device, Drops);
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    RAK3172_Uplink_Notify(Drops, Count);
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    if(p_Device.LoRaWAN.ActiveUplink == RAK3172_UPLINK_NONE)
+    {
+        Index = RAK3172_Uplink_Next(p_Device);
+        if(Index == RAK3172_UPLINK_NONE)
+        {
+            xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+            return;
+        }
+
+        Uplink = &p_Device.LoRaWAN.Uplinks[Index];
+        Uplink->State = RAK_UPLINK_PENDING;
+        Uplink->Step = RAK3172_Uplink_GetStep(Uplink, RAK3172_UPLINK_STEP_RETRIES);
+        Uplink->Start = xTaskGetTickCount() - (RAK3172_UPLINK_RETRY_DELAY / portTICK_PERIOD_MS);
+        p_Device.LoRaWAN.ActiveUplink = Index;
+
+        Wait = (xTaskGetTickCount() - Uplink->Queued) * portTICK_PERIOD_MS;
+        p_Device.LoRaWAN.UplinkStats.WaitTime = Wait;
+        p_Device.LoRaWAN.UplinkStats.MaxWaitTime = std::max(p_Device.LoRaWAN.UplinkStats.MaxWaitTime, Wait);
+    }
+
+    Uplink = &p_Device.LoRaWAN.Uplinks[p_Device.LoRaWAN.ActiveUplink];
+    if((Uplink->State != RAK_UPLINK_PENDING) || ((xTaskGetTickCount() - Uplink->Start) < (RAK3172_UPLINK_RETRY_DELAY / portTICK_PERIOD_MS)))
+    {
+        xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+        return;
+    }
+
+    Uplink->State = RAK_UPLINK_SENDING;
+    Uplink->Start = xTaskGetTickCount();
+    Step = Uplink->Step;
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    if(Step == RAK3172_UPLINK_STEP_RETRIES)
+    {
+        Fragments[0] = RAK3172_Fragment_Text("AT+RETY=");
+        Fragments[1] = RAK3172_Fragment_Number(Uplink->Retries);
+        Error = RAK3172_SendCommandAsync(p_Device, Fragments, 2, RAK_RESPONSE_STATUS, RAK3172_Uplink_OnSetup, &p_Device);
+    }
+    else if(Step == RAK3172_UPLINK_STEP_CONFIRM)
+    {
+        Fragments[0] = RAK3172_Fragment_Text("AT+CFM=");
+        Fragments[1] = RAK3172_Fragment_Number(Uplink->Confirmed);
+        Error = RAK3172_SendCommandAsync(p_Device, Fragments, 2, RAK_RESPONSE_STATUS, RAK3172_Uplink_OnSetup, &p_Device);
+    }
+    else
+    {
+        RAK3172_LOGD(TAG, "Transmit uplink %u", static_cast<unsigned int>(Uplink->Frame));
+
+        // The payload is encoded straight into the serial interface.
+        Count = 0;
+        if(Uplink->isLong)
+        {
+            Fragments[Count++] = RAK3172_Fragment_Text("AT+LPSEND=");
+            Fragments[Count++] = RAK3172_Fragment_Number(Uplink->Port);
+            Fragments[Count++] = RAK3172_Fragment_Text(":");
+            Fragments[Count++] = RAK3172_Fragment_Number(Uplink->Confirmed);
+        }
+        else
+        {
+            Fragments[Count++] = RAK3172_Fragment_Text("AT+SEND=");
+            Fragments[Count++] = RAK3172_Fragment_Number(Uplink->Port);
+        }
+        Fragments[Count++] = RAK3172_Fragment_Text(":");
+        Fragments[Count++] = RAK3172_Fragment_Hex(Uplink->Data, Uplink->Length);
+
+        Error = RAK3172_SendCommandAsync(p_Device, Fragments, Count, RAK_RESPONSE_VALUE, RAK3172_Uplink_OnSend, &p_Device);
+    }
+
+    // No free command request or the device is busy. Transmit the command again with the next poll.
+    if(Error != RAK3172_ERR_OK)
+    {
+        xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+        Uplink->State = RAK_UPLINK_PENDING;
+        Uplink->Start = xTaskGetTickCount();
+        xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+    }
+}
+
+RAK3172_Error_t RAK3172_Uplink_Init(RAK3172_t& p_Device)
+{
+    p_Device.LoRaWAN.Uplinks = new RAK3172_Uplink_t[CONFIG_RAK3172_UPLINK_QUEUE_LENGTH]();
+    p_Device.LoRaWAN.UplinkLock = xSemaphoreCreateMutex();
+    p_Device.LoRaWAN.ActiveUplink = RAK3172_UPLINK_NONE;
+    p_Device.LoRaWAN.UplinkStats = RAK3172_Uplink_Stats_t();
+
+    if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        RAK3172_Uplink_Deinit(p_Device);
+
+        return RAK3172_ERR_NO_MEM;
+    }
+
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        p_Device.LoRaWAN.Uplinks[i].State = RAK_UPLINK_FREE;
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_Uplink_Deinit(RAK3172_t& p_Device)
+{
+    if((p_Device.LoRaWAN.Uplinks != NULL) && (p_Device.LoRaWAN.UplinkLock != NULL))
+    {
+        RAK3172_Uplink_Abort(p_Device, RAK3172_ERR_INVALID_STATE);
+    }
+
+    if(p_Device.LoRaWAN.UplinkLock != NULL)
+    {
+        vSemaphoreDelete(p_Device.LoRaWAN.UplinkLock);
+        p_Device.LoRaWAN.UplinkLock = NULL;
+    }
+
+    delete[] p_Device.LoRaWAN.Uplinks;
+    p_Device.LoRaWAN.Uplinks = NULL;
+}
+
+RAK3172_Error_t RAK3172_Uplink_Submit(RAK3172_t& p_Device, uint8_t Port, const void* p_Buffer, uint16_t Length, bool Confirmed, uint8_t Retries, RAK3172_Uplink_Priority_t Priority, uint32_t Deadline, RAK3172_Uplink_Callback_t Callback, void* p_Arg, uint32_t* p_Frame, bool Coalesce)
+{
+    uint8_t Index;
+    uint8_t Count;
+    uint8_t MaxPayload;
+    uint8_t Depth;
+    TickType_t Now;
+    TickType_t Ticks;
+    RAK3172_Uplink_t* Uplink;
+    RAK3172_Uplink_Drop_t Drops[CONFIG_RAK3172_UPLINK_QUEUE_LENGTH];
+
+    Now = xTaskGetTickCount();
+    Ticks = Deadline / portTICK_PERIOD_MS;
+    if((Deadline > 0) && (Ticks == 0))
+    {
+        Ticks = 1;
+    }
+
+    MaxPayload = 0;
+    if(p_Device.LoRaWAN.Config.Valid & RAK_LORAWAN_CFG_BAND)
+    {
+        RAK3172_LoRaWAN_GetMaxPayload(p_Device.LoRaWAN.Config.Band, RAK3172_Uplink_GetDataRate(p_Device), &MaxPayload);
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    Count = RAK3172_Uplink_Expire(p_Device, Drops);
+
+    // Append the payload to a queued uplink for the same port when the frame has enough space for both payloads. The payloads are concatenated
+    // without framing, so only uplinks of submissions, which allow it, are combined. The maximum payload always fits into the payload buffer.
+    for(uint8_t i = 0; (i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH) && Coalesce; i++)
+    {
+        Uplink = &p_Device.LoRaWAN.Uplinks[i];
+        if((Uplink->State != RAK_UPLINK_QUEUED) || (Uplink->isCoalescing == false) || (Uplink->Port != Port) || (Uplink->Confirmed != Confirmed) ||
+           (Uplink->Retries != Retries) || (Uplink->Callback != Callback) || (Uplink->Arg != p_Arg) || ((Uplink->Length + Length) > MaxPayload))
+        {
+            continue;
+        }
+
+        memcpy(&Uplink->Payload[Uplink->Length], p_Buffer, Length);
+        Uplink->Length += Length;
+        Uplink->Priority = std::max(Uplink->Priority, Priority);
+
+        // The merged uplink expires with the earlier deadline.
+        if((Ticks > 0) && ((Uplink->Deadline == 0) || (((Now - Uplink->Queued) + Ticks) < Uplink->Deadline)))
+        {
+            Uplink->Deadline = (Now - Uplink->Queued) + Ticks;
+        }
+
+        p_Device.LoRaWAN.UplinkStats.Coalesced++;
+
+        if(p_Frame != NULL)
+        {
+            *p_Frame = Uplink->Frame;
+        }
+
+        xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+        RAK3172_Uplink_Notify(Drops, Count);
+
+        return RAK3172_ERR_OK;
+    }
+
+    Index = RAK3172_UPLINK_NONE;
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        if(p_Device.LoRaWAN.Uplinks[i].State == RAK_UPLINK_FREE)
+        {
+            Index = i;
+
+            break;
+        }
+    }
+
+    // The queue is full. Drop the newest queued uplink with the lowest priority when it has a lower priority than the new uplink.
+    if(Index == RAK3172_UPLINK_NONE)
+    {
+        for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+        {
+            Uplink = &p_Device.LoRaWAN.Uplinks[i];
+            if((Uplink->State != RAK_UPLINK_QUEUED) || (Uplink->Priority >= Priority))
+            {
+                continue;
+            }
+
+            if((Index == RAK3172_UPLINK_NONE) || (Uplink->Priority < p_Device.LoRaWAN.Uplinks[Index].Priority) ||
+               ((Uplink->Priority == p_Device.LoRaWAN.Uplinks[Index].Priority) && (static_cast<int32_t>(Uplink->Frame - p_Device.LoRaWAN.Uplinks[Index].Frame) > 0)))
+            {
+                Index = i;
+            }
+        }
+
+        if(Index != RAK3172_UPLINK_NONE)
+        {
+            RAK3172_Uplink_Remove(p_Device, Index, RAK3172_ERR_BUSY, &Drops[Count++]);
+            p_Device.LoRaWAN.UplinkStats.Dropped++;
+        }
+    }
+
+    if(Index == RAK3172_UPLINK_NONE)
+    {
+        xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+        RAK3172_Uplink_Notify(Drops, Count);
+
+        RAK3172_LOGE(TAG, "No free uplink available!");
+
+        return RAK3172_ERR_BUSY;
+    }
+
+    // The payload is stored binary and encoded straight into the send command by the dispatcher. Payloads, which don´t fit into the payload
+    // buffer, are encoded from the buffer of the application.
+    Uplink = &p_Device.LoRaWAN.Uplinks[Index];
+    if(Length <= sizeof(Uplink->Payload))
+    {
+        memcpy(Uplink->Payload, p_Buffer, Length);
+        Uplink->Data = Uplink->Payload;
+    }
+    else
+    {
+        Uplink->Data = static_cast<const uint8_t*>(p_Buffer);
+    }
+
+    Uplink->Port = Port;
+    Uplink->Confirmed = Confirmed;
+    Uplink->isLong = Length > 500;
+    Uplink->isCoalescing = Coalesce && (Uplink->Data == Uplink->Payload);
+    Uplink->Length = Length;
+    Uplink->Retries = Retries;
+    Uplink->BusyCounter = 0;
+    Uplink->Priority = Priority;
+    Uplink->Queued = Now;
+    Uplink->Deadline = Ticks;
+    Uplink->State = RAK_UPLINK_QUEUED;
+    Uplink->Callback = Callback;
+    Uplink->Arg = p_Arg;
+    Uplink->Frame = p_Device.LoRaWAN.NextFrame++;
+
+    Depth = 0;
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        if(p_Device.LoRaWAN.Uplinks[i].State == RAK_UPLINK_QUEUED)
+        {
+            Depth++;
+        }
+    }
+    p_Device.LoRaWAN.UplinkStats.MaxDepth = std::max(p_Device.LoRaWAN.UplinkStats.MaxDepth, Depth);
+
+    if(p_Frame != NULL)
+    {
+        *p_Frame = Uplink->Frame;
+    }
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    RAK3172_Uplink_Notify(Drops, Count);
+
+    RAK3172_Uplink_Dispatch(p_Device);
+
+    // The receive task must retry the uplink when the module has rejected the transmission.
+    RAK3172_Registry_Wake(p_Device);
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_Uplink_Confirm(RAK3172_t& p_Device, bool Success)
+{
+    bool isWaiting;
+
+    if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        return;
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+    isWaiting = (p_Device.LoRaWAN.ActiveUplink != RAK3172_UPLINK_NONE) && (p_Device.LoRaWAN.Uplinks[p_Device.LoRaWAN.ActiveUplink].State == RAK_UPLINK_WAIT_ACK);
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    if(isWaiting)
+    {
+        RAK3172_Uplink_Complete(p_Device, Success ? RAK3172_ERR_OK : RAK3172_ERR_INVALID_RESPONSE);
+        RAK3172_Uplink_Dispatch(p_Device);
+    }
+}
+
+TickType_t RAK3172_Uplink_Poll(RAK3172_t& p_Device)
+{
+    TickType_t Elapsed;
+    TickType_t Remaining;
+    RAK3172_Uplink_t* Uplink;
+
+    if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        return portMAX_DELAY;
+    }
+
+    RAK3172_Uplink_Dispatch(p_Device);
+
+    // Only a rejected uplink waits for the next transmission. All other states are completed by events.
+    Remaining = portMAX_DELAY;
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    if(p_Device.LoRaWAN.ActiveUplink != RAK3172_UPLINK_NONE)
+    {
+        Uplink = &p_Device.LoRaWAN.Uplinks[p_Device.LoRaWAN.ActiveUplink];
+        if(Uplink->State == RAK_UPLINK_PENDING)
+        {
+            Elapsed = xTaskGetTickCount() - Uplink->Start;
+            Remaining = 1;
+            if(Elapsed < (RAK3172_UPLINK_RETRY_DELAY / portTICK_PERIOD_MS))
+            {
+                Remaining = (RAK3172_UPLINK_RETRY_DELAY / portTICK_PERIOD_MS) - Elapsed;
+            }
+        }
+    }
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    return Remaining;
+}
+
+void RAK3172_Uplink_Abort(RAK3172_t& p_Device, RAK3172_Error_t Error)
+{
+    uint8_t Count;
+    RAK3172_Uplink_Drop_t Drops[CONFIG_RAK3172_UPLINK_QUEUE_LENGTH];
+
+    RAK3172_Uplink_Complete(p_Device, Error);
+
+    Count = 0;
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        if(p_Device.LoRaWAN.Uplinks[i].State == RAK_UPLINK_QUEUED)
+        {
+            RAK3172_Uplink_Remove(p_Device, i, Error, &Drops[Count++]);
+        }
+    }
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    RAK3172_Uplink_Notify(Drops, Count);
+}
+
+bool RAK3172_Uplink_isTransmitting(RAK3172_t& p_Device)
+{
+    bool isTransmitting;
+    RAK3172_Uplink_State_t State;
+
+    if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    isTransmitting = false;
+    if(p_Device.LoRaWAN.ActiveUplink != RAK3172_UPLINK_NONE)
+    {
+        State = p_Device.LoRaWAN.Uplinks[p_Device.LoRaWAN.ActiveUplink].State;
+        isTransmitting = (State == RAK_UPLINK_SENDING) || (State == RAK_UPLINK_WAIT_ACK);
+    }
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    return isTransmitting;
+}
+
+bool RAK3172_Uplink_isDataRateKnown(const RAK3172_t& p_Device)
+{
+    // The network can lower the data rate when ADR is enabled.
+    return p_Device.LoRaWAN.isDataRateValid && (((p_Device.LoRaWAN.Config.Valid & RAK_LORAWAN_CFG_ADR) == 0) || (p_Device.LoRaWAN.Config.UseADR == false));
+}
+
+RAK3172_DataRate_t RAK3172_Uplink_GetDataRate(const RAK3172_t& p_Device)
+{
+    if(RAK3172_Uplink_isDataRateKnown(p_Device))
+    {
+        return p_Device.LoRaWAN.DataRate;
+    }
+
+    return RAK_DR_0;
+}
+
+RAK3172_Error_t RAK3172_Uplink_GetStats(RAK3172_t& p_Device, RAK3172_Uplink_Stats_t* p_Stats)
+{
+    if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    *p_Stats = p_Device.LoRaWAN.UplinkStats;
+    p_Stats->Depth = 0;
+    for(uint8_t i = 0; i < CONFIG_RAK3172_UPLINK_QUEUE_LENGTH; i++)
+    {
+        if(p_Device.LoRaWAN.Uplinks[i].State == RAK_UPLINK_QUEUED)
+        {
+            p_Stats->Depth++;
+        }
+    }
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    return RAK3172_ERR_OK;
+}
+
+#endif
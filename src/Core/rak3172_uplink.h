@@ -0,0 +1,105 @@
+ /*
+ * rak3172_uplink.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: LoRaWAN uplink tracker for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_UPLINK_H_
+#define RAK3172_UPLINK_H_
+
+#include "rak3172_defs.h"
+
+/** @brief Index of the active uplink when no uplink is active.
+ */
+#define RAK3172_UPLINK_NONE                                     0xFF
+
+/** @brief          Allocate the uplinks and the lock for a device.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_NO_MEM when the uplinks or the lock cannot be created
+ */
+RAK3172_Error_t RAK3172_Uplink_Init(RAK3172_t& p_Device);
+
+/** @brief          Abort all queued uplinks and release the uplinks of a device.
+ *  @param p_Device RAK3172 device object
+ */
+void RAK3172_Uplink_Deinit(RAK3172_t& p_Device);
+
+/** @brief              Queue an uplink. Queued uplinks are transmitted by priority and in the order of submission.
+ *                      With coalescing, the payload is appended to a queued coalescing uplink with the same port and settings when both payloads
+ *                      fit into one frame. Payloads longer than #RAK3172_UPLINK_MAX_PAYLOAD aren´t copied and must be valid until the uplink is completed.
+ *  @param p_Device     RAK3172 device object
+ *  @param Port         LoRaWAN port
+ *  @param p_Buffer     Pointer to payload
+ *  @param Length       Payload length in bytes. Payloads with more than 500 bytes use the long payload command
+ *  @param Confirmed    Enable message confirmation
+ *  @param Retries      Number of confirmed payload retransmissions
+ *  @param Priority     Priority of the uplink
+ *  @param Deadline     Maximum queue time in milliseconds. 0 when the uplink doesn´t expire
+ *  @param Callback     (Optional) Completion callback
+ *  @param p_Arg        (Optional) Argument for the completion callback
+ *  @param p_Frame      (Optional) Pointer to frame number of the uplink
+ *  @param Coalesce     Allow later payloads to be appended to this uplink and append this payload to a queued uplink
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_BUSY when the uplink queue is full
+ */
+RAK3172_Error_t RAK3172_Uplink_Submit(RAK3172_t& p_Device, uint8_t Port, const void* p_Buffer, uint16_t Length, bool Confirmed, uint8_t Retries, RAK3172_Uplink_Priority_t Priority, uint32_t Deadline, RAK3172_Uplink_Callback_t Callback, void* p_Arg, uint32_t* p_Frame, bool Coalesce);
+
+/** @brief          Complete the active uplink with a confirmation event. Called from the receive task.
+ *  @param p_Device RAK3172 device object
+ *  @param Success  #true when the uplink was confirmed
+ */
+void RAK3172_Uplink_Confirm(RAK3172_t& p_Device, bool Success);
+
+/** @brief          Transmit the next queued uplink when the module is ready. Called from the receive task.
+ *  @param p_Device RAK3172 device object
+ *  @return         Time in ticks until the active uplink is transmitted again or portMAX_DELAY when no transmission is pending
+ */
+TickType_t RAK3172_Uplink_Poll(RAK3172_t& p_Device);
+
+/** @brief          Complete the active uplink and all queued uplinks with an error.
+ *  @param p_Device RAK3172 device object
+ *  @param Error    Error code for the uplinks
+ */
+void RAK3172_Uplink_Abort(RAK3172_t& p_Device, RAK3172_Error_t Error);
+
+/** @brief          Check if the module transmits the active uplink. The active uplink has a command or a confirmation in flight.
+ *  @param p_Device RAK3172 device object
+ *  @return         #true when the module transmits the active uplink
+ */
+bool RAK3172_Uplink_isTransmitting(RAK3172_t& p_Device);
+
+/** @brief          Check if the data rate for the next uplink is known.
+ *  @param p_Device RAK3172 device object
+ *  @return         #true when the data rate was set with #RAK3172_LoRaWAN_SetDataRate and ADR is disabled
+ */
+bool RAK3172_Uplink_isDataRateKnown(const RAK3172_t& p_Device);
+
+/** @brief          Get the data rate for the next uplink.
+ *  @param p_Device RAK3172 device object
+ *  @return         Data rate set with #RAK3172_LoRaWAN_SetDataRate or DR0 when the data rate is unknown or ADR is enabled
+ */
+RAK3172_DataRate_t RAK3172_Uplink_GetDataRate(const RAK3172_t& p_Device);
+
+/** @brief          Get the statistics of the uplink scheduler.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Stats  Pointer to statistics
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_STATE when the uplinks aren´t initialized
+ */
+RAK3172_Error_t RAK3172_Uplink_GetStats(RAK3172_t& p_Device, RAK3172_Uplink_Stats_t* p_Stats);
+
+#endif /* RAK3172_UPLINK_H_ */
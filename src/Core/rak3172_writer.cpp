@@ -0,0 +1,137 @@
+ /*
+ * rak3172_writer.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Scatter / gather AT command writer for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <algorithm>
+
+#include "rak3172_writer.h"
+#include "rak3172_hex.h"
+
+/** @brief Staging buffer of the command writer.
+ */
+typedef struct
+{
+    const RAK3172_t* Device;                        /**< Pointer to RAK3172 device object. */
+    char Data[RAK3172_WRITER_BUFFER_SIZE];          /**< Buffered characters. */
+    size_t Used;                                    /**< Number of buffered characters. */
+} RAK3172_Writer_t;
+
+/** @brief          Write the buffered characters to the UART.
+ *  @param p_Writer Pointer to writer
+ */
+static void RAK3172_Writer_Flush(RAK3172_Writer_t* p_Writer)
+{
+    if(p_Writer->Used > 0)
+    {
+        uart_write_bytes(p_Writer->Device->UART.Interface, p_Writer->Data, p_Writer->Used);
+        p_Writer->Used = 0;
+    }
+}
+
+/** @brief          Add text to the staging buffer. Text, which doesn´t fit into the buffer, is written without copying.
+ *  @param p_Writer Pointer to writer
+ *  @param p_Text   Pointer to text
+ *  @param Length   Text length in bytes
+ */
+static void RAK3172_Writer_Put(RAK3172_Writer_t* p_Writer, const char* p_Text, size_t Length)
+{
+    if(Length > (sizeof(p_Writer->Data) - p_Writer->Used))
+    {
+        RAK3172_Writer_Flush(p_Writer);
+
+        if(Length >= sizeof(p_Writer->Data))
+        {
+            uart_write_bytes(p_Writer->Device->UART.Interface, p_Text, Length);
+
+            return;
+        }
+    }
+
+    memcpy(&p_Writer->Data[p_Writer->Used], p_Text, Length);
+    p_Writer->Used += Length;
+}
+
+void RAK3172_Writer_Write(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count)
+{
+    RAK3172_Writer_t Writer;
+
+    Writer.Device = &p_Device;
+    Writer.Used = 0;
+
+    for(uint8_t i = 0; i < Count; i++)
+    {
+        switch(p_Fragments[i].Type)
+        {
+            case RAK_FRAGMENT_TEXT:
+            {
+                RAK3172_Writer_Put(&Writer, static_cast<const char*>(p_Fragments[i].Data), p_Fragments[i].Length);
+
+                break;
+            }
+            case RAK_FRAGMENT_NUMBER:
+            {
+                char Digits[10];
+                uint8_t Length;
+                uint32_t Value;
+
+                // Convert the number from the last to the first digit.
+                Length = 0;
+                Value = p_Fragments[i].Value;
+                do
+                {
+                    Digits[sizeof(Digits) - 1 - Length++] = '0' + (Value % 10);
+                    Value /= 10;
+                } while(Value > 0);
+
+                RAK3172_Writer_Put(&Writer, &Digits[sizeof(Digits) - Length], Length);
+
+                break;
+            }
+            case RAK_FRAGMENT_HEX:
+            {
+                size_t Chunk;
+                size_t Remaining;
+                const uint8_t* Data;
+
+                // Encode the data in chunks, which fill the free space of the buffer.
+                Data = static_cast<const uint8_t*>(p_Fragments[i].Data);
+                Remaining = p_Fragments[i].Length;
+                while(Remaining > 0)
+                {
+                    Chunk = std::min(Remaining, (sizeof(Writer.Data) - Writer.Used) / 2);
+                    if(Chunk == 0)
+                    {
+                        RAK3172_Writer_Flush(&Writer);
+
+                        continue;
+                    }
+
+                    RAK3172_Hex_Encode(Data, Chunk, &Writer.Data[Writer.Used]);
+                    Writer.Used += 2 * Chunk;
+                    Data += Chunk;
+                    Remaining -= Chunk;
+                }
+
+                break;
+            }
+        }
+    }
+
+    RAK3172_Writer_Put(&Writer, "\r\n", 2);
+    RAK3172_Writer_Flush(&Writer);
+}
@@ -0,0 +1,77 @@
+ /*
+ * rak3172_writer.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Scatter / gather AT command writer for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_WRITER_H_
+#define RAK3172_WRITER_H_
+
+#include <string.h>
+
+#include "rak3172_defs.h"
+
+/** @brief Size of the staging buffer of the command writer in bytes.
+ */
+#define RAK3172_WRITER_BUFFER_SIZE                              64
+
+/** @brief          Create a text fragment.
+ *  @param p_Text   Pointer to text
+ *  @param Length   Text length in bytes
+ *  @return         Fragment
+ */
+inline __attribute__((always_inline)) RAK3172_Fragment_t RAK3172_Fragment_Text(const char* p_Text, size_t Length)
+{
+    return {RAK_FRAGMENT_TEXT, p_Text, Length, 0};
+}
+
+/** @brief          Create a text fragment from a terminated string.
+ *  @param p_Text   Pointer to text
+ *  @return         Fragment
+ */
+inline __attribute__((always_inline)) RAK3172_Fragment_t RAK3172_Fragment_Text(const char* p_Text)
+{
+    return {RAK_FRAGMENT_TEXT, p_Text, strlen(p_Text), 0};
+}
+
+/** @brief          Create a decimal number fragment.
+ *  @param Value    Number
+ *  @return         Fragment
+ */
+inline __attribute__((always_inline)) RAK3172_Fragment_t RAK3172_Fragment_Number(uint32_t Value)
+{
+    return {RAK_FRAGMENT_NUMBER, NULL, 0, Value};
+}
+
+/** @brief          Create a hex fragment. The data isn´t copied and must be valid until the fragment is written.
+ *  @param p_Data   Pointer to binary data
+ *  @param Length   Data length in bytes
+ *  @return         Fragment
+ */
+inline __attribute__((always_inline)) RAK3172_Fragment_t RAK3172_Fragment_Hex(const void* p_Data, size_t Length)
+{
+    return {RAK_FRAGMENT_HEX, p_Data, Length, 0};
+}
+
+/** @brief              Write an AT command from fragments and the terminating CR and LF to the UART of a device. The fragments are encoded
+ *                      into a small staging buffer on the stack, so no memory is allocated. Long text fragments are written without copying.
+ *  @param p_Device     RAK3172 device object
+ *  @param p_Fragments  Pointer to fragments
+ *  @param Count        Number of fragments
+ */
+void RAK3172_Writer_Write(const RAK3172_t& p_Device, const RAK3172_Fragment_t* p_Fragments, uint8_t Count);
+
+#endif /* RAK3172_WRITER_H_ */
@@ -21,20 +21,38 @@
 
 #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
 
-#include "../../Arch/Logging/rak3172_logging.h"
-#include "../../Arch/Timer/rak3172_timer.h"
+#include <atomic>
 
-#ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
-    #include "../../Arch/PwrMgmt/rak3172_pwrmgmt.h"
-#endif
+#include "../../Core/rak3172_hex.h"
+#include "../../Core/rak3172_parser.h"
+#include "../../Core/rak3172_rxqueue.h"
+#include "../../Core/rak3172_uplink.h"
+#include "../../Arch/Logging/rak3172_logging.h"
+#include "../../Arch/PwrMgmt/rak3172_pwrmgmt.h"
 
 #include "rak3172.h"
 
+/** @brief Maximum application payload in bytes for the data rates DR0 - DR7 of each band (LoRaWAN Regional Parameters, without FOpts).
+ *         The table is ordered like #RAK3172_Band_t. 0 marks a data rate, which isn´t defined for uplinks. The module uses the values,
+ *         which aren´t repeater compatible. AS923 uses the values without dwell time limit.
+ */
+static const uint8_t _RAK3172_LoRaWAN_MaxPayload[][8] = {
+    {51, 51, 51, 115, 242, 242, 242, 242},  // EU433
+    {51, 51, 51, 115, 242, 242, 0, 0},      // CN470
+    {51, 51, 51, 115, 242, 242, 242, 242},  // RU864
+    {51, 51, 51, 115, 242, 242, 0, 242},    // IN865
+    {51, 51, 51, 115, 242, 242, 242, 242},  // EU868
+    {11, 53, 125, 242, 242, 0, 0, 0},       // US915
+    {51, 51, 51, 115, 242, 242, 242, 0},    // AU915
+    {51, 51, 51, 115, 242, 242, 0, 0},      // KR920
+    {51, 51, 115, 115, 242, 242, 242, 242}, // AS923
+};
+
 static const char* TAG = "RAK3172_LoRaWAN";
 
 RAK3172_Error_t RAK3172_LoRaWAN_Init(RAK3172_t& p_Device, uint8_t TxPwr, RAK3172_JoinMode_t JoinMode, const uint8_t* const p_Key1, const uint8_t* const p_Key2, const uint8_t* const p_Key3, RAK3172_Class_t Class, RAK3172_Band_t Band, RAK3172_SubBand_t Subband, bool UseADR, uint32_t Timeout)
 {
-    std::string Command;
+    RAK3172_LoRaWAN_Config_t Config;
 
     if(((Class != RAK_CLASS_A) && (Class != RAK_CLASS_B) && (Class != RAK_CLASS_C)) || (p_Key1 == NULL) || (p_Key2 == NULL) || (p_Key3 == NULL))
     {
@@ -54,43 +72,35 @@ RAK3172_Error_t RAK3172_LoRaWAN_Init(RAK3172_t& p_Device, uint8_t TxPwr, RAK3172
 
     p_Device.Internal.isBusy = false;
 
-    Command = "AT+CLASS=";
-    Command += Class;
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, Command));
-
-	RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetADR(p_Device, UseADR));
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetBand(p_Device, Band));
-
-    if(Subband != RAK_SUB_BAND_NONE)
-    {
-        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetSubBand(p_Device, Subband))
-    }
-
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetTxPwr(p_Device, TxPwr));
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetJoinMode(p_Device, JoinMode));
+    // Only the settings that differ from the cached module state are transmitted.
+    RAK3172_LoRaWAN_Config_Begin(&Config);
+    RAK3172_LoRaWAN_Config_SetClass(&Config, Class);
+    RAK3172_LoRaWAN_Config_SetADR(&Config, UseADR);
+    RAK3172_LoRaWAN_Config_SetBand(&Config, Band);
+    RAK3172_LoRaWAN_Config_SetSubBand(&Config, Subband);
+    RAK3172_LoRaWAN_Config_SetTxPwr(&Config, TxPwr);
 
-    p_Device.LoRaWAN.Join = JoinMode;
-    if(p_Device.LoRaWAN.Join == RAK_JOIN_OTAA)
+    if(JoinMode == RAK_JOIN_OTAA)
     {
         RAK3172_LOGI(TAG, "Using OTAA mode");
 
-        return RAK3172_LoRaWAN_SetOTAAKeys(p_Device, p_Key1, p_Key2, p_Key3);
+        RAK3172_LoRaWAN_Config_SetOTAAKeys(&Config, p_Key1, p_Key2, p_Key3);
     }
     else
     {
         RAK3172_LOGI(TAG, "Using ABP mode");
 
-        return RAK3172_LoRaWAN_SetABPKeys(p_Device, p_Key1, p_Key2, p_Key3);
+        RAK3172_LoRaWAN_Config_SetABPKeys(&Config, p_Key1, p_Key2, p_Key3);
     }
 
-    return RAK3172_ERR_INVALID_ARG;
+    return RAK3172_LoRaWAN_Config_Commit(p_Device, &Config);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(const RAK3172_t& p_Device, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY)
+RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(RAK3172_t& p_Device, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY)
 {
-    std::string AppEUIString;
-    std::string DevEUIString;
-    std::string AppKeyString;
+    std::string AppEUIString = "AT+APPEUI=";
+    std::string DevEUIString = "AT+DEVEUI=";
+    std::string AppKeyString = "AT+APPKEY=";
 
     if((p_DEVEUI == NULL) || (p_APPEUI == NULL) || (p_APPKEY == NULL))
     {
@@ -105,37 +115,28 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetOTAAKeys(const RAK3172_t& p_Device, const uin
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    // Copy the keys from the buffer into a string.
-    char Buffer[3];
-    for(uint8_t i = 0; i < 8; i++)
-    {
-        sprintf(Buffer, "%02X", p_APPEUI[i]);
-        AppEUIString += std::string(Buffer);
-
-        sprintf(Buffer, "%02X", p_DEVEUI[i]);
-        DevEUIString += std::string(Buffer);
-    }
-
-    for(uint8_t i = 0; i < 16; i++)
-    {
-        sprintf(Buffer, "%02X", p_APPKEY[i]);
-        AppKeyString += std::string(Buffer);
-    }
+    // Encode the keys into the commands.
+    RAK3172_Hex_Append(&AppEUIString, p_APPEUI, 8);
+    RAK3172_Hex_Append(&DevEUIString, p_DEVEUI, 8);
+    RAK3172_Hex_Append(&AppKeyString, p_APPKEY, 16);
 
     RAK3172_LOGD(TAG, "DEVEUI: %s - Size: %u", DevEUIString.c_str(), DevEUIString.length());
     RAK3172_LOGD(TAG, "APPEUI: %s - Size: %u", AppEUIString.c_str(), AppEUIString.length());
     RAK3172_LOGD(TAG, "APPKEY: %s - Size: %u", AppKeyString.c_str(), AppKeyString.length());
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DEVEUI=" + DevEUIString));
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+APPEUI=" + AppEUIString));
-    return RAK3172_SendCommand(p_Device, "AT+APPKEY=" + AppKeyString);
+    // The keys are no longer known when the transmission fails.
+    RAK3172_LoRaWAN_Config_Invalidate(p_Device, RAK_LORAWAN_CFG_OTAA | RAK_LORAWAN_CFG_ABP);
+
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, DevEUIString));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, AppEUIString));
+    return RAK3172_SendCommand(p_Device, AppKeyString);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint8_t* const p_APPSKEY, const uint8_t* const p_NWKSKEY, const uint8_t* const p_DEVADDR)
+RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(RAK3172_t& p_Device, const uint8_t* const p_APPSKEY, const uint8_t* const p_NWKSKEY, const uint8_t* const p_DEVADDR)
 {
-    std::string AppSKEYString;
-    std::string NwkSKEYString;
-    std::string DevADDRString;
+    std::string AppSKEYString = "AT+APPSKEY=";
+    std::string NwkSKEYString = "AT+NWKSKEY=";
+    std::string DevADDRString = "AT+DEVADDR=";
 
     if((p_APPSKEY == NULL) || (p_NWKSKEY == NULL) || (p_DEVADDR == NULL))
     {
@@ -150,39 +151,88 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetABPKeys(const RAK3172_t& p_Device, const uint
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    // Copy the keys from the buffer into a string.
-    char Buffer[3];
-    for(uint8_t i = 0; i < 16; i++)
-    {
-        sprintf(Buffer, "%02X", p_APPSKEY[i]);
-        AppSKEYString += std::string(Buffer);
-
-        sprintf(Buffer, "%02X", p_NWKSKEY[i]);
-        NwkSKEYString += std::string(Buffer);
-    }
-
-    for(uint8_t i = 0; i < 4; i++)
-    {
-        sprintf(Buffer, "%02X", p_DEVADDR[i]);
-        DevADDRString += std::string(Buffer);
-    }
+    // Encode the keys into the commands.
+    RAK3172_Hex_Append(&AppSKEYString, p_APPSKEY, 16);
+    RAK3172_Hex_Append(&NwkSKEYString, p_NWKSKEY, 16);
+    RAK3172_Hex_Append(&DevADDRString, p_DEVADDR, 4);
 
     RAK3172_LOGD(TAG, "APPSKEY: %s - Size: %u", AppSKEYString.c_str(), AppSKEYString.length());
     RAK3172_LOGD(TAG, "NWKSKEY: %s - Size: %u", NwkSKEYString.c_str(), NwkSKEYString.length());
     RAK3172_LOGD(TAG, "DEVADDR: %s - Size: %u", DevADDRString.c_str(), DevADDRString.length());
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+APPSKEY=" + AppSKEYString));
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NWKSKEY=" + NwkSKEYString));
-    return RAK3172_SendCommand(p_Device, "AT+DEVADDR=" + DevADDRString);
+    // The keys are no longer known when the transmission fails.
+    RAK3172_LoRaWAN_Config_Invalidate(p_Device, RAK_LORAWAN_CFG_OTAA | RAK_LORAWAN_CFG_ABP);
+
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, AppSKEYString));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, NwkSKEYString));
+    return RAK3172_SendCommand(p_Device, DevADDRString);
+}
+
+/** @brief          Transmit the join command.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Join   Pointer to join handle
+ *  @return         RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t RAK3172_LoRaWAN_SendJoin(RAK3172_t& p_Device, RAK3172_Join_t* p_Join)
+{
+    return RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(p_Join->EnableAutoJoin) + ":" + std::to_string(p_Join->Interval) + ":" + std::to_string(p_Join->Attempts));
+}
+
+/** @brief          Finish a join process.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Join   Pointer to join handle
+ *  @param Error    Result of the join process
+ *  @return         Result of the join process
+ */
+static RAK3172_Error_t RAK3172_LoRaWAN_FinishJoin(RAK3172_t& p_Device, RAK3172_Join_t* p_Join, RAK3172_Error_t Error)
+{
+    p_Join->isActive = false;
+    p_Join->Error = Error;
+
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_End(p_Device);
+    #endif
+
+    // Release the device before the join is stopped, because the command is rejected otherwise.
+    p_Device.Internal.isBusy = false;
+    if(Error != RAK3172_ERR_OK)
+    {
+        RAK3172_LoRaWAN_StopJoin(p_Device);
+    }
+
+    return Error;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_StartJoin(RAK3172_t& p_Device, uint8_t Attempts, uint32_t Timeout, bool Block, bool EnableAutoJoin, uint8_t Interval, RAK3172_Wait_t on_Wait)
 {
-    #ifdef CONFIG_RAK3172_USE_RUI3
-        uint32_t TimeNow;
+    RAK3172_Join_t Join;
+
+    if((Attempts == 0) && (Block == true))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    #ifndef CONFIG_RAK3172_USE_RUI3
+        else if(Block == false)
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
     #endif
 
-    if(((Attempts == 0) && (Block == true)) || (Interval < 7))
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_StartJoinAsync(p_Device, &Join, Attempts, Timeout, EnableAutoJoin, Interval));
+
+    if(Block == false)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    return RAK3172_LoRaWAN_WaitJoin(p_Device, &Join, true, on_Wait);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_StartJoinAsync(RAK3172_t& p_Device, RAK3172_Join_t* p_Join, uint8_t Attempts, uint32_t Timeout, bool EnableAutoJoin, uint8_t Interval)
+{
+    RAK3172_Error_t Error;
+
+    if((p_Join == NULL) || (Interval < 7))
     {
         return RAK3172_ERR_INVALID_ARG;
     }
@@ -190,106 +240,122 @@ RAK3172_Error_t RAK3172_LoRaWAN_StartJoin(RAK3172_t& p_Device, uint8_t Attempts,
     {
         return RAK3172_ERR_BUSY;
     }
-    else if(p_Device.LoRaWAN.isJoined)
-    {
-        return RAK3172_ERR_OK;
-    }
     else if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
-    #ifndef CONFIG_RAK3172_USE_RUI3
-        else if(Block == false)
-        {
-            return RAK3172_ERR_INVALID_ARG;
-        }
-    #endif
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(EnableAutoJoin) + ":" + std::to_string(Interval) + ":" + std::to_string(Attempts)));
+    p_Join->Start = xTaskGetTickCount();
+    p_Join->Timeout = (Timeout * 1000UL) / portTICK_PERIOD_MS;
+    p_Join->Attempts = Attempts;
+    p_Join->EnableAutoJoin = EnableAutoJoin;
+    p_Join->Interval = Interval;
+    p_Join->isActive = false;
+    p_Join->Error = RAK3172_ERR_OK;
 
-    #ifndef CONFIG_RAK3172_USE_RUI3
-        p_Device.Internal.isJoinEvent = false;
-    #endif
+    if(p_Device.LoRaWAN.isJoined)
+    {
+        return RAK3172_ERR_OK;
+    }
 
+    // Prepare the join state before the command is transmitted, because the module can answer immediately.
+    xEventGroupClearBits(p_Device.Internal.Events, RAK3172_EVENT_JOINED | RAK3172_EVENT_JOIN_FAILED | RAK3172_EVENT_JOIN_RETRY);
     p_Device.LoRaWAN.AttemptCounter = Attempts + 1;
-    p_Device.Internal.isBusy = true;
 
-    #ifdef CONFIG_RAK3172_USE_RUI3
-        TimeNow = RAK3172_Timer_GetMilliseconds() / 1000ULL;
-        do
-        {
-            if((Timeout > 0) && (((RAK3172_Timer_GetMilliseconds() / 1000ULL) - TimeNow) >= (Timeout * 1000ULL)))
-            {
-                RAK3172_LOGE(TAG, "Join timeout!");
+    Error = RAK3172_LoRaWAN_SendJoin(p_Device, p_Join);
+    if(Error != RAK3172_ERR_OK)
+    {
+        p_Join->Error = Error;
 
-                RAK3172_LoRaWAN_StopJoin(p_Device);
+        return Error;
+    }
 
-                p_Device.Internal.isBusy = false;
+    p_Join->isActive = true;
+    p_Device.Internal.isBusy = true;
 
-                return RAK3172_ERR_TIMEOUT;
-            }
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_Begin(p_Device);
+    #endif
 
-            if(on_Wait != NULL)
-            {
-                on_Wait();
-            }
+    return RAK3172_ERR_OK;
+}
 
-            if(p_Device.LoRaWAN.AttemptCounter == 0)
+RAK3172_Error_t RAK3172_LoRaWAN_WaitJoin(RAK3172_t& p_Device, RAK3172_Join_t* p_Join, bool Block, RAK3172_Wait_t on_Wait)
+{
+    EventBits_t Bits;
+    TickType_t Elapsed;
+    TickType_t Wait;
+
+    if(p_Join == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Join->isActive == false)
+    {
+        return p_Join->Error;
+    }
+
+    do
+    {
+        Wait = portMAX_DELAY;
+        if(p_Join->Timeout > 0)
+        {
+            Elapsed = xTaskGetTickCount() - p_Join->Start;
+            if(Elapsed >= p_Join->Timeout)
             {
-                RAK3172_LoRaWAN_StopJoin(p_Device);
+                RAK3172_LOGE(TAG, "Join timeout!");
 
-                break;
+                return RAK3172_LoRaWAN_FinishJoin(p_Device, p_Join, RAK3172_ERR_TIMEOUT);
             }
 
-            RAK3172_PwrMagnt_EnterLightSleep(p_Device);
-
-            // We need this delay to prevent a task watchdog reset on ESP32.
-            vTaskDelay(20 / portTICK_PERIOD_MS);
-        } while((Block == true) && (p_Device.LoRaWAN.isJoined == false) && (p_Device.Internal.isBusy == true));
+            Wait = p_Join->Timeout - Elapsed;
+        }
 
-        if((Block == true) && (p_Device.LoRaWAN.isJoined == false))
+        // Wake up periodically only when a wait hook has to be called.
+        if(on_Wait != NULL)
         {
-            return RAK3172_ERR_FAIL;
+            Wait = std::min(Wait, static_cast<TickType_t>(RAK3172_WAIT_INTERVAL / portTICK_PERIOD_MS));
         }
-    #else
-        do
+
+        if(Block == false)
         {
-            // Join event has occured and join was not successful. Start a new join.
-            if((p_Device.Internal.isJoinEvent == true) && (p_Device.LoRaWAN.isJoined == false))
-            {
-                RAK3172_SendCommand(p_Device, "AT+JOIN=1:" + std::to_string(EnableAutoJoin) + ":" + std::to_string(Interval) + ":" + std::to_string(Attempts));
-                p_Device.Internal.isJoinEvent = false;
-            }
-            // Join event has occured and join was successful.
-            else if((p_Device.Internal.isJoinEvent == true) && (p_Device.LoRaWAN.isJoined == true))
-            {
-                break;
-            }
+            Wait = 0;
+        }
 
-            if(on_Wait != NULL)
-            {
-                on_Wait();
-            }
+        // Sleep until the module reports the result of the join.
+        #ifdef CONFIG_RAK3172_PWRMGMT_LIGHT_SLEEP
+            Wait = RAK3172_PwrMgmt_Sleep(p_Device, Wait);
+        #endif
 
-            if(p_Device.LoRaWAN.AttemptCounter == 0)
+        Bits = xEventGroupWaitBits(p_Device.Internal.Events, RAK3172_EVENT_JOINED | RAK3172_EVENT_JOIN_FAILED | RAK3172_EVENT_JOIN_RETRY, pdTRUE, pdFALSE, Wait);
+        if(Bits & RAK3172_EVENT_JOINED)
+        {
+            return RAK3172_LoRaWAN_FinishJoin(p_Device, p_Join, RAK3172_ERR_OK);
+        }
+        else if(Bits & RAK3172_EVENT_JOIN_FAILED)
+        {
+            return RAK3172_LoRaWAN_FinishJoin(p_Device, p_Join, RAK3172_ERR_FAIL);
+        }
+        #ifndef CONFIG_RAK3172_USE_RUI3
+            // Join attempt has failed. Start a new join.
+            else if(Bits & RAK3172_EVENT_JOIN_RETRY)
             {
-                RAK3172_LoRaWAN_StopJoin(p_Device);
+                if(RAK3172_LoRaWAN_SendJoin(p_Device, p_Join) != RAK3172_ERR_OK)
+                {
+                    return RAK3172_LoRaWAN_FinishJoin(p_Device, p_Join, RAK3172_ERR_FAIL);
+                }
 
-                break;
+                p_Device.Internal.isBusy = true;
             }
+        #endif
 
-            RAK3172_PwrMagnt_EnterLightSleep(p_Device);
-
-            vTaskDelay(20 / portTICK_PERIOD_MS);
-        } while(p_Device.LoRaWAN.isJoined == false);
-
-        if(p_Device.LoRaWAN.isJoined == false)
+        if(on_Wait != NULL)
         {
-            return RAK3172_ERR_FAIL;
+            on_Wait();
         }
-    #endif
+    } while(Block);
 
-    return RAK3172_ERR_OK;
+    return RAK3172_ERR_BUSY;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_StopJoin(const RAK3172_t& p_Device)
@@ -325,18 +391,126 @@ bool RAK3172_LoRaWAN_isJoined(RAK3172_t& p_Device, bool Refresh)
     return p_Device.LoRaWAN.isJoined;
 }
 
+/** @brief Completion state of a blocking transmission.
+ */
+typedef struct
+{
+    TaskHandle_t Task;                                  /**< Task which waits for the uplink. */
+    RAK3172_Error_t Error;                              /**< Result of the uplink. */
+    std::atomic<bool> isDone;                           /**< #true when the uplink is completed. */
+} RAK3172_LoRaWAN_TxResult_t;
+
+/** @brief          Completion callback for blocking transmissions.
+ *  @param Frame    Frame number of the uplink
+ *  @param Error    Result of the uplink
+ *  @param Latency  Time between transmission and acknowledgement in milliseconds
+ *  @param p_Arg    Pointer to transmission result
+ */
+static void RAK3172_LoRaWAN_OnTransmit(uint32_t Frame, RAK3172_Error_t Error, uint32_t Latency, void* p_Arg)
+{
+    TaskHandle_t Task;
+    RAK3172_LoRaWAN_TxResult_t* Result = static_cast<RAK3172_LoRaWAN_TxResult_t*>(p_Arg);
+
+    RAK3172_LOGD(TAG, "Uplink %u completed after %u ms with error 0x%X", Frame, Latency, static_cast<int>(Error));
+
+    // The result lives on the stack of the waiting task and is invalid as soon as the uplink is marked as done.
+    Task = Result->Task;
+    Result->Error = Error;
+    Result->isDone.store(true, std::memory_order_release);
+    xTaskNotifyGive(Task);
+}
+
 RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const uint8_t* const p_Buffer, uint16_t Length, uint8_t Retries)
 {
-    return RAK3172_LoRaWAN_Transmit(p_Device, Port, p_Buffer, Length, Retries);
+    return RAK3172_LoRaWAN_Transmit(p_Device, Port, static_cast<const void*>(p_Buffer), Length, Retries);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, uint8_t Retries, bool Confirmed, RAK3172_Wait_t Wait)
 {
-    std::string Payload;
-    std::string Status;
-    char Buffer[3];
+    RAK3172_Error_t Error;
+    RAK3172_LoRaWAN_TxResult_t Result;
 
-    if(((p_Buffer == NULL) && (Length == 0)) || (Length > 1000) || (Port == 0) || (Port > 233) || (Retries > 7))
+    if((p_Buffer != NULL) && (Length == 0))
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    Result.Task = xTaskGetCurrentTaskHandle();
+    Result.Error = RAK3172_ERR_OK;
+    Result.isDone = false;
+
+    // Clear a stale notification before the uplink is queued.
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    // Long payloads are transmitted with a higher baud rate.
+    #ifdef CONFIG_RAK3172_UART_USE_BURST
+        if(Length > 500)
+        {
+            RAK3172_ERROR_CHECK(RAK3172_BeginBurst(p_Device));
+        }
+    #endif
+
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_Begin(p_Device);
+    #endif
+
+    // The callback can complete the uplink before the function returns. So only a rejected uplink is completed here.
+    Error = RAK3172_LoRaWAN_TransmitAsync(p_Device, Port, p_Buffer, Length, Retries, Confirmed, RAK3172_LoRaWAN_OnTransmit, &Result);
+    if(Error != RAK3172_ERR_OK)
+    {
+        Result.Error = Error;
+        Result.isDone = true;
+    }
+
+    // Block until the receive task completes the uplink. The wait hook is called periodically when used.
+    while(Result.isDone.load(std::memory_order_acquire) == false)
+    {
+        TickType_t Timeout;
+
+        Timeout = portMAX_DELAY;
+        if(Wait)
+        {
+            Wait();
+            Timeout = RAK3172_WAIT_INTERVAL / portTICK_PERIOD_MS;
+        }
+
+        // Sleep until the module reports the transmission or the acknowledgement.
+        #ifdef CONFIG_RAK3172_PWRMGMT_LIGHT_SLEEP
+            Timeout = RAK3172_PwrMgmt_Sleep(p_Device, Timeout);
+        #endif
+
+        ulTaskNotifyTake(pdTRUE, Timeout);
+    }
+
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_End(p_Device);
+    #endif
+
+    #ifdef CONFIG_RAK3172_UART_USE_BURST
+        if(Length > 500)
+        {
+            RAK3172_EndBurst(p_Device);
+        }
+    #endif
+
+    return Result.Error;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_TransmitAsync(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, uint8_t Retries, bool Confirmed, RAK3172_Uplink_Callback_t Callback, void* p_Arg, uint32_t* p_Frame)
+{
+    return RAK3172_LoRaWAN_Schedule(p_Device, Port, p_Buffer, Length, RAK_UPLINK_PRIO_NORMAL, 0, Retries, Confirmed, Callback, p_Arg, p_Frame);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Schedule(RAK3172_t& p_Device, uint8_t Port, const void* const p_Buffer, uint16_t Length, RAK3172_Uplink_Priority_t Priority, uint32_t Deadline, uint8_t Retries, bool Confirmed, RAK3172_Uplink_Callback_t Callback, void* p_Arg, uint32_t* p_Frame, bool Coalesce)
+{
+    uint8_t MaxPayload;
+
+    if((p_Buffer == NULL) || (Length == 0) || (Length > 1000) || (Port == 0) || (Port > 233) || (Retries > 7) || (Priority > RAK_UPLINK_PRIO_HIGH))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    // Long payloads aren´t copied, so the application must know when the buffer can be reused.
+    else if((Length > RAK3172_UPLINK_MAX_PAYLOAD) && (Callback == NULL))
     {
         return RAK3172_ERR_INVALID_ARG;
     }
@@ -352,79 +526,52 @@ RAK3172_Error_t RAK3172_LoRaWAN_Transmit(RAK3172_t& p_Device, uint8_t Port, cons
     {
         return RAK3172_ERR_INVALID_MODE;
     }
-    else if(Length == 0)
-    {
-        return RAK3172_ERR_OK;
-    }
 
-    if(Confirmed)
+    // Reject a payload, which doesn´t fit into a frame of the current data rate, before it is transmitted to the module.
+    if((Length <= 500) && (p_Device.LoRaWAN.Config.Valid & RAK_LORAWAN_CFG_BAND) && RAK3172_Uplink_isDataRateKnown(p_Device) &&
+       (RAK3172_LoRaWAN_GetMaxPayload(p_Device.LoRaWAN.Config.Band, p_Device.LoRaWAN.DataRate, &MaxPayload) == RAK3172_ERR_OK) && (Length > MaxPayload))
     {
-        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetRetries(p_Device, Retries));
-    }
+        RAK3172_LOGE(TAG, "Payload with %u bytes exceeds the maximum payload of %u bytes!", Length, MaxPayload);
 
-    // Encode the payload into an ASCII string.
-    for(uint8_t i = 0x00; i < Length; i++)
-    {
-        sprintf(Buffer, "%02x", ((uint8_t*)p_Buffer)[i]);
-        Payload += std::string(Buffer);
+        return RAK3172_ERR_INVALID_ARG;
     }
 
-    if(Length > 500)
-    {
-        RAK3172_SendCommand(p_Device, "AT+LPSEND=" + std::to_string(Port) + ":" + std::to_string(Confirmed) + ":" + Payload, NULL, &Status);
-    }
-    else
-    {
-        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_SetConfirmation(p_Device, Confirmed));
-        RAK3172_SendCommand(p_Device, "AT+SEND=" + std::to_string(Port) + ":" + Payload, NULL, &Status);
-    }
+    return RAK3172_Uplink_Submit(p_Device, Port, p_Buffer, Length, Confirmed, Retries, Priority, Deadline, Callback, p_Arg, p_Frame, Coalesce);
+}
 
-    // The device is busy. Leave the function with an invalid state error.
-    if(Status.find("AT_BUSY_ERROR") != std::string::npos)
-    {
-        return RAK3172_ERR_BUSY;
-    }
-    else if(Status.find("Restricted") != std::string::npos)
+RAK3172_Error_t RAK3172_LoRaWAN_GetUplinkStats(RAK3172_t& p_Device, RAK3172_Uplink_Stats_t* const p_Stats)
+{
+    if(p_Stats == NULL)
     {
-        return RAK3172_ERR_RESTRICTED;
+        return RAK3172_ERR_INVALID_ARG;
     }
-    // No transmission error and no confirmation needed.
-    else if((Confirmed == false) && (Status.find("OK") == std::string::npos))
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
-        return RAK3172_ERR_OK;
+        return RAK3172_ERR_INVALID_MODE;
     }
 
-    p_Device.Internal.isBusy = true;
-    p_Device.LoRaWAN.ConfirmError = false;
-
-    // Wait for the confirmation if needed.
-    if(Confirmed)
-    {
-        do
-        {
-            if(Wait)
-            {
-                Wait();
-            }
+    return RAK3172_Uplink_GetStats(p_Device, p_Stats);
+}
 
-            RAK3172_PwrMagnt_EnterLightSleep(p_Device);
+RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* p_Message, uint32_t Timeout)
+{
+    const RAK3172_Rx_t* Message;
 
-            // We need this delay to prevent a task watchdog reset on ESP32.
-            vTaskDelay(20 / portTICK_PERIOD_MS);
-        } while(p_Device.Internal.isBusy);
+    if(p_Message == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
     }
 
-    p_Device.Internal.isBusy = false;
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_Borrow(p_Device, &Message, Timeout));
 
-    if(Confirmed && p_Device.LoRaWAN.ConfirmError)
-    {
-        return RAK3172_ERR_INVALID_RESPONSE;
-    }
+    RAK3172_RxQueue_Copy(p_Message, Message);
+
+    RAK3172_ReleaseMessage(p_Device, Message);
 
     return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* p_Message, uint32_t Timeout)
+RAK3172_Error_t RAK3172_LoRaWAN_Borrow(RAK3172_t& p_Device, const RAK3172_Rx_t** p_Message, uint32_t Timeout)
 {
     RAK3172_Rx_t* FromQueue = NULL;
 
@@ -441,17 +588,12 @@ RAK3172_Error_t RAK3172_LoRaWAN_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* p_Mes
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    if(xQueueReceive(p_Device.Internal.ReceiveQueue, &FromQueue, (Timeout * 1000UL) / portTICK_PERIOD_MS) != pdPASS)
+    if(RAK3172_RxQueue_Receive(p_Device, &FromQueue, (Timeout * 1000UL) / portTICK_PERIOD_MS) == false)
     {
         return RAK3172_ERR_TIMEOUT;
     }
 
-    p_Message->RSSI = FromQueue->RSSI;
-    p_Message->SNR = FromQueue->SNR;
-    p_Message->Port = FromQueue->Port;
-    p_Message->Payload = FromQueue->Payload;
-
-    delete FromQueue;
+    *p_Message = FromQueue;
 
     return RAK3172_ERR_OK;
 }
@@ -485,9 +627,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRetries(const RAK3172_t& p_Device, uint8_t* c
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RETY=?", &Response));
 
-    *p_Retries = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Retries);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetPNM(const RAK3172_t& p_Device, bool Enable)
@@ -515,9 +655,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetPNM(const RAK3172_t& p_Device, bool* const p_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PNM=?", &Response));
 
-    *p_Enable = static_cast<bool>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Enable);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetConfirmation(const RAK3172_t& p_Device, bool Enable)
@@ -545,19 +683,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetConfirmation(const RAK3172_t& p_Device, bool*
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+CFM=?", &Response));
 
-    *p_Enable = static_cast<bool>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Enable);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetBand(const RAK3172_t& p_Device, RAK3172_Band_t Band)
+RAK3172_Error_t RAK3172_LoRaWAN_SetBand(RAK3172_t& p_Device, RAK3172_Band_t Band)
 {
-    if(p_Device.Mode != RAK_MODE_LORAWAN)
-    {
-        return RAK3172_ERR_INVALID_MODE;
-    }
+    RAK3172_LoRaWAN_Config_t Config;
+
+    RAK3172_LoRaWAN_Config_Begin(&Config);
+    RAK3172_LoRaWAN_Config_SetBand(&Config, Band);
 
-    return RAK3172_SendCommand(p_Device, "AT+BAND=" + std::to_string(static_cast<uint8_t>(Band)));
+    return RAK3172_LoRaWAN_Config_Commit(p_Device, &Config);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_t* const p_Band)
@@ -575,14 +711,12 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBand(const RAK3172_t& p_Device, RAK3172_Band_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAND=?", &Response));
 
-    *p_Band = static_cast<RAK3172_Band_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Band, RAK_BAND_EU433, RAK_BAND_AS923);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t Band)
+RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(RAK3172_t& p_Device, RAK3172_SubBand_t Band)
 {
-    RAK3172_Band_t Dummy;
+    RAK3172_LoRaWAN_Config_t Config;
 
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
@@ -593,31 +727,10 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetSubBand(const RAK3172_t& p_Device, RAK3172_Su
         return RAK3172_ERR_OK;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Dummy));
+    RAK3172_LoRaWAN_Config_Begin(&Config);
+    RAK3172_LoRaWAN_Config_SetSubBand(&Config, Band);
 
-    // The sub band can only be changed when using US915, AU915 or CN470 frequency band.
-    if((Dummy == RAK_BAND_US915) || (Dummy == RAK_BAND_AU915) || (Dummy == RAK_BAND_CN470))
-    {
-        if((Band > RAK_SUB_BAND_9) && (Dummy != RAK_BAND_CN470))
-        {
-            return RAK3172_ERR_INVALID_ARG;
-        }
-
-        if(Band == RAK_SUB_BAND_ALL)
-        {
-            return RAK3172_SendCommand(p_Device, "AT+MASK=0000");
-        }
-        else
-        {
-            char Temp[5];
-
-            sprintf(Temp, "%04X", 1 << (Band - 2));
-    
-            return RAK3172_SendCommand(p_Device, "AT+MASK=" + std::string(Temp));
-        }
-    }
-
-    return RAK3172_ERR_FAIL;
+    return RAK3172_LoRaWAN_Config_Commit(p_Device, &Config);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_SubBand_t* const p_Band)
@@ -625,7 +738,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_Su
     RAK3172_Band_t Dummy;
     std::string Response;
     uint32_t Mask;
-    uint8_t Shifts = 1;
+    uint8_t Shifts = 0;
 
     if(p_Band == NULL)
     {
@@ -647,7 +760,8 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_Su
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+MASK=?", &Response));
 
-    Mask = std::stoi(Response);
+    // The mask is transmitted as hex value.
+    RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Response, &Mask, 16));
 
     if(Mask == 0)
     {
@@ -669,59 +783,14 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSubBand(const RAK3172_t& p_Device, RAK3172_Su
     }
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(const RAK3172_t& p_Device, uint8_t TxPwr)
+RAK3172_Error_t RAK3172_LoRaWAN_SetTxPwr(RAK3172_t& p_Device, uint8_t TxPwr)
 {
-    uint8_t TxPwrIndex = 0;
-    RAK3172_Band_t Band;
-
-    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
+    RAK3172_LoRaWAN_Config_t Config;
 
-    RAK3172_LOGD(TAG, "Set Tx power to: %u dBm", TxPwr);
-
-    // For EU868 the maximum transmit power is +16 dB EIRP.
-    if(Band == RAK_BAND_EU868)
-    {
-        const uint8_t EIRP = 16;
-
-        if(TxPwr >= EIRP)
-        {
-            TxPwrIndex = 0;
-        }
-        else if(TxPwr < (EIRP - 14))
-        {
-            TxPwrIndex = 10;
-        }
-        else
-        {
-            TxPwrIndex = static_cast<uint8_t>((EIRP - TxPwr) / 2);
-        }
-    }
-    // For US915 the maximum transmit power is +30 dBm conducted power.
-    else if(Band == RAK_BAND_US915)
-    {
-        const uint8_t MaxPwr = 30;
+    RAK3172_LoRaWAN_Config_Begin(&Config);
+    RAK3172_LoRaWAN_Config_SetTxPwr(&Config, TxPwr);
 
-        if(TxPwr >= MaxPwr)
-        {
-            TxPwrIndex = 0;
-        }
-        else if(TxPwr < 10)
-        {
-            TxPwrIndex = 10;
-        }
-        else
-        {
-            TxPwrIndex = static_cast<uint8_t>((MaxPwr - TxPwr) / 2);
-        }
-    }
-    else
-    {
-        RAK3172_LOGE(TAG, "Tx power is not implemented for the selected frequency band!");
-    }
-
-    RAK3172_LOGD(TAG, "Set Tx power index: %u", TxPwrIndex);
-
-    return RAK3172_SendCommand(p_Device, "AT+TXP=" + std::to_string(TxPwrIndex));
+    return RAK3172_LoRaWAN_Config_Commit(p_Device, &Config);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetJoin1Delay(const RAK3172_t& p_Device, uint32_t Delay)
@@ -764,9 +833,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetJoin1Delay(const RAK3172_t& p_Device, uint32_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+JN1DL=?", &Response));
 
-    *p_Delay = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Delay);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetJoin2Delay(const RAK3172_t& p_Device, uint32_t Delay)
@@ -809,9 +876,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetJoin2Delay(const RAK3172_t& p_Device, uint32_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+JN2DL=?", &Response));
 
-    *p_Delay = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Delay);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetRX1Delay(const RAK3172_t& p_Device, uint32_t Delay)
@@ -853,9 +918,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX1Delay(const RAK3172_t& p_Device, uint32_t*
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RX1DL=?", &Response));
 
-    *p_Delay = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Delay);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Delay(const RAK3172_t& p_Device, uint32_t Delay)
@@ -897,9 +960,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX2Delay(const RAK3172_t& p_Device, uint32_t*
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RX2DL=?", &Response));
 
-    *p_Delay = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Delay);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetRX2Freq(const RAK3172_t& p_Device, uint32_t Frequency)
@@ -927,9 +988,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX2Freq(const RAK3172_t& p_Device, uint32_t*
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RX2FQ=?", &Response));
 
-    *p_Frequency = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Frequency);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetRX2DataRate(const RAK3172_t& p_Device, uint8_t DataRate)
@@ -993,9 +1052,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRX2DataRate(const RAK3172_t& p_Device, uint32
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RX2DR=?", &Response));
 
-    *p_DataRate = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_DataRate);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetSNR(const RAK3172_t& p_Device, int8_t* const p_SNR)
@@ -1013,9 +1070,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSNR(const RAK3172_t& p_Device, int8_t* const
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+SNR=?", &Response));
 
-    *p_SNR = static_cast<int8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_SNR);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetRSSI(const RAK3172_t& p_Device, int8_t* const p_RSSI)
@@ -1033,9 +1088,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRSSI(const RAK3172_t& p_Device, int8_t* const
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RSSI=?", &Response));
 
-    *p_RSSI = static_cast<int8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_RSSI);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* const p_Duty)
@@ -1056,12 +1109,10 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDuty(const RAK3172_t& p_Device, uint8_t* cons
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DUTYTIME=?", &Response));
 
-    *p_Duty = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Duty);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t DR)
+RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(RAK3172_t& p_Device, RAK3172_DataRate_t DR)
 {
     if(DR > RAK_DR_7)
     {
@@ -1072,7 +1123,12 @@ RAK3172_Error_t RAK3172_LoRaWAN_SetDataRate(const RAK3172_t& p_Device, RAK3172_D
         return RAK3172_ERR_INVALID_MODE;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+DR=" + std::to_string(DR));
+    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DR=" + std::to_string(DR)));
+
+    p_Device.LoRaWAN.DataRate = DR;
+    p_Device.LoRaWAN.isDataRateValid = true;
+
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_DataRate_t* const p_DR)
@@ -1090,19 +1146,29 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetDataRate(const RAK3172_t& p_Device, RAK3172_D
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+DR=?", &Response));
 
-    *p_DR = static_cast<RAK3172_DataRate_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_DR, RAK_DR_0, RAK_DR_7);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetADR(const RAK3172_t& p_Device, bool Enable)
+RAK3172_Error_t RAK3172_LoRaWAN_GetMaxPayload(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint8_t* const p_Length)
 {
-    if(p_Device.Mode != RAK_MODE_LORAWAN)
+    if((p_Length == NULL) || (Band > RAK_BAND_AS923) || (DR > RAK_DR_7) || (_RAK3172_LoRaWAN_MaxPayload[Band][DR] == 0))
     {
-        return RAK3172_ERR_INVALID_MODE;
+        return RAK3172_ERR_INVALID_ARG;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+ADR=" + std::to_string(Enable));
+    *p_Length = _RAK3172_LoRaWAN_MaxPayload[Band][DR];
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_SetADR(RAK3172_t& p_Device, bool Enable)
+{
+    RAK3172_LoRaWAN_Config_t Config;
+
+    RAK3172_LoRaWAN_Config_Begin(&Config);
+    RAK3172_LoRaWAN_Config_SetADR(&Config, Enable);
+
+    return RAK3172_LoRaWAN_Config_Commit(p_Device, &Config);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_Enable)
@@ -1120,18 +1186,18 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetADR(const RAK3172_t& p_Device, bool* const p_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+ADR=?", &Response));
 
-    *p_Enable = static_cast<bool>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Enable);
 }
 
-RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(const RAK3172_t& p_Device, RAK3172_JoinMode_t Mode)
+RAK3172_Error_t RAK3172_LoRaWAN_SetJoinMode(RAK3172_t& p_Device, RAK3172_JoinMode_t Mode)
 {
     if(p_Device.Mode != RAK_MODE_LORAWAN)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
 
+    RAK3172_LoRaWAN_Config_Invalidate(p_Device, RAK_LORAWAN_CFG_OTAA | RAK_LORAWAN_CFG_ABP);
+
     return RAK3172_SendCommand(p_Device, "AT+NJM=" + std::to_string(Mode));
 }
 
@@ -1150,9 +1216,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetJoinMode(const RAK3172_t& p_Device, RAK3172_J
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+NJM=?", &Response));
 
-    *p_Mode = static_cast<RAK3172_JoinMode_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Mode, RAK_JOIN_ABP, RAK_JOIN_OTAA);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetRSSI(const RAK3172_t& p_Device, int* p_RSSI)
@@ -1170,9 +1234,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetRSSI(const RAK3172_t& p_Device, int* p_RSSI)
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+RSSI=?", &Response));
 
-    *p_RSSI = std::stoi(Response);
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_RSSI);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetSNR(const RAK3172_t& p_Device, int* p_SNR)
@@ -1190,9 +1252,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSNR(const RAK3172_t& p_Device, int* p_SNR)
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+SNR=?", &Response));
 
-    *p_SNR = std::stoi(Response);
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_SNR);
 }
 
 #endif
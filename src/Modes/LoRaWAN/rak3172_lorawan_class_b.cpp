@@ -25,33 +25,33 @@
 
 #include "rak3172.h"
 
-/** @brief              Get a substring from the input string. The substring is delimited by the given delimiter.
+#include "../../Core/rak3172_parser.h"
+
+/** @brief              Get the next numeric field from the input string. The field is delimited by the given delimiter.
  *  @param p_Input      Pointer to input string
- *                      NOTE: The input string will be modified!
- *  @param Delimiter    Substring delimiter
- *  @return             Substring
+ *                      NOTE: The input string will be advanced behind the delimiter!
+ *  @param Delimiter    Field delimiter
+ *  @param p_Value      Pointer to field value
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_RESPONSE when the field is missing or invalid
  */
-static std::string RAK3172_SubstringSplitErase(std::string* p_Input, std::string Delimiter)
+static RAK3172_Error_t RAK3172_LoRaWAN_NextField(std::string_view* p_Input, std::string_view Delimiter, int* p_Value)
 {
-    size_t Index;
-    std::string Result = std::string();
+    std::string_view Field;
 
-    assert(p_Input);
-
-    Index = p_Input->find(Delimiter);
-    if(Index != std::string::npos)
+    if(RAK3172_Parser_Next(p_Input, Delimiter, &Field) == false)
     {
-        Result = p_Input->substr(0, Index);
-        p_Input->erase(0, Index + 1);
+        return RAK3172_ERR_INVALID_RESPONSE;
     }
 
-    return Result;
+    return RAK3172_Parser_ToNumber(Field, p_Value);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetBeaconFrequency(RAK3172_t& p_Device, RAK3172_DataRate_t* p_Datarate, uint32_t* p_Frequency)
 {
-    size_t Index;
     std::string Response;
+    std::string_view Input;
+    std::string_view Field;
 
     if((p_Datarate == NULL) || (p_Frequency == NULL))
     {
@@ -64,25 +64,29 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBeaconFrequency(RAK3172_t& p_Device, RAK3172_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BFREQ=?", &Response));
 
+    Input = Response;
+
     #ifdef CONFIG_RAK3172_USE_RUI3
+        size_t Index;
+
         // Remove the leading "BCON: " string.
-        Index = Response.find("BCON: ");
-        if(Index == std::string::npos)
+        Index = Input.find("BCON: ");
+        if(Index == std::string_view::npos)
         {
             return RAK3172_ERR_INVALID_RESPONSE;
         }
-        else
-        {
-            Response.erase(0, Index + std::string("BCON: ").size());
-        }
+
+        Input.remove_prefix(Index + std::string_view("BCON: ").size());
     #endif
 
-    Index = Response.find(",");
-    *p_Datarate = static_cast<RAK3172_DataRate_t>(std::stoi(Response.substr(0, Index)));
-    Response.erase(0, Index + 1);
-    *p_Frequency = static_cast<uint32_t>(std::stoi(Response));
+    if(RAK3172_Parser_Next(&Input, ",", &Field) == false)
+    {
+        return RAK3172_ERR_INVALID_RESPONSE;
+    }
 
-    return RAK3172_ERR_OK;
+    RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Field, p_Datarate, RAK_DR_0, RAK_DR_7));
+
+    return RAK3172_Parser_ToNumber(Input, p_Frequency);
 }
 
 #ifdef CONFIG_RAK3172_USE_RUI3
@@ -90,6 +94,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBeaconFrequency(RAK3172_t& p_Device, RAK3172_
     {
         size_t Index;
         std::string Response;
+        std::string_view Input;
 
         if(p_Time == NULL)
         {
@@ -101,16 +106,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetBeaconFrequency(RAK3172_t& p_Device, RAK3172_
         }
 
         RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BTIME=?", &Response));
-        Index = Response.find("BTIME: ");
-        if(Index == std::string::npos)
+
+        Input = Response;
+        Index = Input.find("BTIME: ");
+        if(Index == std::string_view::npos)
         {
             return RAK3172_ERR_INVALID_RESPONSE;
         }
 
-        Response.erase(0, Index + std::string("BTIME: ").size());
-        *p_Time = static_cast<uint32_t>(std::stoi(Response));
+        Input.remove_prefix(Index + std::string_view("BTIME: ").size());
 
-        return RAK3172_ERR_OK;
+        return RAK3172_Parser_ToNumber(Input, p_Time);
     }
 
     RAK3172_Error_t RAK3172_LoRaWAN_GetGatewayInfo(RAK3172_t& p_Device, std::string* p_NetID, std::string* p_GatewayID, std::string* p_Longitude, std::string* p_Latitude)
@@ -136,6 +142,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetLocalTime(RAK3172_t& p_Device, struct tm* p_D
 {
     size_t Index;
     std::string Response;
+    std::string_view Input;
 
     if(p_DateTime == NULL)
     {
@@ -147,42 +154,41 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetLocalTime(RAK3172_t& p_Device, struct tm* p_D
     }
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+LTIME=?", &Response));
-    Index = Response.find("LTIME:");
-    if(Index == std::string::npos)
+
+    Input = Response;
+    Index = Input.find("LTIME:");
+    if(Index == std::string_view::npos)
     {
         return RAK3172_ERR_INVALID_RESPONSE;
     }
 
     memset(p_DateTime, 0, sizeof(struct tm));
 
+    Input.remove_prefix(Index + std::string_view("LTIME:").size());
+    Input = RAK3172_Parser_Trim(Input);
+
+    // We continue with a string with the format "00h37m58s 2018-11-14" (RUI3) or "00h37m58s on 14/11/2018" here.
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "h", &p_DateTime->tm_hour));
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "m", &p_DateTime->tm_min));
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "s", &p_DateTime->tm_sec));
+
+    Input = RAK3172_Parser_Trim(Input);
+
     #ifdef CONFIG_RAK3172_USE_RUI3
-        Response.erase(0, Index + std::string("LTIME: ").size());
-        Index = Response.find(" ");
-        Response.erase(Index, std::string(" ").size());
-
-        // We continue with a string with the format "00h37m58s2018-11-14" here.
-        p_DateTime->tm_hour = std::stoi(RAK3172_SubstringSplitErase(&Response, "h"));
-        p_DateTime->tm_min = std::stoi(RAK3172_SubstringSplitErase(&Response, "m"));
-        p_DateTime->tm_sec = std::stoi(RAK3172_SubstringSplitErase(&Response, "s"));
-        p_DateTime->tm_year = std::stoi(RAK3172_SubstringSplitErase(&Response, "-")) - 1900;
-        p_DateTime->tm_mon = std::stoi(RAK3172_SubstringSplitErase(&Response, "-"));
-        p_DateTime->tm_mday = std::stoi(Response);
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "-", &p_DateTime->tm_year));
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "-", &p_DateTime->tm_mon));
+        RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Input, &p_DateTime->tm_mday));
     #else
-        Response.erase(0, Index + std::string("LTIME:").size());
-
         // Remove the "on" string between the time and the date.
-        Index = Response.find(" on ");
-        Response.erase(Index, std::string(" on ").size());
-
-        // We continue with a string with the format "00h37m58s14-11-2018" here.
-        p_DateTime->tm_hour = std::stoi(RAK3172_SubstringSplitErase(&Response, "h"));
-        p_DateTime->tm_min = std::stoi(RAK3172_SubstringSplitErase(&Response, "m"));
-        p_DateTime->tm_sec = std::stoi(RAK3172_SubstringSplitErase(&Response, "s"));
-        p_DateTime->tm_mday = std::stoi(RAK3172_SubstringSplitErase(&Response, "/"));
-        p_DateTime->tm_mon = std::stoi(RAK3172_SubstringSplitErase(&Response, "/"));
-        p_DateTime->tm_year = std::stoi(Response) - 1900;
+        RAK3172_Parser_SkipPrefix(&Input, "on ");
+
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "/", &p_DateTime->tm_mday));
+        RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_NextField(&Input, "/", &p_DateTime->tm_mon));
+        RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Input, &p_DateTime->tm_year));
     #endif
 
+    p_DateTime->tm_year -= 1900;
+
     return RAK3172_ERR_OK;
 }
 
@@ -215,9 +221,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetPeriodicity(RAK3172_t& p_Device, uint8_t* p_P
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PGSLOT=?", &Response));
 
-    *p_Periodicity = static_cast<uint8_t>(std::stoi(Response));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Response, p_Periodicity);
 }
 
 #endif
\ No newline at end of file
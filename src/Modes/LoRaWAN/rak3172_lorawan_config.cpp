@@ -0,0 +1,464 @@
+ /*
+ * rak3172_lorawan_config.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "../../Core/rak3172_cmdqueue.h"
+#include "../../Core/rak3172_hex.h"
+#include "../../Arch/Logging/rak3172_logging.h"
+
+/** @brief Settings that depend on the frequency band.
+ */
+#define RAK3172_LORAWAN_CFG_BAND_DEPENDENT                      (RAK_LORAWAN_CFG_SUB_BAND | RAK_LORAWAN_CFG_TX_PWR)
+
+/** @brief Settings that contain the join mode.
+ */
+#define RAK3172_LORAWAN_CFG_JOIN                                (RAK_LORAWAN_CFG_OTAA | RAK_LORAWAN_CFG_ABP)
+
+static const char* TAG = "RAK3172_LoRaWAN";
+
+/** @brief          Convert a key into a hex string.
+ *  @param p_Key    Pointer to key
+ *  @param Length   Key length in bytes
+ *  @return         Hex string
+ */
+static std::string RAK3172_LoRaWAN_Config_ToHex(const uint8_t* p_Key, uint8_t Length)
+{
+    std::string Result;
+
+    RAK3172_Hex_Append(&Result, p_Key, Length);
+
+    return Result;
+}
+
+/** @brief          Copy up to three keys into a configuration object.
+ *  @param p_Config Pointer to configuration object
+ *  @param p_Key1   Pointer to key 1
+ *  @param Length1  Length of key 1
+ *  @param p_Key2   Pointer to key 2
+ *  @param Length2  Length of key 2
+ *  @param p_Key3   Pointer to key 3
+ *  @param Length3  Length of key 3
+ */
+static void RAK3172_LoRaWAN_Config_CopyKeys(RAK3172_LoRaWAN_Config_t* p_Config, const uint8_t* p_Key1, uint8_t Length1, const uint8_t* p_Key2, uint8_t Length2, const uint8_t* p_Key3, uint8_t Length3)
+{
+    // Clear the unused bytes, because the keys are compared with their full size.
+    memset(p_Config->Key1, 0, sizeof(p_Config->Key1));
+    memset(p_Config->Key2, 0, sizeof(p_Config->Key2));
+    memset(p_Config->Key3, 0, sizeof(p_Config->Key3));
+
+    memcpy(p_Config->Key1, p_Key1, Length1);
+    memcpy(p_Config->Key2, p_Key2, Length2);
+    memcpy(p_Config->Key3, p_Key3, Length3);
+}
+
+/** @brief          Get the Tx power index for the module.
+ *  @param Band     Frequency band
+ *  @param TxPwr    Tx power in dBm
+ *  @return         Tx power index
+ */
+static uint8_t RAK3172_LoRaWAN_Config_GetTxPwrIndex(RAK3172_Band_t Band, uint8_t TxPwr)
+{
+    // For EU868 the maximum transmit power is +16 dB EIRP.
+    if(Band == RAK_BAND_EU868)
+    {
+        const uint8_t EIRP = 16;
+
+        if(TxPwr >= EIRP)
+        {
+            return 0;
+        }
+        else if(TxPwr < (EIRP - 14))
+        {
+            return 10;
+        }
+
+        return static_cast<uint8_t>((EIRP - TxPwr) / 2);
+    }
+    // For US915 the maximum transmit power is +30 dBm conducted power.
+    else if(Band == RAK_BAND_US915)
+    {
+        const uint8_t MaxPwr = 30;
+
+        if(TxPwr >= MaxPwr)
+        {
+            return 0;
+        }
+        else if(TxPwr < 10)
+        {
+            return 10;
+        }
+
+        return static_cast<uint8_t>((MaxPwr - TxPwr) / 2);
+    }
+
+    RAK3172_LOGE(TAG, "Tx power is not implemented for the selected frequency band!");
+
+    return 0;
+}
+
+/** @brief              Get the command for a sub band.
+ *  @param Band         Frequency band
+ *  @param SubBand      Sub band
+ *  @param p_Command    Pointer to command
+ *  @return             RAK3172_ERR_OK when successful
+ *                      RAK3172_ERR_INVALID_ARG when the sub band isn´t supported by the frequency band
+ *                      RAK3172_ERR_FAIL when the frequency band doesn´t support sub bands
+ */
+static RAK3172_Error_t RAK3172_LoRaWAN_Config_GetMaskCommand(RAK3172_Band_t Band, RAK3172_SubBand_t SubBand, std::string* p_Command)
+{
+    char Temp[5];
+
+    // The sub band can only be changed when using US915, AU915 or CN470 frequency band.
+    if((Band != RAK_BAND_US915) && (Band != RAK_BAND_AU915) && (Band != RAK_BAND_CN470))
+    {
+        return RAK3172_ERR_FAIL;
+    }
+    else if((SubBand > RAK_SUB_BAND_9) && (Band != RAK_BAND_CN470))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    if(SubBand == RAK_SUB_BAND_ALL)
+    {
+        *p_Command = "AT+MASK=0000";
+    }
+    else
+    {
+        sprintf(Temp, "%04X", 1 << (SubBand - 2));
+        *p_Command = "AT+MASK=" + std::string(Temp);
+    }
+
+    return RAK3172_ERR_OK;
+}
+
+/** @brief          Get the settings of a transaction that differ from the cache.
+ *  @param Cache    Cached module configuration
+ *  @param Config   Configuration transaction
+ *  @return         Changed settings
+ */
+static uint32_t RAK3172_LoRaWAN_Config_Diff(const RAK3172_LoRaWAN_Config_t& Cache, const RAK3172_LoRaWAN_Config_t& Config)
+{
+    uint32_t Changed;
+
+    // Settings which are not cached are always changed.
+    Changed = Config.Valid & ~Cache.Valid;
+
+    if((Config.Valid & Cache.Valid & RAK_LORAWAN_CFG_CLASS) && (Config.Class != Cache.Class))
+    {
+        Changed |= RAK_LORAWAN_CFG_CLASS;
+    }
+
+    if((Config.Valid & Cache.Valid & RAK_LORAWAN_CFG_ADR) && (Config.UseADR != Cache.UseADR))
+    {
+        Changed |= RAK_LORAWAN_CFG_ADR;
+    }
+
+    if((Config.Valid & Cache.Valid & RAK_LORAWAN_CFG_BAND) && (Config.Band != Cache.Band))
+    {
+        Changed |= RAK_LORAWAN_CFG_BAND;
+    }
+
+    if((Config.Valid & Cache.Valid & RAK_LORAWAN_CFG_SUB_BAND) && (Config.SubBand != Cache.SubBand))
+    {
+        Changed |= RAK_LORAWAN_CFG_SUB_BAND;
+    }
+
+    if((Config.Valid & Cache.Valid & RAK_LORAWAN_CFG_TX_PWR) && (Config.TxPwr != Cache.TxPwr))
+    {
+        Changed |= RAK_LORAWAN_CFG_TX_PWR;
+    }
+
+    if((Config.Valid & Cache.Valid & RAK3172_LORAWAN_CFG_JOIN) &&
+       ((memcmp(Config.Key1, Cache.Key1, sizeof(Config.Key1)) != 0) ||
+        (memcmp(Config.Key2, Cache.Key2, sizeof(Config.Key2)) != 0) ||
+        (memcmp(Config.Key3, Cache.Key3, sizeof(Config.Key3)) != 0)))
+    {
+        Changed |= Config.Valid & RAK3172_LORAWAN_CFG_JOIN;
+    }
+
+    // The module can reset the band dependent settings when the band changes.
+    if(Changed & RAK_LORAWAN_CFG_BAND)
+    {
+        Changed |= Config.Valid & RAK3172_LORAWAN_CFG_BAND_DEPENDENT;
+    }
+
+    return Changed;
+}
+
+void RAK3172_LoRaWAN_Config_Begin(RAK3172_LoRaWAN_Config_t* p_Config)
+{
+    if(p_Config == NULL)
+    {
+        return;
+    }
+
+    memset(p_Config, 0, sizeof(RAK3172_LoRaWAN_Config_t));
+}
+
+void RAK3172_LoRaWAN_Config_SetClass(RAK3172_LoRaWAN_Config_t* p_Config, RAK3172_Class_t Class)
+{
+    p_Config->Class = Class;
+    p_Config->Valid |= RAK_LORAWAN_CFG_CLASS;
+}
+
+void RAK3172_LoRaWAN_Config_SetADR(RAK3172_LoRaWAN_Config_t* p_Config, bool Enable)
+{
+    p_Config->UseADR = Enable;
+    p_Config->Valid |= RAK_LORAWAN_CFG_ADR;
+}
+
+void RAK3172_LoRaWAN_Config_SetBand(RAK3172_LoRaWAN_Config_t* p_Config, RAK3172_Band_t Band)
+{
+    p_Config->Band = Band;
+    p_Config->Valid |= RAK_LORAWAN_CFG_BAND;
+}
+
+void RAK3172_LoRaWAN_Config_SetSubBand(RAK3172_LoRaWAN_Config_t* p_Config, RAK3172_SubBand_t Band)
+{
+    if(Band == RAK_SUB_BAND_NONE)
+    {
+        return;
+    }
+
+    p_Config->SubBand = Band;
+    p_Config->Valid |= RAK_LORAWAN_CFG_SUB_BAND;
+}
+
+void RAK3172_LoRaWAN_Config_SetTxPwr(RAK3172_LoRaWAN_Config_t* p_Config, uint8_t TxPwr)
+{
+    p_Config->TxPwr = TxPwr;
+    p_Config->Valid |= RAK_LORAWAN_CFG_TX_PWR;
+}
+
+void RAK3172_LoRaWAN_Config_SetOTAAKeys(RAK3172_LoRaWAN_Config_t* p_Config, const uint8_t* const p_DEVEUI, const uint8_t* const p_APPEUI, const uint8_t* const p_APPKEY)
+{
+    if((p_DEVEUI == NULL) || (p_APPEUI == NULL) || (p_APPKEY == NULL))
+    {
+        return;
+    }
+
+    RAK3172_LoRaWAN_Config_CopyKeys(p_Config, p_DEVEUI, 8, p_APPEUI, 8, p_APPKEY, 16);
+    p_Config->Valid &= ~RAK_LORAWAN_CFG_ABP;
+    p_Config->Valid |= RAK_LORAWAN_CFG_OTAA;
+}
+
+void RAK3172_LoRaWAN_Config_SetABPKeys(RAK3172_LoRaWAN_Config_t* p_Config, const uint8_t* const p_APPSKEY, const uint8_t* const p_NWKSKEY, const uint8_t* const p_DEVADDR)
+{
+    if((p_APPSKEY == NULL) || (p_NWKSKEY == NULL) || (p_DEVADDR == NULL))
+    {
+        return;
+    }
+
+    RAK3172_LoRaWAN_Config_CopyKeys(p_Config, p_APPSKEY, 16, p_NWKSKEY, 16, p_DEVADDR, 4);
+    p_Config->Valid &= ~RAK_LORAWAN_CFG_OTAA;
+    p_Config->Valid |= RAK_LORAWAN_CFG_ABP;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Config_Commit(RAK3172_t& p_Device, const RAK3172_LoRaWAN_Config_t* p_Config)
+{
+    uint32_t Changed;
+    RAK3172_Band_t Band = RAK_BAND_EU868;
+    RAK3172_Batch_t Batch;
+    RAK3172_Error_t Error;
+    std::string MaskCommand;
+    RAK3172_LoRaWAN_Config_t* Cache;
+
+    if(p_Config == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if((p_Config->Valid & RAK_LORAWAN_CFG_CLASS) && (p_Config->Class != RAK_CLASS_A) && (p_Config->Class != RAK_CLASS_B) && (p_Config->Class != RAK_CLASS_C))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+
+    Cache = &p_Device.LoRaWAN.Config;
+
+    Changed = RAK3172_LoRaWAN_Config_Diff(*Cache, *p_Config);
+
+    RAK3172_LOGD(TAG, "Configuration changes: 0x%X", static_cast<unsigned int>(Changed));
+
+    if(Changed == 0)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    // The band dependent settings need the frequency band. Read the band from the module when it isn´t known.
+    if(Changed & RAK3172_LORAWAN_CFG_BAND_DEPENDENT)
+    {
+        if(p_Config->Valid & RAK_LORAWAN_CFG_BAND)
+        {
+            Band = p_Config->Band;
+        }
+        else if(Cache->Valid & RAK_LORAWAN_CFG_BAND)
+        {
+            Band = Cache->Band;
+        }
+        else
+        {
+            RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetBand(p_Device, &Band));
+
+            Cache->Band = Band;
+            Cache->Valid |= RAK_LORAWAN_CFG_BAND;
+        }
+
+        if(Changed & RAK_LORAWAN_CFG_SUB_BAND)
+        {
+            RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_Config_GetMaskCommand(Band, p_Config->SubBand, &MaskCommand));
+        }
+    }
+
+    // The module state is unknown until all commands are completed.
+    Cache->Valid &= ~Changed;
+    if(Changed & RAK_LORAWAN_CFG_BAND)
+    {
+        Cache->Valid &= ~RAK3172_LORAWAN_CFG_BAND_DEPENDENT;
+    }
+
+    if(Changed & RAK3172_LORAWAN_CFG_JOIN)
+    {
+        Cache->Valid &= ~RAK3172_LORAWAN_CFG_JOIN;
+    }
+
+    // The keys are the largest part of a configuration. Transmit them with a higher baud rate.
+    #ifdef CONFIG_RAK3172_UART_USE_BURST
+        if(Changed & RAK3172_LORAWAN_CFG_JOIN)
+        {
+            RAK3172_ERROR_CHECK(RAK3172_BeginBurst(p_Device));
+        }
+    #endif
+
+    RAK3172_Batch_Begin(&Batch);
+
+    if(Changed & RAK_LORAWAN_CFG_CLASS)
+    {
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+CLASS=" + std::string(1, static_cast<char>(p_Config->Class)), RAK_LORAWAN_CFG_CLASS);
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_ADR)
+    {
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+ADR=" + std::to_string(p_Config->UseADR), RAK_LORAWAN_CFG_ADR);
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_BAND)
+    {
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+BAND=" + std::to_string(static_cast<uint8_t>(p_Config->Band)), RAK_LORAWAN_CFG_BAND);
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_SUB_BAND)
+    {
+        RAK3172_Batch_Add(p_Device, &Batch, MaskCommand, RAK_LORAWAN_CFG_SUB_BAND);
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_TX_PWR)
+    {
+        RAK3172_LOGD(TAG, "Set Tx power to: %u dBm", p_Config->TxPwr);
+
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+TXP=" + std::to_string(RAK3172_LoRaWAN_Config_GetTxPwrIndex(Band, p_Config->TxPwr)), RAK_LORAWAN_CFG_TX_PWR);
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_OTAA)
+    {
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+NJM=" + std::to_string(RAK_JOIN_OTAA), RAK_LORAWAN_CFG_OTAA);
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+DEVEUI=" + RAK3172_LoRaWAN_Config_ToHex(p_Config->Key1, 8), RAK_LORAWAN_CFG_OTAA);
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+APPEUI=" + RAK3172_LoRaWAN_Config_ToHex(p_Config->Key2, 8), RAK_LORAWAN_CFG_OTAA);
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+APPKEY=" + RAK3172_LoRaWAN_Config_ToHex(p_Config->Key3, 16), RAK_LORAWAN_CFG_OTAA);
+    }
+    else if(Changed & RAK_LORAWAN_CFG_ABP)
+    {
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+NJM=" + std::to_string(RAK_JOIN_ABP), RAK_LORAWAN_CFG_ABP);
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+APPSKEY=" + RAK3172_LoRaWAN_Config_ToHex(p_Config->Key1, 16), RAK_LORAWAN_CFG_ABP);
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+NWKSKEY=" + RAK3172_LoRaWAN_Config_ToHex(p_Config->Key2, 16), RAK_LORAWAN_CFG_ABP);
+        RAK3172_Batch_Add(p_Device, &Batch, "AT+DEVADDR=" + RAK3172_LoRaWAN_Config_ToHex(p_Config->Key3, 4), RAK_LORAWAN_CFG_ABP);
+    }
+
+    Error = RAK3172_Batch_End(p_Device, &Batch);
+
+    #ifdef CONFIG_RAK3172_UART_USE_BURST
+        if(Changed & RAK3172_LORAWAN_CFG_JOIN)
+        {
+            RAK3172_EndBurst(p_Device);
+        }
+    #endif
+
+    // Update the cache with all successful settings.
+    Changed &= ~Batch.Failed;
+    if(Changed & RAK_LORAWAN_CFG_CLASS)
+    {
+        Cache->Class = p_Config->Class;
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_ADR)
+    {
+        Cache->UseADR = p_Config->UseADR;
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_BAND)
+    {
+        Cache->Band = p_Config->Band;
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_SUB_BAND)
+    {
+        Cache->SubBand = p_Config->SubBand;
+    }
+
+    if(Changed & RAK_LORAWAN_CFG_TX_PWR)
+    {
+        Cache->TxPwr = p_Config->TxPwr;
+    }
+
+    if(Changed & RAK3172_LORAWAN_CFG_JOIN)
+    {
+        memcpy(Cache->Key1, p_Config->Key1, sizeof(Cache->Key1));
+        memcpy(Cache->Key2, p_Config->Key2, sizeof(Cache->Key2));
+        memcpy(Cache->Key3, p_Config->Key3, sizeof(Cache->Key3));
+    }
+
+    Cache->Valid |= Changed;
+
+    if(p_Config->Valid & RAK_LORAWAN_CFG_OTAA)
+    {
+        p_Device.LoRaWAN.Join = RAK_JOIN_OTAA;
+    }
+    else if(p_Config->Valid & RAK_LORAWAN_CFG_ABP)
+    {
+        p_Device.LoRaWAN.Join = RAK_JOIN_ABP;
+    }
+
+    return Error;
+}
+
+void RAK3172_LoRaWAN_Config_Invalidate(RAK3172_t& p_Device, uint32_t Settings)
+{
+    p_Device.LoRaWAN.Config.Valid &= ~Settings;
+}
+
+#endif
@@ -0,0 +1,455 @@
+ /*
+ * rak3172_lorawan_classb.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#if(defined CONFIG_RAK3172_MODE_WITH_LORAWAN) && (defined CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY)
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "rak3172.h"
+
+#include "../../Core/rak3172_uplink.h"
+#include "../../Arch/Timer/rak3172_timer.h"
+
+/** @brief Length of a duty cycle time slot in milliseconds.
+ */
+#define RAK3172_DUTY_SLOT_TIME                                  120000UL
+
+/** @brief Length of the duty cycle window in microseconds.
+ */
+#define RAK3172_DUTY_WINDOW                                     (static_cast<uint64_t>(RAK3172_DUTY_SLOT_TIME) * RAK3172_DUTY_SLOTS * 1000ULL)
+
+/** @brief LoRaWAN frame overhead (MHDR, FHDR, FPort and MIC) in bytes.
+ */
+#define RAK3172_DUTY_FRAME_OVERHEAD                             13
+
+/** @brief Maximum LoRa payload length in bytes.
+ */
+#define RAK3172_DUTY_MAX_PAYLOAD                                255
+
+/** @brief Modulation of a LoRaWAN data rate.
+ */
+typedef struct
+{
+    uint8_t SF;                         /**< Spreading factor. 0 for FSK. */
+    uint32_t Bandwidth;                 /**< Bandwidth in Hz. 0 when the data rate isn´t defined. */
+} RAK3172_Duty_Modulation_t;
+
+/** @brief Regulatory sub band.
+ */
+typedef struct
+{
+    uint32_t Min;                       /**< Lower frequency in Hz. */
+    uint32_t Max;                       /**< Upper frequency in Hz. */
+    uint16_t Duty;                      /**< Duty cycle in 1 / 10000. */
+} RAK3172_Duty_SubBand_t;
+
+/** @brief Data rates DR0 - DR7 of the bands with SF12 - SF7 at 125 kHz, SF7 at 250 kHz and FSK.
+ */
+static const RAK3172_Duty_Modulation_t _RAK3172_Duty_DR_EU[] = {
+    {12, 125000}, {11, 125000}, {10, 125000}, {9, 125000}, {8, 125000}, {7, 125000}, {7, 250000}, {0, 50000},
+};
+
+/** @brief Data rates DR0 - DR7 of the IN865 band.
+ */
+static const RAK3172_Duty_Modulation_t _RAK3172_Duty_DR_IN[] = {
+    {12, 125000}, {11, 125000}, {10, 125000}, {9, 125000}, {8, 125000}, {7, 125000}, {0, 0}, {0, 50000},
+};
+
+/** @brief Data rates DR0 - DR7 of the CN470 and KR920 band.
+ */
+static const RAK3172_Duty_Modulation_t _RAK3172_Duty_DR_CN[] = {
+    {12, 125000}, {11, 125000}, {10, 125000}, {9, 125000}, {8, 125000}, {7, 125000}, {0, 0}, {0, 0},
+};
+
+/** @brief Uplink data rates DR0 - DR7 of the US915 band.
+ */
+static const RAK3172_Duty_Modulation_t _RAK3172_Duty_DR_US[] = {
+    {10, 125000}, {9, 125000}, {8, 125000}, {7, 125000}, {8, 500000}, {0, 0}, {0, 0}, {0, 0},
+};
+
+/** @brief Uplink data rates DR0 - DR7 of the AU915 band.
+ */
+static const RAK3172_Duty_Modulation_t _RAK3172_Duty_DR_AU[] = {
+    {12, 125000}, {11, 125000}, {10, 125000}, {9, 125000}, {8, 125000}, {7, 125000}, {8, 500000}, {0, 0},
+};
+
+/** @brief Sub bands of the EU868 band (ETSI EN 300 220). The first sub band contains the default channels.
+ */
+static const RAK3172_Duty_SubBand_t _RAK3172_Duty_SubBands_EU868[] = {
+    {868000000, 868600000, 100},
+    {863000000, 865000000, 10},
+    {865000000, 868000000, 100},
+    {868700000, 869200000, 10},
+    {869400000, 869650000, 1000},
+    {869700000, 870000000, 100},
+};
+
+/** @brief Sub bands of the RU864 band. The first sub band contains the default channels.
+ */
+static const RAK3172_Duty_SubBand_t _RAK3172_Duty_SubBands_RU864[] = {
+    {868700000, 869200000, 100},
+    {864000000, 868600000, 100},
+};
+
+/** @brief Sub bands of the EU433 band.
+ */
+static const RAK3172_Duty_SubBand_t _RAK3172_Duty_SubBands_EU433[] = {
+    {433050000, 434790000, 100},
+};
+
+/** @brief          Get the modulation of a data rate.
+ *  @param Band     Frequency band
+ *  @param DR       Data rate
+ *  @return         Pointer to modulation or #NULL when the data rate isn´t defined for the band
+ */
+static const RAK3172_Duty_Modulation_t* RAK3172_Duty_GetModulation(RAK3172_Band_t Band, RAK3172_DataRate_t DR)
+{
+    const RAK3172_Duty_Modulation_t* Table;
+
+    if(DR > RAK_DR_7)
+    {
+        return NULL;
+    }
+
+    switch(Band)
+    {
+        case RAK_BAND_EU433:
+        case RAK_BAND_RU864:
+        case RAK_BAND_EU868:
+        case RAK_BAND_AS923:
+        {
+            Table = _RAK3172_Duty_DR_EU;
+
+            break;
+        }
+        case RAK_BAND_IN865:
+        {
+            Table = _RAK3172_Duty_DR_IN;
+
+            break;
+        }
+        case RAK_BAND_CN470:
+        case RAK_BAND_KR920:
+        {
+            Table = _RAK3172_Duty_DR_CN;
+
+            break;
+        }
+        case RAK_BAND_US915:
+        {
+            Table = _RAK3172_Duty_DR_US;
+
+            break;
+        }
+        case RAK_BAND_AU915:
+        {
+            Table = _RAK3172_Duty_DR_AU;
+
+            break;
+        }
+        default:
+        {
+            return NULL;
+        }
+    }
+
+    if(Table[DR].Bandwidth == 0)
+    {
+        return NULL;
+    }
+
+    return &Table[DR];
+}
+
+/** @brief          Get the regulatory sub band of a frequency.
+ *  @param Band     Frequency band
+ *  @param Frequency Frequency in Hz. 0 for the default channels of the band
+ *  @param p_Index  Pointer to index of the sub band in the ledger
+ *  @return         Pointer to sub band or #NULL when the frequency isn´t regulated by a duty cycle
+ */
+static const RAK3172_Duty_SubBand_t* RAK3172_Duty_GetSubBand(RAK3172_Band_t Band, uint32_t Frequency, uint8_t* p_Index)
+{
+    uint8_t Count;
+    const RAK3172_Duty_SubBand_t* Table;
+
+    switch(Band)
+    {
+        case RAK_BAND_EU868:
+        {
+            Table = _RAK3172_Duty_SubBands_EU868;
+            Count = sizeof(_RAK3172_Duty_SubBands_EU868) / sizeof(RAK3172_Duty_SubBand_t);
+
+            break;
+        }
+        case RAK_BAND_RU864:
+        {
+            Table = _RAK3172_Duty_SubBands_RU864;
+            Count = sizeof(_RAK3172_Duty_SubBands_RU864) / sizeof(RAK3172_Duty_SubBand_t);
+
+            break;
+        }
+        case RAK_BAND_EU433:
+        {
+            Table = _RAK3172_Duty_SubBands_EU433;
+            Count = sizeof(_RAK3172_Duty_SubBands_EU433) / sizeof(RAK3172_Duty_SubBand_t);
+
+            break;
+        }
+        default:
+        {
+            return NULL;
+        }
+    }
+
+    if(Frequency == 0)
+    {
+        *p_Index = 0;
+
+        return &Table[0];
+    }
+
+    for(uint8_t i = 0; i < Count; i++)
+    {
+        if((Frequency >= Table[i].Min) && (Frequency < Table[i].Max))
+        {
+            *p_Index = i;
+
+            return &Table[i];
+        }
+    }
+
+    return NULL;
+}
+
+/** @brief          Remove the expired time slots from the ledger.
+ *                  NOTE: The uplink lock must be taken!
+ *  @param p_Duty   Pointer to duty cycle ledger
+ *  @return         Current time in milliseconds
+ */
+static unsigned long RAK3172_Duty_Update(RAK3172_Duty_t* p_Duty)
+{
+    unsigned long Now;
+    unsigned long Slot;
+
+    Now = RAK3172_Timer_GetMilliseconds();
+    Slot = Now / RAK3172_DUTY_SLOT_TIME;
+
+    // The timer has wrapped around or the whole window has expired.
+    if((Slot < p_Duty->Slot) || ((Slot - p_Duty->Slot) >= RAK3172_DUTY_SLOTS))
+    {
+        memset(p_Duty->Airtime, 0, sizeof(p_Duty->Airtime));
+    }
+    else
+    {
+        for(unsigned long s = p_Duty->Slot + 1; s <= Slot; s++)
+        {
+            for(uint8_t i = 0; i < RAK3172_DUTY_SUB_BANDS; i++)
+            {
+                p_Duty->Airtime[i][s % RAK3172_DUTY_SLOTS] = 0;
+            }
+        }
+    }
+
+    p_Duty->Slot = Slot;
+
+    return Now;
+}
+
+RAK3172_Error_t RAK3172_LoRa_GetAirtime(uint8_t SF, uint32_t Bandwidth, uint8_t CR, uint16_t Preamble, uint16_t Length, uint32_t* const p_Airtime)
+{
+    bool UseLDRO;
+    int32_t Bits;
+    uint32_t Quarters;
+    uint32_t Symbols;
+    uint32_t Divider;
+
+    if((p_Airtime == NULL) || (SF < 5) || (SF > 12) || (Bandwidth == 0) || (CR < 1) || (CR > 4) || (Length > RAK3172_DUTY_MAX_PAYLOAD))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    // The low data rate optimization is enabled for symbol times of 16 ms and more.
+    UseLDRO = ((static_cast<uint64_t>(1) << SF) * 1000000ULL) >= (16384ULL * Bandwidth);
+
+    // Payload symbols with explicit header and CRC (see SX126x datasheet, chapter 6.1.4).
+    Bits = (8 * Length) + 16 - (4 * SF) + 20;
+    if(SF >= 7)
+    {
+        Bits += 8;
+    }
+
+    Divider = 4 * (SF - (UseLDRO ? 2 : 0));
+    Symbols = 8;
+    if(Bits > 0)
+    {
+        Symbols += ((static_cast<uint32_t>(Bits) + Divider - 1) / Divider) * (CR + 4);
+    }
+
+    // Count in quarter symbols, because the preamble is extended by 4.25 (SF7 - SF12) or 6.25 (SF5 and SF6) symbols.
+    Quarters = (4 * (static_cast<uint32_t>(Preamble) + Symbols)) + ((SF >= 7) ? 17 : 25);
+
+    *p_Airtime = static_cast<uint32_t>(((static_cast<uint64_t>(Quarters) << SF) * 1000000ULL) / (4ULL * Bandwidth));
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_GetAirtime(RAK3172_Band_t Band, RAK3172_DataRate_t DR, uint16_t Length, uint32_t* const p_Airtime)
+{
+    uint16_t Frame;
+    uint32_t Airtime;
+    const RAK3172_Duty_Modulation_t* Modulation;
+
+    Modulation = RAK3172_Duty_GetModulation(Band, DR);
+    if((p_Airtime == NULL) || (Modulation == NULL))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    *p_Airtime = 0;
+
+    // Long payloads are transmitted by the module as multiple frames.
+    do
+    {
+        Frame = std::min<uint16_t>(Length, RAK3172_DUTY_MAX_PAYLOAD - RAK3172_DUTY_FRAME_OVERHEAD);
+        Length -= Frame;
+
+        if(Modulation->SF == 0)
+        {
+            // FSK with 5 bytes preamble, 3 bytes sync word, length byte and CRC at 50 kbps.
+            Airtime = (5 + 3 + 1 + Frame + RAK3172_DUTY_FRAME_OVERHEAD + 2) * 8 * 20;
+        }
+        else
+        {
+            // LoRaWAN uses a coding rate of 4/5 and a preamble with 8 symbols.
+            RAK3172_ERROR_CHECK(RAK3172_LoRa_GetAirtime(Modulation->SF, Modulation->Bandwidth, 1, 8, Frame + RAK3172_DUTY_FRAME_OVERHEAD, &Airtime));
+        }
+
+        *p_Airtime += Airtime;
+    } while(Length > 0);
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Duty_GetAirtime(const RAK3172_t& p_Device, uint16_t Length, uint32_t* const p_Airtime)
+{
+    if((p_Device.LoRaWAN.Config.Valid & RAK_LORAWAN_CFG_BAND) == 0)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    return RAK3172_LoRaWAN_GetAirtime(p_Device.LoRaWAN.Config.Band, RAK3172_Uplink_GetDataRate(p_Device), Length, p_Airtime);
+}
+
+void RAK3172_LoRaWAN_Duty_Record(RAK3172_t& p_Device, uint32_t Airtime, uint32_t Frequency)
+{
+    uint8_t Index;
+    uint32_t* Slot;
+
+    if((p_Device.LoRaWAN.UplinkLock == NULL) || ((p_Device.LoRaWAN.Config.Valid & RAK_LORAWAN_CFG_BAND) == 0) ||
+       (RAK3172_Duty_GetSubBand(p_Device.LoRaWAN.Config.Band, Frequency, &Index) == NULL))
+    {
+        return;
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    RAK3172_Duty_Update(&p_Device.LoRaWAN.Duty);
+
+    Slot = &p_Device.LoRaWAN.Duty.Airtime[Index][p_Device.LoRaWAN.Duty.Slot % RAK3172_DUTY_SLOTS];
+    *Slot = (*Slot > (UINT32_MAX - Airtime)) ? UINT32_MAX : (*Slot + Airtime);
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_Duty_GetNext(RAK3172_t& p_Device, uint16_t Length, uint32_t* const p_Delay, uint32_t Frequency)
+{
+    uint8_t Index;
+    uint32_t Airtime;
+    uint64_t Budget;
+    uint64_t Used;
+    unsigned long Now;
+    const RAK3172_Duty_SubBand_t* SubBand;
+
+    if(p_Delay == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_Duty_GetAirtime(p_Device, Length, &Airtime));
+
+    *p_Delay = 0;
+
+    SubBand = RAK3172_Duty_GetSubBand(p_Device.LoRaWAN.Config.Band, Frequency, &Index);
+    if(SubBand == NULL)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    Budget = (RAK3172_DUTY_WINDOW * SubBand->Duty) / 10000;
+    if(Airtime > Budget)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+
+    Now = RAK3172_Duty_Update(&p_Device.LoRaWAN.Duty);
+
+    Used = 0;
+    for(uint8_t i = 0; i < RAK3172_DUTY_SLOTS; i++)
+    {
+        Used += p_Device.LoRaWAN.Duty.Airtime[Index][i];
+    }
+
+    // Expire the time slots from the oldest to the newest slot until the uplink fits into the budget.
+    // The oldest slot is the slot after the current slot and expires at the end of the current slot.
+    for(unsigned long s = p_Device.LoRaWAN.Duty.Slot + 1; (Used + Airtime) > Budget; s++)
+    {
+        Used -= p_Device.LoRaWAN.Duty.Airtime[Index][s % RAK3172_DUTY_SLOTS];
+        *p_Delay = (s * RAK3172_DUTY_SLOT_TIME) - Now;
+    }
+
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+
+    return RAK3172_ERR_OK;
+}
+
+void RAK3172_LoRaWAN_Duty_Reset(RAK3172_t& p_Device)
+{
+    if(p_Device.LoRaWAN.UplinkLock == NULL)
+    {
+        memset(p_Device.LoRaWAN.Duty.Airtime, 0, sizeof(p_Device.LoRaWAN.Duty.Airtime));
+
+        return;
+    }
+
+    xSemaphoreTake(p_Device.LoRaWAN.UplinkLock, portMAX_DELAY);
+    memset(p_Device.LoRaWAN.Duty.Airtime, 0, sizeof(p_Device.LoRaWAN.Duty.Airtime));
+    xSemaphoreGive(p_Device.LoRaWAN.UplinkLock);
+}
+
+#endif
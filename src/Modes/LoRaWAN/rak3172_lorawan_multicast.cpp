@@ -21,10 +21,10 @@
 
 #if(defined CONFIG_RAK3172_MODE_WITH_LORAWAN) && (defined CONFIG_RAK3172_MODE_WITH_LORAWAN_MULTICAST)
 
-#include <vector>
-
 #include "rak3172.h"
 
+#include "../../Core/rak3172_parser.h"
+
 RAK3172_Error_t RAK3172_LoRaWAN_MC_AddGroup(RAK3172_t& p_Device, RAK3172_MC_Group_t Group)
 {
     return RAK3172_LoRaWAN_MC_AddGroup(p_Device, Group.Class, Group.DevAddr, Group.NwkSKey, Group.AppSKey, Group.Frequency, Group.Datarate, Group.Periodicity);
@@ -71,9 +71,10 @@ RAK3172_Error_t RAK3172_LoRaWAN_MC_RemoveGroup(RAK3172_t& p_Device, std::string
 
 RAK3172_Error_t RAK3172_LoRaWAN_MC_ListGroup(RAK3172_t& p_Device, RAK3172_MC_Group_t* p_Group)
 {
-    size_t Index;
+    uint8_t Fields = 0;
     std::string Response;
-    std::vector<std::string> SubStrings;
+    std::string_view Input;
+    std::string_view SubStrings[7];
 
     if(p_Group == NULL)
     {
@@ -86,27 +87,31 @@ RAK3172_Error_t RAK3172_LoRaWAN_MC_ListGroup(RAK3172_t& p_Device, RAK3172_MC_Gro
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+LSTMULC=?", &Response));
 
-    do
+    // Format: <Class>:<DevAddr>:<NwkSKey>:<AppSKey>:<Frequency>:<Datarate>[:<Periodicity>]
+    Input = Response;
+    while((Fields < (sizeof(SubStrings) / sizeof(SubStrings[0]))) && RAK3172_Parser_Next(&Input, ":", &SubStrings[Fields]))
     {
-        Index = Response.find(":");
-        if(Index != std::string::npos)
-        {
-            SubStrings.push_back(Response.substr(0, Index));
-            Response.erase(0, Index + 1);
-        }
-    } while(Index != std::string::npos);
-
-    if(SubStrings.size() != 5)
+        Fields++;
+    }
+
+    if((Fields < 6) || (SubStrings[0].empty()))
     {
         return RAK3172_ERR_INVALID_RESPONSE;
     }
 
-    p_Group->Class = static_cast<RAK3172_Class_t>(SubStrings.at(0).at(0));
-    p_Group->DevAddr = SubStrings.at(1);
-    p_Group->NwkSKey = SubStrings.at(2);
-    p_Group->AppSKey = SubStrings.at(3);
-    p_Group->Frequency = std::stoi(SubStrings.at(4));
-    p_Group->Datarate = static_cast<RAK3172_DataRate_t>(std::stoi(SubStrings.at(5)));
+    RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(SubStrings[4], &p_Group->Frequency));
+    RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(SubStrings[5], &p_Group->Datarate, RAK_DR_0, RAK_DR_7));
+
+    p_Group->Periodicity = 0;
+    if(Fields > 6)
+    {
+        RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(SubStrings[6], &p_Group->Periodicity));
+    }
+
+    p_Group->Class = static_cast<RAK3172_Class_t>(SubStrings[0].front());
+    p_Group->DevAddr = std::string(SubStrings[1]);
+    p_Group->NwkSKey = std::string(SubStrings[2]);
+    p_Group->AppSKey = std::string(SubStrings[3]);
 
     return RAK3172_ERR_OK;
 }
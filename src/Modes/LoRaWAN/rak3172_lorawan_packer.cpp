@@ -0,0 +1,178 @@
+ /*
+ * rak3172_lorawan_classb.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: RAK3172 serial driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), 
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, 
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, 
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * 
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de
+ */
+
+#include <sdkconfig.h>
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+
+#include <string.h>
+
+#include "rak3172.h"
+
+#include "../../Core/rak3172_uplink.h"
+
+/** @brief Largest maximum payload of all bands and data rates in bytes.
+ */
+#define RAK3172_PACK_FRAME_SIZE                                 242
+
+RAK3172_Error_t RAK3172_LoRaWAN_Pack(const RAK3172_Record_t* const p_Records, uint8_t Count, uint8_t MaxPayload, uint8_t* const p_Frames, uint8_t* const p_FrameCount)
+{
+    uint8_t Items;
+    uint8_t Frames;
+    uint16_t Rest;
+    uint8_t Order[RAK3172_PACK_MAX_RECORDS];
+    uint8_t Free[RAK3172_PACK_MAX_RECORDS];
+
+    if((p_Records == NULL) || (p_Frames == NULL) || (p_FrameCount == NULL) || (Count == 0) || (Count > RAK3172_PACK_MAX_RECORDS) || (MaxPayload == 0))
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    // Sort the remaining parts by length in descending order. Parts with the same length keep the order of the records.
+    Items = 0;
+    for(uint8_t i = 0; i < Count; i++)
+    {
+        uint8_t j;
+
+        if((p_Records[i].Data == NULL) && (p_Records[i].Length > 0))
+        {
+            return RAK3172_ERR_INVALID_ARG;
+        }
+
+        p_Frames[i] = RAK3172_PACK_NONE;
+
+        Rest = p_Records[i].Length % MaxPayload;
+        if(Rest == 0)
+        {
+            continue;
+        }
+
+        for(j = Items; (j > 0) && ((p_Records[Order[j - 1]].Length % MaxPayload) < Rest); j--)
+        {
+            Order[j] = Order[j - 1];
+        }
+
+        Order[j] = i;
+        Items++;
+    }
+
+    // Put each part into the first frame with enough space.
+    Frames = 0;
+    for(uint8_t i = 0; i < Items; i++)
+    {
+        uint8_t Frame;
+
+        Rest = p_Records[Order[i]].Length % MaxPayload;
+
+        for(Frame = 0; (Frame < Frames) && (Free[Frame] < Rest); Frame++);
+
+        if(Frame == Frames)
+        {
+            Free[Frames++] = MaxPayload;
+        }
+
+        Free[Frame] -= Rest;
+        p_Frames[Order[i]] = Frame;
+    }
+
+    *p_FrameCount = Frames;
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_LoRaWAN_TransmitRecords(RAK3172_t& p_Device, uint8_t Port, const RAK3172_Record_t* const p_Records, uint8_t Count, RAK3172_Uplink_Priority_t Priority, uint32_t Deadline, uint8_t Retries, bool Confirmed, uint8_t* const p_Uplinks)
+{
+    uint8_t Uplinks;
+    uint8_t MaxPayload;
+    uint8_t FrameCount;
+    uint16_t Length;
+    uint16_t Rest;
+    const uint8_t* Data;
+    RAK3172_Error_t Error;
+    uint8_t Frames[RAK3172_PACK_MAX_RECORDS];
+    uint8_t Buffer[RAK3172_PACK_FRAME_SIZE];
+
+    if(p_Uplinks != NULL)
+    {
+        *p_Uplinks = 0;
+    }
+
+    if(p_Device.Mode != RAK_MODE_LORAWAN)
+    {
+        return RAK3172_ERR_INVALID_MODE;
+    }
+    else if((p_Device.LoRaWAN.Config.Valid & RAK_LORAWAN_CFG_BAND) == 0)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_GetMaxPayload(p_Device.LoRaWAN.Config.Band, RAK3172_Uplink_GetDataRate(p_Device), &MaxPayload));
+    RAK3172_ERROR_CHECK(RAK3172_LoRaWAN_Pack(p_Records, Count, MaxPayload, Frames, &FrameCount));
+
+    Uplinks = 0;
+    Error = RAK3172_ERR_OK;
+
+    // The full size parts of large records are queued without copying them.
+    for(uint8_t i = 0; (i < Count) && (Error == RAK3172_ERR_OK); i++)
+    {
+        Data = static_cast<const uint8_t*>(p_Records[i].Data);
+
+        for(uint16_t Offset = 0; ((Offset + MaxPayload) <= p_Records[i].Length) && (Error == RAK3172_ERR_OK); Offset += MaxPayload)
+        {
+            Error = RAK3172_LoRaWAN_Schedule(p_Device, Port, &Data[Offset], MaxPayload, Priority, Deadline, Retries, Confirmed);
+            if(Error == RAK3172_ERR_OK)
+            {
+                Uplinks++;
+            }
+        }
+    }
+
+    // Concatenate the remaining parts of each packed frame in the order of the records.
+    for(uint8_t Frame = 0; (Frame < FrameCount) && (Error == RAK3172_ERR_OK); Frame++)
+    {
+        Length = 0;
+        for(uint8_t i = 0; i < Count; i++)
+        {
+            if(Frames[i] != Frame)
+            {
+                continue;
+            }
+
+            Data = static_cast<const uint8_t*>(p_Records[i].Data);
+            Rest = p_Records[i].Length % MaxPayload;
+            memcpy(&Buffer[Length], &Data[p_Records[i].Length - Rest], Rest);
+            Length += Rest;
+        }
+
+        Error = RAK3172_LoRaWAN_Schedule(p_Device, Port, Buffer, Length, Priority, Deadline, Retries, Confirmed);
+        if(Error == RAK3172_ERR_OK)
+        {
+            Uplinks++;
+        }
+    }
+
+    if(p_Uplinks != NULL)
+    {
+        *p_Uplinks = Uplinks;
+    }
+
+    return Error;
+}
+
+#endif
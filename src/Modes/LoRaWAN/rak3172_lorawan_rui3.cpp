@@ -23,6 +23,8 @@
 
 #include "rak3172.h"
 
+#include "../../Core/rak3172_parser.h"
+
 RAK3172_Error_t RAK3172_LoRaWAN_GetNetID(const RAK3172_t& p_Device, std::string* const p_ID)
 {
     if(p_ID == NULL)
@@ -70,9 +72,7 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetSingleChannelMode(const RAK3172_t& p_Device,
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+CHS=?", &Value));
 
-    *p_Enable = static_cast<bool>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Enable);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_SetEightChannelMode(const RAK3172_t& p_Device, bool Enable)
@@ -100,15 +100,14 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetEightChannelMode(const RAK3172_t& p_Device, b
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+CHE=?", &Value));
 
-    *p_Enable = static_cast<bool>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Enable);
 }
 
 RAK3172_Error_t RAK3172_LoRaWAN_GetChannelRSSI(const RAK3172_t& p_Device, std::vector<int>* p_RSSI)
 {
-    std::string Dummy;
     std::string Value;
+    std::string_view Input;
+    std::string_view Channel;
 
     if(p_RSSI == NULL)
     {
@@ -121,13 +120,17 @@ RAK3172_Error_t RAK3172_LoRaWAN_GetChannelRSSI(const RAK3172_t& p_Device, std::v
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+ARSSI=?", &Value));
 
-    do
+    // Format: <Channel>:<RSSI>,<Channel>:<RSSI>,...
+    Input = Value;
+    while(RAK3172_Parser_Next(&Input, ",", &Channel))
     {
-        Dummy = Value.substr(0, Value.find(","));
-        Value.erase(0, Dummy.length() + 1);
+        int RSSI;
+
+        Channel.remove_prefix(std::min(Channel.find(":") + 1, Channel.length()));
+        RAK3172_ERROR_CHECK(RAK3172_Parser_ToNumber(Channel, &RSSI));
 
-        p_RSSI->push_back(std::stoi(Dummy.substr(Dummy.find(":") + 1)));
-    } while(Value.length() > 0);
+        p_RSSI->push_back(RSSI);
+    }
 
     return RAK3172_ERR_OK;
 }
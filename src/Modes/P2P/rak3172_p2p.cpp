@@ -26,42 +26,138 @@
 #include <freertos/event_groups.h>
 #include <freertos/queue.h>
 
+#include "../../Core/rak3172_writer.h"
+#include "../../Core/rak3172_parser.h"
+#include "../../Core/rak3172_ring.h"
+#include "../../Core/rak3172_rxqueue.h"
 #include "../../Arch/Logging/rak3172_logging.h"
 
 #include "rak3172.h"
 
 static const char* TAG = "RAK3172_P2P";
 
-/** @brief          LoRa P2P receive task.
+#ifndef CONFIG_RAK3172_USE_RUI3
+    /** @brief              Check if a bandwidth is supported by the module.
+     *  @param Bandwidth    Bandwidth
+     *  @return             #true when the bandwidth is supported
+     */
+    static bool RAK3172_P2P_IsBandwidth(RAK3172_BW_t Bandwidth)
+    {
+        return (Bandwidth == RAK_BW_125) || (Bandwidth == RAK_BW_250) || (Bandwidth == RAK_BW_500);
+    }
+#endif
+
+/** @brief          LoRa P2P receive task. The task sleeps until a message, a receive timeout or a stop request is received.
  *  @param p_Arg    Pointer to task arguments
  */
 static void RAK3172_P2P_ReceiveTask(void* p_Arg)
 {
+    TaskHandle_t Waiter;
     RAK3172_t* Device = static_cast<RAK3172_t*>(p_Arg);
 
-    Device->P2P.Active = true;
-
+    // The stop request is handled before the received messages.
     while(Device->P2P.Active)
     {
         RAK3172_Rx_t* FromQueue = NULL;
 
-        if(xQueueReceive(Device->Internal.ReceiveQueue, &FromQueue, 20 / portTICK_PERIOD_MS) == pdPASS)
+        // Wake ups without a message are used for the receive timeout of the module and for a stop request.
+        if(RAK3172_RxQueue_Receive(*Device, &FromQueue, portMAX_DELAY) == false)
         {
-            if(Device->P2P.Timeout != RAK_REC_REPEAT)
+            Device->Internal.Wakeups++;
+
+            if(Device->P2P.isRxTimeout)
             {
-                Device->P2P.isRxTimeout = true;
-                Device->Internal.isBusy = false;
-                Device->P2P.Active = false;
+                break;
             }
 
-            xQueueSend(Device->P2P.ListenQueue, &FromQueue, 0);
+            continue;
+        }
+
+        Device->Internal.Wakeups++;
+
+        // The slot is passed to the listen queue and returned to the receive queue by the consumer.
+        if(RAK3172_Ring_Push(Device->P2P.ListenQueue, RAK3172_RxQueue_GetIndex(*Device, FromQueue)) == false)
+        {
+            RAK3172_LOGW(TAG, "Listen queue full. Drop message!");
+
+            RAK3172_RxQueue_Drop(*Device, FromQueue);
+        }
+
+        if(Device->P2P.Timeout != RAK_REC_REPEAT)
+        {
+            Device->P2P.isRxTimeout = true;
+
+            break;
         }
     }
 
-    vTaskSuspend(NULL);
+    Device->Internal.isBusy = false;
+    Device->P2P.Active = false;
+
+    Waiter = Device->Internal.Waiter;
+    Device->P2P.ListenHandle = NULL;
+    if(Waiter != NULL)
+    {
+        xTaskNotifyGive(Waiter);
+    }
+
     vTaskDelete(NULL);
 }
 
+/** @brief          Terminate the LoRa P2P receive task with a stop request and wait until the task has finished.
+ *  @param p_Device RAK3172 device object
+ */
+static void RAK3172_P2P_StopTask(RAK3172_t& p_Device)
+{
+    if(p_Device.P2P.ListenHandle == NULL)
+    {
+        return;
+    }
+
+    // Clear a stale notification from a previous wait for a message before the termination is awaited.
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    p_Device.Internal.Waiter = xTaskGetCurrentTaskHandle();
+    p_Device.P2P.Active = false;
+
+    // The task isn´t deleted by force, because it can be registered as consumer of the receive ring. The stop doorbell always ends the wait
+    // of the task, so the task terminates as soon as it gets the CPU.
+    RAK3172_RxQueue_Signal(p_Device);
+    if(ulTaskNotifyTake(pdTRUE, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == 0)
+    {
+        RAK3172_LOGW(TAG, "Receive task doesn´t respond. Wait for termination...");
+
+        while(p_Device.P2P.ListenHandle != NULL)
+        {
+            ulTaskNotifyTake(pdTRUE, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS);
+        }
+    }
+
+    p_Device.Internal.Waiter = NULL;
+    p_Device.Internal.isBusy = false;
+}
+
+/** @brief          Return the unread messages of the listen queue to the receive queue and delete the listen queue.
+ *  @param p_Device RAK3172 device object
+ */
+static void RAK3172_P2P_DeleteListenQueue(RAK3172_t& p_Device)
+{
+    uint8_t Index;
+
+    if(p_Device.P2P.ListenQueue == NULL)
+    {
+        return;
+    }
+
+    while(RAK3172_Ring_Pop(p_Device.P2P.ListenQueue, &Index))
+    {
+        RAK3172_RxQueue_Release(p_Device, RAK3172_RxQueue_GetSlot(p_Device, Index));
+    }
+
+    RAK3172_Ring_Delete(p_Device.P2P.ListenQueue);
+    p_Device.P2P.ListenQueue = NULL;
+}
+
 RAK3172_Error_t RAK3172_P2P_Init(RAK3172_t& p_Device, uint32_t Frequency, RAK3172_PSF_t SF, RAK3172_BW_t Bandwidth, RAK3172_CR_t CodeRate, uint16_t Preamble, uint8_t Power, uint32_t Timeout)
 {
     std::string Value;
@@ -157,9 +253,7 @@ RAK3172_Error_t RAK3172_P2P_GetFrequency(const RAK3172_t& p_Device, uint32_t* co
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PFREQ=?", &Value));
 
-    *p_Frequency = std::stoi(Value);
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Frequency);
 }
 
 RAK3172_Error_t RAK3172_P2P_SetSpreading(const RAK3172_t& p_Device, RAK3172_PSF_t SF)
@@ -195,9 +289,11 @@ RAK3172_Error_t RAK3172_P2P_GetSpreading(const RAK3172_t& p_Device, RAK3172_PSF_
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PSF=?", &Value));
 
-    *p_SF = static_cast<RAK3172_PSF_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        return RAK3172_Parser_ToNumber(Value, p_SF, RAK_PSF_5, RAK_PSF_12);
+    #else
+        return RAK3172_Parser_ToNumber(Value, p_SF, RAK_PSF_6, RAK_PSF_12);
+    #endif
 }
 
 RAK3172_Error_t RAK3172_P2P_SetBandwidth(const RAK3172_t& p_Device, uint32_t Bandwidth)
@@ -245,9 +341,11 @@ RAK3172_Error_t RAK3172_P2P_GetBandwidth(const RAK3172_t& p_Device, RAK3172_BW_t
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PBW=?", &Value));
 
-    *p_Bandwidth = static_cast<RAK3172_BW_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        return RAK3172_Parser_ToNumber(Value, p_Bandwidth, RAK_BW_125, RAK_BW_625);
+    #else
+        return RAK3172_Parser_ToNumber(Value, p_Bandwidth, RAK3172_P2P_IsBandwidth);
+    #endif
 }
 
 RAK3172_Error_t RAK3172_P2P_SetCodeRate(const RAK3172_t& p_Device, RAK3172_CR_t CodeRate)
@@ -279,9 +377,7 @@ RAK3172_Error_t RAK3172_P2P_GetCodeRate(const RAK3172_t& p_Device, RAK3172_CR_t*
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PCR=?", &Value));
 
-    *p_CodeRate = static_cast<RAK3172_CR_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_CodeRate, RAK_CR_45, RAK_CR_48);
 }
 
 RAK3172_Error_t RAK3172_P2P_SetPreamble(const RAK3172_t& p_Device, uint16_t Preamble)
@@ -317,9 +413,7 @@ RAK3172_Error_t RAK3172_P2P_GetPreamble(const RAK3172_t& p_Device, uint16_t* con
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PPL=?", &Value));
 
-    *p_Preamble = static_cast<uint16_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Preamble);
 }
 
 RAK3172_Error_t RAK3172_P2P_SetPower(const RAK3172_t& p_Device, uint8_t Power)
@@ -351,14 +445,12 @@ RAK3172_Error_t RAK3172_P2P_GetPower(const RAK3172_t& p_Device, uint8_t* const p
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PTP=?", &Value));
 
-    *p_Power = static_cast<uint8_t>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Power);
 }
 
 RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const uint8_t* const p_Buffer, uint8_t Length)
 {
-    std::string Payload;
+    RAK3172_Fragment_t Fragments[2];
 
     if((p_Buffer == NULL) && (Length > 0))
     {
@@ -373,20 +465,37 @@ RAK3172_Error_t RAK3172_P2P_Transmit(const RAK3172_t& p_Device, const uint8_t* c
         return RAK3172_ERR_OK;
     }
 
-    // Encode the payload into an ASCII string.
-    for(uint8_t i = 0; i < Length; i++)
-    {
-        char Buffer[3];
+    // The payload is encoded straight into the serial interface.
+    Fragments[0] = RAK3172_Fragment_Text("AT+PSEND=");
+    Fragments[1] = RAK3172_Fragment_Hex(p_Buffer, Length);
+
+    return RAK3172_SendCommand(p_Device, Fragments, 2);
+}
 
-        sprintf(Buffer, "%02x", ((uint8_t*)p_Buffer)[i]);
-        Payload += std::string(Buffer);
+RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_Message, uint16_t Timeout)
+{
+    const RAK3172_Rx_t* Message;
+
+    if(p_Message == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
     }
 
-    return RAK3172_SendCommand(p_Device, "AT+PSEND=" + Payload);
+    RAK3172_ERROR_CHECK(RAK3172_P2P_Borrow(p_Device, &Message, Timeout));
+
+    RAK3172_RxQueue_Copy(p_Message, Message);
+
+    RAK3172_ReleaseMessage(p_Device, Message);
+
+    return RAK3172_ERR_OK;
 }
 
-RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_Message, uint16_t Timeout)
+RAK3172_Error_t RAK3172_P2P_Borrow(RAK3172_t& p_Device, const RAK3172_Rx_t** p_Message, uint16_t Timeout)
 {
+    TickType_t Wait;
+    TickType_t Start;
+    TickType_t Elapsed;
+    TickType_t Remaining;
     RAK3172_Rx_t* FromQueue = NULL;
 
     if((p_Message == NULL) || (Timeout > 65534))
@@ -398,29 +507,46 @@ RAK3172_Error_t RAK3172_P2P_Receive(RAK3172_t& p_Device, RAK3172_Rx_t* const p_M
         return RAK3172_ERR_INVALID_MODE;
     }
 
+    // The flag must be cleared before the command is transmitted, because the receive timeout can occur before the command returns.
+    p_Device.P2P.isRxTimeout = false;
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=" + std::to_string(Timeout)));
 
-    p_Device.P2P.isRxTimeout = false;
-    do
+    // Wait for a message or for the receive timeout of the module. The receive modes without timeout wait forever.
+    Wait = portMAX_DELAY;
+    if(Timeout < RAK_REC_REPEAT)
     {
-        if(xQueueReceive(p_Device.Internal.ReceiveQueue, &FromQueue, 20 / portTICK_PERIOD_MS) == pdPASS)
-        {
-            p_Message->RSSI = FromQueue->RSSI;
-            p_Message->SNR = FromQueue->SNR;
-            p_Message->Payload = FromQueue->Payload;
+        Wait = (Timeout + RAK3172_DEFAULT_WAIT_TIMEOUT) / portTICK_PERIOD_MS;
+    }
 
-            delete FromQueue;
+    // Skip wake ups from a previous receive.
+    Start = xTaskGetTickCount();
+    Remaining = Wait;
+    while(RAK3172_RxQueue_Receive(p_Device, &FromQueue, Remaining) == false)
+    {
+        if(p_Device.P2P.isRxTimeout)
+        {
+            return RAK3172_ERR_TIMEOUT;
+        }
+        else if(Wait != portMAX_DELAY)
+        {
+            Elapsed = xTaskGetTickCount() - Start;
+            if(Elapsed >= Wait)
+            {
+                return RAK3172_ERR_TIMEOUT;
+            }
 
-            return RAK3172_ERR_OK;
+            Remaining = Wait - Elapsed;
         }
-    } while(p_Device.P2P.isRxTimeout == false);
+    }
 
-    return RAK3172_ERR_TIMEOUT;
+    *p_Message = FromQueue;
+
+    return RAK3172_ERR_OK;
 }
 
 RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout, uint8_t CoreID, uint8_t Priority, uint8_t QueueSize)
 {
-    if(QueueSize == 0)
+    if((QueueSize == 0) || (QueueSize == 0xFF))
     {
         return RAK3172_ERR_INVALID_ARG;
     }
@@ -429,11 +555,18 @@ RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout, uint8_
         return RAK3172_ERR_INVALID_MODE;
     }
 
+    // Terminate the receive task of a previous listen call.
+    RAK3172_P2P_StopTask(p_Device);
+
     p_Device.P2P.Timeout = Timeout;
+    p_Device.P2P.isRxTimeout = false;
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=" + std::to_string(p_Device.P2P.Timeout)));
 
-    p_Device.P2P.ListenQueue = xQueueCreate(QueueSize, sizeof(RAK3172_Rx_t*));
+    // Messages from a previous listen call, which weren´t read, are dropped.
+    RAK3172_P2P_DeleteListenQueue(p_Device);
+
+    p_Device.P2P.ListenQueue = RAK3172_Ring_Create(QueueSize);
     if(p_Device.P2P.ListenQueue == NULL)
     {
         RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=0"));
@@ -441,21 +574,17 @@ RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout, uint8_
         return RAK3172_ERR_NO_MEM;
     }
 
-    if(p_Device.P2P.ListenHandle != NULL)
-    {
-        vTaskDelete(p_Device.P2P.ListenHandle);
-    }
-
+    p_Device.P2P.Active = true;
     xTaskCreatePinnedToCore(RAK3172_P2P_ReceiveTask, "receiveTask", 2048, &p_Device, Priority, &p_Device.P2P.ListenHandle, CoreID);
     if(p_Device.P2P.ListenHandle == NULL)
     {
-        vQueueDelete(p_Device.P2P.ListenQueue);
+        p_Device.P2P.Active = false;
+        RAK3172_P2P_DeleteListenQueue(p_Device);
         RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=0"));
 
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    p_Device.P2P.isRxTimeout = false;
     p_Device.Internal.isBusy = true;
 
     return RAK3172_ERR_OK;
@@ -463,8 +592,26 @@ RAK3172_Error_t RAK3172_P2P_Listen(RAK3172_t& p_Device, uint16_t Timeout, uint8_
 
 RAK3172_Error_t RAK3172_P2P_PopItem(const RAK3172_t& p_Device, RAK3172_Rx_t* p_Message)
 {
+    const RAK3172_Rx_t* Message;
+
+    if(p_Message == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+
+    RAK3172_ERROR_CHECK(RAK3172_P2P_BorrowItem(p_Device, &Message));
+
+    RAK3172_RxQueue_Copy(p_Message, Message);
+
+    RAK3172_ReleaseMessage(p_Device, Message);
+
+    return RAK3172_ERR_OK;
+}
+
+RAK3172_Error_t RAK3172_P2P_BorrowItem(const RAK3172_t& p_Device, const RAK3172_Rx_t** p_Message)
+{
+    uint8_t Index;
     uint8_t Items;
-    RAK3172_Rx_t* FromQueue;
 
     if(p_Message == NULL)
     {
@@ -474,12 +621,13 @@ RAK3172_Error_t RAK3172_P2P_PopItem(const RAK3172_t& p_Device, RAK3172_Rx_t* p_M
     {
         return RAK3172_ERR_INVALID_MODE;
     }
-    else if((p_Device.P2P.ListenHandle == NULL) || (p_Device.P2P.ListenQueue == NULL))
+    // The received messages are kept after the receive task has finished.
+    else if(p_Device.P2P.ListenQueue == NULL)
     {
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    Items = uxQueueMessagesWaiting(p_Device.P2P.ListenQueue);
+    Items = RAK3172_Ring_Count(p_Device.P2P.ListenQueue);
     RAK3172_LOGD(TAG, "Items in queue: %u", Items);
 
     if(Items == 0)
@@ -487,14 +635,12 @@ RAK3172_Error_t RAK3172_P2P_PopItem(const RAK3172_t& p_Device, RAK3172_Rx_t* p_M
         return RAK3172_ERR_FAIL;
     }
 
-    if(xQueueReceive(p_Device.P2P.ListenQueue, &FromQueue, 0) != pdPASS)
+    if(RAK3172_Ring_Pop(p_Device.P2P.ListenQueue, &Index) == false)
     {
         return RAK3172_ERR_FAIL;
     }
 
-    *p_Message = *FromQueue;
-
-    delete FromQueue;
+    *p_Message = RAK3172_RxQueue_GetSlot(p_Device, Index);
 
     return RAK3172_ERR_OK;
 }
@@ -505,23 +651,15 @@ RAK3172_Error_t RAK3172_P2P_Stop(RAK3172_t& p_Device)
     {
         return RAK3172_ERR_INVALID_MODE;
     }
-    else if((p_Device.P2P.ListenHandle == NULL) || (p_Device.P2P.ListenQueue == NULL))
+    else if(p_Device.P2P.ListenHandle == NULL)
     {
         return RAK3172_ERR_OK;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+PRECV=" + std::to_string(RAK_REC_STOP)));
+    // The receive task clears the busy flag, which blocks the stop command.
+    RAK3172_P2P_StopTask(p_Device);
 
-    p_Device.P2P.Active = false;
-    p_Device.Internal.isBusy = false;
-
-    if(p_Device.P2P.ListenHandle != NULL)
-    {
-        vTaskSuspend(p_Device.P2P.ListenHandle);
-        vTaskDelete(p_Device.P2P.ListenHandle);
-    }
-
-    return RAK3172_ERR_OK;
+    return RAK3172_SendCommand(p_Device, "AT+PRECV=" + std::to_string(RAK_REC_STOP));
 }
 
 #endif
\ No newline at end of file
@@ -23,10 +23,12 @@
 
 #include "rak3172.h"
 
+#include "../../Core/rak3172_hex.h"
+#include "../../Core/rak3172_parser.h"
+
 RAK3172_Error_t RAK3172_P2P_EnableEncryption(RAK3172_t& p_Device, const RAK3172_EncryptKey_t p_Key)
 {
-    std::string Key;
-    char Buffer[3];
+    std::string Key = "AT+ENCKEY=";
 
     if(p_Key == NULL)
     {
@@ -41,14 +43,10 @@ RAK3172_Error_t RAK3172_P2P_EnableEncryption(RAK3172_t& p_Device, const RAK3172_
 
     p_Device.P2P.isEncryptionEnabled = true;
 
-    // Encode the key into an ASCII string.
-    for(uint8_t i = 0; i < 8; i++)
-    {
-        sprintf(Buffer, "%02x", ((uint8_t*)p_Key)[i]);
-        Key += std::string(Buffer);
-    }
+    // Encode the key into the command.
+    RAK3172_Hex_Append(&Key, p_Key, 8);
 
-    return RAK3172_SendCommand(p_Device, "AT+ENCKEY=" + Key, NULL, NULL);
+    return RAK3172_SendCommand(p_Device, Key, NULL, NULL);
 }
 
 RAK3172_Error_t RAK3172_P2P_DisableEncryption(RAK3172_t& p_Device)
@@ -80,9 +78,7 @@ RAK3172_Error_t RAK3172_P2P_isEncryptionEnabled(const RAK3172_t& p_Device, bool*
 
     RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+ENCRY=?", &Value));
 
-    *p_Enabled = static_cast<bool>(std::stoi(Value));
-
-    return RAK3172_ERR_OK;
+    return RAK3172_Parser_ToNumber(Value, p_Enabled);
 }
 
 #endif
\ No newline at end of file
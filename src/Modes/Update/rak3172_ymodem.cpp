@@ -24,15 +24,22 @@
 
 #include <string.h>
 
+#include <new>
+#include <algorithm>
+
 #include "rak3172.h"
 
+#include "../../Core/rak3172_registry.h"
+
+#include "rak3172_ymodem_crc.h"
+
 #define YMODEM_INITIAL_PACKET_SIZE		128
 #define YMODEM_PACKET_SIZE				1024
 #define YMODEM_HEADER_SIZE				3
 
-/** @brief CRC polynomial used by the Ymodem protocol.
+/** @brief Number of transmissions of a packet before the update is aborted.
  */
-#define YMODEM_CRC_POLY					0x1021
+#define YMODEM_MAX_RETRIES				10
 
 /** @brief Start of a 128 byte data packet.
  */
@@ -54,88 +61,94 @@
  */
 #define YMODEM_EOT						0x04
 
-/** @brief  		Update the CRC16 value with a given input byte.
- * 	@param CRC_In	CRC input
- * 	@param Input	Input byte
- * 	@return			New CRC16 value
+/** @brief Cancel the transmission.
  */
-static uint16_t RAK3172_Ymodem_UpdateCRC16(uint16_t CRC_In, uint16_t Input)
-{
-	uint16_t XOR;
-	uint16_t Out;
-
-	Out = CRC_In << 1;
-	XOR = CRC_In >> 15;
+#define YMODEM_CAN						0x18
 
-	if(Input)
-	{
-		Out++;
-	}
-
-	if(XOR)
-	{
-		Out ^= YMODEM_CRC_POLY;
-	}
+/** @brief Padding byte for the final data packet.
+ */
+#define YMODEM_PADDING					0x1A
 
-	return Out;
-}
+/** @brief Prepared data packet.
+ */
+typedef struct
+{
+	const uint8_t* p_Data;				/**< Pointer to packet data. */
+	uint16_t Length;					/**< Length of the packet data. */
+	uint16_t CRC;						/**< CRC16 of the packet data and the padding. */
+} RAK3172_Ymodem_Block_t;
 
-/** @brief  		Calculate the CRC16 for a YModem Packet.
- *  @param p_Data	Input data
+/** @brief  		Write data to the module.
+ *  @param p_Device	RAK3172 device object
+ *  @param p_Data	Pointer to data
  *  @param Length	Data length
- *  @return			CRC checksum
+ *  @return			RAK3172_ERR_OK when successful
+ * 					RAK3172_ERR_FAIL when the data cannot be transmitted
  */
-static uint16_t RAK3172_Ymodem_CRC16(const uint8_t* p_Data, uint32_t Length)
+static RAK3172_Error_t RAK3172_Ymodem_Write(RAK3172_t& p_Device, const void* p_Data, size_t Length)
 {
-	uint16_t CRC;
-
-	for(CRC = 0; Length > 0; Length--, p_Data++)
+	if((Length > 0) && (uart_write_bytes(p_Device.UART.Interface, p_Data, Length) != static_cast<int>(Length)))
 	{
-		for(uint16_t i = 0x80; i; i >>= 1)
-		{
-			CRC = RAK3172_Ymodem_UpdateCRC16(CRC, *p_Data & i);
-		}
-	}
-
-	for(uint16_t i = 0; i < 16; i++)
-	{
-		CRC = RAK3172_Ymodem_UpdateCRC16(CRC, 0);
+		return RAK3172_ERR_FAIL;
 	}
 
-	return CRC;
+	return RAK3172_ERR_OK;
 }
 
-/** @brief				Prepare and transmit a packet.
+/** @brief				Transmit a packet. The data is transmitted without copying it and only the missing bytes are padded.
  *  @param p_Device		RAK3172 device object
- *  @param p_Header		Pointer to header data
- *  @param LengthHeader	Length of the data
+ *  @param Start		Start byte of the packet
+ *  @param Index		Packet index
  *  @param p_Data		Pointer to data
- *  @param LengthData	Length of the data
+ *  @param Length		Length of the data
+ *  @param Size			Packet size
+ *  @param Padding		Padding byte for the missing data
+ *  @param CRC			CRC16 of the data and the padding
  *  @return				RAK3172_ERR_OK when successful
  * 						RAK3172_ERR_FAIL when the data cannot be transmitted
- * 						RAK3172_ERR_INVALID_RESPONSE when the update process can´t get started
  */
-static RAK3172_Error_t RAK3172_Ymodem_Transmit(RAK3172_t& p_Device, const uint8_t* const p_Header, uint8_t LengthHeader, const uint8_t* const p_Data, uint16_t LengthData)
+static RAK3172_Error_t RAK3172_Ymodem_TransmitPacket(RAK3172_t& p_Device, uint8_t Start, uint8_t Index, const uint8_t* const p_Data, uint16_t Length, uint16_t Size, uint8_t Padding, uint16_t CRC)
 {
-	uint16_t CRC;
-	uint8_t Temp[2];
+	uint8_t Temp[32];
+	uint8_t Header[YMODEM_HEADER_SIZE];
+
+	Header[0] = Start;
+	Header[1] = Index;
+	Header[2] = 0xFF - Index;
 
-	CRC = RAK3172_Ymodem_CRC16(p_Data, LengthData);
+	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Write(p_Device, Header, sizeof(Header)));
+	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Write(p_Device, p_Data, Length));
 
-	// Transmit the message header and the initial message payload.
-    if((uart_write_bytes(p_Device.UART.Interface, p_Header, LengthHeader) != LengthHeader) &&
-	   (uart_write_bytes(p_Device.UART.Interface, p_Data, LengthData) != LengthData)
-	  )
+	// Transmit the padding in small chunks.
+	memset(Temp, Padding, sizeof(Temp));
+	for(uint16_t Remaining = Size - Length; Remaining > 0; )
 	{
-		return RAK3172_ERR_FAIL;
+		uint16_t Chunk = std::min(Remaining, static_cast<uint16_t>(sizeof(Temp)));
+
+		RAK3172_ERROR_CHECK(RAK3172_Ymodem_Write(p_Device, Temp, Chunk));
+		Remaining -= Chunk;
 	}
- 
+
 	// Transmit the CRC.
 	Temp[0] = CRC >> 0x08;
 	Temp[1] = CRC & 0xFF;
-    if(uart_write_bytes(p_Device.UART.Interface, Temp, sizeof(Temp)) != sizeof(Temp))
+
+	return RAK3172_Ymodem_Write(p_Device, Temp, 2);
+}
+
+/** @brief				Wait for a response from the module.
+ *  @param p_Device		RAK3172 device object
+ *  @param p_Response	Pointer to response buffer
+ *  @param Length		Expected response length
+ *  @param Timeout		Timeout in seconds
+ *  @return				RAK3172_ERR_OK when successful
+ * 						RAK3172_ERR_TIMEOUT when the response wasn´t received
+ */
+static RAK3172_Error_t RAK3172_Ymodem_Receive(RAK3172_t& p_Device, uint8_t* p_Response, uint8_t Length, uint8_t Timeout)
+{
+	if(uart_read_bytes(p_Device.UART.Interface, p_Response, Length, (Timeout * 1000UL) / portTICK_PERIOD_MS) != Length)
 	{
-		return RAK3172_ERR_FAIL;
+		return RAK3172_ERR_TIMEOUT;
 	}
 
 	return RAK3172_ERR_OK;
@@ -152,35 +165,26 @@ static RAK3172_Error_t RAK3172_Ymodem_Transmit(RAK3172_t& p_Device, const uint8_
  */
 static RAK3172_Error_t RAK3172_Ymodem_TransmitIntialPacket(RAK3172_t& p_Device, const char* const p_FileName, uint8_t Length, uint8_t Timeout = 1)
 {
-	uint8_t Header[YMODEM_HEADER_SIZE];
-	uint8_t Data[YMODEM_INITIAL_PACKET_SIZE];
+	uint16_t CRC;
+	uint8_t Response[2];
 
 	if(Length > YMODEM_INITIAL_PACKET_SIZE)
 	{
 		return RAK3172_ERR_INVALID_ARG;
 	}
 
-	Header[0] = YMODEM_SOH;
-	Header[1] = 0x00;
-	Header[2] = 0xFF;
-
-	memset(Data, 0, sizeof(Data));
+	CRC = RAK3172_Ymodem_CRC16(reinterpret_cast<const uint8_t*>(p_FileName), Length, 0);
+	CRC = RAK3172_Ymodem_PaddingCRC16(0x00, YMODEM_INITIAL_PACKET_SIZE - Length, CRC);
 
-	// Copy the filename into the buffer
-	for(uint8_t i = 0; i < Length; i++)
-	{
-		Data[i] = p_FileName[i];
-	}
-
-	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Transmit(p_Device, Header, sizeof(Header), Data, sizeof(Data)));
+	RAK3172_ERROR_CHECK(RAK3172_Ymodem_TransmitPacket(p_Device, YMODEM_SOH, 0x00, reinterpret_cast<const uint8_t*>(p_FileName), Length, YMODEM_INITIAL_PACKET_SIZE, 0x00, CRC));
 
 	// Wait for ACK and 'C'.
-	if(uart_read_bytes(p_Device.UART.Interface, Data, 2, (Timeout * 1000UL) / portTICK_RATE_MS) == -1)
+	if(RAK3172_Ymodem_Receive(p_Device, Response, sizeof(Response), Timeout) != RAK3172_ERR_OK)
 	{
 		return RAK3172_ERR_INVALID_RESPONSE;
 	}
 
-	if((Data[0] == YMODEM_ACK) && (Data[1] = 'C'))
+	if((Response[0] == YMODEM_ACK) && (Response[1] == 'C'))
 	{
 		return RAK3172_ERR_OK;
 	}
@@ -188,112 +192,109 @@ static RAK3172_Error_t RAK3172_Ymodem_TransmitIntialPacket(RAK3172_t& p_Device,
 	return RAK3172_ERR_FAIL;
 }
 
-/** @brief			Transmit a data block.
- *  @param p_Device	RAK3172 device object
- *  @param Index	Packet index
- *  @param p_Data	Pointer to data
- *  @param Length	(Optional) Data length
- *  @param Timeout	(Optional) Timeout in seconds
+/** @brief			Prepare the next data block. The block is read and the CRC is calculated while the previous block is transmitted.
+ *  @param p_Image	Pointer to file data or NULL when the reader is used
+ *  @param Offset	Offset of the block in the file
+ *  @param Size		File length
+ *  @param Reader	Reader for the file data when no file data is used
+ *  @param p_Arg	Reader argument
+ *  @param p_Buffer	Pointer to block buffer for the reader
+ *  @param p_Block	Pointer to prepared block
  *  @return         RAK3172_ERR_OK when successful
- * 					RAK3172_ERR_FAIL when the data cannot be transmitted
- * 					RAK3172_ERR_INVALID_RESPONSE when the update process can´t get started
+ * 					Error of the reader when the reader fails
  */
-static RAK3172_Error_t RAK3172_Ymodem_TransmitPacket(RAK3172_t& p_Device, uint8_t Index, const uint8_t* const p_Data, uint16_t Length = YMODEM_PACKET_SIZE, uint8_t Timeout = 1)
+static RAK3172_Error_t RAK3172_Ymodem_Prepare(const uint8_t* const p_Image, uint32_t Offset, uint32_t Size, RAK3172_Update_Reader_t Reader, void* p_Arg, uint8_t* p_Buffer, RAK3172_Ymodem_Block_t* p_Block)
 {
-	uint8_t Data[YMODEM_PACKET_SIZE];
-	uint8_t Header[YMODEM_HEADER_SIZE];
-
-	if(Length > YMODEM_PACKET_SIZE)
-	{
-		return RAK3172_ERR_INVALID_ARG;
-	}
-
-	memset(Data, 0x00, YMODEM_PACKET_SIZE);
+	p_Block->Length = std::min(Size - Offset, static_cast<uint32_t>(YMODEM_PACKET_SIZE));
 
-	// Copy the data into the transmit buffer.
-	for(uint16_t i = 0; i < Length; i++)
+	// Transmit full blocks directly from memory. Otherwise read the block into the buffer.
+	if(p_Image != NULL)
 	{
-		Data[i] = p_Data[i];
+		p_Block->p_Data = &p_Image[Offset];
 	}
-
-	Header[0] = YMODEM_STX;
-	Header[1] = Index;
-	Header[2] = 0xFF - Index;
-
-	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Transmit(p_Device, Header, sizeof(Header), Data, sizeof(Data)));
-
-	// Wait for ACK and 'C'.
-	if(uart_read_bytes(p_Device.UART.Interface, Data, 1, (Timeout * 1000UL) / portTICK_RATE_MS) == -1)
+	else
 	{
-		return RAK3172_ERR_INVALID_RESPONSE;
+		RAK3172_ERROR_CHECK(Reader(Offset, p_Buffer, p_Block->Length, p_Arg));
+		p_Block->p_Data = p_Buffer;
 	}
 
-	if(Data[1] = 'C')
-	{
-		return RAK3172_ERR_OK;
-	}
+	p_Block->CRC = RAK3172_Ymodem_CRC16(p_Block->p_Data, p_Block->Length, 0);
+	p_Block->CRC = RAK3172_Ymodem_PaddingCRC16(YMODEM_PADDING, YMODEM_PACKET_SIZE - p_Block->Length, p_Block->CRC);
 
-	return RAK3172_ERR_FAIL;
+	return RAK3172_ERR_OK;
 }
 
-/** @brief			Transmit the final data block.
+/** @brief			Wait for the acknowledge of a data block. Unexpected characters are ignored.
  *  @param p_Device	RAK3172 device object
- *  @param Index	Packet index
- *  @param p_Data	Pointer to data
- *  @param Length	Data length
+ *  @param p_Stats	Pointer to update statistics
  *  @param Timeout	(Optional) Timeout in seconds
- *  @return         RAK3172_ERR_OK when successful
- * 					RAK3172_ERR_FAIL when the data cannot be transmitted
- * 					RAK3172_ERR_INVALID_RESPONSE when the update process can´t get started
+ *  @return         RAK3172_ERR_OK when the block was acknowledged
+ * 					RAK3172_ERR_INVALID_RESPONSE when the module requests a retransmission
+ * 					RAK3172_ERR_TIMEOUT when the module doesn´t respond
+ * 					RAK3172_ERR_FAIL when the module cancels the transmission
  */
-static RAK3172_Error_t RAK3172_Ymodem_TransmitFinalPacket(RAK3172_t& p_Device, uint8_t Index, const uint8_t* const p_Data, uint16_t Length, uint8_t Timeout = 1)
+static RAK3172_Error_t RAK3172_Ymodem_WaitAck(RAK3172_t& p_Device, RAK3172_Update_Stats_t* p_Stats, uint8_t Timeout = 1)
 {
-	uint8_t Data[YMODEM_PACKET_SIZE];
-	uint8_t Header[YMODEM_HEADER_SIZE];
+	uint8_t Response;
+	TickType_t Start;
 
-	if(Length > YMODEM_PACKET_SIZE)
+	Start = xTaskGetTickCount();
+	do
 	{
-		return RAK3172_ERR_INVALID_ARG;
-	}
+		if(RAK3172_Ymodem_Receive(p_Device, &Response, 1, Timeout) != RAK3172_ERR_OK)
+		{
+			break;
+		}
+
+		if(Response == YMODEM_ACK)
+		{
+			return RAK3172_ERR_OK;
+		}
+		else if(Response == YMODEM_NAK)
+		{
+			p_Stats->NAKs++;
 
-	memset(Data, 0x1A, YMODEM_PACKET_SIZE);
+			return RAK3172_ERR_INVALID_RESPONSE;
+		}
+		else if(Response == YMODEM_CAN)
+		{
+			return RAK3172_ERR_FAIL;
+		}
+	} while((xTaskGetTickCount() - Start) < ((Timeout * 1000UL) / portTICK_PERIOD_MS));
 
-	// Copy the data into the transmit buffer.
-	for(uint16_t i = 0; i < Length; i++)
-	{
-		Data[i] = p_Data[i];
-	}
+	p_Stats->Timeouts++;
 
-	Header[0] = YMODEM_STX;
-	Header[1] = Index;
-	Header[2] = 0xFF - Index;
+	return RAK3172_ERR_TIMEOUT;
+}
 
-	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Transmit(p_Device, Header, sizeof(Header), Data, sizeof(Data)));
+/** @brief			Finish the transmission.
+ *  @param p_Device	RAK3172 device object
+ *  @param Timeout	(Optional) Timeout in seconds
+ *  @return         RAK3172_ERR_OK when successful
+ * 					RAK3172_ERR_FAIL when the data cannot be transmitted
+ * 					RAK3172_ERR_INVALID_RESPONSE when the module doesn´t finish the transmission
+ */
+static RAK3172_Error_t RAK3172_Ymodem_TransmitEnd(RAK3172_t& p_Device, uint8_t Timeout = 1)
+{
+	uint8_t Data[2];
 
 	// Send the first 'EOT'. The device should response with 'NAK'.
 	Data[0] = YMODEM_EOT;
-	if((uart_write_bytes(p_Device.UART.Interface, Data, 1) != 1) &&
-	   (uart_read_bytes(p_Device.UART.Interface, Data, 1, (Timeout * 1000UL) / portTICK_RATE_MS) == -1)
-	  )
-	{
-		return RAK3172_ERR_FAIL;
-	}
-
-	if(Data[0] != YMODEM_NAK)
+	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Write(p_Device, Data, 1));
+	if((RAK3172_Ymodem_Receive(p_Device, Data, 1, Timeout) != RAK3172_ERR_OK) || (Data[0] != YMODEM_NAK))
 	{
 		return RAK3172_ERR_INVALID_RESPONSE;
 	}
 
 	// Send the second 'EOT'. The device should response with 'ACK' and 'C'.
 	Data[0] = YMODEM_EOT;
-	if((uart_write_bytes(p_Device.UART.Interface, Data, 1) != 1) &&
-	   (uart_read_bytes(p_Device.UART.Interface, Data, 2, (Timeout * 1000UL) / portTICK_RATE_MS) == -1)
-	  )
+	RAK3172_ERROR_CHECK(RAK3172_Ymodem_Write(p_Device, Data, 1));
+	if(RAK3172_Ymodem_Receive(p_Device, Data, 2, Timeout) != RAK3172_ERR_OK)
 	{
-		return RAK3172_ERR_FAIL;
+		return RAK3172_ERR_INVALID_RESPONSE;
 	}
 
-	if((Data[0] == YMODEM_ACK) && (Data[1] = 'C'))
+	if((Data[0] == YMODEM_ACK) && (Data[1] == 'C'))
 	{
 		return RAK3172_ERR_OK;
 	}
@@ -301,84 +302,202 @@ static RAK3172_Error_t RAK3172_Ymodem_TransmitFinalPacket(RAK3172_t& p_Device, u
 	return RAK3172_ERR_FAIL;
 }
 
-/** @brief  			Transmit a file using the Ymodem protocol.
+/** @brief  			Transmit a file using the Ymodem protocol. The data is either transmitted from memory or read block by block with a reader.
+ * 						The next block is prepared while the current block is transmitted and acknowledged.
  *  @param p_Device 	RAK3172 device object
- *  @param p_Data		Pointer to file data
- *  @param LengthData	File length
- *  @param p_FileName	Pointer to filename
- *  @param LengthName	File name length
+ *  @param p_Image		Pointer to file data or NULL when the reader is used
+ *  @param Size			File length
+ *  @param Reader		Reader for the file data when no file data is used
+ *  @param p_Arg		Reader argument
+ *  @param p_Stats		Pointer to update statistics
  *  @return         	RAK3172_ERR_OK when successful
+ * 						RAK3172_ERR_NO_MEM when the block buffers can´t be allocated
  */
-static RAK3172_Error_t RAK3172_Ymodem_Transmit(RAK3172_t& p_Device, const uint8_t* const p_Data, uint32_t LengthData, const char* const p_FileName, uint8_t LengthName)
+static RAK3172_Error_t RAK3172_Ymodem_Transmit(RAK3172_t& p_Device, const uint8_t* const p_Image, uint32_t Size, RAK3172_Update_Reader_t Reader, void* p_Arg, RAK3172_Update_Stats_t* p_Stats)
 {
 	uint8_t Index;
-	uint8_t* Data;
-	uint32_t Length;
-	uint32_t BytesToTransmit;
+	uint8_t Current;
+	uint32_t Offset;
+	uint8_t* Buffers[2] = {NULL, NULL};
+	RAK3172_Ymodem_Block_t Blocks[2];
 	RAK3172_Error_t Error;
 
-	RAK3172_ERROR_CHECK(RAK3172_Ymodem_TransmitIntialPacket(p_Device, p_FileName, LengthName));
-
-	Data = (uint8_t*)p_Data;
-	Length = LengthData - YMODEM_PACKET_SIZE;
-	Index = 1;
-
-	while(Length)
+	// Two block buffers are needed to read the next block while the current block is in flight.
+	if(p_Image == NULL)
 	{
-		if(Length >= YMODEM_PACKET_SIZE)
+		Buffers[0] = new (std::nothrow) uint8_t[2 * YMODEM_PACKET_SIZE];
+		if(Buffers[0] == NULL)
 		{
-			BytesToTransmit = YMODEM_PACKET_SIZE;
+			return RAK3172_ERR_NO_MEM;
 		}
-		else
+
+		Buffers[1] = &Buffers[0][YMODEM_PACKET_SIZE];
+	}
+
+	Error = RAK3172_Ymodem_TransmitIntialPacket(p_Device, NULL, 0);
+	if(Error == RAK3172_ERR_OK)
+	{
+		Error = RAK3172_Ymodem_Prepare(p_Image, 0, Size, Reader, p_Arg, Buffers[0], &Blocks[0]);
+	}
+
+	Index = 1;
+	Current = 0;
+	for(Offset = 0; (Error == RAK3172_ERR_OK) && (Offset < Size); Offset += YMODEM_PACKET_SIZE)
+	{
+		bool isPrepared = ((Offset + YMODEM_PACKET_SIZE) >= Size);
+
+		for(uint8_t Retries = 0; Retries < YMODEM_MAX_RETRIES; Retries++)
 		{
-			BytesToTransmit = BytesToTransmit;
+			if(Retries > 0)
+			{
+				p_Stats->Retries++;
+			}
+
+			Error = RAK3172_Ymodem_TransmitPacket(p_Device, YMODEM_STX, Index, Blocks[Current].p_Data, Blocks[Current].Length, YMODEM_PACKET_SIZE, YMODEM_PADDING, Blocks[Current].CRC);
+			p_Stats->Packets++;
+
+			// Prepare the next block while the UART transmits the current block.
+			if((Error == RAK3172_ERR_OK) && (isPrepared == false))
+			{
+				Error = RAK3172_Ymodem_Prepare(p_Image, Offset + YMODEM_PACKET_SIZE, Size, Reader, p_Arg, Buffers[Current ^ 0x01], &Blocks[Current ^ 0x01]);
+				isPrepared = true;
+			}
+
+			if(Error == RAK3172_ERR_OK)
+			{
+				Error = RAK3172_Ymodem_WaitAck(p_Device, p_Stats);
+			}
+
+			// Only a NAK or a missing response is repeated.
+			if((Error != RAK3172_ERR_INVALID_RESPONSE) && (Error != RAK3172_ERR_TIMEOUT))
+			{
+				break;
+			}
 		}
 
-		Error = RAK3172_Ymodem_TransmitPacket(p_Device, Index, Data, BytesToTransmit);
-		if(Error != RAK3172_ERR_OK)
+		if(Error == RAK3172_ERR_OK)
 		{
-			continue;
+			p_Stats->Bytes += Blocks[Current].Length;
+			Current ^= 0x01;
+			Index++;
 		}
+	}
 
-		Index++;
-		Length -= BytesToTransmit;
-		Data += BytesToTransmit;
+	if(Error == RAK3172_ERR_OK)
+	{
+		Error = RAK3172_Ymodem_TransmitEnd(p_Device);
 	}
 
-	// Transmit the last and final packet.
-	RAK3172_ERROR_CHECK(RAK3172_Ymodem_TransmitFinalPacket(p_Device, Index, Data, YMODEM_PACKET_SIZE));
+	delete[] Buffers[0];
 
-	return RAK3172_ERR_OK;
+	return Error;
 }
 
-RAK3172_Error_t RAK3172_RunUpdate(RAK3172_t& p_Device, const uint8_t* const p_Data, uint32_t Length)
+/** @brief  			Run a firmware update with the Ymodem protocol.
+ *  @param p_Device 	RAK3172 device object
+ *  @param p_Image		Pointer to file data or NULL when the reader is used
+ *  @param Size			File length
+ *  @param Reader		Reader for the file data when no file data is used
+ *  @param p_Arg		Reader argument
+ *  @param p_Stats		(Optional) Pointer to update statistics
+ *  @return         	RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t RAK3172_Ymodem_Update(RAK3172_t& p_Device, const uint8_t* const p_Image, uint32_t Size, RAK3172_Update_Reader_t Reader, void* p_Arg, RAK3172_Update_Stats_t* p_Stats)
 {
 	std::string Status;
+	TickType_t Start;
 	RAK3172_Error_t Error;
+	RAK3172_Update_Stats_t Stats;
 
-	if((p_Data == NULL) || (Length == 0))
-	{
-		return RAK3172_ERR_INVALID_ARG;
-	}
+	memset(&Stats, 0, sizeof(RAK3172_Update_Stats_t));
+
+	#ifdef CONFIG_RAK3172_UART_USE_BURST
+		RAK3172_ERROR_CHECK(RAK3172_BeginBurst(p_Device));
+	#endif
 
 	// Put the device into DFU mode.
 	RAK3172_SendCommand(p_Device, "AT+BOOT", NULL, &Status);
 	if(Status.find("AT_BUSY_ERROR") != std::string::npos)
 	{
+		#ifdef CONFIG_RAK3172_UART_USE_BURST
+			RAK3172_EndBurst(p_Device);
+		#endif
+
 		return RAK3172_ERR_BUSY;
 	}
 
-	vTaskSuspend(p_Device.Internal.Handle);
+	#ifdef CONFIG_RAK3172_TASK_SHARED
+		RAK3172_Registry_Pause(p_Device, true);
+	#else
+		vTaskSuspend(p_Device.Internal.Handle);
+	#endif
 
-	Error = RAK3172_Ymodem_Transmit(p_Device, p_Data, Length, NULL, 0);
+	// Remove the rest of the status line (i. e. the LF), so that it isn´t read as response of the first packet.
+	uart_flush(p_Device.UART.Interface);
+
+	Start = xTaskGetTickCount();
+	Error = RAK3172_Ymodem_Transmit(p_Device, p_Image, Size, Reader, p_Arg, &Stats);
+	Stats.Duration = (xTaskGetTickCount() - Start) * portTICK_PERIOD_MS;
+	if(Stats.Duration > 0)
+	{
+		Stats.Throughput = (static_cast<uint64_t>(Stats.Bytes) * 1000UL) / Stats.Duration;
+	}
 
 	uart_flush(p_Device.UART.Interface);
-	vTaskResume(p_Device.Internal.Handle);
+	#ifdef CONFIG_RAK3172_TASK_SHARED
+		RAK3172_Registry_Pause(p_Device, false);
+	#else
+		vTaskResume(p_Device.Internal.Handle);
+	#endif
+
+	if(p_Stats != NULL)
+	{
+		*p_Stats = Stats;
+	}
 
 	// Leave DFU mode.
-	Error |= RAK3172_SendCommand(p_Device, "AT+RUN");
+	if(Error != RAK3172_ERR_OK)
+	{
+		RAK3172_SendCommand(p_Device, "AT+RUN");
+	}
+	else
+	{
+		Error = RAK3172_SendCommand(p_Device, "AT+RUN");
+	}
 
-	return RAK3172_ERR_OK;
+	// Report a failed baud rate restore only when the update was successful.
+	#ifdef CONFIG_RAK3172_UART_USE_BURST
+		if(Error == RAK3172_ERR_OK)
+		{
+			Error = RAK3172_EndBurst(p_Device);
+		}
+		else
+		{
+			RAK3172_EndBurst(p_Device);
+		}
+	#endif
+
+	return Error;
+}
+
+RAK3172_Error_t RAK3172_RunUpdate(RAK3172_t& p_Device, const uint8_t* const p_Data, uint32_t Length, RAK3172_Update_Stats_t* p_Stats)
+{
+	if((p_Data == NULL) || (Length == 0))
+	{
+		return RAK3172_ERR_INVALID_ARG;
+	}
+
+	return RAK3172_Ymodem_Update(p_Device, p_Data, Length, NULL, NULL, p_Stats);
+}
+
+RAK3172_Error_t RAK3172_RunUpdate(RAK3172_t& p_Device, uint32_t Size, RAK3172_Update_Reader_t Reader, void* p_Arg, RAK3172_Update_Stats_t* p_Stats)
+{
+	if((Reader == NULL) || (Size == 0))
+	{
+		return RAK3172_ERR_INVALID_ARG;
+	}
+
+	return RAK3172_Ymodem_Update(p_Device, NULL, Size, Reader, p_Arg, p_Stats);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+ /*
+ * rak3172_ymodem_crc.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Table driven CRC16 of the Ymodem protocol for the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_YMODEM_CRC_H_
+#define RAK3172_YMODEM_CRC_H_
+
+#include <stdint.h>
+
+/** @brief CRC polynomial used by the Ymodem protocol.
+ */
+#define YMODEM_CRC_POLY                                         0x1021
+
+/** @brief CRC16 lookup table for a whole byte.
+ */
+typedef struct
+{
+    uint16_t Entries[256];              /**< CRC of each byte value. */
+} RAK3172_Ymodem_CRCTable_t;
+
+/** @brief  Build the CRC16 lookup table for the Ymodem polynomial.
+ *  @return Lookup table
+ */
+static constexpr RAK3172_Ymodem_CRCTable_t RAK3172_Ymodem_BuildCRCTable(void)
+{
+    RAK3172_Ymodem_CRCTable_t Table = {};
+
+    for(uint16_t i = 0; i < 256; i++)
+    {
+        uint16_t CRC = i << 8;
+
+        for(uint8_t Bit = 0; Bit < 8; Bit++)
+        {
+            CRC = (CRC & 0x8000) ? ((CRC << 1) ^ YMODEM_CRC_POLY) : (CRC << 1);
+        }
+
+        Table.Entries[i] = CRC;
+    }
+
+    return Table;
+}
+
+static constexpr RAK3172_Ymodem_CRCTable_t _RAK3172_Ymodem_CRCTable = RAK3172_Ymodem_BuildCRCTable();
+
+/** @brief          Update the CRC16 value with a given input byte.
+ *  @param CRC      CRC input
+ *  @param Input    Input byte
+ *  @return         New CRC16 value
+ */
+static inline uint16_t RAK3172_Ymodem_UpdateCRC16(uint16_t CRC, uint8_t Input)
+{
+    return (CRC << 8) ^ _RAK3172_Ymodem_CRCTable.Entries[(CRC >> 8) ^ Input];
+}
+
+/** @brief          Update the CRC16 value with a data block.
+ *  @param p_Data   Pointer to data
+ *  @param Length   Data length
+ *  @param CRC      CRC of the previous packet data
+ *  @return         New CRC16 value
+ */
+static inline uint16_t RAK3172_Ymodem_CRC16(const uint8_t* p_Data, uint16_t Length, uint16_t CRC)
+{
+    for(uint16_t i = 0; i < Length; i++)
+    {
+        CRC = RAK3172_Ymodem_UpdateCRC16(CRC, p_Data[i]);
+    }
+
+    return CRC;
+}
+
+/** @brief          Update the CRC16 value with padding bytes.
+ *  @param Padding  Padding byte
+ *  @param Length   Padding length
+ *  @param CRC      CRC of the previous packet data
+ *  @return         New CRC16 value
+ */
+static inline uint16_t RAK3172_Ymodem_PaddingCRC16(uint8_t Padding, uint16_t Length, uint16_t CRC)
+{
+    for(uint16_t i = 0; i < Length; i++)
+    {
+        CRC = RAK3172_Ymodem_UpdateCRC16(CRC, Padding);
+    }
+
+    return CRC;
+}
+
+#endif /* RAK3172_YMODEM_CRC_H_ */
@@ -19,17 +19,42 @@
 
 #include <algorithm>
 
+#include <string.h>
+
 #include <sdkconfig.h>
 
+#include <esp_rom_crc.h>
+
 #include "rak3172.h"
 
+#include "Core/rak3172_events.h"
+#include "Core/rak3172_cmdqueue.h"
+#include "Core/rak3172_hex.h"
+#include "Core/rak3172_parser.h"
+#include "Core/rak3172_linepool.h"
+#include "Core/rak3172_uplink.h"
+#include "Core/rak3172_registry.h"
+#include "Core/rak3172_rxqueue.h"
 #include "Arch/Logging/rak3172_logging.h"
+#include "Arch/PwrMgmt/rak3172_pwrmgmt.h"
 
 #define STRINGIFY(s)                            STR(s)
 #define STR(s)                                  #s
 
+/** @brief Number of "AT" commands used to verify the link after a baud rate change.
+ */
+#define RAK3172_PROBE_ATTEMPTS                  3
+
+/** @brief Number of "AT" commands for each baud rate during the baud rate detection.
+ */
+#define RAK3172_AUTO_BAUD_ATTEMPTS              2
+
+/** @brief Timeout in milliseconds for each "AT" command during the baud rate detection.
+ */
+#define RAK3172_AUTO_BAUD_TIMEOUT               100
+
 #ifdef CONFIG_RAK3172_RESET_USE_HW
-    static gpio_config_t _RAK3172_Reset_Config = {
+    static const gpio_config_t _RAK3172_Reset_Config = {
         .pin_bit_mask       = 0,
         .mode               = GPIO_MODE_OUTPUT,
         .pull_up_en         = GPIO_PULLUP_DISABLE,
@@ -38,7 +63,7 @@
     };
 #endif
 
-static uart_config_t _RAK3172_UART_Config = {
+static const uart_config_t _RAK3172_UART_Config = {
     .baud_rate              = 9600,
     .data_bits              = UART_DATA_8_BITS,
     .parity                 = UART_PARITY_DISABLE,
@@ -65,11 +90,11 @@ static const char* TAG      = "RAK3172";
  */
 static RAK3172_Error_t RAK3172_ReceiveSplashScreen(RAK3172_t& p_Device, uint16_t Timeout = 1000)
 {
-    std::string* Response = NULL;
+    RAK3172_Line_t* Response = NULL;
 
     do
     {
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Response, Timeout / portTICK_PERIOD_MS) != pdPASS)
+        if(RAK3172_LinePool_Receive(p_Device, &Response, Timeout / portTICK_PERIOD_MS) == false)
         {
             RAK3172_LOGE(TAG, "     Timeout!");
 
@@ -78,334 +103,837 @@ static RAK3172_Error_t RAK3172_ReceiveSplashScreen(RAK3172_t& p_Device, uint16_t
             return RAK3172_ERR_TIMEOUT;
         }
 
-        RAK3172_LOGD(TAG, "Response: %s", Response->c_str());
+        RAK3172_LOGD(TAG, "Response: %s", Response->Data);
 
         // The driver was compiled for RUI3, but an older splash screen was received (version 1.4.0 and below).
         #ifdef CONFIG_RAK3172_USE_RUI3
-            if(Response->find("Version.") != std::string::npos)
+            if(strstr(Response->Data, "Version.") != NULL)
             {
                 RAK3172_LOGE(TAG, "Firmware compiled for RUI3, but module firmware does not support RUI3!");
 
+                RAK3172_LinePool_Release(p_Device, Response);
                 p_Device.Internal.isBusy = false;
 
                 return RAK3172_ERR_INVALID_RESPONSE;
             }
         #endif
 
-        if((Response->find("LoRaWAN.") != std::string::npos) || (Response->find("LoRa P2P.") != std::string::npos))
+        if((strstr(Response->Data, "LoRaWAN.") != NULL) || (strstr(Response->Data, "LoRa P2P.") != NULL))
         {
             p_Device.Internal.isBusy = false;
         }
 
-        delete Response;
+        RAK3172_LinePool_Release(p_Device, Response);
     } while(p_Device.Internal.isBusy);
 
     return RAK3172_ERR_OK;
 }
 
-/** @brief          UART receive task.
- *  @param p_Arg    Pointer to task arguments
+/** @brief          Receive the status of a command that was transmitted without the command queue.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Command Transmitted command
+ *  @param p_Echo   (Optional) Set to #true when the module has echoed the command
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_FAIL when the status is not "OK"
+ *                  RAK3172_ERR_TIMEOUT when a receive timeout occurs
  */
-static void RAK3172_UART_EventTask(void* p_Arg)
+static RAK3172_Error_t RAK3172_ReceiveStatus(RAK3172_t& p_Device, const char* p_Command, bool* p_Echo)
 {
-    uart_event_t Event;
-    RAK3172_t* Device = (RAK3172_t*)p_Arg;
+    bool isStatus;
+    RAK3172_Line_t* Response = NULL;
+    RAK3172_Error_t Error = RAK3172_ERR_OK;
 
-    RAK3172_LOGD(TAG, "Start RAK3172 event task");
+    do
+    {
+        if(RAK3172_LinePool_Receive(p_Device, &Response, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
+        {
+            return RAK3172_ERR_TIMEOUT;
+        }
 
-    while(true)
+        RAK3172_LOGD(TAG, "Response: %s", Response->Data);
+
+        if((p_Echo != NULL) && (strcmp(Response->Data, p_Command) == 0))
+        {
+            *p_Echo = true;
+        }
+
+        isStatus = RAK3172_CmdQueue_isStatus(Response);
+        if(isStatus && (strcmp(Response->Data, "OK") != 0))
+        {
+            Error = RAK3172_ERR_FAIL;
+        }
+
+        RAK3172_LinePool_Release(p_Device, Response);
+    } while(isStatus == false);
+
+    return Error;
+}
+
+/** @brief          Change the baud rate of the UART interface without reinstalling the UART driver.
+ *  @param p_Device RAK3172 device object
+ *  @param Baudrate New baud rate
+ *  @return         RAK3172_ERR_OK when successful
+ *                  RAK3172_ERR_INVALID_STATE when the baud rate can´t be changed
+ */
+static RAK3172_Error_t RAK3172_SwitchBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate)
+{
+    uart_wait_tx_done(p_Device.UART.Interface, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS);
+
+    if(uart_set_baudrate(p_Device.UART.Interface, Baudrate) != ESP_OK)
     {
-        if(xQueueReceive(Device->Internal.EventQueue, (void*)&Event, 20 / portTICK_PERIOD_MS) == pdPASS)
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    // Drop all characters which were received with the wrong baud rate.
+    uart_flush_input(p_Device.UART.Interface);
+    RAK3172_LinePool_Flush(p_Device);
+
+    return RAK3172_ERR_OK;
+}
+
+#ifdef CONFIG_RAK3172_UART_AUTO_BAUD
+    /** @brief Supported baud rates in the order of the detection. The configured baud rate is always probed first.
+     */
+    static const RAK3172_Baud_t _RAK3172_Baudrates[] = {
+        RAK_BAUD_115200,
+        RAK_BAUD_9600,
+        RAK_BAUD_57600,
+        RAK_BAUD_38400,
+        RAK_BAUD_19200,
+        RAK_BAUD_4800,
+    };
+
+    /** @brief          Probe the module with the current baud rate of the UART interface. The probe bypasses the command queue.
+     *  @param p_Device RAK3172 device object
+     *  @return         RAK3172_ERR_OK when the module responds with a status code
+     *                  RAK3172_ERR_INVALID_RESPONSE when invalid characters were received
+     *                  RAK3172_ERR_TIMEOUT when the module doesn´t respond
+     */
+    static RAK3172_Error_t RAK3172_ProbeBaudrate(RAK3172_t& p_Device)
+    {
+        size_t Buffered = 0;
+        RAK3172_Line_t* Response = NULL;
+
+        uart_write_bytes(p_Device.UART.Interface, "AT\r\n", std::string("AT\r\n").length());
+
+        // Wait for the echo, the line feed (firmware without RUI3) and the status code.
+        for(uint8_t i = 0; i < 3; i++)
+        {
+            bool isStatus;
+            bool isValid;
+
+            if(RAK3172_LinePool_Receive(p_Device, &Response, RAK3172_AUTO_BAUD_TIMEOUT / portTICK_PERIOD_MS) == false)
+            {
+                break;
+            }
+
+            // Any status code is a valid response, because it can only be received with the correct baud rate.
+            isStatus = RAK3172_CmdQueue_isStatus(Response);
+            isValid = isStatus || (Response->Length == 0) || (strcmp(Response->Data, "AT") == 0);
+            RAK3172_LinePool_Release(p_Device, Response);
+
+            if(isStatus)
+            {
+                return RAK3172_ERR_OK;
+            }
+            else if(isValid == false)
+            {
+                return RAK3172_ERR_INVALID_RESPONSE;
+            }
+        }
+
+        // Characters without a line end are received with a wrong baud rate too.
+        uart_get_buffered_data_len(p_Device.UART.Interface, &Buffered);
+        if(Buffered > 0)
+        {
+            return RAK3172_ERR_INVALID_RESPONSE;
+        }
+
+        return RAK3172_ERR_TIMEOUT;
+    }
+
+    /** @brief          Detect the baud rate of the module and lock the UART interface to the detected baud rate.
+     *  @param p_Device RAK3172 device object
+     *  @return         RAK3172_ERR_OK when successful
+     *                  RAK3172_ERR_INVALID_STATE when the baud rate of the UART interface can´t be changed
+     *                  RAK3172_ERR_TIMEOUT when the module doesn´t respond with any supported baud rate
+     */
+    static RAK3172_Error_t RAK3172_DetectBaudrate(RAK3172_t& p_Device)
+    {
+        RAK3172_Baud_t Configured;
+
+        RAK3172_LOGI(TAG, "Detect baud rate...");
+
+        Configured = p_Device.UART.Baudrate;
+        for(int8_t i = -1; i < static_cast<int8_t>(sizeof(_RAK3172_Baudrates) / sizeof(_RAK3172_Baudrates[0])); i++)
         {
-            size_t BufferedSize;
-            int32_t PatternPos;
+            RAK3172_Baud_t Baudrate;
+
+            Baudrate = (i < 0) ? Configured : _RAK3172_Baudrates[i];
+            if((i >= 0) && (Baudrate == Configured))
+            {
+                continue;
+            }
+
+            RAK3172_ERROR_CHECK(RAK3172_SwitchBaudrate(p_Device, Baudrate));
 
-            switch(Event.type)
+            for(uint8_t j = 0; j < RAK3172_AUTO_BAUD_ATTEMPTS; j++)
             {
-                case UART_FIFO_OVF:
+                RAK3172_Error_t Error;
+
+                Error = RAK3172_ProbeBaudrate(p_Device);
+                if(Error == RAK3172_ERR_OK)
                 {
-                    ESP_LOGW(TAG, "HW FIFO Overflow");
+                    RAK3172_LOGI(TAG, "     Baudrate: %u", Baudrate);
 
-                    uart_flush(Device->UART.Interface);
-                    xQueueReset(Device->Internal.MessageQueue);
+                    p_Device.UART.Baudrate = Baudrate;
+
+                    return RAK3172_ERR_OK;
+                }
+                // Only probe again when the module doesn´t respond, because the first probe may wake up the module.
+                else if(Error != RAK3172_ERR_TIMEOUT)
+                {
+                    break;
+                }
+            }
+        }
+
+        RAK3172_LOGE(TAG, "     No response!");
+
+        RAK3172_SwitchBaudrate(p_Device, Configured);
+
+        return RAK3172_ERR_TIMEOUT;
+    }
+#endif
+
+#if(defined CONFIG_RAK3172_MODE_WITH_LORAWAN) || (defined CONFIG_RAK3172_MODE_WITH_P2P)
+    /** @brief              Decode the hex payload of an event into the receive slot.
+     *  @param Payload      Hex payload
+     *  @param p_Received   Pointer to receive slot
+     *  @return             RAK3172_ERR_OK when successful
+     *                      RAK3172_ERR_INVALID_ARG when the payload doesn´t fit into the slot
+     *                      RAK3172_ERR_INVALID_RESPONSE when the payload is no valid hex string
+     */
+    static RAK3172_Error_t RAK3172_RxDecode(std::string_view Payload, RAK3172_Rx_t* p_Received)
+    {
+        size_t Length = 0;
+
+        RAK3172_ERROR_CHECK(RAK3172_Hex_Decode(Payload, p_Received->Data, sizeof(p_Received->Data), &Length));
+        p_Received->Length = Length;
+
+        return RAK3172_ERR_OK;
+    }
+#endif
+
+#ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+    /** @brief          Handle a LoRaWAN join event.
+     *  @param p_Device Pointer to RAK3172 device object
+     *  @param Joined   #true when the join was successful
+     */
+    static void RAK3172_Event_Join(RAK3172_t* p_Device, bool Joined)
+    {
+        // The flags are written before the event bit is set, so the waiting task reads the new values.
+        if(Joined)
+        {
+            RAK3172_LOGD(TAG, " Joined...");
+
+            p_Device->LoRaWAN.isJoined = true;
+            p_Device->Internal.isBusy = false;
+
+            xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_JOINED);
+        }
+        else
+        {
+            RAK3172_LOGD(TAG, " Not joined...");
+
+            p_Device->LoRaWAN.isJoined = false;
+
+            if(p_Device->LoRaWAN.AttemptCounter > 0)
+            {
+                p_Device->LoRaWAN.AttemptCounter--;
+            }
+
+            if(p_Device->LoRaWAN.AttemptCounter == 0)
+            {
+                p_Device->Internal.isBusy = false;
+
+                xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_JOIN_FAILED);
+            }
+            #ifndef CONFIG_RAK3172_USE_RUI3
+                // The module doesn´t repeat the join. Release the device, so the waiting task can start the next attempt.
+                else
+                {
+                    p_Device->Internal.isBusy = false;
+
+                    xEventGroupSetBits(p_Device->Internal.Events, RAK3172_EVENT_JOIN_RETRY);
+                }
+            #endif
+        }
+    }
+
+    /** @brief          Handle a LoRaWAN confirmation event.
+     *  @param p_Device Pointer to RAK3172 device object
+     *  @param Success  #true when the transmission was confirmed
+     */
+    static void RAK3172_Event_Confirm(RAK3172_t* p_Device, bool Success)
+    {
+        p_Device->LoRaWAN.ConfirmError = !Success;
+
+        RAK3172_Uplink_Confirm(*p_Device, Success);
+    }
+
+    /** @brief          Store a LoRaWAN downlink in a receive slot.
+     *  @param p_Device Pointer to RAK3172 device object
+     *  @param Group    Receive group from the event keyword
+     *  @param RSSI     RSSI of the downlink
+     *  @param SNR      SNR of the downlink
+     *  @param Response Downlink with the format "UNICAST:Port:Payload" or "MULCAST:Port:Payload"
+     */
+    static void RAK3172_Event_LoRaWAN_Downlink(RAK3172_t* p_Device, RAK3172_Rx_Group_t Group, std::string_view RSSI, std::string_view SNR, std::string_view Response)
+    {
+        std::string_view Port;
+        std::string_view Dummy;
+        RAK3172_Rx_t* Received;
+
+        // Remove the "UNICAST" or the "MULCAST" from the message and get the communication port.
+        if((RAK3172_Parser_Next(&Response, ":", &Dummy) == false) || (RAK3172_Parser_Next(&Response, ":", &Port) == false))
+        {
+            RAK3172_LOGE(TAG, "Invalid downlink event!");
+
+            return;
+        }
+
+        Received = RAK3172_RxQueue_Acquire(*p_Device);
+        if(Received == NULL)
+        {
+            RAK3172_LOGW(TAG, "Receive queue full. Drop downlink!");
+
+            return;
+        }
+
+        Received->Group = Group;
+        if((RAK3172_Parser_ToNumber(RSSI, &Received->RSSI) != RAK3172_ERR_OK) ||
+           (RAK3172_Parser_ToNumber(SNR, &Received->SNR) != RAK3172_ERR_OK) ||
+           (RAK3172_Parser_ToNumber(Port, &Received->Port) != RAK3172_ERR_OK))
+        {
+            RAK3172_LOGE(TAG, "Invalid downlink event!");
+
+            RAK3172_RxQueue_Release(*p_Device, Received);
+
+            return;
+        }
+
+        // Decode the payload into the slot.
+        if(RAK3172_RxDecode(Response, Received) != RAK3172_ERR_OK)
+        {
+            RAK3172_LOGE(TAG, "Invalid payload!");
+
+            RAK3172_RxQueue_Release(*p_Device, Received);
+
+            return;
+        }
+
+        RAK3172_LOGI(TAG, "RSSI: %i", Received->RSSI);
+        RAK3172_LOGI(TAG, "SNR: %i", Received->SNR);
+        RAK3172_LOGI(TAG, "Port: %u", Received->Port);
+        RAK3172_LOGI(TAG, "Channel: %u", Received->Group);
+        RAK3172_LOGI(TAG, "Payload: %.*s", static_cast<int>(Response.length()), Response.data());
+
+        RAK3172_RxQueue_Send(*p_Device, Received);
+    }
+
+    /** @brief          Handle a LoRaWAN downlink event.
+     *  @param p_Device Pointer to RAK3172 device object
+     *  @param Group    Receive group from the event keyword
+     *  @param p_Args   Event arguments following the "RX_x" keyword
+     */
+    static void RAK3172_Event_LoRaWAN_Rx(RAK3172_t* p_Device, RAK3172_Rx_Group_t Group, const char* p_Args)
+    {
+        std::string_view Response;
+        std::string_view RSSI;
+        std::string_view SNR;
+
+        // Formats documentation:
+        //  FW 1.03     +EVT:RX_1, RSSI -89, SNR 4
+        //              +EVT:UNICAST
+        //              +EVT:1:AABB
+        //  RUI3        +EVT:RX_1:-89:4:UNICAST:1:AABB
+
+        // Remove the separator after "RX_x" from the response.
+        Response = std::string_view(p_Args);
+        Response.remove_prefix(std::min(Response.length(), static_cast<size_t>(1)));
+
+        #ifdef CONFIG_RAK3172_USE_RUI3
+            RAK3172_Parser_Next(&Response, ":", &RSSI);
+            RAK3172_Parser_Next(&Response, ":", &SNR);
+
+            RAK3172_Event_LoRaWAN_Downlink(p_Device, Group, RSSI, SNR, Response);
+        #else
+            int Bytes;
+            char* Marker;
+            RAK3172_Line_t* Next;
+
+            RAK3172_Parser_Next(&Response, ",", &RSSI);
+            RAK3172_Parser_Next(&Response, ",", &SNR);
+
+            RSSI = RAK3172_Parser_Trim(RSSI);
+            SNR = RAK3172_Parser_Trim(SNR);
+            RAK3172_Parser_SkipPrefix(&RSSI, "RSSI");
+            RAK3172_Parser_SkipPrefix(&SNR, "SNR");
+
+            // The payload is stored in the next lines. The event line is still in use, so the lines are read into a second line slot.
+            Next = RAK3172_LinePool_Acquire(*p_Device);
+            if(Next == NULL)
+            {
+                RAK3172_LOGW(TAG, "No free line available. Drop downlink!");
+
+                return;
+            }
+
+            Next->Length = 0;
+            do
+            {
+                char Data;
+
+                Bytes = uart_read_bytes(p_Device->UART.Interface, &Data, 1, 10);
+                if((Bytes > 0) && (Data != '\r') && (Data != '\n') && (Next->Length < (sizeof(Next->Data) - 1)))
+                {
+                    Next->Data[Next->Length++] = Data;
+                }
+            } while(Bytes > 0);
+            Next->Data[Next->Length] = '\0';
+
+            RAK3172_LOGD(TAG, "Next line: %s", Next->Data);
+
+            // Remove all "+EVT" strings.
+            Response = std::string_view(Next->Data, Next->Length);
+            RAK3172_Parser_SkipPrefix(&Response, "+EVT:");
+
+            Marker = strstr(Next->Data + (Response.data() - Next->Data), "+EVT");
+            if(Marker != NULL)
+            {
+                memmove(Marker, Marker + std::string_view("+EVT").length(), strlen(Marker + std::string_view("+EVT").length()) + 1);
+                Response = std::string_view(Response.data());
+            }
+
+            RAK3172_Event_LoRaWAN_Downlink(p_Device, Group, RSSI, SNR, Response);
+
+            RAK3172_LinePool_Release(*p_Device, Next);
+        #endif
+    }
+#endif
+
+#ifdef CONFIG_RAK3172_MODE_WITH_P2P
+    /** @brief          Handle a LoRa P2P receive event.
+     *  @param p_Device Pointer to RAK3172 device object
+     *  @param p_Args   Event arguments following the "RXP2P" keyword
+     */
+    static void RAK3172_Event_P2P_Rx(RAK3172_t* p_Device, const char* p_Args)
+    {
+        std::string_view Response;
+        std::string_view RSSI;
+        std::string_view SNR;
+        RAK3172_Rx_t* Received;
+
+        // Formats documentation:
+        //  FW 1.03     +EVT:RXP2P, RSSI -30, SNR 7
+        //  RUI3        +EVT:RXP2P:-30:7:AABB
+
+        // Remove the separator after "RXP2P" from the response.
+        Response = std::string_view(p_Args);
+        Response.remove_prefix(std::min(Response.length(), static_cast<size_t>(1)));
+
+        #ifdef CONFIG_RAK3172_USE_RUI3
+            RAK3172_Parser_Next(&Response, ":", &RSSI);
+            RAK3172_Parser_Next(&Response, ":", &SNR);
+        #else
+            RAK3172_Parser_Next(&Response, ",", &RSSI);
+            RAK3172_Parser_Next(&Response, ",:", &SNR);
+
+            RSSI = RAK3172_Parser_Trim(RSSI);
+            SNR = RAK3172_Parser_Trim(SNR);
+            RAK3172_Parser_SkipPrefix(&RSSI, "RSSI");
+            RAK3172_Parser_SkipPrefix(&SNR, "SNR");
+        #endif
+
+        Received = RAK3172_RxQueue_Acquire(*p_Device);
+        if(Received == NULL)
+        {
+            RAK3172_LOGW(TAG, "Receive queue full. Drop message!");
+
+            return;
+        }
+
+        Received->Port = 0;
+        Received->Group = RAK_RX_GROUP_1;
+        if((RAK3172_Parser_ToNumber(RSSI, &Received->RSSI) != RAK3172_ERR_OK) ||
+           (RAK3172_Parser_ToNumber(SNR, &Received->SNR) != RAK3172_ERR_OK))
+        {
+            RAK3172_LOGE(TAG, "Invalid receive event!");
+
+            RAK3172_RxQueue_Release(*p_Device, Received);
+
+            return;
+        }
+
+        // Decode the payload into the slot.
+        if(RAK3172_RxDecode(Response, Received) != RAK3172_ERR_OK)
+        {
+            RAK3172_LOGE(TAG, "Invalid payload!");
+
+            RAK3172_RxQueue_Release(*p_Device, Received);
+
+            return;
+        }
+
+        RAK3172_LOGD(TAG, "RSSI: %i", Received->RSSI);
+        RAK3172_LOGD(TAG, "SNR: %i", Received->SNR);
+        RAK3172_LOGD(TAG, "Payload: %.*s", static_cast<int>(Response.length()), Response.data());
+
+        RAK3172_RxQueue_Send(*p_Device, Received);
+    }
+#endif
+
+/** @brief          Process a UART event of a device.
+ *  @param Device   Pointer to RAK3172 device object
+ *  @param p_Event  Pointer to UART event
+ */
+static void RAK3172_UART_HandleEvent(RAK3172_t* Device, uart_event_t* p_Event)
+{
+    size_t BufferedSize;
+    int32_t PatternPos;
+
+    switch(p_Event->type)
+    {
+        case UART_FIFO_OVF:
+        {
+            ESP_LOGW(TAG, "HW FIFO Overflow");
+
+            uart_flush(Device->UART.Interface);
+            RAK3172_LinePool_Flush(*Device);
+            RAK3172_CmdQueue_Abort(*Device, RAK3172_ERR_INVALID_RESPONSE);
+
+            break;
+        }
+        case UART_BUFFER_FULL:
+        {
+            ESP_LOGW(TAG, "Ring Buffer Full");
+
+            uart_flush(Device->UART.Interface);
+            RAK3172_LinePool_Flush(*Device);
+            RAK3172_CmdQueue_Abort(*Device, RAK3172_ERR_INVALID_RESPONSE);
+
+            break;
+        }
+        case UART_PATTERN_DET:
+        {
+            uart_get_buffered_data_len(Device->UART.Interface, &BufferedSize);
+
+            PatternPos = uart_pattern_pop_pos(Device->UART.Interface);
+
+            if(PatternPos == -1)
+            {
+                uart_flush_input(Device->UART.Interface);
+                RAK3172_LinePool_Flush(*Device);
+            }
+            else
+            {
+                int BytesRead;
+                const char* Args;
+                RAK3172_Line_t* Line;
+                RAK3172_Event_t Event;
+
+                RAK3172_LOGD(TAG, "     Pattern detected at position %u. Use buffered size: %u", static_cast<unsigned int>(PatternPos), static_cast<unsigned int>(BufferedSize));
+
+                Line = RAK3172_LinePool_Acquire(*Device);
+                if(Line == NULL)
+                {
+                    RAK3172_LOGW(TAG, "No free line available");
+
+                    uart_flush_input(Device->UART.Interface);
 
                     break;
                 }
-                case UART_BUFFER_FULL:
+
+                // Read the line directly into the slot. The pattern position is always smaller than the UART buffer.
+                BytesRead = uart_read_bytes(Device->UART.Interface, Line->Data, std::min(static_cast<size_t>(PatternPos), sizeof(Line->Data) - 1), 10);
+                if(BytesRead == -1)
                 {
-                    ESP_LOGW(TAG, "Ring Buffer Full");
+                    RAK3172_LinePool_Release(*Device, Line);
 
                     uart_flush(Device->UART.Interface);
-                    xQueueReset(Device->Internal.MessageQueue);
+                    RAK3172_LinePool_Flush(*Device);
 
                     break;
                 }
-                case UART_PATTERN_DET:
+
+                // Remove CR and LF from the line.
+                for(int i = 0; i < BytesRead; i++)
                 {
-                    uart_get_buffered_data_len(Device->UART.Interface, &BufferedSize);
+                    char Character;
 
-                    PatternPos = uart_pattern_pop_pos(Device->UART.Interface);
+                    Character = Line->Data[i];
 
-                    if(PatternPos == -1)
+                    if((Character != '\n') && (Character != '\r'))
                     {
-                        uart_flush_input(Device->UART.Interface);
-                        xQueueReset(Device->Internal.MessageQueue);
+                        Line->Data[Line->Length++] = Character;
                     }
-                    else
+                }
+                Line->Data[Line->Length] = '\0';
+
+                #ifdef CONFIG_RAK3172_PWRMGMT_LIGHT_SLEEP
+                    // The first characters of a line which wakes up the host are lost.
+                    if(Device->Internal.isWoken.exchange(false, std::memory_order_acq_rel))
                     {
-                        int BytesRead;
-                        std::string* Response = new std::string();
+                        RAK3172_PwrMgmt_Restore(Line);
+                    }
+                #endif
 
-                        RAK3172_LOGD(TAG, "     Pattern detected at position %u. Use buffered size: %u", static_cast<unsigned int>(PatternPos), static_cast<unsigned int>(BufferedSize));
+                RAK3172_LOGD(TAG, "     Response: %s", Line->Data);
 
-                        BytesRead = uart_read_bytes(Device->UART.Interface, Device->Internal.RxBuffer, PatternPos, 10);
-                        if(BytesRead == -1)
+                Event = RAK3172_Events_Classify(Line->Data, &Args);
+
+                #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+                    if((Device->Mode == RAK_MODE_LORAWAN) && (Event != RAK3172_EVT_NONE))
+                    {
+                        RAK3172_LOGD(TAG, "Event: %s", Line->Data);
+
+                        switch(Event)
                         {
-                            uart_flush(Device->UART.Interface);
-                            xQueueReset(Device->Internal.MessageQueue);
+                            case RAK3172_EVT_JOINED:
+                            {
+                                RAK3172_Event_Join(Device, true);
+
+                                break;
+                            }
+                            case RAK3172_EVT_JOIN_FAILED:
+                            {
+                                RAK3172_Event_Join(Device, false);
+
+                                break;
+                            }
+                            case RAK3172_EVT_CONFIRMED_OK:
+                            {
+                                RAK3172_Event_Confirm(Device, true);
+
+                                break;
+                            }
+                            case RAK3172_EVT_CONFIRMED_FAILED:
+                            {
+                                RAK3172_Event_Confirm(Device, false);
+
+                                break;
+                            }
+                            case RAK3172_EVT_RX_1:
+                            {
+                                RAK3172_Event_LoRaWAN_Rx(Device, RAK_RX_GROUP_1, Args);
+
+                                break;
+                            }
+                            case RAK3172_EVT_RX_2:
+                            {
+                                RAK3172_Event_LoRaWAN_Rx(Device, RAK_RX_GROUP_2, Args);
 
-                            break;
+                                break;
+                            }
+                            case RAK3172_EVT_RX_B:
+                            {
+                                RAK3172_Event_LoRaWAN_Rx(Device, RAK_RX_GROUP_B, Args);
+
+                                break;
+                            }
+                            case RAK3172_EVT_RX_C:
+                            {
+                                RAK3172_Event_LoRaWAN_Rx(Device, RAK_RX_GROUP_C, Args);
+
+                                break;
+                            }
+                            default:
+                            {
+                                break;
+                            }
                         }
 
-                        // Copy the data from the buffer into the string.
-                        for(uint32_t i = 0; i < BytesRead; i++)
+                        RAK3172_LinePool_Release(*Device, Line);
+                    }
+                    else
+                #endif
+                #ifdef CONFIG_RAK3172_MODE_WITH_P2P
+                    if((Device->Mode == RAK_MODE_P2P) && (Event != RAK3172_EVT_NONE))
+                    {
+                        RAK3172_LOGD(TAG, "Event: %s", Line->Data);
+
+                        if(Event == RAK3172_EVT_RXP2P_TIMEOUT)
+                        {
+                            // Wake up the waiting task with an empty message.
+                            Device->P2P.isRxTimeout = true;
+                            RAK3172_RxQueue_Signal(*Device);
+                        }
+                        else if(Event == RAK3172_EVT_RXP2P)
                         {
-                            char Character;
+                            RAK3172_Event_P2P_Rx(Device, Args);
+                        }
+
+                        RAK3172_LinePool_Release(*Device, Line);
+                    }
+                    else
+                #endif
+                // Any other messages from the module. Responses belong to the oldest command in flight.
+                if(RAK3172_CmdQueue_Feed(*Device, Line) == false)
+                {
+                    RAK3172_LinePool_Send(*Device, Line);
+                }
+            }
+
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+}
+
+/** @brief          Handle the command timeouts and transmit the queued uplinks of a device.
+ *  @param Device   Pointer to RAK3172 device object
+ *  @return         Time in ticks until the function must be called again or portMAX_DELAY when the device is idle
+ */
+static TickType_t RAK3172_UART_Poll(RAK3172_t* Device)
+{
+    TickType_t Timeout;
+
+    Timeout = RAK3172_CmdQueue_Poll(*Device);
+
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+        if(Device->Mode == RAK_MODE_LORAWAN)
+        {
+            Timeout = std::min(Timeout, RAK3172_Uplink_Poll(*Device));
+        }
+    #endif
+
+    return Timeout;
+}
+
+#ifndef CONFIG_RAK3172_TASK_SHARED
+    /** @brief          UART receive task. The task sleeps until a UART event is received, the wake signal is given or the next timeout
+     *                  of the device expires and terminates itself when the device is stopped.
+     *  @param p_Arg    Pointer to task arguments
+     */
+    static void RAK3172_UART_EventTask(void* p_Arg)
+    {
+        uart_event_t Event;
+        TickType_t Timeout;
+        TaskHandle_t Waiter;
+        QueueSetMemberHandle_t Member;
+        RAK3172_t* Device = (RAK3172_t*)p_Arg;
+
+        RAK3172_LOGD(TAG, "Start RAK3172 event task");
+
+        Timeout = portMAX_DELAY;
+        while(true)
+        {
+            Member = xQueueSelectFromSet(Device->Internal.EventSet, Timeout);
+            if(Member == Device->Internal.WakeSignal)
+            {
+                xSemaphoreTake(Device->Internal.WakeSignal, 0);
+            }
+            else if((Member == Device->Internal.EventQueue) && (xQueueReceive(Device->Internal.EventQueue, (void*)&Event, 0) == pdPASS))
+            {
+                RAK3172_UART_HandleEvent(Device, &Event);
+            }
+
+            if(Device->Internal.isStopping)
+            {
+                break;
+            }
+
+            Device->Internal.Wakeups++;
+            Timeout = RAK3172_UART_Poll(Device);
+        }
+
+        RAK3172_LOGD(TAG, "Stop RAK3172 event task");
+
+        Waiter = Device->Internal.Waiter;
+        Device->Internal.Handle = NULL;
+        if(Waiter != NULL)
+        {
+            xTaskNotifyGive(Waiter);
+        }
+
+        vTaskDelete(NULL);
+    }
+#endif
+
+#ifndef CONFIG_RAK3172_TASK_SHARED
+    /** @brief          Remove the UART event queue and the wake signal from the queue set of the receive task and delete the queue set.
+     *                  NOTE: The receive task must not use the queue set anymore!
+     *  @param p_Device RAK3172 device object
+     */
+    static void RAK3172_UART_DeleteEventSet(RAK3172_t& p_Device)
+    {
+        if(p_Device.Internal.EventSet == NULL)
+        {
+            return;
+        }
+
+        // Only empty queues can be removed from a queue set. The UART driver can add new events at any time.
+        do
+        {
+            xQueueReset(p_Device.Internal.EventQueue);
+        } while(xQueueRemoveFromSet(p_Device.Internal.EventQueue, p_Device.Internal.EventSet) != pdPASS);
+
+        do
+        {
+            xSemaphoreTake(p_Device.Internal.WakeSignal, 0);
+        } while(xQueueRemoveFromSet(p_Device.Internal.WakeSignal, p_Device.Internal.EventSet) != pdPASS);
 
-                            Character = Device->Internal.RxBuffer[i];
+        vQueueDelete(p_Device.Internal.EventSet);
+        p_Device.Internal.EventSet = NULL;
+    }
+#endif
 
-                            if((Character != '\n') && (Character != '\r'))
-                            {
-                                *Response += Character;
-                            }
-                        }
+/** @brief          Stop the processing of the UART events of a device. The receive task of the device is terminated with the wake signal
+ *                  and the function waits until the task has finished.
+ *  @param p_Device RAK3172 device object
+ */
+static void RAK3172_UART_Stop(RAK3172_t& p_Device)
+{
+    #ifdef CONFIG_RAK3172_TASK_SHARED
+        RAK3172_Registry_Remove(p_Device);
+    #else
+        // Clear a stale notification from a previous wait for a message before the termination is awaited.
+        ulTaskNotifyTake(pdTRUE, 0);
 
-                        RAK3172_LOGD(TAG, "     Response: %s", Response->c_str());
+        p_Device.Internal.Waiter = xTaskGetCurrentTaskHandle();
+        p_Device.Internal.isStopping = true;
 
-                        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
-                            if((Device->Mode == RAK_MODE_LORAWAN) && (Response->find("+EVT") != std::string::npos))
-                            {
-                                RAK3172_LOGD(TAG, "Event: %s", Response->c_str());
-
-                                // Join was successful.
-                                if(Response->find("JOINED") != std::string::npos)
-                                {
-                                    RAK3172_LOGD(TAG, " Joined...");
-
-                                    #ifndef CONFIG_RAK3172_USE_RUI3
-                                        Device->Internal.isJoinEvent = true;
-                                    #endif
-
-                                    Device->Internal.isBusy = false;
-                                    Device->LoRaWAN.isJoined = true;
-                                }
-                                // Join failed.
-                                #ifdef CONFIG_RAK3172_USE_RUI3
-                                    else if(Response->find("JOIN_FAILED_RX_TIMEOUT") != std::string::npos)
-                                #else
-                                    else if(Response->find("JOIN FAILED") != std::string::npos)
-                                #endif
-                                {
-                                    RAK3172_LOGD(TAG, " Not joined...");
-
-                                    if(Device->LoRaWAN.AttemptCounter > 0)
-                                    {
-                                        Device->LoRaWAN.AttemptCounter--;
-                                    }
-                                    else
-                                    {
-                                        Device->Internal.isBusy = false;
-                                    }
-
-                                    #ifndef CONFIG_RAK3172_USE_RUI3
-                                        Device->Internal.isBusy = false;
-                                        Device->Internal.isJoinEvent = true;
-                                    #endif
-
-                                    Device->LoRaWAN.isJoined = false;
-                                }
-                                // Transmission failed.
-                                #ifdef CONFIG_RAK3172_USE_RUI3
-                                    else if(Response->find("SEND_CONFIRMED_FAILED") != std::string::npos)
-                                #else
-                                    else if(Response->find("SEND CONFIRMED FAILED") != std::string::npos)
-                                #endif
-                                {
-                                    Device->Internal.isBusy = false;
-                                    Device->LoRaWAN.ConfirmError = true;
-                                }
-                                // Transmission was successful.
-                                #ifdef CONFIG_RAK3172_USE_RUI3
-                                    else if(Response->find("SEND_CONFIRMED_OK") != std::string::npos)
-                                #else
-                                    else if(Response->find("SEND CONFIRMED OK") != std::string::npos)
-                                #endif
-                                {
-                                    Device->Internal.isBusy = false;
-                                    Device->LoRaWAN.ConfirmError = false;
-                                }
-                                else if(Response->find("RX") != std::string::npos)
-                                {
-                                    size_t Index;
-                                    std::string Dummy;
-                                    RAK3172_Rx_t* Received = new RAK3172_Rx_t();
-
-                                    // Formats documentation:
-                                    //  FW 1.03     +EVT:RX_1, RSSI -89, SNR 4
-
-                                    // Remove "+EVT:" from the response.
-                                    Response->erase(Response->find("+EVT:"), std::string("+EVT:").length());
-
-                                    // Get the channel number from the "RX_x" part of the response.
-                                    Index = Response->find("RX");
-
-                                    if(Response->at(Index + 1) == '1')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_1;
-                                    }
-                                    else if(Response->at(Index + 1) == '2')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_2;
-                                    }
-                                    else if(Response->at(Index + 1) == 'B')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_B;
-                                    }
-                                    else if(Response->at(Index + 1) == 'C')
-                                    {
-                                        Received->Group = RAK_RX_GROUP_C;
-                                    }
-
-                                    // Remove the "RX_x" from the response.
-                                    Response->erase(0, sizeof("RX_x"));
-
-                                    // Get the RSSI value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("RSSI").length() + 1, Response->find(","));
-                                        Response->erase(0, std::string(Dummy).length() + 2);
-                                    #endif
-                                    Received->RSSI = std::stoi(Dummy);
-
-                                    // Get the SNR value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("SNR").length() + 1, Response->find(","));
-                                    #endif
-                                    Received->SNR = std::stoi(Dummy);
-
-                                    #ifndef CONFIG_RAK3172_USE_RUI3
-                                        // The payload is stored in the next line.
-                                        char Data;
-                                        int Bytes;
-
-                                        Response->clear();
-                                        do
-                                        {
-                                            Bytes = uart_read_bytes(Device->UART.Interface, &Data, 1, 10);
-                                            if((Bytes != 0) && (Data != '\r') && (Data != '\n'))
-                                            {
-                                                *Response += Data;
-                                            }
-                                        } while(Bytes != 0);
-
-                                        RAK3172_LOGD(TAG, "Next line: %s", Response->c_str());
-
-                                        // Remove all "+EVT" strings.
-                                        Response->erase(0, std::string("+EVT:").length());
-                                        Response->erase(Response->find("+EVT"), std::string("+EVT").length());
-                                    #endif
-
-                                    // Remove the "UNICAST" or the "MULCAST" from the message.
-                                    Response->erase(0, Response->find(":") + 1);
-
-                                    // Get the communication port.
-                                    Dummy = Response->substr(0, Response->find(":"));
-                                    Response->erase(Response->find(Dummy), std::string(Dummy + ":").length());
-                                    Received->Port = std::stoi(Dummy);
-
-                                    // Get the payload.
-                                    Received->Payload = *Response;
-
-                                    RAK3172_LOGI(TAG, "RSSI: %i", Received->RSSI);
-                                    RAK3172_LOGI(TAG, "SNR: %i", Received->SNR);
-                                    RAK3172_LOGI(TAG, "Port: %u", Received->Port);
-                                    RAK3172_LOGI(TAG, "Channel: %u", Received->Group);
-                                    RAK3172_LOGI(TAG, "Payload: %s", Received->Payload.c_str());
-
-                                    xQueueSend(Device->Internal.ReceiveQueue, &Received, 0);
-                                }
-
-                                delete Response;
-                            }
-                        #endif
-                        #ifdef CONFIG_RAK3172_MODE_WITH_P2P
-                            if((Device->Mode == RAK_MODE_P2P) && (Response->find("+EVT") != std::string::npos))
-                            {
-                                RAK3172_LOGD(TAG, "Event: %s", Response->c_str());
-
-                                if(Response->find("+EVT:RXP2P RECEIVE TIMEOUT") != std::string::npos)
-                                {
-                                    Device->P2P.isRxTimeout = true;
-                                }
-                                else if(Response->find("RX") != std::string::npos)
-                                {
-                                    std::string Dummy;
-                                    RAK3172_Rx_t* Received = new RAK3172_Rx_t();
-
-                                    // Remove "+EVT:RXP2P:" from the response.
-                                    Response->erase(Response->find("+EVT:"), std::string("+EVT:").length() + 6);
-
-                                    // Get the RSSI value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("RSSI").length() + 1, Response->find(","));
-                                        Response->erase(0, std::string(Dummy + ":").length() + 1);
-                                    #endif
-                                    Received->RSSI = std::stoi(Dummy);
-
-                                    // Get the SNR value.
-                                    #ifdef CONFIG_RAK3172_USE_RUI3
-                                        Dummy = Response->substr(0, Response->find(":"));
-                                        Response->erase(0, std::string(Dummy + ":").length());
-                                    #else
-                                        Dummy = Response->substr(std::string("SNR").length() + 1, Response->find(","));
-                                    #endif
-                                    Received->SNR = std::stoi(Dummy);
-
-                                    // Get the payload.
-                                    Received->Payload = *Response;
-
-                                    RAK3172_LOGD(TAG, "RSSI: %i", Received->RSSI);
-                                    RAK3172_LOGD(TAG, "SNR: %i", Received->SNR);
-                                    RAK3172_LOGD(TAG, "Payload: %s", Received->Payload.c_str());
-
-                                    xQueueSend(Device->Internal.ReceiveQueue, &Received, 0);
-                                }
-                            }
-                            // Any other messages from the module.
-                            else
-                        #endif
-                        {
-                            xQueueSend(Device->Internal.MessageQueue, &Response, 0);
-                        }
-                    }
+        // The task isn´t deleted by force, because it can hold the command lock, a line of the pool or a slot of the receive ring.
+        // The wake signal stays given until the task takes it, so the task terminates as soon as it gets the CPU.
+        RAK3172_Registry_Wake(p_Device);
+        if(ulTaskNotifyTake(pdTRUE, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == 0)
+        {
+            RAK3172_LOGW(TAG, "Receive task doesn´t respond. Wait for termination...");
 
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
+            while(p_Device.Internal.Handle != NULL)
+            {
+                ulTaskNotifyTake(pdTRUE, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS);
             }
         }
-    }
+        p_Device.Internal.Waiter = NULL;
+
+        RAK3172_UART_DeleteEventSet(p_Device);
+    #endif
+
+    p_Device.Internal.Handle = NULL;
+}
+
+/** @brief              Calculate the CRC of a device state snapshot.
+ *  @param p_Snapshot   Pointer to snapshot
+ *  @return             CRC32 of the snapshot without the CRC field
+ */
+static uint32_t RAK3172_GetSnapshotCRC(const RAK3172_Snapshot_t* p_Snapshot)
+{
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(p_Snapshot), offsetof(RAK3172_Snapshot_t, CRC));
 }
 
 /** @brief          Perform the basic initialization of the driver.
@@ -416,6 +944,7 @@ static void RAK3172_UART_EventTask(void* p_Arg)
 static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
 {
     uint8_t Flags;
+    uart_config_t Config;
     RAK3172_Error_t Error;
 
     if(p_Device.UART.Tx == p_Device.UART.Rx)
@@ -446,8 +975,10 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    _RAK3172_UART_Config.baud_rate = p_Device.UART.Baudrate;
-    if(uart_param_config(p_Device.UART.Interface, &_RAK3172_UART_Config) ||
+    // Each device uses its own copy of the configuration, because the devices can use different baud rates.
+    Config = _RAK3172_UART_Config;
+    Config.baud_rate = p_Device.UART.Baudrate;
+    if(uart_param_config(p_Device.UART.Interface, &Config) ||
        uart_set_pin(p_Device.UART.Interface, p_Device.UART.Tx, p_Device.UART.Rx, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) ||
        uart_enable_pattern_det_baud_intr(p_Device.UART.Interface, '\n', 1, 1, 0, 0) ||
        uart_pattern_queue_reset(p_Device.UART.Interface, CONFIG_RAK3172_UART_QUEUE_LENGTH)
@@ -458,7 +989,11 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    p_Device.Internal.MessageQueue = xQueueCreate(CONFIG_RAK3172_UART_QUEUE_LENGTH, sizeof(std::string*));
+    #ifdef CONFIG_RAK3172_PWRMGMT_ENABLE
+        RAK3172_PwrMgmt_Init(p_Device);
+    #endif
+
+    p_Device.Internal.MessageQueue = xQueueCreate(CONFIG_RAK3172_UART_QUEUE_LENGTH, sizeof(uint8_t));
     if(p_Device.Internal.MessageQueue == NULL)
     {
         Error = RAK3172_ERR_NO_MEM;
@@ -466,56 +1001,125 @@ static RAK3172_Error_t RAK3172_BasicInit(RAK3172_t& p_Device)
         goto RAK3172_BasicInit_Error_1;
     }
 
-    p_Device.Internal.ReceiveQueue = xQueueCreate(8, sizeof(RAK3172_Rx_t*));
-    if(p_Device.Internal.ReceiveQueue == NULL)
-    { 
-        Error = RAK3172_ERR_NO_MEM;
-
-        goto RAK3172_BasicInit_Error_2;
+    Error = RAK3172_RxQueue_Init(p_Device);
+    if(Error != RAK3172_ERR_OK)
+    {
+        goto RAK3172_BasicInit_Error_1;
     }
 
-    p_Device.Internal.RxBuffer = (uint8_t*)malloc(CONFIG_RAK3172_UART_BUFFER_SIZE);
-    if(p_Device.Internal.RxBuffer == NULL)
+    p_Device.Internal.Events = xEventGroupCreate();
+    p_Device.Internal.WakeSignal = xSemaphoreCreateBinary();
+    p_Device.Internal.BurstLock = xSemaphoreCreateMutex();
+    if((p_Device.Internal.Events == NULL) || (p_Device.Internal.WakeSignal == NULL) || (p_Device.Internal.BurstLock == NULL))
     {
         Error = RAK3172_ERR_NO_MEM;
 
         goto RAK3172_BasicInit_Error_3;
     }
 
-    #ifdef CONFIG_RAK3172_TASK_CORE_AFFINITY
-        xTaskCreatePinnedToCore(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle, CONFIG_RAK3172_TASK_CORE);
-    #else
-        xTaskCreate(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, &p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle);
-    #endif
-
-    if(p_Device.Internal.Handle == NULL)
+    Error = RAK3172_LinePool_Init(p_Device);
+    if(Error != RAK3172_ERR_OK)
     {
-        Error = RAK3172_ERR_NO_MEM;
+        goto RAK3172_BasicInit_Error_3;
+    }
 
+    Error = RAK3172_CmdQueue_Init(p_Device);
+    if(Error != RAK3172_ERR_OK)
+    {
         goto RAK3172_BasicInit_Error_4;
     }
 
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+        Error = RAK3172_Uplink_Init(p_Device);
+        if(Error != RAK3172_ERR_OK)
+        {
+            goto RAK3172_BasicInit_Error_5;
+        }
+    #endif
+
+    #ifdef CONFIG_RAK3172_TASK_SHARED
+        p_Device.Internal.Handle = NULL;
+
+        Error = RAK3172_Registry_Add(p_Device, RAK3172_UART_HandleEvent, RAK3172_UART_Poll);
+        if(Error != RAK3172_ERR_OK)
+        {
+            goto RAK3172_BasicInit_Error_5;
+        }
+    #else
+        p_Device.Internal.isStopping = false;
+        p_Device.Internal.EventSet = xQueueCreateSet(CONFIG_RAK3172_UART_QUEUE_LENGTH + 1);
+        if(p_Device.Internal.EventSet == NULL)
+        {
+            Error = RAK3172_ERR_NO_MEM;
+
+            goto RAK3172_BasicInit_Error_5;
+        }
+
+        // Only empty queues can be added to a queue set.
+        xQueueReset(p_Device.Internal.EventQueue);
+        xQueueAddToSet(p_Device.Internal.EventQueue, p_Device.Internal.EventSet);
+        xQueueAddToSet(p_Device.Internal.WakeSignal, p_Device.Internal.EventSet);
+
+        #ifdef CONFIG_RAK3172_TASK_CORE_USE_AFFINITY
+            xTaskCreatePinnedToCore(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, &p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle, CONFIG_RAK3172_TASK_CORE);
+        #else
+            xTaskCreate(RAK3172_UART_EventTask, "RAK3172-Event", CONFIG_RAK3172_TASK_STACK_SIZE, &p_Device, CONFIG_RAK3172_TASK_PRIO, &p_Device.Internal.Handle);
+        #endif
+
+        if(p_Device.Internal.Handle == NULL)
+        {
+            RAK3172_UART_DeleteEventSet(p_Device);
+
+            Error = RAK3172_ERR_NO_MEM;
+
+            goto RAK3172_BasicInit_Error_5;
+        }
+    #endif
+
     if(uart_flush(p_Device.UART.Interface))
     {
         Error = RAK3172_ERR_INVALID_STATE;
 
-        goto RAK3172_BasicInit_Error_4;
+        goto RAK3172_BasicInit_Error_6;
     }
 
-    xQueueReset(p_Device.Internal.MessageQueue);
+    RAK3172_LinePool_Flush(p_Device);
     p_Device.Internal.isInitialized = true;
 
     return RAK3172_ERR_OK;
 
+RAK3172_BasicInit_Error_6:
+    RAK3172_UART_Stop(p_Device);
+
+RAK3172_BasicInit_Error_5:
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+        RAK3172_Uplink_Deinit(p_Device);
+    #endif
+    RAK3172_CmdQueue_Deinit(p_Device);
+
 RAK3172_BasicInit_Error_4:
-    vTaskSuspend(p_Device.Internal.Handle);
-    vTaskDelete(p_Device.Internal.Handle);
+    RAK3172_LinePool_Deinit(p_Device);
 
 RAK3172_BasicInit_Error_3:
-    free(p_Device.Internal.RxBuffer);
+    if(p_Device.Internal.Events != NULL)
+    {
+        vEventGroupDelete(p_Device.Internal.Events);
+        p_Device.Internal.Events = NULL;
+    }
+
+    if(p_Device.Internal.WakeSignal != NULL)
+    {
+        vSemaphoreDelete(p_Device.Internal.WakeSignal);
+        p_Device.Internal.WakeSignal = NULL;
+    }
+
+    if(p_Device.Internal.BurstLock != NULL)
+    {
+        vSemaphoreDelete(p_Device.Internal.BurstLock);
+        p_Device.Internal.BurstLock = NULL;
+    }
 
-RAK3172_BasicInit_Error_2:
-    vQueueDelete(p_Device.Internal.ReceiveQueue);
+    RAK3172_RxQueue_Deinit(p_Device);
 
 RAK3172_BasicInit_Error_1:
     vQueueDelete(p_Device.Internal.MessageQueue);
@@ -529,7 +1133,15 @@ RAK3172_BasicInit_Error_1:
 
 RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
 {
-    std::string Response;
+    bool isEcho = false;
+
+    #ifdef CONFIG_RAK3172_RESET_USE_HW
+        gpio_config_t Reset;
+    #endif
+
+    #ifdef CONFIG_RAK3172_UART_AUTO_BAUD_SWITCH
+        RAK3172_Baud_t Target;
+    #endif
 
     #ifdef CONFIG_RAK3172_RESET_USE_HW
         if((p_Device.Reset == GPIO_NUM_NC) || (p_Device.Reset >= GPIO_NUM_MAX))
@@ -562,22 +1174,23 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
         RAK3172_LOGI(TAG, "     [x] Hardware reset");
         RAK3172_LOGI(TAG, "     [ ] Software reset");
 
-        _RAK3172_Reset_Config.pin_bit_mask = BIT(p_Device.Reset);
+        Reset = _RAK3172_Reset_Config;
+        Reset.pin_bit_mask = BIT(p_Device.Reset);
 
         // Configure the pull-up / pull-down resistor.
         #ifdef CONFIG_RAK3172_RESET_USE_PULL
             #ifdef CONFIG_RAK3172_RESET_INVERT
                 RAK3172_LOGI(TAG, "     [x] Internal pull-down");
-                _RAK3172_Reset_Config.pull_down_en = GPIO_PULLDOWN_ENABLE,
+                Reset.pull_down_en = GPIO_PULLDOWN_ENABLE;
             #else
                 RAK3172_LOGI(TAG, "     [x] Internal pull-up");
-                _RAK3172_Reset_Config.pull_up_en = GPIO_PULLUP_ENABLE;
+                Reset.pull_up_en = GPIO_PULLUP_ENABLE;
             #endif
         #else
             RAK3172_LOGI(TAG, "     [x] No pull-up / pull-down");
         #endif
 
-        if(gpio_config(&_RAK3172_Reset_Config) != ESP_OK)
+        if(gpio_config(&Reset) != ESP_OK)
         {
             return RAK3172_ERR_INVALID_STATE;
         }
@@ -599,6 +1212,15 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
 
     RAK3172_ERROR_CHECK(RAK3172_BasicInit(p_Device));
 
+    // The baud rate must be known before the reset, because the reset is verified with the splash screen.
+    #ifdef CONFIG_RAK3172_UART_AUTO_BAUD
+        #ifdef CONFIG_RAK3172_UART_AUTO_BAUD_SWITCH
+            Target = p_Device.UART.Baudrate;
+        #endif
+
+        RAK3172_ERROR_CHECK(RAK3172_DetectBaudrate(p_Device));
+    #endif
+
     #ifdef CONFIG_RAK3172_RESET_USE_HW
         RAK3172_ERROR_CHECK(RAK3172_HardReset(p_Device));
     #else
@@ -612,54 +1234,26 @@ RAK3172_Error_t RAK3172_Init(RAK3172_t& p_Device)
         RAK3172_ERROR_CHECK(RAK3172_FactoryReset(p_Device));
     #endif
 
-    // Check if echo mode is enabled.
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT", NULL, &Response));
-    RAK3172_LOGD(TAG, "Response from 'AT': %s", Response.c_str());
-    if(Response.find("OK") == std::string::npos)
+    // Check if echo mode is enabled. The check bypasses the command queue, because the echo would be taken for a response.
+    RAK3172_LinePool_Flush(p_Device);
+    uart_write_bytes(p_Device.UART.Interface, "AT\r\n", std::string("AT\r\n").length());
+    RAK3172_ERROR_CHECK(RAK3172_ReceiveStatus(p_Device, "AT", &isEcho));
+    if(isEcho)
     {
-        std::string* Dummy;
-
-        // Echo mode is enabled. Need to receive one more line.
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
-        {
-            return RAK3172_ERR_TIMEOUT;
-        }
-        delete Dummy;
-
         RAK3172_LOGD(TAG, "Echo mode enabled. Disabling echo mode...");
 
-        // Disable echo mode
-        //  -> Transmit the command
-        //  -> Receive the echo
-        //  -> Receive the value
-        //  -> Receive the status
         uart_write_bytes(p_Device.UART.Interface, "ATE\r\n", std::string("ATE\r\n").length());
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
-        {
-            return RAK3172_ERR_TIMEOUT;
-        }
-        delete Dummy;
-
-        #ifndef CONFIG_RAK3172_USE_RUI3
-            if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
-            {
-                return RAK3172_ERR_TIMEOUT;
-            }
-            delete Dummy;
-        #endif
+        RAK3172_ERROR_CHECK(RAK3172_ReceiveStatus(p_Device, "ATE", NULL));
+    }
 
-        if(xQueueReceive(p_Device.Internal.MessageQueue, &Dummy, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) != pdPASS)
+    #ifdef CONFIG_RAK3172_UART_AUTO_BAUD_SWITCH
+        if(p_Device.UART.Baudrate != Target)
         {
-            return RAK3172_ERR_TIMEOUT;
-        }
+            RAK3172_LOGI(TAG, "Switch module from %u baud to %u baud...", p_Device.UART.Baudrate, Target);
 
-        // Error during initialization when everything else except 'OK' is received.
-        if(Dummy->find("OK") == std::string::npos)
-        {
-            return RAK3172_ERR_TIMEOUT;
+            RAK3172_ERROR_CHECK(RAK3172_SetBaudrate(p_Device, Target));
         }
-        delete Dummy;
-    }
+    #endif
 
     if(p_Device.Info != NULL)
     {
@@ -682,8 +1276,10 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
         return;
     }
 
-    vTaskSuspend(p_Device.Internal.Handle);
-    vTaskDelete(p_Device.Internal.Handle);
+    RAK3172_UART_Stop(p_Device);
+
+    // Reject new commands from the completion callbacks of the aborted commands and uplinks.
+    p_Device.Internal.isInitialized = false;
 
     if(uart_is_driver_installed(p_Device.UART.Interface))
     {
@@ -696,13 +1292,33 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
         vQueueDelete(p_Device.Internal.MessageQueue);
     }
 
-    if(p_Device.Internal.ReceiveQueue != NULL)
+    RAK3172_RxQueue_Deinit(p_Device);
+
+    if(p_Device.Internal.Events != NULL)
+    {
+        vEventGroupDelete(p_Device.Internal.Events);
+        p_Device.Internal.Events = NULL;
+    }
+
+    RAK3172_CmdQueue_Deinit(p_Device);
+
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+        RAK3172_Uplink_Deinit(p_Device);
+    #endif
+
+    RAK3172_LinePool_Deinit(p_Device);
+
+    if(p_Device.Internal.WakeSignal != NULL)
     {
-        vQueueDelete(p_Device.Internal.ReceiveQueue);
+        vSemaphoreDelete(p_Device.Internal.WakeSignal);
+        p_Device.Internal.WakeSignal = NULL;
     }
 
-    free(p_Device.Internal.RxBuffer);
-    p_Device.Internal.RxBuffer = NULL;
+    if(p_Device.Internal.BurstLock != NULL)
+    {
+        vSemaphoreDelete(p_Device.Internal.BurstLock);
+        p_Device.Internal.BurstLock = NULL;
+    }
 
     gpio_reset_pin(static_cast<gpio_num_t>(p_Device.UART.Rx));
     gpio_reset_pin(static_cast<gpio_num_t>(p_Device.UART.Tx));
@@ -711,32 +1327,178 @@ void RAK3172_Deinit(RAK3172_t& p_Device)
     p_Device.Internal.isBusy = false;
 }
 
+/** @brief          Transmit a command without checking the busy flag of the device.
+ *                  NOTE: Only used while the baud rate is changed!
+ *  @param p_Device RAK3172 device object
+ *  @param Command  AT command
+ *  @return         RAK3172_ERR_OK when successful
+ */
+static RAK3172_Error_t RAK3172_SendDirect(RAK3172_t& p_Device, const std::string& Command)
+{
+    RAK3172_Command_t* Request;
+
+    RAK3172_ERROR_CHECK(RAK3172_CmdQueue_Submit(p_Device, Command, RAK_RESPONSE_STATUS, NULL, NULL, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS, &Request));
+
+    return RAK3172_CmdQueue_Wait(p_Device, Request, NULL, NULL);
+}
+
+/** @brief          Check the communication with the module with an "AT" command.
+ *  @param p_Device RAK3172 device object
+ *  @return         RAK3172_ERR_OK when the module responds
+ *                  RAK3172_ERR_TIMEOUT when the module doesn´t respond
+ */
+static RAK3172_Error_t RAK3172_Probe(RAK3172_t& p_Device)
+{
+    for(uint8_t i = 0; i < RAK3172_PROBE_ATTEMPTS; i++)
+    {
+        if(RAK3172_SendDirect(p_Device, "AT") == RAK3172_ERR_OK)
+        {
+            return RAK3172_ERR_OK;
+        }
+    }
+
+    return RAK3172_ERR_TIMEOUT;
+}
+
 RAK3172_Error_t RAK3172_SetBaudrate(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate)
 {
-    if(p_Device.UART.Baudrate == Baudrate)
+    RAK3172_Error_t Error;
+    RAK3172_Baud_t Previous;
+
+    if(p_Device.Internal.isInitialized == false)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+    else if(p_Device.UART.Baudrate == Baudrate)
     {
         return RAK3172_ERR_OK;
     }
 
-    RAK3172_ERROR_CHECK(RAK3172_SendCommand(p_Device, "AT+BAUD=" + std::to_string(Baudrate)));
+    // Reject new commands and uplinks until the link is verified with the new baud rate. All commands and uplinks in flight
+    // must be completed first, because the responses and events would be received with the wrong baud rate.
+    if(p_Device.Internal.isBusy.exchange(true))
+    {
+        return RAK3172_ERR_BUSY;
+    }
+
+    Error = RAK3172_ERR_OK;
+    if(RAK3172_CmdQueue_WaitIdle(p_Device, RAK3172_DEFAULT_WAIT_TIMEOUT / portTICK_PERIOD_MS) == false)
+    {
+        Error = RAK3172_ERR_BUSY;
+    }
+
+    #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+        if((Error == RAK3172_ERR_OK) && RAK3172_Uplink_isTransmitting(p_Device))
+        {
+            Error = RAK3172_ERR_BUSY;
+        }
+    #endif
+
+    if(Error == RAK3172_ERR_OK)
+    {
+        Error = RAK3172_SendDirect(p_Device, "AT+BAUD=" + std::to_string(Baudrate));
+    }
+
+    if(Error != RAK3172_ERR_OK)
+    {
+        p_Device.Internal.isBusy = false;
+
+        return Error;
+    }
+
+    Previous = p_Device.UART.Baudrate;
+
+    Error = RAK3172_SwitchBaudrate(p_Device, Baudrate);
+    if(Error == RAK3172_ERR_OK)
+    {
+        Error = RAK3172_Probe(p_Device);
+    }
+
+    if(Error == RAK3172_ERR_OK)
+    {
+        p_Device.UART.Baudrate = Baudrate;
+    }
+    else
+    {
+        RAK3172_LOGW(TAG, "No response with %u baud. Restore %u baud!", Baudrate, Previous);
+
+        // Try to restore the baud rate of the module with the new baud rate first, because the module may have changed the baud rate.
+        RAK3172_SendDirect(p_Device, "AT+BAUD=" + std::to_string(Previous));
+        RAK3172_SwitchBaudrate(p_Device, Previous);
+
+        if(RAK3172_Probe(p_Device) == RAK3172_ERR_OK)
+        {
+            Error = RAK3172_ERR_INVALID_RESPONSE;
+        }
+        else
+        {
+            Error = RAK3172_ERR_INVALID_STATE;
+        }
+    }
+
+    p_Device.Internal.isBusy = false;
+
+    return Error;
+}
+
+RAK3172_Error_t RAK3172_BeginBurst(RAK3172_t& p_Device, RAK3172_Baud_t Baudrate)
+{
+    RAK3172_Error_t Error;
+
+    if(p_Device.Internal.BurstLock == NULL)
+    {
+        return RAK3172_ERR_INVALID_STATE;
+    }
+
+    // The nested bursts of all tasks of the device are serialized, so a burst returns after the baud rate was changed by the outermost burst.
+    // Other devices aren´t blocked while the baud rate is changed.
+    xSemaphoreTake(p_Device.Internal.BurstLock, portMAX_DELAY);
+
+    Error = RAK3172_ERR_OK;
+
+    // The baud rate is only changed by the outermost burst.
+    if(p_Device.UART.BurstCounter++ == 0)
+    {
+        p_Device.UART.Restore = p_Device.UART.Baudrate;
+        if(Baudrate > p_Device.UART.Baudrate)
+        {
+            Error = RAK3172_SetBaudrate(p_Device, Baudrate);
+            if(Error != RAK3172_ERR_OK)
+            {
+                p_Device.UART.BurstCounter--;
+            }
+        }
+    }
+
+    xSemaphoreGive(p_Device.Internal.BurstLock);
+
+    return Error;
+}
+
+RAK3172_Error_t RAK3172_EndBurst(RAK3172_t& p_Device)
+{
+    RAK3172_Error_t Error;
 
-    // Deinitialize the UART interface.
-    if(uart_driver_delete(p_Device.UART.Interface))
+    if(p_Device.Internal.BurstLock == NULL)
     {
         return RAK3172_ERR_INVALID_STATE;
     }
 
-    // Initialize the interface with the new baudrate. Do a rollback if something is going wrong.
-    _RAK3172_UART_Config.baud_rate = Baudrate;
-    if(RAK3172_BasicInit(p_Device) != RAK3172_ERR_OK)
+    xSemaphoreTake(p_Device.Internal.BurstLock, portMAX_DELAY);
+
+    Error = RAK3172_ERR_OK;
+    if(p_Device.UART.BurstCounter == 0)
+    {
+        Error = RAK3172_ERR_INVALID_STATE;
+    }
+    else if(--p_Device.UART.BurstCounter == 0)
     {
-        _RAK3172_UART_Config.baud_rate = p_Device.UART.Baudrate;
-        RAK3172_ERROR_CHECK(RAK3172_BasicInit(p_Device));
+        Error = RAK3172_SetBaudrate(p_Device, p_Device.UART.Restore);
     }
 
-    p_Device.UART.Baudrate = Baudrate;
+    xSemaphoreGive(p_Device.Internal.BurstLock);
 
-    return RAK3172_ERR_OK;
+    return Error;
 }
 
 RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device)
@@ -757,6 +1519,90 @@ RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device)
     return RAK3172_SendCommand(p_Device, "AT");
 }
 
+void RAK3172_SaveSnapshot(const RAK3172_t& p_Device, RAK3172_Snapshot_t* p_Snapshot)
+{
+    if(p_Snapshot == NULL)
+    {
+        return;
+    }
+
+    // Clear the padding bytes, because they are part of the CRC.
+    memset(p_Snapshot, 0, sizeof(RAK3172_Snapshot_t));
+
+    p_Snapshot->Version = RAK3172_SNAPSHOT_VERSION;
+    p_Snapshot->Size = sizeof(RAK3172_Snapshot_t);
+    p_Snapshot->Baudrate = p_Device.UART.Baudrate;
+    p_Snapshot->Mode = p_Device.Mode;
+    p_Snapshot->Join = p_Device.LoRaWAN.Join;
+    p_Snapshot->isJoined = p_Device.LoRaWAN.isJoined;
+    p_Snapshot->Config = p_Device.LoRaWAN.Config;
+
+    // The RTC memory isn´t protected, so the keys are only stored on request.
+    #ifndef CONFIG_RAK3172_SNAPSHOT_WITH_KEYS
+        memset(p_Snapshot->Config.Key1, 0, sizeof(p_Snapshot->Config.Key1));
+        memset(p_Snapshot->Config.Key2, 0, sizeof(p_Snapshot->Config.Key2));
+        memset(p_Snapshot->Config.Key3, 0, sizeof(p_Snapshot->Config.Key3));
+        p_Snapshot->Config.Valid &= ~(RAK_LORAWAN_CFG_OTAA | RAK_LORAWAN_CFG_ABP);
+    #endif
+
+    if(p_Device.Info != NULL)
+    {
+        strncpy(p_Snapshot->Firmware, p_Device.Info->Firmware.c_str(), sizeof(p_Snapshot->Firmware) - 1);
+        strncpy(p_Snapshot->Serial, p_Device.Info->Serial.c_str(), sizeof(p_Snapshot->Serial) - 1);
+    }
+
+    p_Snapshot->CRC = RAK3172_GetSnapshotCRC(p_Snapshot);
+}
+
+RAK3172_Error_t RAK3172_WakeUp(RAK3172_t& p_Device, const RAK3172_Snapshot_t* p_Snapshot)
+{
+    if(p_Snapshot == NULL)
+    {
+        return RAK3172_ERR_INVALID_ARG;
+    }
+    else if(p_Device.Internal.isInitialized == true)
+    {
+        return RAK3172_ERR_OK;
+    }
+
+    // The snapshot is invalid after a power loss or a driver update. Read the state from the module.
+    if((p_Snapshot->Version != RAK3172_SNAPSHOT_VERSION) || (p_Snapshot->Size != sizeof(RAK3172_Snapshot_t)) || (p_Snapshot->CRC != RAK3172_GetSnapshotCRC(p_Snapshot)))
+    {
+        RAK3172_LOGW(TAG, "Invalid snapshot. Read the state from the module...");
+
+        RAK3172_ERROR_CHECK(RAK3172_WakeUp(p_Device));
+        RAK3172_ERROR_CHECK(RAK3172_GetMode(p_Device));
+
+        #ifdef CONFIG_RAK3172_MODE_WITH_LORAWAN
+            if(p_Device.Mode == RAK_MODE_LORAWAN)
+            {
+                p_Device.LoRaWAN.isJoined = RAK3172_LoRaWAN_isJoined(p_Device, true);
+            }
+        #endif
+
+        if(p_Device.Info != NULL)
+        {
+            RAK3172_ERROR_CHECK(RAK3172_GetFWVersion(p_Device, &p_Device.Info->Firmware) | RAK3172_GetSerialNumber(p_Device, &p_Device.Info->Serial));
+        }
+
+        return RAK3172_ERR_OK;
+    }
+
+    p_Device.UART.Baudrate = p_Snapshot->Baudrate;
+    p_Device.Mode = p_Snapshot->Mode;
+    p_Device.LoRaWAN.Join = p_Snapshot->Join;
+    p_Device.LoRaWAN.isJoined = p_Snapshot->isJoined;
+    p_Device.LoRaWAN.Config = p_Snapshot->Config;
+
+    if(p_Device.Info != NULL)
+    {
+        p_Device.Info->Firmware = std::string(p_Snapshot->Firmware);
+        p_Device.Info->Serial = std::string(p_Snapshot->Serial);
+    }
+
+    return RAK3172_WakeUp(p_Device);
+}
+
 RAK3172_Error_t RAK3172_FactoryReset(RAK3172_t& p_Device)
 {
     if(p_Device.Internal.isInitialized == false)
@@ -777,6 +1623,10 @@ RAK3172_Error_t RAK3172_FactoryReset(RAK3172_t& p_Device)
         RAK3172_SendCommand(p_Device, "ATR");
     #endif
 
+    // The module has lost its configuration.
+    p_Device.LoRaWAN.Config.Valid = 0;
+    p_Device.LoRaWAN.isDataRateValid = false;
+
     RAK3172_LOGI(TAG, "     Successful!");
 
     return RAK3172_ERR_OK;
@@ -0,0 +1,122 @@
+ /*
+ * rak3172_alloc.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Allocation counter for the host tests of the RAK3172 driver.
+ *             NOTE: Must only be included by one file of a test program, because it replaces the global allocation functions!
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_ALLOC_H_
+#define RAK3172_ALLOC_H_
+
+#include <new>
+#include <atomic>
+
+#include <stdlib.h>
+
+/** @brief Number of allocations of all threads since the start of the test program.
+ */
+static std::atomic<uint32_t> _RAK3172_Test_Allocations(0);
+
+#ifdef __GLIBC__
+    extern "C" void* __libc_malloc(size_t Size);
+    extern "C" void* __libc_calloc(size_t Count, size_t Size);
+    extern "C" void* __libc_realloc(void* p_Memory, size_t Size);
+
+    // The C allocation functions of the driver are counted too. The operators below use them.
+    extern "C" void* malloc(size_t Size)
+    {
+        _RAK3172_Test_Allocations++;
+
+        return __libc_malloc(Size);
+    }
+
+    extern "C" void* calloc(size_t Count, size_t Size)
+    {
+        _RAK3172_Test_Allocations++;
+
+        return __libc_calloc(Count, Size);
+    }
+
+    extern "C" void* realloc(void* p_Memory, size_t Size)
+    {
+        _RAK3172_Test_Allocations++;
+
+        return __libc_realloc(p_Memory, Size);
+    }
+
+    void* operator new(size_t Size)
+    {
+        void* Memory = __libc_malloc((Size == 0) ? 1 : Size);
+
+        if(Memory == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        _RAK3172_Test_Allocations++;
+
+        return Memory;
+    }
+#else
+    void* operator new(size_t Size)
+    {
+        void* Memory = malloc((Size == 0) ? 1 : Size);
+
+        if(Memory == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        _RAK3172_Test_Allocations++;
+
+        return Memory;
+    }
+#endif
+
+void* operator new[](size_t Size)
+{
+    return operator new(Size);
+}
+
+void operator delete(void* p_Memory) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete(void* p_Memory, size_t Size) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete[](void* p_Memory) noexcept
+{
+    free(p_Memory);
+}
+
+void operator delete[](void* p_Memory, size_t Size) noexcept
+{
+    free(p_Memory);
+}
+
+/** @brief  Get the number of allocations of all threads since the start of the test program.
+ *  @return Number of allocations
+ */
+static inline uint32_t RAK3172_Test_GetAllocations(void)
+{
+    return _RAK3172_Test_Allocations.load();
+}
+
+#endif /* RAK3172_ALLOC_H_ */
@@ -0,0 +1,304 @@
+ /*
+ * rak3172_sim.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Simulated RAK3172 module for the host tests of the driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <chrono>
+
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+
+/** @brief Characters, which are received by the driver when the baud rates don´t match.
+ */
+static const char _RAK3172_Sim_Noise[] = {'\xE0', '\x1C', '\xFE', '\x80', '\xF8'};
+
+/** @brief          Check if the baud rates of the module and of the UART interface match.
+ *                  NOTE: The lock must be held!
+ *  @param p_Sim    Pointer to simulator
+ *  @return         #true when the baud rates match
+ */
+static bool RAK3172_Sim_isSynchronized(const RAK3172_Sim_t* p_Sim)
+{
+    return RAK3172_Host_UART_GetBaudrate(p_Sim->Port) == p_Sim->Baudrate;
+}
+
+/** @brief          Transmit a line to the driver.
+ *                  NOTE: The lock must be held!
+ *  @param p_Sim    Pointer to simulator
+ *  @param Line     Line without CR and LF
+ */
+static void RAK3172_Sim_Write(RAK3172_Sim_t* p_Sim, const std::string& Line)
+{
+    std::string Data;
+
+    if(RAK3172_Sim_isSynchronized(p_Sim) == false)
+    {
+        if(p_Sim->isNoisy)
+        {
+            RAK3172_Host_UART_Inject(p_Sim->Port, _RAK3172_Sim_Noise, sizeof(_RAK3172_Sim_Noise));
+        }
+
+        return;
+    }
+
+    Data = Line + "\r\n";
+    RAK3172_Host_UART_Inject(p_Sim->Port, Data.c_str(), Data.length());
+}
+
+/** @brief          Transmit the splash screen of the module after a reset.
+ *                  NOTE: The lock must be held!
+ *  @param p_Sim    Pointer to simulator
+ */
+static void RAK3172_Sim_Splash(RAK3172_Sim_t* p_Sim)
+{
+    const char* Mode;
+
+    Mode = (p_Sim->Values["NWM"] == "0") ? "LoRa P2P." : "LoRaWAN.";
+
+    RAK3172_Sim_Write(p_Sim, "RAKwireless RAK3172 Example");
+    RAK3172_Sim_Write(p_Sim, "------------------------------------------------------");
+    if(p_Sim->isRUI3 == false)
+    {
+        RAK3172_Sim_Write(p_Sim, "Version. 1.0.4");
+    }
+    RAK3172_Sim_Write(p_Sim, std::string("Current Work Mode: ") + Mode);
+}
+
+/** @brief          Process a command with the default behavior of the module.
+ *                  NOTE: The lock must be held!
+ *  @param p_Sim    Pointer to simulator
+ *  @param Command  Received command without CR and LF
+ */
+static void RAK3172_Sim_Process(RAK3172_Sim_t* p_Sim, const std::string& Command)
+{
+    size_t Index;
+    std::string Name;
+
+    if((Command == "AT") || ((p_Sim->isRUI3 == true) && (Command == "ATR")))
+    {
+        RAK3172_Sim_Write(p_Sim, "OK");
+    }
+    else if(Command == "ATE")
+    {
+        p_Sim->isEcho = !p_Sim->isEcho;
+        RAK3172_Sim_Write(p_Sim, "OK");
+    }
+    else if((Command == "ATZ") || (Command == "ATR"))
+    {
+        RAK3172_Sim_Splash(p_Sim);
+    }
+    else if(Command.compare(0, 3, "AT+") == 0)
+    {
+        Index = Command.find('=');
+        Name = Command.substr(3, Index - 3);
+
+        if(Index == std::string::npos)
+        {
+            RAK3172_Sim_Write(p_Sim, "OK");
+        }
+        else if(Command.compare(Index, std::string::npos, "=?") == 0)
+        {
+            if(p_Sim->Values.count(Name) == 0)
+            {
+                RAK3172_Sim_Write(p_Sim, "AT_COMMAND_NOT_FOUND");
+
+                return;
+            }
+
+            RAK3172_Sim_Write(p_Sim, p_Sim->isRUI3 ? ("AT+" + Name + "=" + p_Sim->Values[Name]) : p_Sim->Values[Name]);
+            RAK3172_Sim_Write(p_Sim, "OK");
+        }
+        else
+        {
+            p_Sim->Values[Name] = Command.substr(Index + 1);
+            RAK3172_Sim_Write(p_Sim, "OK");
+
+            // The module responds with the old baud rate.
+            if(Name == "BAUD")
+            {
+                p_Sim->Baudrate = std::stoul(p_Sim->Values[Name]);
+            }
+        }
+    }
+    else
+    {
+        RAK3172_Sim_Write(p_Sim, "AT_ERROR");
+    }
+}
+
+/** @brief          Task of the simulator. Processes one command after another.
+ *  @param p_Sim    Pointer to simulator
+ */
+static void RAK3172_Sim_Task(RAK3172_Sim_t* p_Sim)
+{
+    std::unique_lock<std::mutex> Guard(p_Sim->Lock);
+
+    while(true)
+    {
+        std::string Command;
+
+        p_Sim->Changed.wait(Guard, [p_Sim]() {
+            return (p_Sim->Pending.empty() == false) || (p_Sim->isRunning == false);
+        });
+
+        if(p_Sim->isRunning == false)
+        {
+            break;
+        }
+
+        Command = p_Sim->Pending.front();
+
+        if(p_Sim->Delay > 0)
+        {
+            Guard.unlock();
+            std::this_thread::sleep_for(std::chrono::milliseconds(p_Sim->Delay));
+            Guard.lock();
+        }
+
+        if(p_Sim->isEcho)
+        {
+            RAK3172_Sim_Write(p_Sim, Command);
+        }
+
+        // The test handler may transmit lines or wait, so it is called without the lock.
+        if(p_Sim->Handler != NULL)
+        {
+            bool isHandled;
+
+            Guard.unlock();
+            isHandled = p_Sim->Handler(p_Sim, Command);
+            Guard.lock();
+
+            if(isHandled == false)
+            {
+                RAK3172_Sim_Process(p_Sim, Command);
+            }
+        }
+        else
+        {
+            RAK3172_Sim_Process(p_Sim, Command);
+        }
+
+        // The command is removed after the processing, so a flush waits for the responses.
+        p_Sim->Pending.pop_front();
+        p_Sim->Changed.notify_all();
+    }
+}
+
+/** @brief          Receive handler of the simulator.
+ *  @param Port     UART interface
+ *  @param p_Data   Pointer to the data written by the driver
+ *  @param Length   Length of the data
+ *  @param p_Arg    Pointer to simulator
+ */
+static void RAK3172_Sim_OnReceive(uart_port_t Port, const uint8_t* p_Data, size_t Length, void* p_Arg)
+{
+    RAK3172_Sim_t* Sim = static_cast<RAK3172_Sim_t*>(p_Arg);
+    std::lock_guard<std::mutex> Guard(Sim->Lock);
+
+    if(Sim->Raw != NULL)
+    {
+        size_t Processed;
+
+        Processed = Sim->Raw(Sim, p_Data, Length);
+        if(Sim->Raw != NULL)
+        {
+            return;
+        }
+
+        p_Data += Processed;
+        Length -= Processed;
+    }
+
+    for(size_t i = 0; i < Length; i++)
+    {
+        if(p_Data[i] == '\r')
+        {
+            continue;
+        }
+        else if(p_Data[i] != '\n')
+        {
+            Sim->Line += static_cast<char>(p_Data[i]);
+
+            continue;
+        }
+
+        Sim->Baudrates.push_back(RAK3172_Host_UART_GetBaudrate(Sim->Port));
+
+        // The module receives invalid characters when the baud rates don´t match.
+        if(RAK3172_Sim_isSynchronized(Sim))
+        {
+            Sim->Received.push_back(Sim->Line);
+            Sim->Pending.push_back(Sim->Line);
+            Sim->Changed.notify_all();
+        }
+        else if(Sim->isNoisy)
+        {
+            RAK3172_Host_UART_Inject(Sim->Port, _RAK3172_Sim_Noise, sizeof(_RAK3172_Sim_Noise));
+        }
+
+        Sim->Line.clear();
+    }
+}
+
+void RAK3172_Sim_Start(RAK3172_Sim_t* p_Sim, uart_port_t Port, uint32_t Baudrate)
+{
+    p_Sim->Port = Port;
+    p_Sim->Baudrate = Baudrate;
+    p_Sim->isRUI3 = true;
+    p_Sim->isEcho = true;
+    p_Sim->isNoisy = false;
+    p_Sim->Delay = 0;
+    p_Sim->Values["NWM"] = "1";
+    p_Sim->Handler = NULL;
+    p_Sim->p_Arg = NULL;
+    p_Sim->Raw = NULL;
+    p_Sim->isRunning = true;
+    p_Sim->Task = std::thread(RAK3172_Sim_Task, p_Sim);
+
+    RAK3172_Host_UART_Attach(Port, RAK3172_Sim_OnReceive, p_Sim);
+}
+
+void RAK3172_Sim_Stop(RAK3172_Sim_t* p_Sim)
+{
+    RAK3172_Host_UART_Attach(p_Sim->Port, NULL, NULL);
+
+    {
+        std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+        p_Sim->isRunning = false;
+        p_Sim->Changed.notify_all();
+    }
+
+    p_Sim->Task.join();
+}
+
+void RAK3172_Sim_Send(RAK3172_Sim_t* p_Sim, const std::string& Line)
+{
+    std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+    RAK3172_Sim_Write(p_Sim, Line);
+}
+
+void RAK3172_Sim_Flush(RAK3172_Sim_t* p_Sim)
+{
+    std::unique_lock<std::mutex> Guard(p_Sim->Lock);
+
+    p_Sim->Changed.wait(Guard, [p_Sim]() {
+        return p_Sim->Pending.empty();
+    });
+}
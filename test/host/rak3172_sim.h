@@ -0,0 +1,99 @@
+ /*
+ * rak3172_sim.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Simulated RAK3172 module for the host tests of the driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_SIM_H_
+#define RAK3172_SIM_H_
+
+#include <map>
+#include <mutex>
+#include <deque>
+#include <string>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+
+#include <driver/uart.h>
+
+struct RAK3172_Sim_t;
+
+/** @brief          Command handler of a test. The handler is called before the default processing of the simulator.
+ *                  NOTE: Called from the task of the simulator!
+ *  @param p_Sim    Pointer to simulator
+ *  @param Command  Received command without CR and LF
+ *  @return         #true when the command was handled by the test
+ */
+typedef bool (*RAK3172_Sim_Handler_t)(RAK3172_Sim_t* p_Sim, const std::string& Command);
+
+/** @brief          Receiver for binary data of a test (i. e. a Ymodem transfer). The receiver replaces the line processing of the simulator.
+ *                  NOTE: Called from the writing task with the lock of the simulator held!
+ *  @param p_Sim    Pointer to simulator
+ *  @param p_Data   Pointer to the data written by the driver
+ *  @param Length   Length of the data
+ *  @return         Number of processed bytes. The remaining bytes are processed as lines when the receiver removed itself
+ */
+typedef size_t (*RAK3172_Sim_Raw_t)(RAK3172_Sim_t* p_Sim, const uint8_t* p_Data, size_t Length);
+
+/** @brief Simulated module. The simulator processes one command after another like the module. All fields are protected by the lock.
+ */
+typedef struct RAK3172_Sim_t
+{
+    uart_port_t Port;                                   /**< UART interface of the driver. */
+    uint32_t Baudrate;                                  /**< Baud rate of the module. */
+    bool isRUI3;                                        /**< Respond like a module with RUI3 firmware. */
+    bool isEcho;                                        /**< Echo mode of the module. */
+    bool isNoisy;                                       /**< Respond with invalid characters when the baud rates don´t match. */
+    uint32_t Delay;                                     /**< Delay in milliseconds before each response. */
+    std::map<std::string, std::string> Values;          /**< Values of the settings without the "AT+" prefix. */
+    std::vector<std::string> Received;                  /**< All commands, which were received with the correct baud rate. */
+    std::vector<uint32_t> Baudrates;                    /**< Baud rate of the UART interface for each received line, also with a wrong baud rate. */
+    RAK3172_Sim_Handler_t Handler;                      /**< (Optional) Command handler of the test. */
+    void* p_Arg;                                        /**< (Optional) Argument of the test. */
+    RAK3172_Sim_Raw_t Raw;                              /**< (Optional) Receiver for binary data. The lines are processed again when the receiver is removed. */
+    std::mutex Lock;
+    std::condition_variable Changed;
+    std::string Line;
+    std::deque<std::string> Pending;
+    std::thread Task;
+    bool isRunning;
+} RAK3172_Sim_t;
+
+/** @brief          Start a simulated module with the default settings (RUI3, echo on, LoRaWAN mode) on a UART interface.
+ *  @param p_Sim    Pointer to simulator
+ *  @param Port     UART interface of the driver
+ *  @param Baudrate Baud rate of the module
+ */
+void RAK3172_Sim_Start(RAK3172_Sim_t* p_Sim, uart_port_t Port, uint32_t Baudrate);
+
+/** @brief          Stop a simulated module.
+ *  @param p_Sim    Pointer to simulator
+ */
+void RAK3172_Sim_Stop(RAK3172_Sim_t* p_Sim);
+
+/** @brief          Transmit a line to the driver. The baud rates of the module and of the UART interface must match.
+ *  @param p_Sim    Pointer to simulator
+ *  @param Line     Line without CR and LF
+ */
+void RAK3172_Sim_Send(RAK3172_Sim_t* p_Sim, const std::string& Line);
+
+/** @brief          Wait until the simulator has processed all received commands.
+ *  @param p_Sim    Pointer to simulator
+ */
+void RAK3172_Sim_Flush(RAK3172_Sim_t* p_Sim);
+
+#endif /* RAK3172_SIM_H_ */
@@ -0,0 +1,68 @@
+ /*
+ * rak3172_test.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Minimal check macros for the host tests of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_TEST_H_
+#define RAK3172_TEST_H_
+
+#include <chrono>
+
+#include <stdio.h>
+#include <stdint.h>
+
+/** @brief Number of failed checks of the current test program.
+ */
+static unsigned int _RAK3172_Test_Failures = 0;
+
+/** @brief              Check a condition and report the location when the condition is false.
+ *  @param Condition    Condition to check
+ */
+#define RAK3172_TEST_CHECK(Condition)                                                   \
+    do                                                                                  \
+    {                                                                                   \
+        if(!(Condition))                                                                \
+        {                                                                               \
+            printf("%s:%d: Check failed: %s\n", __FILE__, __LINE__, #Condition);        \
+            _RAK3172_Test_Failures++;                                                   \
+        }                                                                               \
+    } while(0)
+
+/** @brief          Run a test function and print its name.
+ *  @param Function Test function without arguments
+ */
+#define RAK3172_TEST_RUN(Function)                                                      \
+    do                                                                                  \
+    {                                                                                   \
+        printf("Run %s\n", #Function);                                                  \
+        Function();                                                                     \
+    } while(0)
+
+/** @brief  Get a monotonic time stamp for the benchmarks.
+ *  @return Time in nanoseconds
+ */
+static inline uint64_t RAK3172_Test_Now(void)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/** @brief  Get the result of the test program.
+ *  @return 0 when all checks were successful
+ */
+#define RAK3172_TEST_RESULT()                                                           ((_RAK3172_Test_Failures == 0) ? 0 : 1)
+
+#endif /* RAK3172_TEST_H_ */
@@ -0,0 +1,16 @@
+#pragma once
+#include "esp_err.h"
+#include <stdint.h>
+typedef enum { GPIO_NUM_NC = -1, GPIO_NUM_0 = 0, GPIO_NUM_12 = 12, GPIO_NUM_14 = 14, GPIO_NUM_MAX = 40 } gpio_num_t;
+typedef enum { GPIO_MODE_INPUT, GPIO_MODE_OUTPUT } gpio_mode_t;
+typedef enum { GPIO_PULLUP_DISABLE, GPIO_PULLUP_ENABLE } gpio_pullup_t;
+typedef enum { GPIO_PULLDOWN_DISABLE, GPIO_PULLDOWN_ENABLE } gpio_pulldown_t;
+typedef enum { GPIO_INTR_DISABLE } gpio_int_type_t;
+typedef enum { GPIO_PULLUP_ONLY } gpio_pull_mode_t;
+typedef struct { uint64_t pin_bit_mask; gpio_mode_t mode; gpio_pullup_t pull_up_en; gpio_pulldown_t pull_down_en; gpio_int_type_t intr_type; } gpio_config_t;
+esp_err_t gpio_config(const gpio_config_t*);
+esp_err_t gpio_set_level(gpio_num_t, uint32_t);
+esp_err_t gpio_reset_pin(gpio_num_t);
+esp_err_t gpio_sleep_set_direction(gpio_num_t, gpio_mode_t);
+esp_err_t gpio_sleep_set_pull_mode(gpio_num_t, gpio_pull_mode_t);
+#define BIT(n) (1ULL << (n))
@@ -0,0 +1,5 @@
+#pragma once
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_SLOW_ATTR
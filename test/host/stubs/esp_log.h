@@ -0,0 +1,8 @@
+#pragma once
+typedef enum { ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG, ESP_LOG_VERBOSE } esp_log_level_t;
+static inline void esp_log_level_set(const char*, esp_log_level_t) {}
+static inline void esp_log_discard(const char*, const char*, ...) {}
+#define ESP_LOGI(tag, fmt, ...) esp_log_discard(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...) esp_log_discard(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) esp_log_discard(tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGE(tag, fmt, ...) esp_log_discard(tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+typedef struct { int x; } StaticTask_t;
+typedef struct { int x; } StaticQueue_t;
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define portTICK_PERIOD_MS 1
+#define portTICK_RATE_MS 1
+#define portMAX_DELAY 0xFFFFFFFF
+#define pdMS_TO_TICKS(x) (x)
+#define configASSERT(x)
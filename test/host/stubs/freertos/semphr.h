@@ -0,0 +1,10 @@
+#pragma once
+#include "queue.h"
+typedef QueueHandle_t SemaphoreHandle_t;
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t);
+void vSemaphoreDelete(SemaphoreHandle_t);
+typedef StaticQueue_t StaticSemaphore_t;
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t*);
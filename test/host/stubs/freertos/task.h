@@ -0,0 +1,18 @@
+#pragma once
+#include "FreeRTOS.h"
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+BaseType_t xTaskCreate(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*, BaseType_t);
+void vTaskDelete(TaskHandle_t);
+void vTaskSuspend(TaskHandle_t);
+void vTaskResume(TaskHandle_t);
+void vTaskDelay(TickType_t);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t);
+BaseType_t xTaskNotifyGive(TaskHandle_t);
+typedef enum { eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite } eNotifyAction;
+BaseType_t xTaskNotify(TaskHandle_t, uint32_t, eNotifyAction);
+BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t*, TickType_t);
+void taskYIELD(void);
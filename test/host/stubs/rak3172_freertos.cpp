@@ -0,0 +1,579 @@
+ /*
+ * rak3172_freertos.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: FreeRTOS port for the host tests of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include <string.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+
+/** @brief Object types of the host port.
+ */
+typedef enum
+{
+    RAK3172_HOST_QUEUE,
+    RAK3172_HOST_MUTEX,
+    RAK3172_HOST_BINARY,
+    RAK3172_HOST_SET,
+} RAK3172_Host_Queue_Type_t;
+
+/** @brief Kernel object of the host port. Like the kernel objects of FreeRTOS, all memory is allocated during the creation,
+ *         so the tests can count the allocations of the driver.
+ */
+struct QueueDefinition
+{
+    RAK3172_Host_Queue_Type_t Type;
+    UBaseType_t Length;
+    UBaseType_t ItemSize;
+    std::vector<uint8_t> Items;
+    UBaseType_t Head;
+    UBaseType_t Waiting;
+    UBaseType_t Count;
+    QueueDefinition* Set;
+    std::vector<QueueDefinition*> Ready;
+    UBaseType_t ReadyHead;
+    UBaseType_t ReadyCount;
+};
+
+struct EventGroupDef_t
+{
+    EventBits_t Bits;
+};
+
+/** @brief Task object of a host thread.
+ */
+typedef struct
+{
+    uint32_t Value;
+    bool isSuspended;
+    TaskFunction_t Function;
+    void* p_Arg;
+} RAK3172_Host_Task_t;
+
+/** @brief Exception, which is used to leave the thread of a task that deletes itself.
+ */
+struct RAK3172_Host_TaskExit_t
+{
+};
+
+/** @brief All kernel objects share one lock and one condition variable, like the scheduler lock of a single core.
+ */
+static std::mutex _RAK3172_Host_Kernel;
+static std::condition_variable _RAK3172_Host_Changed;
+
+static const auto _RAK3172_Host_Start = std::chrono::steady_clock::now();
+
+/** @brief  Get the task object of the calling thread. Threads, which aren´t created with xTaskCreate, get an own object.
+ *  @return Pointer to the task object
+ */
+static RAK3172_Host_Task_t*& RAK3172_Host_GetTask(void)
+{
+    static thread_local RAK3172_Host_Task_t Own = {};
+    static thread_local RAK3172_Host_Task_t* p_Task = &Own;
+
+    return p_Task;
+}
+
+/** @brief              Wait for a condition of the kernel objects.
+ *  @param p_Guard      Lock of the kernel
+ *  @param Timeout      Timeout in ticks
+ *  @param Condition    Condition to wait for
+ *  @return             true when the condition is true
+ */
+template<typename Predicate>
+static bool RAK3172_Host_Wait(std::unique_lock<std::mutex>& p_Guard, TickType_t Timeout, Predicate Condition)
+{
+    if(Timeout == portMAX_DELAY)
+    {
+        _RAK3172_Host_Changed.wait(p_Guard, Condition);
+
+        return true;
+    }
+
+    return _RAK3172_Host_Changed.wait_for(p_Guard, std::chrono::milliseconds(Timeout * portTICK_PERIOD_MS), Condition);
+}
+
+/** @brief          Create a kernel object.
+ *  @param Type     Object type
+ *  @param Length   Maximum number of items or semaphore count
+ *  @param ItemSize Size of an item in bytes
+ *  @param Count    Initial semaphore count
+ *  @return         Handle of the object
+ */
+static QueueDefinition* RAK3172_Host_CreateQueue(RAK3172_Host_Queue_Type_t Type, UBaseType_t Length, UBaseType_t ItemSize, UBaseType_t Count)
+{
+    QueueDefinition* Queue = new QueueDefinition();
+
+    Queue->Type = Type;
+    Queue->Length = Length;
+    Queue->ItemSize = ItemSize;
+    Queue->Items.resize(Length * ItemSize);
+    Queue->Head = 0;
+    Queue->Waiting = 0;
+    Queue->Count = Count;
+    Queue->Set = NULL;
+    Queue->ReadyHead = 0;
+    Queue->ReadyCount = 0;
+
+    if(Type == RAK3172_HOST_SET)
+    {
+        Queue->Ready.resize(Length);
+    }
+
+    return Queue;
+}
+
+/** @brief          Post a queue, which has new data, to its queue set.
+ *  @param Queue    Queue handle
+ */
+static void RAK3172_Host_Notify(QueueDefinition* Queue)
+{
+    QueueDefinition* Set = Queue->Set;
+
+    if((Set != NULL) && (Set->ReadyCount < Set->Length))
+    {
+        Set->Ready[(Set->ReadyHead + Set->ReadyCount) % Set->Length] = Queue;
+        Set->ReadyCount++;
+    }
+
+    _RAK3172_Host_Changed.notify_all();
+}
+
+static BaseType_t RAK3172_Host_Send(QueueHandle_t Queue, const void* p_Item, TickType_t Timeout, bool Front)
+{
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+    const uint8_t* Item = static_cast<const uint8_t*>(p_Item);
+
+    UBaseType_t Index;
+
+    if(RAK3172_Host_Wait(Guard, Timeout, [Queue]() { return Queue->Waiting < Queue->Length; }) == false)
+    {
+        return pdFAIL;
+    }
+
+    if(Front)
+    {
+        Queue->Head = (Queue->Head + Queue->Length - 1) % Queue->Length;
+        Index = Queue->Head;
+    }
+    else
+    {
+        Index = (Queue->Head + Queue->Waiting) % Queue->Length;
+    }
+
+    memcpy(&Queue->Items[Index * Queue->ItemSize], Item, Queue->ItemSize);
+    Queue->Waiting++;
+
+    RAK3172_Host_Notify(Queue);
+
+    return pdPASS;
+}
+
+static BaseType_t RAK3172_Host_Receive(QueueHandle_t Queue, void* p_Item, TickType_t Timeout, bool Remove)
+{
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    if(RAK3172_Host_Wait(Guard, Timeout, [Queue]() { return Queue->Waiting > 0; }) == false)
+    {
+        return pdFAIL;
+    }
+
+    memcpy(p_Item, &Queue->Items[Queue->Head * Queue->ItemSize], Queue->ItemSize);
+    if(Remove)
+    {
+        Queue->Head = (Queue->Head + 1) % Queue->Length;
+        Queue->Waiting--;
+        _RAK3172_Host_Changed.notify_all();
+    }
+
+    return pdPASS;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t Length, UBaseType_t ItemSize)
+{
+    return RAK3172_Host_CreateQueue(RAK3172_HOST_QUEUE, Length, ItemSize, 0);
+}
+
+void vQueueDelete(QueueHandle_t Queue)
+{
+    delete Queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t Queue, const void* p_Item, TickType_t Timeout)
+{
+    return RAK3172_Host_Send(Queue, p_Item, Timeout, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t Queue, const void* p_Item, TickType_t Timeout)
+{
+    return RAK3172_Host_Send(Queue, p_Item, Timeout, true);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t Queue, void* p_Item, TickType_t Timeout)
+{
+    return RAK3172_Host_Receive(Queue, p_Item, Timeout, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t Queue, void* p_Item, TickType_t Timeout)
+{
+    return RAK3172_Host_Receive(Queue, p_Item, Timeout, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t Queue)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    Queue->Head = 0;
+    Queue->Waiting = 0;
+    _RAK3172_Host_Changed.notify_all();
+
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t Queue)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    if(Queue->Type == RAK3172_HOST_QUEUE)
+    {
+        return Queue->Waiting;
+    }
+    else if(Queue->Type == RAK3172_HOST_SET)
+    {
+        return Queue->ReadyCount;
+    }
+
+    return Queue->Count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t Queue)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    return Queue->Length - Queue->Waiting;
+}
+
+QueueSetHandle_t xQueueCreateSet(UBaseType_t Length)
+{
+    return RAK3172_Host_CreateQueue(RAK3172_HOST_SET, Length, 0, 0);
+}
+
+BaseType_t xQueueAddToSet(QueueSetMemberHandle_t Member, QueueSetHandle_t Set)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    if(Member->Set != NULL)
+    {
+        return pdFAIL;
+    }
+
+    Member->Set = Set;
+
+    return pdPASS;
+}
+
+BaseType_t xQueueRemoveFromSet(QueueSetMemberHandle_t Member, QueueSetHandle_t Set)
+{
+    UBaseType_t Count;
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    if(Member->Set != Set)
+    {
+        return pdFAIL;
+    }
+
+    Member->Set = NULL;
+
+    // Remove all entries of the member and keep the order of the other members.
+    Count = 0;
+    for(UBaseType_t i = 0; i < Set->ReadyCount; i++)
+    {
+        QueueDefinition* Ready = Set->Ready[(Set->ReadyHead + i) % Set->Length];
+
+        if(Ready != Member)
+        {
+            Set->Ready[(Set->ReadyHead + Count) % Set->Length] = Ready;
+            Count++;
+        }
+    }
+    Set->ReadyCount = Count;
+
+    return pdPASS;
+}
+
+QueueSetMemberHandle_t xQueueSelectFromSet(QueueSetHandle_t Set, TickType_t Timeout)
+{
+    bool isReady;
+    QueueSetMemberHandle_t Member;
+    RAK3172_Host_Task_t* Task = RAK3172_Host_GetTask();
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    // A thread can´t be stopped from the outside, so a suspended task is stopped at its next wait for a queue set. This is the idle
+    // point of the receive tasks, so a suspended task never holds a lock. The timeout expires, but the task doesn´t run until it is resumed.
+    isReady = RAK3172_Host_Wait(Guard, Timeout, [Set, Task]() { return (Task->isSuspended == false) && (Set->ReadyCount > 0); });
+    _RAK3172_Host_Changed.wait(Guard, [Task]() { return Task->isSuspended == false; });
+
+    if((isReady == false) && (Set->ReadyCount == 0))
+    {
+        return NULL;
+    }
+
+    Member = Set->Ready[Set->ReadyHead];
+    Set->ReadyHead = (Set->ReadyHead + 1) % Set->Length;
+    Set->ReadyCount--;
+
+    return Member;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return RAK3172_Host_CreateQueue(RAK3172_HOST_MUTEX, 1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* p_Buffer)
+{
+    return xSemaphoreCreateMutex();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return RAK3172_Host_CreateQueue(RAK3172_HOST_BINARY, 1, 0, 0);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t Semaphore, TickType_t Timeout)
+{
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    if(RAK3172_Host_Wait(Guard, Timeout, [Semaphore]() { return Semaphore->Count > 0; }) == false)
+    {
+        return pdFALSE;
+    }
+
+    Semaphore->Count--;
+
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t Semaphore)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    if(Semaphore->Count >= Semaphore->Length)
+    {
+        return pdFALSE;
+    }
+
+    Semaphore->Count++;
+    RAK3172_Host_Notify(Semaphore);
+
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t Semaphore)
+{
+    delete Semaphore;
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return new EventGroupDef_t();
+}
+
+void vEventGroupDelete(EventGroupHandle_t Group)
+{
+    delete Group;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t Group, EventBits_t Bits)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    Group->Bits |= Bits;
+    _RAK3172_Host_Changed.notify_all();
+
+    return Group->Bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t Group, EventBits_t Bits)
+{
+    EventBits_t Previous;
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    Previous = Group->Bits;
+    Group->Bits &= ~Bits;
+
+    return Previous;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t Group)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    return Group->Bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t Group, EventBits_t Bits, BaseType_t Clear, BaseType_t All, TickType_t Timeout)
+{
+    EventBits_t Value;
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    auto Condition = [Group, Bits, All]() {
+        return All ? ((Group->Bits & Bits) == Bits) : ((Group->Bits & Bits) != 0);
+    };
+
+    // Like FreeRTOS, the bits are only cleared when the condition was met.
+    if(RAK3172_Host_Wait(Guard, Timeout, Condition) && Clear)
+    {
+        Value = Group->Bits;
+        Group->Bits &= ~Bits;
+
+        return Value;
+    }
+
+    Value = Group->Bits;
+
+    return Value;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t Function, const char* p_Name, uint32_t Stack, void* p_Arg, UBaseType_t Priority, TaskHandle_t* p_Handle)
+{
+    RAK3172_Host_Task_t* Task = new RAK3172_Host_Task_t();
+
+    Task->Function = Function;
+    Task->p_Arg = p_Arg;
+
+    if(p_Handle != NULL)
+    {
+        *p_Handle = Task;
+    }
+
+    // The task objects are never freed, because a handle can still be used after the task has left its thread.
+    std::thread([Task]() {
+        RAK3172_Host_GetTask() = Task;
+
+        try
+        {
+            Task->Function(Task->p_Arg);
+        }
+        catch(const RAK3172_Host_TaskExit_t&)
+        {
+        }
+    }).detach();
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t Function, const char* p_Name, uint32_t Stack, void* p_Arg, UBaseType_t Priority, TaskHandle_t* p_Handle, BaseType_t Core)
+{
+    return xTaskCreate(Function, p_Name, Stack, p_Arg, Priority, p_Handle);
+}
+
+void vTaskDelete(TaskHandle_t Handle)
+{
+    // A thread can´t be stopped from the outside, so only a task that deletes itself leaves its thread.
+    if((Handle == NULL) || (Handle == RAK3172_Host_GetTask()))
+    {
+        throw RAK3172_Host_TaskExit_t();
+    }
+}
+
+void vTaskSuspend(TaskHandle_t Handle)
+{
+    RAK3172_Host_Task_t* Task = (Handle == NULL) ? RAK3172_Host_GetTask() : static_cast<RAK3172_Host_Task_t*>(Handle);
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    Task->isSuspended = true;
+    _RAK3172_Host_Changed.notify_all();
+
+    // Another task is stopped at its next wait for a kernel object.
+    if(Task == RAK3172_Host_GetTask())
+    {
+        _RAK3172_Host_Changed.wait(Guard, [Task]() { return Task->isSuspended == false; });
+    }
+}
+
+void vTaskResume(TaskHandle_t Handle)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    static_cast<RAK3172_Host_Task_t*>(Handle)->isSuspended = false;
+    _RAK3172_Host_Changed.notify_all();
+}
+
+void vTaskDelay(TickType_t Ticks)
+{
+    if(Ticks == 0)
+    {
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(Ticks * portTICK_PERIOD_MS));
+    }
+}
+
+void taskYIELD(void)
+{
+    std::this_thread::yield();
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return static_cast<TickType_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _RAK3172_Host_Start).count());
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return RAK3172_Host_GetTask();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t Handle)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    static_cast<RAK3172_Host_Task_t*>(Handle)->Value++;
+    _RAK3172_Host_Changed.notify_all();
+
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t Clear, TickType_t Timeout)
+{
+    uint32_t Value;
+    RAK3172_Host_Task_t* Task = RAK3172_Host_GetTask();
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_Kernel);
+
+    RAK3172_Host_Wait(Guard, Timeout, [Task]() { return Task->Value > 0; });
+
+    Value = Task->Value;
+    if(Value > 0)
+    {
+        Task->Value = Clear ? 0 : (Value - 1);
+    }
+
+    return Value;
+}
@@ -0,0 +1,61 @@
+ /*
+ * rak3172_host.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: ESP-IDF stubs for the host tests of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <chrono>
+
+#include <esp_timer.h>
+#include <esp_rom_crc.h>
+#include <driver/gpio.h>
+
+static const auto _RAK3172_Host_Start = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time(void)
+{
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _RAK3172_Host_Start).count());
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const* buf, uint32_t len)
+{
+    crc = ~crc;
+    for(uint32_t i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        for(uint8_t Bit = 0; Bit < 8; Bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 0x01)));
+        }
+    }
+
+    return ~crc;
+}
+
+esp_err_t gpio_config(const gpio_config_t* p_Config)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t Pin, uint32_t Level)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t Pin)
+{
+    return ESP_OK;
+}
@@ -0,0 +1,61 @@
+ /*
+ * rak3172_host.h
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Access to the simulated UART interfaces of the host tests.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#ifndef RAK3172_HOST_H_
+#define RAK3172_HOST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <driver/uart.h>
+
+/** @brief Number of simulated UART interfaces.
+ */
+#define RAK3172_HOST_UART_COUNT                                 3
+
+/** @brief          Receive handler of the remote side of a simulated UART interface.
+ *                  NOTE: Called from the task, which writes to the interface!
+ *  @param Port     UART interface
+ *  @param p_Data   Pointer to the data written by the driver
+ *  @param Length   Length of the data
+ *  @param p_Arg    Argument of the handler
+ */
+typedef void (*RAK3172_Host_UART_Handler_t)(uart_port_t Port, const uint8_t* p_Data, size_t Length, void* p_Arg);
+
+/** @brief          Attach the remote side to a simulated UART interface.
+ *  @param Port     UART interface
+ *  @param Handler  Receive handler or NULL to detach the remote side
+ *  @param p_Arg    Argument of the handler
+ */
+void RAK3172_Host_UART_Attach(uart_port_t Port, RAK3172_Host_UART_Handler_t Handler, void* p_Arg);
+
+/** @brief          Transmit data from the remote side to the driver. Each line feed creates a pattern event.
+ *  @param Port     UART interface
+ *  @param p_Data   Pointer to data
+ *  @param Length   Length of the data
+ */
+void RAK3172_Host_UART_Inject(uart_port_t Port, const void* p_Data, size_t Length);
+
+/** @brief      Get the current baud rate of a simulated UART interface.
+ *  @param Port UART interface
+ *  @return     Baud rate
+ */
+uint32_t RAK3172_Host_UART_GetBaudrate(uart_port_t Port);
+
+#endif /* RAK3172_HOST_H_ */
@@ -0,0 +1,339 @@
+ /*
+ * rak3172_uart.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Simulated UART driver for the host tests of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+#include <driver/uart.h>
+
+#include "rak3172_host.h"
+
+/** @brief State of a simulated UART interface. The pattern positions are offsets in the received data stream. The ESP-IDF driver
+ *         returns them relative to the current read position. The buffers are allocated during the installation of the driver.
+ */
+typedef struct
+{
+    bool isInstalled;
+    uint32_t Baudrate;
+    QueueHandle_t EventQueue;
+    std::vector<uint8_t> Rx;
+    size_t RxHead;
+    size_t RxCount;
+    std::vector<uint64_t> Patterns;
+    size_t PatternHead;
+    size_t PatternCount;
+    uint64_t Read;
+    uint64_t Received;
+    RAK3172_Host_UART_Handler_t Handler;
+    void* p_Arg;
+} RAK3172_Host_UART_t;
+
+static std::mutex _RAK3172_Host_UART_Lock;
+static std::condition_variable _RAK3172_Host_UART_Changed;
+static RAK3172_Host_UART_t _RAK3172_Host_UART[RAK3172_HOST_UART_COUNT];
+
+/** @brief      Remove all received data and pattern positions of an interface.
+ *              NOTE: The lock must be held!
+ *  @param UART Pointer to interface
+ */
+static void RAK3172_Host_UART_Clear(RAK3172_Host_UART_t* UART)
+{
+    UART->Read += UART->RxCount;
+    UART->RxHead = 0;
+    UART->RxCount = 0;
+    UART->PatternHead = 0;
+    UART->PatternCount = 0;
+}
+
+/** @brief      Remove the pattern positions of the data, which was already read. The ESP-IDF driver drops them during the read.
+ *              NOTE: The lock must be held!
+ *  @param UART Pointer to interface
+ */
+static void RAK3172_Host_UART_DropPatterns(RAK3172_Host_UART_t* UART)
+{
+    while((UART->PatternCount > 0) && (UART->Patterns[UART->PatternHead] < UART->Read))
+    {
+        UART->PatternHead = (UART->PatternHead + 1) % UART->Patterns.size();
+        UART->PatternCount--;
+    }
+}
+
+void RAK3172_Host_UART_Attach(uart_port_t Port, RAK3172_Host_UART_Handler_t Handler, void* p_Arg)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    _RAK3172_Host_UART[Port].Handler = Handler;
+    _RAK3172_Host_UART[Port].p_Arg = p_Arg;
+}
+
+void RAK3172_Host_UART_Inject(uart_port_t Port, const void* p_Data, size_t Length)
+{
+    const uint8_t* Data = static_cast<const uint8_t*>(p_Data);
+    RAK3172_Host_UART_t* UART = &_RAK3172_Host_UART[Port];
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    if(UART->isInstalled == false)
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < Length; i++)
+    {
+        uart_event_t Event = {};
+
+        // Like the ESP-IDF driver, characters are lost when the buffer is full.
+        if(UART->RxCount == UART->Rx.size())
+        {
+            Event.type = UART_BUFFER_FULL;
+            xQueueSend(UART->EventQueue, &Event, 0);
+
+            break;
+        }
+
+        UART->Rx[(UART->RxHead + UART->RxCount) % UART->Rx.size()] = Data[i];
+        UART->RxCount++;
+        UART->Received++;
+
+        if(Data[i] != '\n')
+        {
+            continue;
+        }
+
+        // A pattern is lost when the pattern queue or the event queue is full.
+        if(UART->PatternCount < UART->Patterns.size())
+        {
+            UART->Patterns[(UART->PatternHead + UART->PatternCount) % UART->Patterns.size()] = UART->Received - 1;
+            UART->PatternCount++;
+
+            Event.type = UART_PATTERN_DET;
+            xQueueSend(UART->EventQueue, &Event, 0);
+        }
+    }
+
+    Guard.unlock();
+    _RAK3172_Host_UART_Changed.notify_all();
+}
+
+uint32_t RAK3172_Host_UART_GetBaudrate(uart_port_t Port)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    return _RAK3172_Host_UART[Port].Baudrate;
+}
+
+esp_err_t uart_driver_install(uart_port_t Port, int RxSize, int TxSize, int QueueLength, QueueHandle_t* p_Queue, int Flags)
+{
+    RAK3172_Host_UART_t* UART = &_RAK3172_Host_UART[Port];
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    if(UART->isInstalled)
+    {
+        return ESP_FAIL;
+    }
+
+    UART->EventQueue = xQueueCreate(QueueLength, sizeof(uart_event_t));
+    UART->Rx.assign(RxSize, 0);
+    UART->Patterns.clear();
+    RAK3172_Host_UART_Clear(UART);
+    UART->isInstalled = true;
+
+    if(p_Queue != NULL)
+    {
+        *p_Queue = UART->EventQueue;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t Port)
+{
+    RAK3172_Host_UART_t* UART = &_RAK3172_Host_UART[Port];
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    if(UART->isInstalled == false)
+    {
+        return ESP_FAIL;
+    }
+
+    vQueueDelete(UART->EventQueue);
+    UART->EventQueue = NULL;
+    RAK3172_Host_UART_Clear(UART);
+    UART->isInstalled = false;
+
+    return ESP_OK;
+}
+
+bool uart_is_driver_installed(uart_port_t Port)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    return _RAK3172_Host_UART[Port].isInstalled;
+}
+
+esp_err_t uart_param_config(uart_port_t Port, const uart_config_t* p_Config)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    _RAK3172_Host_UART[Port].Baudrate = p_Config->baud_rate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t Port, int Tx, int Rx, int RTS, int CTS)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_enable_pattern_det_baud_intr(uart_port_t Port, char Pattern, uint8_t Count, int Timeout, int PostIdle, int PreIdle)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_disable_pattern_det_intr(uart_port_t Port)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_pattern_queue_reset(uart_port_t Port, int QueueLength)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    _RAK3172_Host_UART[Port].Patterns.assign(QueueLength, 0);
+    _RAK3172_Host_UART[Port].PatternHead = 0;
+    _RAK3172_Host_UART[Port].PatternCount = 0;
+
+    return ESP_OK;
+}
+
+int uart_pattern_pop_pos(uart_port_t Port)
+{
+    uint64_t Position;
+    RAK3172_Host_UART_t* UART = &_RAK3172_Host_UART[Port];
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    RAK3172_Host_UART_DropPatterns(UART);
+
+    if(UART->PatternCount == 0)
+    {
+        return -1;
+    }
+
+    Position = UART->Patterns[UART->PatternHead];
+    UART->PatternHead = (UART->PatternHead + 1) % UART->Patterns.size();
+    UART->PatternCount--;
+
+    return static_cast<int>(Position - UART->Read);
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t Port, size_t* p_Size)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    *p_Size = _RAK3172_Host_UART[Port].RxCount;
+
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t Port, void* p_Buffer, uint32_t Length, TickType_t Timeout)
+{
+    uint32_t Bytes;
+    uint8_t* Buffer = static_cast<uint8_t*>(p_Buffer);
+    RAK3172_Host_UART_t* UART = &_RAK3172_Host_UART[Port];
+    std::unique_lock<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    _RAK3172_Host_UART_Changed.wait_for(Guard, std::chrono::milliseconds(Timeout * portTICK_PERIOD_MS), [UART, Length]() {
+        return UART->RxCount >= Length;
+    });
+
+    Bytes = std::min(static_cast<uint32_t>(UART->RxCount), Length);
+    for(uint32_t i = 0; i < Bytes; i++)
+    {
+        Buffer[i] = UART->Rx[UART->RxHead];
+        UART->RxHead = (UART->RxHead + 1) % UART->Rx.size();
+    }
+    UART->RxCount -= Bytes;
+    UART->Read += Bytes;
+
+    return static_cast<int>(Bytes);
+}
+
+int uart_write_bytes(uart_port_t Port, const void* p_Data, size_t Length)
+{
+    void* p_Arg;
+    RAK3172_Host_UART_Handler_t Handler;
+
+    {
+        std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+        Handler = _RAK3172_Host_UART[Port].Handler;
+        p_Arg = _RAK3172_Host_UART[Port].p_Arg;
+    }
+
+    if(Handler != NULL)
+    {
+        Handler(Port, static_cast<const uint8_t*>(p_Data), Length, p_Arg);
+    }
+
+    return static_cast<int>(Length);
+}
+
+esp_err_t uart_flush(uart_port_t Port)
+{
+    return uart_flush_input(Port);
+}
+
+esp_err_t uart_flush_input(uart_port_t Port)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    RAK3172_Host_UART_Clear(&_RAK3172_Host_UART[Port]);
+
+    return ESP_OK;
+}
+
+esp_err_t uart_set_baudrate(uart_port_t Port, uint32_t Baudrate)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    _RAK3172_Host_UART[Port].Baudrate = Baudrate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_get_baudrate(uart_port_t Port, uint32_t* p_Baudrate)
+{
+    std::lock_guard<std::mutex> Guard(_RAK3172_Host_UART_Lock);
+
+    *p_Baudrate = _RAK3172_Host_UART[Port].Baudrate;
+
+    return ESP_OK;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t Port, TickType_t Timeout)
+{
+    return ESP_OK;
+}
+
+esp_err_t uart_set_wakeup_threshold(uart_port_t Port, int Threshold)
+{
+    return ESP_OK;
+}
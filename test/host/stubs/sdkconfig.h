@@ -0,0 +1,26 @@
+#pragma once
+#ifndef RAK3172_HOST_LEGACY
+#define CONFIG_RAK3172_USE_RUI3 1
+#else
+#define CONFIG_RAK3172_RX_PAYLOAD_STRING 1
+#endif
+#define CONFIG_RAK3172_FACTORY_RESET 1
+#define CONFIG_RAK3172_SLEEP_WAKE_TIME 50
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_CLASS_B 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_MULTICAST 1
+#define CONFIG_RAK3172_MODE_WITH_LORAWAN_DUTY 1
+#define CONFIG_RAK3172_MODE_WITH_P2P 1
+#define CONFIG_RAK3172_MODE_WITH_UPDATE 1
+#define CONFIG_RAK3172_UART_AUTO_BAUD 1
+#define CONFIG_RAK3172_UART_AUTO_BAUD_SWITCH 1
+#define CONFIG_RAK3172_UART_BUFFER_SIZE 512
+#define CONFIG_RAK3172_UART_QUEUE_LENGTH 8
+#define CONFIG_RAK3172_COMMAND_QUEUE_LENGTH 4
+#define CONFIG_RAK3172_UPLINK_QUEUE_LENGTH 4
+#define CONFIG_RAK3172_RX_QUEUE_LENGTH 8
+#define CONFIG_RAK3172_TASK_PRIO 12
+#define CONFIG_RAK3172_TASK_BUFFER_SIZE 1024
+#define CONFIG_RAK3172_TASK_STACK_SIZE 4096
+#define CONFIG_RAK3172_MISC_ERROR_BASE 0xA000
+#define CONFIG_RAK3172_MISC_ENABLE_LOG 1
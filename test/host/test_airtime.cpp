@@ -0,0 +1,132 @@
+ /*
+ * test_airtime.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the LoRa and LoRaWAN airtime calculation and the duty cycle ledger.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+static void Test_Airtime_LoRa(void)
+{
+    uint32_t Airtime;
+
+    // 10 bytes with 125 kHz, 4/5 coding rate and 8 preamble symbols.
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(7, 125000, 1, 8, 10, &Airtime) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Airtime == 41216);
+
+    // SF12 uses the low data rate optimization.
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(12, 125000, 1, 8, 10, &Airtime) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Airtime == 991232);
+
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(7, 250000, 1, 8, 10, &Airtime) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Airtime == 20608);
+}
+
+static void Test_Airtime_LoRaWAN(void)
+{
+    uint32_t Airtime;
+
+    // 10 bytes application payload and 13 bytes LoRaWAN overhead with SF7 and SF12.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetAirtime(RAK_BAND_EU868, RAK_DR_5, 10, &Airtime) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Airtime == 61696);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetAirtime(RAK_BAND_EU868, RAK_DR_0, 10, &Airtime) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Airtime == 1482752);
+}
+
+static void Test_Airtime_Invalid(void)
+{
+    uint32_t Airtime;
+
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(4, 125000, 1, 8, 10, &Airtime) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(13, 125000, 1, 8, 10, &Airtime) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(7, 0, 1, 8, 10, &Airtime) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(7, 125000, 0, 8, 10, &Airtime) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(7, 125000, 5, 8, 10, &Airtime) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(7, 125000, 1, 8, 10, NULL) == RAK3172_ERR_INVALID_ARG);
+}
+
+static void Test_Airtime_Monotonic(void)
+{
+    uint32_t Previous;
+    uint32_t Airtime;
+
+    // The airtime never decreases with a longer payload or a higher spreading factor.
+    for(uint8_t SF = 5; SF <= 12; SF++)
+    {
+        Previous = 0;
+        for(uint16_t Length = 0; Length <= 222; Length++)
+        {
+            RAK3172_TEST_CHECK(RAK3172_LoRa_GetAirtime(SF, 125000, 1, 8, Length, &Airtime) == RAK3172_ERR_OK);
+            RAK3172_TEST_CHECK(Airtime >= Previous);
+            Previous = Airtime;
+        }
+    }
+}
+
+static void Test_Airtime_Duty(void)
+{
+    uint32_t Delay;
+    uint32_t Airtime;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Device.LoRaWAN.UplinkLock = xSemaphoreCreateMutex();
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 10, &Delay) == RAK3172_ERR_INVALID_STATE);
+
+    // The host stub reports DR0, so each 10 byte uplink uses 1482.752 ms of the 36 s budget of the 1 % sub band.
+    Device.LoRaWAN.Config.Band = RAK_BAND_EU868;
+    Device.LoRaWAN.Config.Valid |= RAK_LORAWAN_CFG_BAND;
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetAirtime(Device, 10, &Airtime) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Airtime == 1482752);
+
+    for(uint8_t i = 0; i < 24; i++)
+    {
+        RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 10, &Delay) == RAK3172_ERR_OK);
+        RAK3172_TEST_CHECK(Delay == 0);
+        RAK3172_LoRaWAN_Duty_Record(Device, Airtime);
+    }
+
+    // The 25th uplink must wait until the slots with the recorded uplinks have expired.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 10, &Delay) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK((Delay > 0) && (Delay <= 3600000));
+
+    // Other sub bands have their own budget. Frequencies outside of a regulated sub band are never delayed.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 10, &Delay, 869500000) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Delay == 0);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 10, &Delay, 869300000) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Delay == 0);
+
+    // An uplink, which exceeds the budget of a whole hour in the 0.1 % sub band, can never be transmitted.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 242, &Delay, 864000000) == RAK3172_ERR_INVALID_ARG);
+
+    RAK3172_LoRaWAN_Duty_Reset(Device);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Duty_GetNext(Device, 10, &Delay) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Delay == 0);
+
+    vSemaphoreDelete(Device.LoRaWAN.UplinkLock);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Airtime_LoRa);
+    RAK3172_TEST_RUN(Test_Airtime_LoRaWAN);
+    RAK3172_TEST_RUN(Test_Airtime_Invalid);
+    RAK3172_TEST_RUN(Test_Airtime_Monotonic);
+    RAK3172_TEST_RUN(Test_Airtime_Duty);
+
+    return RAK3172_TEST_RESULT();
+}
@@ -0,0 +1,193 @@
+ /*
+ * test_baud.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the baud rate detection of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+/** @brief Baud rate, which isn´t supported by the driver.
+ */
+#define TEST_BAUD_UNSUPPORTED               1200
+
+/** @brief                  Initialize the driver with a module, which uses another baud rate.
+ *  @param p_Sim            Pointer to simulator
+ *  @param p_Device         RAK3172 device object
+ *  @param Baudrate         Baud rate of the module
+ *  @param isNoisy          #true when the module responds with invalid characters to a wrong baud rate
+ *  @return                 Result of the initialization
+ */
+static RAK3172_Error_t Test_Baud_Init(RAK3172_Sim_t* p_Sim, RAK3172_t& p_Device, uint32_t Baudrate, bool isNoisy)
+{
+    RAK3172_Sim_Start(p_Sim, UART_NUM_1, Baudrate);
+
+    {
+        std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+        p_Sim->isNoisy = isNoisy;
+    }
+
+    return RAK3172_Init(p_Device);
+}
+
+/** @brief              Check the baud rates of the probes.
+ *  @param p_Sim        Pointer to simulator
+ *  @param Expected     Baud rates of the probes in the order of the detection
+ */
+static void Test_Baud_CheckProbes(RAK3172_Sim_t* p_Sim, const std::vector<uint32_t>& Expected)
+{
+    std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+    RAK3172_TEST_CHECK(p_Sim->Baudrates.size() >= Expected.size());
+    if(p_Sim->Baudrates.size() < Expected.size())
+    {
+        return;
+    }
+
+    RAK3172_TEST_CHECK(std::equal(Expected.begin(), Expected.end(), p_Sim->Baudrates.begin()));
+}
+
+/** @brief          Check that the module received a command.
+ *  @param p_Sim    Pointer to simulator
+ *  @param Command  Command
+ *  @return         #true when the command was received
+ */
+static bool Test_Baud_isReceived(RAK3172_Sim_t* p_Sim, const std::string& Command)
+{
+    std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+    return std::find(p_Sim->Received.begin(), p_Sim->Received.end(), Command) != p_Sim->Received.end();
+}
+
+static void Test_Baud_Configured(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    // The configured baud rate is probed first, so a matching module is found with one probe.
+    RAK3172_TEST_CHECK(Test_Baud_Init(&Sim, Device, RAK_BAUD_9600, false) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Test_Baud_isReceived(&Sim, "AT+BAUD=9600") == false);
+
+    {
+        std::lock_guard<std::mutex> Guard(Sim.Lock);
+
+        RAK3172_TEST_CHECK(std::count(Sim.Baudrates.begin(), Sim.Baudrates.end(), RAK_BAUD_9600) == static_cast<long>(Sim.Baudrates.size()));
+        RAK3172_TEST_CHECK(Sim.Received.front() == "AT");
+    }
+
+    RAK3172_TEST_CHECK(Device.UART.Baudrate == RAK_BAUD_9600);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_Baud_Order(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    // A silent module is probed twice with each baud rate, because the first probe may only wake up the module.
+    RAK3172_TEST_CHECK(Test_Baud_Init(&Sim, Device, RAK_BAUD_38400, false) == RAK3172_ERR_OK);
+    Test_Baud_CheckProbes(&Sim, {RAK_BAUD_9600, RAK_BAUD_9600, RAK_BAUD_115200, RAK_BAUD_115200, RAK_BAUD_57600, RAK_BAUD_57600,
+                                 RAK_BAUD_38400});
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_Baud_Noise(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    // Invalid characters show a wrong baud rate, so the next baud rate is probed without a second probe.
+    RAK3172_TEST_CHECK(Test_Baud_Init(&Sim, Device, RAK_BAUD_19200, true) == RAK3172_ERR_OK);
+    Test_Baud_CheckProbes(&Sim, {RAK_BAUD_9600, RAK_BAUD_115200, RAK_BAUD_57600, RAK_BAUD_38400, RAK_BAUD_19200});
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_Baud_Switch(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    // The module is switched from the detected baud rate to the configured baud rate after the reset.
+    RAK3172_TEST_CHECK(Test_Baud_Init(&Sim, Device, RAK_BAUD_57600, true) == RAK3172_ERR_OK);
+    Test_Baud_CheckProbes(&Sim, {RAK_BAUD_9600, RAK_BAUD_115200, RAK_BAUD_57600});
+    RAK3172_TEST_CHECK(Test_Baud_isReceived(&Sim, "AT+BAUD=9600"));
+    RAK3172_TEST_CHECK(Device.UART.Baudrate == RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_1) == RAK_BAUD_9600);
+
+    {
+        std::lock_guard<std::mutex> Guard(Sim.Lock);
+
+        RAK3172_TEST_CHECK(Sim.Baudrate == RAK_BAUD_9600);
+    }
+
+    RAK3172_TEST_CHECK(RAK3172_SendCommand(Device, "AT") == RAK3172_ERR_OK);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_Baud_Fallback(void)
+{
+    RAK3172_Sim_t Sim;
+    std::vector<uint32_t> Expected;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    // All supported baud rates are probed and the configured baud rate is restored.
+    RAK3172_TEST_CHECK(Test_Baud_Init(&Sim, Device, TEST_BAUD_UNSUPPORTED, false) == RAK3172_ERR_TIMEOUT);
+    for(uint32_t Baudrate : {RAK_BAUD_9600, RAK_BAUD_115200, RAK_BAUD_57600, RAK_BAUD_38400, RAK_BAUD_19200, RAK_BAUD_4800})
+    {
+        Expected.push_back(Baudrate);
+        Expected.push_back(Baudrate);
+    }
+
+    Test_Baud_CheckProbes(&Sim, Expected);
+    RAK3172_TEST_CHECK(Device.UART.Baudrate == RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_1) == RAK_BAUD_9600);
+
+    {
+        std::lock_guard<std::mutex> Guard(Sim.Lock);
+
+        RAK3172_TEST_CHECK(Sim.Baudrates.size() == Expected.size());
+        RAK3172_TEST_CHECK(Sim.Received.empty());
+    }
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Baud_Configured);
+    RAK3172_TEST_RUN(Test_Baud_Order);
+    RAK3172_TEST_RUN(Test_Baud_Noise);
+    RAK3172_TEST_RUN(Test_Baud_Switch);
+    RAK3172_TEST_RUN(Test_Baud_Fallback);
+
+    return RAK3172_TEST_RESULT();
+}
@@ -0,0 +1,130 @@
+ /*
+ * test_burst.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the burst mode of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <atomic>
+
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+/** @brief Response delay of the slow module in milliseconds.
+ */
+#define TEST_BURST_DELAY                    300
+
+static void Test_Burst_NotInitialized(void)
+{
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_TEST_CHECK(RAK3172_BeginBurst(Device) == RAK3172_ERR_INVALID_STATE);
+    RAK3172_TEST_CHECK(RAK3172_EndBurst(Device) == RAK3172_ERR_INVALID_STATE);
+}
+
+static void Test_Burst_Nesting(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+
+    RAK3172_TEST_CHECK(RAK3172_BeginBurst(Device) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_1) == RAK_BAUD_115200);
+    RAK3172_TEST_CHECK(RAK3172_BeginBurst(Device) == RAK3172_ERR_OK);
+
+    // Only the outermost burst restores the baud rate.
+    RAK3172_TEST_CHECK(RAK3172_EndBurst(Device) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_1) == RAK_BAUD_115200);
+    RAK3172_TEST_CHECK(RAK3172_EndBurst(Device) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_1) == RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(Device.UART.Baudrate == RAK_BAUD_9600);
+
+    RAK3172_TEST_CHECK(RAK3172_EndBurst(Device) == RAK3172_ERR_INVALID_STATE);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_Burst_Devices(void)
+{
+    uint64_t Start;
+    uint64_t Duration;
+    RAK3172_Sim_t Slow;
+    RAK3172_Sim_t Fast;
+    std::thread Task;
+    std::atomic<bool> isSlowDone(false);
+    RAK3172_Error_t SlowError = RAK3172_ERR_FAIL;
+    RAK3172_t SlowDevice = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+    RAK3172_t FastDevice = RAK3172_DEFAULT_CONFIG(UART_NUM_2, 18, 19, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Slow, UART_NUM_1, RAK_BAUD_9600);
+    RAK3172_Sim_Start(&Fast, UART_NUM_2, RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Init(SlowDevice) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_Init(FastDevice) == RAK3172_ERR_OK);
+
+    {
+        std::lock_guard<std::mutex> Guard(Slow.Lock);
+
+        Slow.Delay = TEST_BURST_DELAY;
+    }
+
+    Task = std::thread([&]() {
+        SlowError = RAK3172_BeginBurst(SlowDevice);
+        isSlowDone = true;
+    });
+
+    // Wait until the slow device changes the baud rate.
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_BURST_DELAY / 4));
+
+    // The baud rate change of the slow device doesn´t block the burst of the other device.
+    Start = RAK3172_Test_Now();
+    RAK3172_TEST_CHECK(RAK3172_BeginBurst(FastDevice) == RAK3172_ERR_OK);
+    Duration = (RAK3172_Test_Now() - Start) / 1000000ULL;
+    RAK3172_TEST_CHECK(Duration < TEST_BURST_DELAY);
+    RAK3172_TEST_CHECK(isSlowDone == false);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_2) == RAK_BAUD_115200);
+
+    Task.join();
+    RAK3172_TEST_CHECK(SlowError == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_Host_UART_GetBaudrate(UART_NUM_1) == RAK_BAUD_115200);
+
+    {
+        std::lock_guard<std::mutex> Guard(Slow.Lock);
+
+        Slow.Delay = 0;
+    }
+
+    RAK3172_TEST_CHECK(RAK3172_EndBurst(SlowDevice) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_EndBurst(FastDevice) == RAK3172_ERR_OK);
+
+    RAK3172_Deinit(SlowDevice);
+    RAK3172_Deinit(FastDevice);
+    RAK3172_Sim_Stop(&Slow);
+    RAK3172_Sim_Stop(&Fast);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Burst_NotInitialized);
+    RAK3172_TEST_RUN(Test_Burst_Nesting);
+    RAK3172_TEST_RUN(Test_Burst_Devices);
+
+    return RAK3172_TEST_RESULT();
+}
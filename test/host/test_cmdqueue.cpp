@@ -0,0 +1,181 @@
+ /*
+ * test_cmdqueue.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the AT command queue of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+#include "../../src/Core/rak3172_cmdqueue.h"
+
+/** @brief Number of commands of the throughput benchmark.
+ */
+#define TEST_CMDQUEUE_COMMANDS              16
+
+/** @brief Response delay of the simulated module in milliseconds for the throughput benchmark.
+ */
+#define TEST_CMDQUEUE_DELAY                 5
+
+/** @brief Maximum time in milliseconds until a command without response is completed.
+ */
+#define TEST_CMDQUEUE_TIMEOUT_LIMIT         (2 * RAK3172_DEFAULT_WAIT_TIMEOUT)
+
+/** @brief          Command handler of the simulator. The module doesn´t respond to the "AT+NJS=?" command.
+ *  @param p_Sim    Pointer to simulator
+ *  @param Command  Received command
+ *  @return         #true when the command was handled
+ */
+static bool Test_CmdQueue_Swallow(RAK3172_Sim_t* p_Sim, const std::string& Command)
+{
+    return Command == "AT+NJS=?";
+}
+
+/** @brief          Transmit a command and measure the time until the command is completed.
+ *  @param p_Device RAK3172 device object
+ *  @param p_Error  Pointer to result of the command
+ *  @return         Duration in milliseconds
+ */
+static uint64_t Test_CmdQueue_Measure(RAK3172_t& p_Device, RAK3172_Error_t* p_Error)
+{
+    uint64_t Start;
+    std::string Value;
+
+    Start = RAK3172_Test_Now();
+    *p_Error = RAK3172_SendCommand(p_Device, "AT+NJS=?", &Value);
+
+    return (RAK3172_Test_Now() - Start) / 1000000ULL;
+}
+
+static void Test_CmdQueue_NoResponse(void)
+{
+    uint64_t Duration;
+    RAK3172_Sim_t Sim;
+    RAK3172_Error_t Error;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+
+    Sim.Handler = Test_CmdQueue_Swallow;
+
+    Duration = Test_CmdQueue_Measure(Device, &Error);
+    RAK3172_TEST_CHECK(Error == RAK3172_ERR_TIMEOUT);
+    RAK3172_TEST_CHECK(Duration < TEST_CMDQUEUE_TIMEOUT_LIMIT);
+
+    // The queue is usable after the timeout.
+    RAK3172_TEST_CHECK(RAK3172_SendCommand(Device, "AT") == RAK3172_ERR_OK);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_CmdQueue_Suspended(void)
+{
+    uint64_t Duration;
+    RAK3172_Sim_t Sim;
+    RAK3172_Error_t Error;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+
+    Sim.Handler = Test_CmdQueue_Swallow;
+
+    // The receive task doesn´t check the response timeouts while it is suspended (i. e. during a firmware update), so the caller must
+    // expire the request.
+    vTaskSuspend(Device.Internal.Handle);
+    Duration = Test_CmdQueue_Measure(Device, &Error);
+    vTaskResume(Device.Internal.Handle);
+
+    RAK3172_TEST_CHECK(Error == RAK3172_ERR_TIMEOUT);
+    RAK3172_TEST_CHECK(Duration < TEST_CMDQUEUE_TIMEOUT_LIMIT);
+
+    RAK3172_Sim_Flush(&Sim);
+    RAK3172_TEST_CHECK(RAK3172_SendCommand(Device, "AT") == RAK3172_ERR_OK);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_CmdQueue_Benchmark(void)
+{
+    uint64_t Start;
+    uint64_t Sequential;
+    uint64_t Pipelined;
+    RAK3172_Sim_t Sim;
+    RAK3172_Batch_t Batch;
+    std::string Values[TEST_CMDQUEUE_COMMANDS];
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+
+    {
+        std::lock_guard<std::mutex> Guard(Sim.Lock);
+
+        Sim.Delay = TEST_CMDQUEUE_DELAY;
+    }
+
+    Start = RAK3172_Test_Now();
+    for(uint8_t i = 0; i < TEST_CMDQUEUE_COMMANDS; i++)
+    {
+        RAK3172_TEST_CHECK(RAK3172_SendCommand(Device, "AT+NWM=?", &Values[i]) == RAK3172_ERR_OK);
+    }
+    Sequential = (RAK3172_Test_Now() - Start) / 1000ULL;
+
+    // The batch keeps up to CONFIG_RAK3172_COMMAND_QUEUE_LENGTH commands in flight, so the module doesn´t wait for the host.
+    Start = RAK3172_Test_Now();
+    RAK3172_Batch_Begin(&Batch);
+    for(uint8_t i = 0; i < TEST_CMDQUEUE_COMMANDS; i++)
+    {
+        RAK3172_Batch_Add(Device, &Batch, "AT+NWM=?", BIT(i), &Values[i]);
+    }
+    RAK3172_TEST_CHECK(RAK3172_Batch_End(Device, &Batch) == RAK3172_ERR_OK);
+    Pipelined = (RAK3172_Test_Now() - Start) / 1000ULL;
+
+    for(uint8_t i = 0; i < TEST_CMDQUEUE_COMMANDS; i++)
+    {
+        RAK3172_TEST_CHECK(Values[i] == "1");
+    }
+
+    printf("    %u commands with %u ms delay: sequential %llu us / pipelined %llu us\n", TEST_CMDQUEUE_COMMANDS, TEST_CMDQUEUE_DELAY,
+           static_cast<unsigned long long>(Sequential), static_cast<unsigned long long>(Pipelined));
+
+    // The module processes one command after another, so the pipeline only saves the turnaround time of the host.
+    RAK3172_TEST_CHECK(Pipelined <= (Sequential + (Sequential / 10)));
+
+    {
+        std::lock_guard<std::mutex> Guard(Sim.Lock);
+
+        Sim.Delay = 0;
+    }
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_CmdQueue_NoResponse);
+    RAK3172_TEST_RUN(Test_CmdQueue_Suspended);
+    RAK3172_TEST_RUN(Test_CmdQueue_Benchmark);
+
+    return RAK3172_TEST_RESULT();
+}
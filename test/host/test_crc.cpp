@@ -0,0 +1,112 @@
+ /*
+ * test_crc.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the CRC16 of the Ymodem protocol.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <random>
+
+#include <string.h>
+
+#include "rak3172_test.h"
+
+#include "../../src/Modes/Update/rak3172_ymodem_crc.h"
+
+/** @brief          Calculate the reference CRC16 bit by bit without the lookup table.
+ *  @param p_Data   Pointer to data
+ *  @param Length   Data length
+ *  @param CRC      CRC of the previous data
+ *  @return         New CRC16 value
+ */
+static uint16_t Test_CRC_Bitwise(const uint8_t* p_Data, size_t Length, uint16_t CRC)
+{
+    for(size_t i = 0; i < Length; i++)
+    {
+        CRC ^= static_cast<uint16_t>(p_Data[i]) << 8;
+
+        for(uint8_t Bit = 0; Bit < 8; Bit++)
+        {
+            CRC = (CRC & 0x8000) ? ((CRC << 1) ^ YMODEM_CRC_POLY) : (CRC << 1);
+        }
+    }
+
+    return CRC;
+}
+
+static void Test_CRC_CheckValue(void)
+{
+    const char* Check = "123456789";
+
+    // Check value of the CRC-16/XMODEM.
+    RAK3172_TEST_CHECK(RAK3172_Ymodem_CRC16(reinterpret_cast<const uint8_t*>(Check), strlen(Check), 0) == 0x31C3);
+    RAK3172_TEST_CHECK(Test_CRC_Bitwise(reinterpret_cast<const uint8_t*>(Check), strlen(Check), 0) == 0x31C3);
+    RAK3172_TEST_CHECK(RAK3172_Ymodem_CRC16(NULL, 0, 0) == 0);
+}
+
+static void Test_CRC_Table(void)
+{
+    // Each table entry is the CRC of a single byte.
+    for(uint16_t i = 0; i < 256; i++)
+    {
+        uint8_t Input = static_cast<uint8_t>(i);
+
+        RAK3172_TEST_CHECK(_RAK3172_Ymodem_CRCTable.Entries[i] == Test_CRC_Bitwise(&Input, 1, 0));
+
+        // The previous CRC must be combined with the input for all start values.
+        RAK3172_TEST_CHECK(RAK3172_Ymodem_UpdateCRC16(0xFFFF - i, Input) == Test_CRC_Bitwise(&Input, 1, 0xFFFF - i));
+    }
+}
+
+static void Test_CRC_Packets(void)
+{
+    uint8_t Data[1024];
+    uint8_t Padding[1024];
+    std::mt19937 Random(1);
+
+    for(size_t i = 0; i < sizeof(Data); i++)
+    {
+        Data[i] = static_cast<uint8_t>(Random());
+    }
+
+    memset(Padding, 0x1A, sizeof(Padding));
+
+    // Packets of the initial packet size, the data packet size and the partial final packets.
+    for(uint16_t Length : {1, 127, 128, 129, 1000, 1023, 1024})
+    {
+        uint16_t CRC;
+
+        RAK3172_TEST_CHECK(RAK3172_Ymodem_CRC16(Data, Length, 0) == Test_CRC_Bitwise(Data, Length, 0));
+
+        // The padding is calculated without a padded copy of the data.
+        CRC = RAK3172_Ymodem_CRC16(Data, Length, 0);
+        CRC = RAK3172_Ymodem_PaddingCRC16(0x1A, sizeof(Data) - Length, CRC);
+        RAK3172_TEST_CHECK(CRC == Test_CRC_Bitwise(Padding, sizeof(Padding) - Length, Test_CRC_Bitwise(Data, Length, 0)));
+
+        // The CRC can be continued with the next block.
+        CRC = RAK3172_Ymodem_CRC16(Data, Length / 2, 0);
+        CRC = RAK3172_Ymodem_CRC16(&Data[Length / 2], Length - (Length / 2), CRC);
+        RAK3172_TEST_CHECK(CRC == Test_CRC_Bitwise(Data, Length, 0));
+    }
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_CRC_CheckValue);
+    RAK3172_TEST_RUN(Test_CRC_Table);
+    RAK3172_TEST_RUN(Test_CRC_Packets);
+
+    return RAK3172_TEST_RESULT();
+}
@@ -0,0 +1,125 @@
+ /*
+ * test_downlink.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the downlink processing of the LoRaWAN mode. The test is built for the RUI3 and for the legacy firmware.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include "rak3172_alloc.h"
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+/** @brief Number of downlinks, which are received after the warm up.
+ */
+#define TEST_DOWNLINK_COUNT                 16
+
+#ifdef CONFIG_RAK3172_USE_RUI3
+    /** @brief Downlink message of the RUI3 firmware.
+     */
+    static const char _Test_Downlink_Message[] = "+EVT:RX_1:-89:4:UNICAST:1:AABB\r\n";
+#else
+    /** @brief Downlink message of the legacy firmware. The message is transmitted as one block, because the driver reads the
+     *         second and the third line directly from the interface.
+     */
+    static const char _Test_Downlink_Message[] = "+EVT:RX_1, RSSI -89, SNR 4\r\n+EVT:UNICAST\r\n+EVT:1:AABB\r\n";
+#endif
+
+/** @brief          Transmit a downlink to the driver and check the received message.
+ *  @param p_Device RAK3172 device object
+ */
+static void Test_Downlink_Receive(RAK3172_t& p_Device)
+{
+    const RAK3172_Rx_t* Message = NULL;
+
+    RAK3172_Host_UART_Inject(p_Device.UART.Interface, _Test_Downlink_Message, sizeof(_Test_Downlink_Message) - 1);
+
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Borrow(p_Device, &Message, 1) == RAK3172_ERR_OK);
+    if(Message == NULL)
+    {
+        return;
+    }
+
+    RAK3172_TEST_CHECK(Message->RSSI == -89);
+    RAK3172_TEST_CHECK(Message->SNR == 4);
+    RAK3172_TEST_CHECK(Message->Port == 1);
+    RAK3172_TEST_CHECK(Message->Group == RAK_RX_GROUP_1);
+    RAK3172_TEST_CHECK(Message->Length == 2);
+    RAK3172_TEST_CHECK((Message->Data[0] == 0xAA) && (Message->Data[1] == 0xBB));
+
+    RAK3172_ReleaseMessage(p_Device, Message);
+}
+
+/** @brief          Transmit a downlink to the driver and check the copy of the received message.
+ *  @param p_Device RAK3172 device object
+ */
+static void Test_Downlink_Copy(RAK3172_t& p_Device)
+{
+    RAK3172_Rx_t Message;
+
+    RAK3172_Host_UART_Inject(p_Device.UART.Interface, _Test_Downlink_Message, sizeof(_Test_Downlink_Message) - 1);
+
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Receive(p_Device, &Message, 1) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Message.Port == 1);
+    RAK3172_TEST_CHECK(Message.Length == 2);
+    RAK3172_TEST_CHECK((Message.Data[0] == 0xAA) && (Message.Data[1] == 0xBB));
+
+    #ifdef CONFIG_RAK3172_RX_PAYLOAD_STRING
+        RAK3172_TEST_CHECK(Message.Payload == "AABB");
+    #endif
+}
+
+static void Test_Downlink_Allocations(void)
+{
+    uint32_t Allocations;
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        Sim.isRUI3 = true;
+    #else
+        Sim.isRUI3 = false;
+    #endif
+
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Device.Mode == RAK_MODE_LORAWAN);
+    Device.LoRaWAN.isJoined = true;
+
+    // The first downlink initializes the lazy state of the runtime (i. e. the thread locals of the host port).
+    Test_Downlink_Receive(Device);
+
+    Allocations = RAK3172_Test_GetAllocations();
+    for(uint8_t i = 0; i < TEST_DOWNLINK_COUNT; i++)
+    {
+        Test_Downlink_Receive(Device);
+    }
+    RAK3172_TEST_CHECK(RAK3172_Test_GetAllocations() == Allocations);
+
+    Test_Downlink_Copy(Device);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Downlink_Allocations);
+
+    return RAK3172_TEST_RESULT();
+}
@@ -0,0 +1,290 @@
+ /*
+ * test_events.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests and benchmark for the event classification. The test is built for the RUI3 and for the legacy firmware.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <string>
+#include <string.h>
+
+#include <sdkconfig.h>
+
+#include "rak3172_test.h"
+
+#include "../../src/Core/rak3172_events.h"
+
+/** @brief Number of classified lines for the benchmark.
+ */
+#define TEST_EVENTS_BENCHMARK_ROUNDS                            100000
+
+/** @brief Event line and the expected classification.
+ */
+typedef struct
+{
+    const char* Line;                   /**< Received line. */
+    RAK3172_Event_t Event;              /**< Expected event. */
+    const char* Args;                   /**< Expected arguments after the keyword. */
+} Test_Events_Case_t;
+
+/** @brief Every keyword of the vocabulary with typical arguments.
+ */
+static const Test_Events_Case_t _Test_Events_Vocabulary[] = {
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        {"+EVT:JOINED",                             RAK3172_EVT_JOINED,             ""},
+        {"+EVT:JOIN_FAILED_RX_TIMEOUT",             RAK3172_EVT_JOIN_FAILED,        ""},
+        {"+EVT:SEND_CONFIRMED_OK",                  RAK3172_EVT_CONFIRMED_OK,       ""},
+        {"+EVT:SEND_CONFIRMED_FAILED",              RAK3172_EVT_CONFIRMED_FAILED,   ""},
+        {"+EVT:RX_1:-89:4:UNICAST:1:AABB",          RAK3172_EVT_RX_1,               ":-89:4:UNICAST:1:AABB"},
+        {"+EVT:RX_2:-90:5:UNICAST:2:CC",            RAK3172_EVT_RX_2,               ":-90:5:UNICAST:2:CC"},
+        {"+EVT:RX_B:-91:6:MULTICAST:3:DD",          RAK3172_EVT_RX_B,               ":-91:6:MULTICAST:3:DD"},
+        {"+EVT:RX_C:-92:7:MULTICAST:4:EE",          RAK3172_EVT_RX_C,               ":-92:7:MULTICAST:4:EE"},
+        {"+EVT:RXP2P:-50:8:AABB",                   RAK3172_EVT_RXP2P,              ":-50:8:AABB"},
+    #else
+        {"+EVT:JOINED",                             RAK3172_EVT_JOINED,             ""},
+        {"+EVT:JOIN FAILED",                        RAK3172_EVT_JOIN_FAILED,        ""},
+        {"+EVT:SEND CONFIRMED OK",                  RAK3172_EVT_CONFIRMED_OK,       ""},
+        {"+EVT:SEND CONFIRMED FAILED",              RAK3172_EVT_CONFIRMED_FAILED,   ""},
+        {"+EVT:RX_1, RSSI -89, SNR 4",              RAK3172_EVT_RX_1,               ", RSSI -89, SNR 4"},
+        {"+EVT:RX_2, RSSI -90, SNR 5",              RAK3172_EVT_RX_2,               ", RSSI -90, SNR 5"},
+        {"+EVT:RX_B, RSSI -91, SNR 6",              RAK3172_EVT_RX_B,               ", RSSI -91, SNR 6"},
+        {"+EVT:RX_C, RSSI -92, SNR 7",              RAK3172_EVT_RX_C,               ", RSSI -92, SNR 7"},
+        {"+EVT:RXP2P, RSSI -50, SNR 8",             RAK3172_EVT_RXP2P,              ", RSSI -50, SNR 8"},
+    #endif
+    {"+EVT:RXP2P RECEIVE TIMEOUT",                  RAK3172_EVT_RXP2P_TIMEOUT,      ""},
+};
+
+/** @brief Lines, which share a prefix with a keyword. The longest matching keyword wins and incomplete keywords are unknown.
+ */
+static const Test_Events_Case_t _Test_Events_Collisions[] = {
+    {"+EVT:JOIN",                                   RAK3172_EVT_UNKNOWN,            "JOIN"},
+    {"+EVT:JOINE",                                  RAK3172_EVT_UNKNOWN,            "JOINE"},
+    {"+EVT:JOINEDX",                                RAK3172_EVT_JOINED,             "X"},
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        {"+EVT:JOIN_FAILED",                        RAK3172_EVT_UNKNOWN,            "JOIN_FAILED"},
+        {"+EVT:SEND_CONFIRMED_",                    RAK3172_EVT_UNKNOWN,            "SEND_CONFIRMED_"},
+        {"+EVT:SEND_CONFIRMED_FAIL",                RAK3172_EVT_UNKNOWN,            "SEND_CONFIRMED_FAIL"},
+    #else
+        {"+EVT:JOIN FAIL",                          RAK3172_EVT_UNKNOWN,            "JOIN FAIL"},
+        {"+EVT:SEND CONFIRMED ",                    RAK3172_EVT_UNKNOWN,            "SEND CONFIRMED "},
+        {"+EVT:SEND CONFIRMED FAIL",                RAK3172_EVT_UNKNOWN,            "SEND CONFIRMED FAIL"},
+    #endif
+    {"+EVT:RX",                                     RAK3172_EVT_UNKNOWN,            "RX"},
+    {"+EVT:RX_",                                    RAK3172_EVT_UNKNOWN,            "RX_"},
+    {"+EVT:RX_3",                                   RAK3172_EVT_UNKNOWN,            "RX_3"},
+    {"+EVT:RXP",                                    RAK3172_EVT_UNKNOWN,            "RXP"},
+    {"+EVT:RXP2P RECEIVE",                          RAK3172_EVT_RXP2P,              " RECEIVE"},
+    {"+EVT:RXP2P RECEIVE TIMEOUTX",                 RAK3172_EVT_RXP2P_TIMEOUT,      "X"},
+    {"+EVT:LINKCHECK:0:0",                          RAK3172_EVT_UNKNOWN,            "LINKCHECK:0:0"},
+    {"+EVT:",                                       RAK3172_EVT_UNKNOWN,            ""},
+    {"\xFF\xFE+EVT:JOINED",                         RAK3172_EVT_JOINED,             ""},
+};
+
+/** @brief Lines of a typical session for the benchmark. Most lines aren´t events.
+ */
+static const char* _Test_Events_Session[] = {
+    "OK",
+    "AT+NWM=1",
+    "AT+NJM=?",
+    "AT+NJM=1",
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        "+EVT:JOINED",
+        "+EVT:SEND_CONFIRMED_OK",
+        "+EVT:RX_1:-89:4:UNICAST:1:AABB",
+    #else
+        "+EVT:JOINED",
+        "+EVT:SEND CONFIRMED OK",
+        "+EVT:RX_1, RSSI -89, SNR 4",
+    #endif
+    "+EVT:RXP2P RECEIVE TIMEOUT",
+};
+
+/** @brief          Classify a line with the find() chain of the receive task before the event trie.
+ *  @param Line     Received line
+ *  @return         Recognized event
+ */
+static RAK3172_Event_t Test_Events_Find(const std::string& Line)
+{
+    size_t Index;
+
+    if(Line.find("+EVT") == std::string::npos)
+    {
+        return RAK3172_EVT_NONE;
+    }
+
+    if(Line.find("JOINED") != std::string::npos)
+    {
+        return RAK3172_EVT_JOINED;
+    }
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        else if(Line.find("JOIN_FAILED_RX_TIMEOUT") != std::string::npos)
+    #else
+        else if(Line.find("JOIN FAILED") != std::string::npos)
+    #endif
+    {
+        return RAK3172_EVT_JOIN_FAILED;
+    }
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        else if(Line.find("SEND_CONFIRMED_FAILED") != std::string::npos)
+    #else
+        else if(Line.find("SEND CONFIRMED FAILED") != std::string::npos)
+    #endif
+    {
+        return RAK3172_EVT_CONFIRMED_FAILED;
+    }
+    #ifdef CONFIG_RAK3172_USE_RUI3
+        else if(Line.find("SEND_CONFIRMED_OK") != std::string::npos)
+    #else
+        else if(Line.find("SEND CONFIRMED OK") != std::string::npos)
+    #endif
+    {
+        return RAK3172_EVT_CONFIRMED_OK;
+    }
+    else if(Line.find("+EVT:RXP2P RECEIVE TIMEOUT") != std::string::npos)
+    {
+        return RAK3172_EVT_RXP2P_TIMEOUT;
+    }
+    else if(Line.find("RXP2P") != std::string::npos)
+    {
+        return RAK3172_EVT_RXP2P;
+    }
+
+    // Get the receive window from the "RX_x" part of the line.
+    Index = Line.find("RX_");
+    if((Index != std::string::npos) && ((Index + 3) < Line.length()))
+    {
+        switch(Line[Index + 3])
+        {
+            case '1':
+            {
+                return RAK3172_EVT_RX_1;
+            }
+            case '2':
+            {
+                return RAK3172_EVT_RX_2;
+            }
+            case 'B':
+            {
+                return RAK3172_EVT_RX_B;
+            }
+            case 'C':
+            {
+                return RAK3172_EVT_RX_C;
+            }
+            default:
+            {
+                break;
+            }
+        }
+    }
+
+    return RAK3172_EVT_UNKNOWN;
+}
+
+/** @brief          Check the classification of a line.
+ *  @param p_Case   Pointer to test case
+ */
+static void Test_Events_Check(const Test_Events_Case_t* p_Case)
+{
+    const char* Args = NULL;
+    RAK3172_Event_t Event;
+
+    Event = RAK3172_Events_Classify(p_Case->Line, &Args);
+    if(Event != p_Case->Event)
+    {
+        printf("    Wrong event %u for \"%s\"\n", static_cast<unsigned int>(Event), p_Case->Line);
+    }
+
+    RAK3172_TEST_CHECK(Event == p_Case->Event);
+    RAK3172_TEST_CHECK((Args != NULL) && (strcmp(Args, p_Case->Args) == 0));
+}
+
+static void Test_Events_Vocabulary(void)
+{
+    for(const Test_Events_Case_t& Case : _Test_Events_Vocabulary)
+    {
+        Test_Events_Check(&Case);
+
+        // The trie recognizes the same events as the find() chain.
+        RAK3172_TEST_CHECK(Test_Events_Find(Case.Line) == Case.Event);
+    }
+}
+
+static void Test_Events_Collisions(void)
+{
+    for(const Test_Events_Case_t& Case : _Test_Events_Collisions)
+    {
+        Test_Events_Check(&Case);
+    }
+}
+
+static void Test_Events_NoEvent(void)
+{
+    const char* Args = NULL;
+
+    RAK3172_TEST_CHECK(RAK3172_Events_Classify("OK", &Args) == RAK3172_EVT_NONE);
+    RAK3172_TEST_CHECK(RAK3172_Events_Classify("", &Args) == RAK3172_EVT_NONE);
+    RAK3172_TEST_CHECK(RAK3172_Events_Classify("EVT:JOINED", &Args) == RAK3172_EVT_NONE);
+    RAK3172_TEST_CHECK(RAK3172_Events_Classify("+EVT JOINED", &Args) == RAK3172_EVT_NONE);
+    RAK3172_TEST_CHECK(Args == NULL);
+}
+
+static void Test_Events_Benchmark(void)
+{
+    uint64_t Start;
+    uint64_t Find;
+    uint64_t Trie;
+    uint32_t Sum;
+    const char* Args;
+    std::string Lines[sizeof(_Test_Events_Session) / sizeof(_Test_Events_Session[0])];
+    const size_t Count = sizeof(_Test_Events_Session) / sizeof(_Test_Events_Session[0]);
+
+    // The receive task used std::string objects for the find() chain.
+    for(size_t i = 0; i < Count; i++)
+    {
+        Lines[i] = _Test_Events_Session[i];
+    }
+
+    Sum = 0;
+    Start = RAK3172_Test_Now();
+    for(uint32_t i = 0; i < TEST_EVENTS_BENCHMARK_ROUNDS; i++)
+    {
+        Sum += Test_Events_Find(Lines[i % Count]);
+    }
+    Find = (RAK3172_Test_Now() - Start) / (TEST_EVENTS_BENCHMARK_ROUNDS / 1000);
+
+    Start = RAK3172_Test_Now();
+    for(uint32_t i = 0; i < TEST_EVENTS_BENCHMARK_ROUNDS; i++)
+    {
+        Sum -= RAK3172_Events_Classify(_Test_Events_Session[i % Count], &Args);
+    }
+    Trie = (RAK3172_Test_Now() - Start) / (TEST_EVENTS_BENCHMARK_ROUNDS / 1000);
+
+    // Both classifications must agree for the whole session.
+    RAK3172_TEST_CHECK(Sum == 0);
+
+    printf("    %zu session lines: find() chain %6llu ps / trie %6llu ps per line\n", Count, static_cast<unsigned long long>(Find),
+           static_cast<unsigned long long>(Trie));
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Events_Vocabulary);
+    RAK3172_TEST_RUN(Test_Events_Collisions);
+    RAK3172_TEST_RUN(Test_Events_NoEvent);
+    RAK3172_TEST_RUN(Test_Events_Benchmark);
+
+    return RAK3172_TEST_RESULT();
+}
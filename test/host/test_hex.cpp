@@ -0,0 +1,154 @@
+ /*
+ * test_hex.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests and benchmark for the hex codec.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <random>
+#include <string>
+#include <string.h>
+
+#include "rak3172_test.h"
+
+#include "../../src/Core/rak3172_hex.h"
+
+/** @brief Number of encoded payloads for each benchmark length.
+ */
+#define TEST_HEX_BENCHMARK_ROUNDS                               2000
+
+/** @brief          Encode a payload with sprintf like the driver did before the table driven codec.
+ *  @param p_Output Pointer to output string
+ *  @param p_Input  Pointer to input data
+ *  @param Length   Input length in bytes
+ */
+static void Test_Hex_Sprintf(std::string* p_Output, const uint8_t* p_Input, size_t Length)
+{
+    char Buffer[3];
+
+    p_Output->reserve(p_Output->length() + (2 * Length));
+    for(size_t i = 0; i < Length; i++)
+    {
+        sprintf(Buffer, "%02X", p_Input[i]);
+        *p_Output += Buffer;
+    }
+}
+
+static void Test_Hex_Encode(void)
+{
+    char Output[16];
+    std::string Text = "AT+SEND=1:";
+    const uint8_t Data[] = {0x00, 0x01, 0xAB, 0xCD, 0xEF, 0x7F, 0x80};
+
+    RAK3172_Hex_Encode(Data, sizeof(Data), Output);
+    RAK3172_TEST_CHECK(memcmp(Output, "0001ABCDEF7F80", 2 * sizeof(Data)) == 0);
+
+    RAK3172_Hex_Append(&Text, Data, 2);
+    RAK3172_TEST_CHECK(Text == "AT+SEND=1:0001");
+
+    RAK3172_Hex_Append(&Text, Data, 0);
+    RAK3172_TEST_CHECK(Text == "AT+SEND=1:0001");
+}
+
+static void Test_Hex_Decode(void)
+{
+    size_t Length;
+    uint8_t Output[4];
+
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("aBcD", Output, sizeof(Output), &Length) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK((Length == 2) && (Output[0] == 0xAB) && (Output[1] == 0xCD));
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("", Output, sizeof(Output), &Length) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Length == 0);
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("ABC", Output, sizeof(Output), &Length) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("0G", Output, sizeof(Output), &Length) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("0 ", Output, sizeof(Output), &Length) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("0011223344", Output, sizeof(Output), &Length) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_Hex_Decode("00", Output, sizeof(Output), NULL) == RAK3172_ERR_INVALID_ARG);
+}
+
+static void Test_Hex_RoundTrip(void)
+{
+    std::mt19937 Random(3172);
+    std::uniform_int_distribution<int> Bytes(0, 255);
+
+    // Cover the word wise and the byte wise encoding of all lengths.
+    for(size_t Length = 0; Length <= 64; Length++)
+    {
+        size_t Decoded;
+        std::string Text;
+        uint8_t Input[64];
+        uint8_t Output[64];
+
+        for(size_t i = 0; i < Length; i++)
+        {
+            Input[i] = static_cast<uint8_t>(Bytes(Random));
+        }
+
+        RAK3172_Hex_Append(&Text, Input, Length);
+        RAK3172_TEST_CHECK(Text.length() == (2 * Length));
+        RAK3172_TEST_CHECK(RAK3172_Hex_Decode(Text, Output, sizeof(Output), &Decoded) == RAK3172_ERR_OK);
+        RAK3172_TEST_CHECK((Decoded == Length) && (memcmp(Input, Output, Length) == 0));
+    }
+}
+
+static void Test_Hex_Benchmark(void)
+{
+    uint8_t Input[1000];
+
+    for(size_t i = 0; i < sizeof(Input); i++)
+    {
+        Input[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    // Compare both encoders for the payload sizes of a key, a typical uplink, the largest LoRaWAN frame and the largest AT+SEND payload.
+    for(size_t Length : {1, 51, 242, 1000})
+    {
+        uint64_t Start;
+        uint64_t Sprintf;
+        uint64_t Table;
+        std::string Reference;
+        std::string Text;
+
+        Start = RAK3172_Test_Now();
+        for(uint32_t i = 0; i < TEST_HEX_BENCHMARK_ROUNDS; i++)
+        {
+            Reference.clear();
+            Test_Hex_Sprintf(&Reference, Input, Length);
+        }
+        Sprintf = (RAK3172_Test_Now() - Start) / TEST_HEX_BENCHMARK_ROUNDS;
+
+        Start = RAK3172_Test_Now();
+        for(uint32_t i = 0; i < TEST_HEX_BENCHMARK_ROUNDS; i++)
+        {
+            Text.clear();
+            RAK3172_Hex_Append(&Text, Input, Length);
+        }
+        Table = (RAK3172_Test_Now() - Start) / TEST_HEX_BENCHMARK_ROUNDS;
+
+        RAK3172_TEST_CHECK(Text == Reference);
+
+        printf("    %4zu B: sprintf %8llu ns / table %6llu ns\n", Length, static_cast<unsigned long long>(Sprintf), static_cast<unsigned long long>(Table));
+    }
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Hex_Encode);
+    RAK3172_TEST_RUN(Test_Hex_Decode);
+    RAK3172_TEST_RUN(Test_Hex_RoundTrip);
+    RAK3172_TEST_RUN(Test_Hex_Benchmark);
+
+    return RAK3172_TEST_RESULT();
+}
@@ -0,0 +1,291 @@
+ /*
+ * test_lorawan.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the maximum payloads and the uplink scheduler of the LoRaWAN mode.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <atomic>
+#include <chrono>
+
+#include "rak3172_sim.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+/** @brief Maximum application payload N in bytes for DR0 - DR7 of each band from the LoRaWAN Regional Parameters RP002-1.0.3
+ *         (tables which aren´t repeater compatible, AS923 with UplinkDwellTime = 0). 0 marks an undefined uplink data rate.
+ */
+static const uint8_t _Test_LoRaWAN_MaxPayload[][8] = {
+    {51, 51, 51, 115, 242, 242, 242, 242},    // EU433
+    {51, 51, 51, 115, 242, 242, 0, 0},        // CN470
+    {51, 51, 51, 115, 242, 242, 242, 242},    // RU864
+    {51, 51, 51, 115, 242, 242, 0, 242},      // IN865
+    {51, 51, 51, 115, 242, 242, 242, 242},    // EU868
+    {11, 53, 125, 242, 242, 0, 0, 0},         // US915
+    {51, 51, 51, 115, 242, 242, 242, 0},      // AU915
+    {51, 51, 51, 115, 242, 242, 0, 0},        // KR920
+    {51, 51, 115, 115, 242, 242, 242, 242},   // AS923
+};
+
+/** @brief Payload, which is larger than any frame.
+ */
+static const uint8_t _Test_LoRaWAN_Payload[256] = {0};
+
+static void Test_LoRaWAN_MaxPayload(void)
+{
+    uint8_t Length;
+
+    for(uint8_t Band = RAK_BAND_EU433; Band <= RAK_BAND_AS923; Band++)
+    {
+        for(uint8_t DR = RAK_DR_0; DR <= RAK_DR_7; DR++)
+        {
+            RAK3172_Error_t Error;
+
+            Length = 0;
+            Error = RAK3172_LoRaWAN_GetMaxPayload(static_cast<RAK3172_Band_t>(Band), static_cast<RAK3172_DataRate_t>(DR), &Length);
+            if(_Test_LoRaWAN_MaxPayload[Band][DR] == 0)
+            {
+                RAK3172_TEST_CHECK(Error == RAK3172_ERR_INVALID_ARG);
+            }
+            else
+            {
+                RAK3172_TEST_CHECK(Error == RAK3172_ERR_OK);
+                RAK3172_TEST_CHECK(Length == _Test_LoRaWAN_MaxPayload[Band][DR]);
+            }
+        }
+    }
+
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetMaxPayload(static_cast<RAK3172_Band_t>(RAK_BAND_AS923 + 1), RAK_DR_0, &Length) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetMaxPayload(RAK_BAND_EU868, static_cast<RAK3172_DataRate_t>(RAK_DR_7 + 1), &Length) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetMaxPayload(RAK_BAND_EU868, RAK_DR_0, NULL) == RAK3172_ERR_INVALID_ARG);
+}
+
+/** @brief          Count the transmitted uplinks of the simulator.
+ *  @param p_Sim    Pointer to simulator
+ *  @return         Number of "AT+SEND" commands
+ */
+static size_t Test_LoRaWAN_CountUplinks(RAK3172_Sim_t* p_Sim)
+{
+    size_t Count = 0;
+    std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+    for(const std::string& Command : p_Sim->Received)
+    {
+        if(Command.compare(0, 8, "AT+SEND=") == 0)
+        {
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+static void Test_LoRaWAN_Schedule(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Device.Mode == RAK_MODE_LORAWAN);
+
+    // Fixed data rate without ADR after a join.
+    Device.LoRaWAN.isJoined = true;
+    Device.LoRaWAN.isDataRateValid = true;
+    Device.LoRaWAN.Config.Valid = RAK_LORAWAN_CFG_BAND | RAK_LORAWAN_CFG_ADR;
+    Device.LoRaWAN.Config.UseADR = false;
+
+    for(uint8_t Band = RAK_BAND_EU433; Band <= RAK_BAND_AS923; Band++)
+    {
+        for(uint8_t DR = RAK_DR_0; DR <= RAK_DR_7; DR++)
+        {
+            uint16_t Max;
+
+            Max = _Test_LoRaWAN_MaxPayload[Band][DR];
+            if(Max == 0)
+            {
+                continue;
+            }
+
+            Device.LoRaWAN.Config.Band = static_cast<RAK3172_Band_t>(Band);
+            Device.LoRaWAN.DataRate = static_cast<RAK3172_DataRate_t>(DR);
+
+            RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 1, _Test_LoRaWAN_Payload, Max + 1, RAK_UPLINK_PRIO_NORMAL, 0, 0, false, NULL, NULL, NULL) == RAK3172_ERR_INVALID_ARG);
+        }
+    }
+
+    // The rejected payloads were never transmitted to the module.
+    RAK3172_Sim_Flush(&Sim);
+    RAK3172_TEST_CHECK(Test_LoRaWAN_CountUplinks(&Sim) == 0);
+
+    // A payload with the maximum length is accepted.
+    Device.LoRaWAN.Config.Band = RAK_BAND_US915;
+    Device.LoRaWAN.DataRate = RAK_DR_0;
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 1, _Test_LoRaWAN_Payload, 11, RAK_UPLINK_PRIO_NORMAL, 0, 0, false, NULL, NULL, NULL) == RAK3172_ERR_OK);
+
+    // The data rate is unknown with ADR, so the module checks the length.
+    Device.LoRaWAN.Config.UseADR = true;
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 2, _Test_LoRaWAN_Payload, 12, RAK_UPLINK_PRIO_NORMAL, 0, 0, false, NULL, NULL, NULL) == RAK3172_ERR_OK);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+/** @brief          Command handler, which never answers the confirmation setting, so the first uplink stays active.
+ *  @param p_Sim    Pointer to simulator
+ *  @param Command  Received command
+ *  @return         #true when the command was handled
+ */
+static bool Test_LoRaWAN_HoldUplink(RAK3172_Sim_t* p_Sim, const std::string& Command)
+{
+    return Command.compare(0, 7, "AT+CFM=") == 0;
+}
+
+/** @brief          Completion callback of the uplinks. Counts the completed uplinks.
+ *  @param Frame    Frame number
+ *  @param Error    Result of the uplink
+ *  @param Latency  Latency in milliseconds
+ *  @param p_Arg    Pointer to counter
+ */
+static void Test_LoRaWAN_OnUplink(uint32_t Frame, RAK3172_Error_t Error, uint32_t Latency, void* p_Arg)
+{
+    (*static_cast<std::atomic<uint32_t>*>(p_Arg))++;
+}
+
+/** @brief              Wait until the simulator has received a command with a given prefix.
+ *  @param p_Sim        Pointer to simulator
+ *  @param Prefix       Command prefix
+ *  @param p_Command    Pointer to received command
+ *  @return             #true when the command was received within one second
+ */
+static bool Test_LoRaWAN_WaitCommand(RAK3172_Sim_t* p_Sim, const std::string& Prefix, std::string* p_Command)
+{
+    for(uint8_t i = 0; i < 100; i++)
+    {
+        {
+            std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+            for(const std::string& Command : p_Sim->Received)
+            {
+                if(Command.compare(0, Prefix.length(), Prefix) == 0)
+                {
+                    *p_Command = Command;
+
+                    return true;
+                }
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return false;
+}
+
+static void Test_LoRaWAN_Coalesce(void)
+{
+    RAK3172_Sim_t Sim;
+    std::string Command;
+    RAK3172_Uplink_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+    Device.LoRaWAN.isJoined = true;
+    Device.LoRaWAN.isDataRateValid = true;
+    Device.LoRaWAN.Config.Valid = RAK_LORAWAN_CFG_BAND | RAK_LORAWAN_CFG_ADR;
+    Device.LoRaWAN.Config.UseADR = false;
+    Device.LoRaWAN.Config.Band = RAK_BAND_EU868;
+    Device.LoRaWAN.DataRate = RAK_DR_5;
+
+    // The first uplink stays active, so the following uplinks stay in the queue.
+    Sim.Handler = Test_LoRaWAN_HoldUplink;
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 1, _Test_LoRaWAN_Payload, 10, RAK_UPLINK_PRIO_NORMAL) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Test_LoRaWAN_WaitCommand(&Sim, "AT+CFM=", &Command));
+
+    // Payloads are only combined when both submissions allow it.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 2, _Test_LoRaWAN_Payload, 10, RAK_UPLINK_PRIO_NORMAL) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 2, _Test_LoRaWAN_Payload, 10, RAK_UPLINK_PRIO_NORMAL, 0, 0, false, NULL, NULL, NULL, true) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetUplinkStats(Device, &Stats) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Stats.Coalesced == 0);
+
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 2, _Test_LoRaWAN_Payload, 10, RAK_UPLINK_PRIO_NORMAL, 0, 0, false, NULL, NULL, NULL, true) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetUplinkStats(Device, &Stats) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Stats.Coalesced == 1);
+    RAK3172_TEST_CHECK(Stats.Depth == 2);
+
+    // The combined payload must fit into the maximum payload of the data rate.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 2, _Test_LoRaWAN_Payload, 223, RAK_UPLINK_PRIO_NORMAL, 0, 0, false, NULL, NULL, NULL, true) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_GetUplinkStats(Device, &Stats) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Stats.Coalesced == 1);
+    RAK3172_TEST_CHECK(Stats.Depth == 3);
+
+    Sim.Handler = NULL;
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_LoRaWAN_LongPayload(void)
+{
+    RAK3172_Sim_t Sim;
+    std::string Command;
+    std::string Expected;
+    std::atomic<uint32_t> Completed(0);
+    static uint8_t Payload[300];
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Expected = "AT+SEND=3:";
+    for(size_t i = 0; i < sizeof(Payload); i++)
+    {
+        char Hex[3];
+
+        Payload[i] = static_cast<uint8_t>(i);
+        snprintf(Hex, sizeof(Hex), "%02X", Payload[i]);
+        Expected += Hex;
+    }
+
+    RAK3172_Sim_Start(&Sim, UART_NUM_1, RAK_BAUD_9600);
+
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+    Device.LoRaWAN.isJoined = true;
+    Device.LoRaWAN.Config.Valid = RAK_LORAWAN_CFG_BAND | RAK_LORAWAN_CFG_ADR;
+    Device.LoRaWAN.Config.UseADR = true;
+    Device.LoRaWAN.Config.Band = RAK_BAND_EU868;
+
+    // The payload doesn´t fit into the payload buffer of the uplink, so it isn´t copied and needs a callback.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 3, Payload, sizeof(Payload), RAK_UPLINK_PRIO_NORMAL) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 3, Payload, sizeof(Payload), RAK_UPLINK_PRIO_NORMAL, 0, 0, false, Test_LoRaWAN_OnUplink, &Completed) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Test_LoRaWAN_WaitCommand(&Sim, "AT+SEND=", &Command));
+    RAK3172_TEST_CHECK(Command == Expected);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+
+    // The uplink is completed before the driver is removed.
+    RAK3172_TEST_CHECK(Completed == 1);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_LoRaWAN_MaxPayload);
+    RAK3172_TEST_RUN(Test_LoRaWAN_Schedule);
+    RAK3172_TEST_RUN(Test_LoRaWAN_Coalesce);
+    RAK3172_TEST_RUN(Test_LoRaWAN_LongPayload);
+
+    return RAK3172_TEST_RESULT();
+}
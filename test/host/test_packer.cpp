@@ -0,0 +1,150 @@
+ /*
+ * test_packer.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the LoRaWAN uplink record packer.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <random>
+
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+/** @brief Number of random record sets for the packer test.
+ */
+#define TEST_PACKER_ROUNDS                                      20000
+
+/** @brief Shared record data, which is larger than any record.
+ */
+static const uint8_t _Test_Packer_Data[512] = {0};
+
+/** @brief              Check that the packed frames respect the maximum payload and that each remaining part has a frame.
+ *  @param p_Records    Pointer to records
+ *  @param Count        Number of records
+ *  @param MaxPayload   Maximum payload of a frame in bytes
+ *  @param p_Frames     Pointer to packed frame index for each record
+ *  @param FrameCount   Number of packed frames
+ */
+static void Test_Packer_Verify(const RAK3172_Record_t* p_Records, uint8_t Count, uint8_t MaxPayload, const uint8_t* p_Frames, uint8_t FrameCount)
+{
+    uint16_t Sizes[RAK3172_PACK_MAX_RECORDS] = {0};
+
+    for(uint8_t i = 0; i < Count; i++)
+    {
+        uint16_t Rest = p_Records[i].Length % MaxPayload;
+
+        if(Rest == 0)
+        {
+            RAK3172_TEST_CHECK(p_Frames[i] == RAK3172_PACK_NONE);
+        }
+        else
+        {
+            RAK3172_TEST_CHECK(p_Frames[i] < FrameCount);
+            if(p_Frames[i] < FrameCount)
+            {
+                Sizes[p_Frames[i]] += Rest;
+            }
+        }
+    }
+
+    for(uint8_t i = 0; i < FrameCount; i++)
+    {
+        RAK3172_TEST_CHECK((Sizes[i] > 0) && (Sizes[i] <= MaxPayload));
+    }
+}
+
+static void Test_Packer_Basic(void)
+{
+    uint8_t FrameCount;
+    uint8_t Frames[RAK3172_PACK_MAX_RECORDS];
+    const RAK3172_Record_t Records[] = {
+        {_Test_Packer_Data, 6},
+        {_Test_Packer_Data, 5},
+        {_Test_Packer_Data, 4},
+        {_Test_Packer_Data, 3},
+        {_Test_Packer_Data, 2},
+    };
+    const RAK3172_Record_t Split[] = {
+        {_Test_Packer_Data, 25},
+        {_Test_Packer_Data, 20},
+        {NULL, 0},
+    };
+
+    // First fit decreasing: 6 + 4 and 5 + 3 + 2.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, 5, 10, Frames, &FrameCount) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(FrameCount == 2);
+    RAK3172_TEST_CHECK((Frames[0] == 0) && (Frames[1] == 1) && (Frames[2] == 0) && (Frames[3] == 1) && (Frames[4] == 1));
+
+    // Only the remaining part of a large record is packed.
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Split, 3, 10, Frames, &FrameCount) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(FrameCount == 1);
+    RAK3172_TEST_CHECK((Frames[0] == 0) && (Frames[1] == RAK3172_PACK_NONE) && (Frames[2] == RAK3172_PACK_NONE));
+}
+
+static void Test_Packer_Invalid(void)
+{
+    uint8_t FrameCount;
+    uint8_t Frames[RAK3172_PACK_MAX_RECORDS];
+    RAK3172_Record_t Records[RAK3172_PACK_MAX_RECORDS + 1] = {};
+    const RAK3172_Record_t Missing[] = {
+        {NULL, 1},
+    };
+
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(NULL, 1, 10, Frames, &FrameCount) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, 0, 10, Frames, &FrameCount) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, RAK3172_PACK_MAX_RECORDS + 1, 10, Frames, &FrameCount) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, 1, 0, Frames, &FrameCount) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, 1, 10, NULL, &FrameCount) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, 1, 10, Frames, NULL) == RAK3172_ERR_INVALID_ARG);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Missing, 1, 10, Frames, &FrameCount) == RAK3172_ERR_INVALID_ARG);
+}
+
+static void Test_Packer_Random(void)
+{
+    std::mt19937 Random(3172);
+    std::uniform_int_distribution<int> Counts(1, RAK3172_PACK_MAX_RECORDS);
+    std::uniform_int_distribution<int> Lengths(0, 300);
+    std::uniform_int_distribution<int> Payloads(1, 242);
+
+    for(uint32_t Round = 0; Round < TEST_PACKER_ROUNDS; Round++)
+    {
+        uint8_t Count;
+        uint8_t MaxPayload;
+        uint8_t FrameCount;
+        uint8_t Frames[RAK3172_PACK_MAX_RECORDS];
+        RAK3172_Record_t Records[RAK3172_PACK_MAX_RECORDS];
+
+        Count = static_cast<uint8_t>(Counts(Random));
+        MaxPayload = static_cast<uint8_t>(Payloads(Random));
+        for(uint8_t i = 0; i < Count; i++)
+        {
+            Records[i].Data = _Test_Packer_Data;
+            Records[i].Length = static_cast<uint16_t>(Lengths(Random));
+        }
+
+        RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Pack(Records, Count, MaxPayload, Frames, &FrameCount) == RAK3172_ERR_OK);
+        Test_Packer_Verify(Records, Count, MaxPayload, Frames, FrameCount);
+    }
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Packer_Basic);
+    RAK3172_TEST_RUN(Test_Packer_Invalid);
+    RAK3172_TEST_RUN(Test_Packer_Random);
+
+    return RAK3172_TEST_RESULT();
+}
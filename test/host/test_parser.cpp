@@ -0,0 +1,246 @@
+ /*
+ * test_parser.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests and fuzz tests for the response parser.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <random>
+#include <string>
+#include <charconv>
+
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+#include "../../src/Core/rak3172_parser.h"
+
+/** @brief Number of random inputs for the fuzz tests.
+ */
+#define TEST_PARSER_FUZZ_ROUNDS                                 200000
+
+/** @brief          Reference for the removal of leading and trailing spaces. It doesn´t use the parser, so a bug in the trim can´t hide itself.
+ *  @param Input    Input string
+ *  @return         Trimmed string
+ */
+static std::string_view Test_Parser_ReferenceTrim(std::string_view Input)
+{
+    size_t First;
+    size_t Last;
+
+    First = Input.find_first_not_of(' ');
+    if(First == std::string_view::npos)
+    {
+        return std::string_view();
+    }
+
+    Last = Input.find_last_not_of(' ');
+
+    return Input.substr(First, Last - First + 1);
+}
+
+/** @brief          Reference conversion of a string into a signed integer.
+ *  @param Input    Input string
+ *  @param Base     Number base (10 or 16)
+ *  @param p_Value  Pointer to value
+ *  @return         #true when the string is a valid 32 bit number
+ */
+static bool Test_Parser_Reference(std::string_view Input, uint8_t Base, int32_t* p_Value)
+{
+    bool isNegative = false;
+    unsigned long long Magnitude;
+    long long Value;
+
+    Input = Test_Parser_ReferenceTrim(Input);
+    if((Input.empty() == false) && (Input.front() == '-'))
+    {
+        isNegative = true;
+        Input.remove_prefix(1);
+    }
+    else if((Input.empty() == false) && (Input.front() == '+'))
+    {
+        Input.remove_prefix(1);
+    }
+
+    if(Input.empty() || (Input.front() == '+') || (Input.front() == '-'))
+    {
+        return false;
+    }
+
+    auto Result = std::from_chars(Input.data(), Input.data() + Input.length(), Magnitude, Base);
+    if((Result.ec != std::errc()) || (Result.ptr != (Input.data() + Input.length())) || (Magnitude > 0x80000000ULL))
+    {
+        return false;
+    }
+
+    Value = isNegative ? -static_cast<long long>(Magnitude) : static_cast<long long>(Magnitude);
+    if((Value < INT32_MIN) || (Value > INT32_MAX))
+    {
+        return false;
+    }
+
+    *p_Value = static_cast<int32_t>(Value);
+
+    return true;
+}
+
+static void Test_Parser_Numbers(void)
+{
+    int32_t Signed;
+    uint32_t Unsigned;
+    int8_t Small;
+    uint16_t Word;
+
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt(" -42 ", &Signed, INT32_MIN, INT32_MAX) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Signed == -42);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("-2147483648", &Signed, INT32_MIN, INT32_MAX) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Signed == INT32_MIN);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("2147483648", &Signed, INT32_MIN, INT32_MAX) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("", &Signed, INT32_MIN, INT32_MAX) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("-", &Signed, INT32_MIN, INT32_MAX) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("12a", &Signed, INT32_MIN, INT32_MAX) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("5", &Signed, 6, 10) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToInt("5", NULL, INT32_MIN, INT32_MAX) == RAK3172_ERR_INVALID_ARG);
+
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToUInt("4294967295", &Unsigned, UINT32_MAX) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Unsigned == UINT32_MAX);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToUInt("4294967296", &Unsigned, UINT32_MAX) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToUInt("-1", &Unsigned, UINT32_MAX) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToUInt("fF", &Unsigned, UINT32_MAX, 16) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Unsigned == 0xFF);
+
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("-128", &Small) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Small == -128);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("128", &Small) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("65535", &Word) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Word == 65535);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("65536", &Word) == RAK3172_ERR_INVALID_RESPONSE);
+}
+
+/** @brief          Validator for the enum test, which only accepts the values of a sparse enum.
+ *  @param Baudrate Baud rate
+ *  @return         #true when the baud rate is supported
+ */
+static bool Test_Parser_IsBaudrate(RAK3172_Baud_t Baudrate)
+{
+    return (Baudrate == RAK_BAUD_9600) || (Baudrate == RAK_BAUD_115200);
+}
+
+static void Test_Parser_Enums(void)
+{
+    RAK3172_Band_t Band = RAK_BAND_EU868;
+    RAK3172_DataRate_t DR = RAK_DR_0;
+    RAK3172_Baud_t Baudrate = RAK_BAUD_9600;
+
+    // The range of the underlying type would accept all of these values.
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("8", &Band, RAK_BAND_EU433, RAK_BAND_AS923) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Band == RAK_BAND_AS923);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("9", &Band, RAK_BAND_EU433, RAK_BAND_AS923) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("-1", &Band, RAK_BAND_EU433, RAK_BAND_AS923) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(Band == RAK_BAND_AS923);
+
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("7", &DR, RAK_DR_0, RAK_DR_7) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(DR == RAK_DR_7);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("200", &DR, RAK_DR_0, RAK_DR_7) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(DR == RAK_DR_7);
+
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("115200", &Baudrate, Test_Parser_IsBaudrate) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Baudrate == RAK_BAUD_115200);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("115201", &Baudrate, Test_Parser_IsBaudrate) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(RAK3172_Parser_ToNumber("19200", &Baudrate, Test_Parser_IsBaudrate) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(Baudrate == RAK_BAUD_115200);
+}
+
+static void Test_Parser_Tokens(void)
+{
+    std::string_view Input = "+EVT:RX_1:-70:8:UNICAST";
+    std::string_view Token;
+
+    RAK3172_TEST_CHECK(RAK3172_Parser_SkipPrefix(&Input, "+EVT:"));
+    RAK3172_TEST_CHECK(RAK3172_Parser_SkipPrefix(&Input, "TX_DONE") == false);
+    RAK3172_TEST_CHECK(RAK3172_Parser_Next(&Input, ":", &Token) && (Token == "RX_1"));
+    RAK3172_TEST_CHECK(RAK3172_Parser_Next(&Input, ":", &Token) && (Token == "-70"));
+    RAK3172_TEST_CHECK(RAK3172_Parser_Next(&Input, ":", &Token) && (Token == "8"));
+    RAK3172_TEST_CHECK(RAK3172_Parser_Next(&Input, ":", &Token) && (Token == "UNICAST"));
+    RAK3172_TEST_CHECK(RAK3172_Parser_Next(&Input, ":", &Token) == false);
+    RAK3172_TEST_CHECK(RAK3172_Parser_Trim("  ") == "");
+}
+
+static void Test_Parser_Fuzz(void)
+{
+    std::mt19937 Random(3172);
+    std::uniform_int_distribution<size_t> Lengths(0, 14);
+    const std::string_view Alphabet = " +-0123456789abcdefABCDEFxz,:";
+    std::uniform_int_distribution<size_t> Characters(0, Alphabet.length() - 1);
+
+    for(uint32_t i = 0; i < TEST_PARSER_FUZZ_ROUNDS; i++)
+    {
+        bool isFirst = true;
+        std::string Input;
+        std::string Joined;
+        std::string_view Rest;
+        std::string_view Token;
+
+        for(size_t Length = Lengths(Random); Length > 0; Length--)
+        {
+            Input += Alphabet[Characters(Random)];
+        }
+
+        RAK3172_TEST_CHECK(RAK3172_Parser_Trim(Input) == Test_Parser_ReferenceTrim(Input));
+
+        // Compare the conversions against the reference.
+        for(uint8_t Base : {10, 16})
+        {
+            int32_t Value = 0;
+            int32_t Expected = 0;
+            bool isValid;
+
+            isValid = Test_Parser_Reference(Input, Base, &Expected);
+            RAK3172_TEST_CHECK((RAK3172_Parser_ToInt(Input, &Value, INT32_MIN, INT32_MAX, Base) == RAK3172_ERR_OK) == isValid);
+            RAK3172_TEST_CHECK((isValid == false) || (Value == Expected));
+        }
+
+        // The tokens and the delimiters must form the input again. A trailing delimiter doesn´t start a new token.
+        Rest = Input;
+        while(RAK3172_Parser_Next(&Rest, ",", &Token))
+        {
+            RAK3172_TEST_CHECK(Token.find(',') == std::string_view::npos);
+
+            if(isFirst == false)
+            {
+                Joined += ',';
+            }
+            Joined.append(Token);
+            isFirst = false;
+        }
+
+        if((Input.empty() == false) && (Input.back() == ','))
+        {
+            Input.pop_back();
+        }
+
+        RAK3172_TEST_CHECK(Joined == Input);
+    }
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Parser_Numbers);
+    RAK3172_TEST_RUN(Test_Parser_Enums);
+    RAK3172_TEST_RUN(Test_Parser_Tokens);
+    RAK3172_TEST_RUN(Test_Parser_Fuzz);
+
+    return RAK3172_TEST_RESULT();
+}
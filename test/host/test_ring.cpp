@@ -0,0 +1,228 @@
+ /*
+ * test_ring.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the single producer single consumer ring.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <chrono>
+#include <thread>
+
+#include "rak3172_test.h"
+
+#include <freertos/queue.h>
+
+#include "../../src/Core/rak3172_ring.h"
+
+/** @brief Number of entries for the producer and consumer test.
+ */
+#define TEST_RING_ITEMS                                         100000
+
+static void Test_Ring_Basic(void)
+{
+    uint8_t Item;
+    RAK3172_Ring_t* Ring;
+
+    RAK3172_TEST_CHECK(RAK3172_Ring_Create(0) == NULL);
+    RAK3172_TEST_CHECK(RAK3172_Ring_Create(0xFF) == NULL);
+
+    Ring = RAK3172_Ring_Create(3);
+    RAK3172_TEST_CHECK(Ring != NULL);
+    RAK3172_TEST_CHECK(RAK3172_Ring_Pop(Ring, &Item) == false);
+
+    // Fill and drain the ring several times to cover the wrap around.
+    for(uint8_t Round = 0; Round < 4; Round++)
+    {
+        RAK3172_TEST_CHECK(RAK3172_Ring_Push(Ring, Round));
+        RAK3172_TEST_CHECK(RAK3172_Ring_Push(Ring, Round + 1));
+        RAK3172_TEST_CHECK(RAK3172_Ring_Push(Ring, Round + 2));
+        RAK3172_TEST_CHECK(RAK3172_Ring_Push(Ring, Round + 3) == false);
+        RAK3172_TEST_CHECK(RAK3172_Ring_Count(Ring) == 3);
+
+        for(uint8_t i = 0; i < 3; i++)
+        {
+            RAK3172_TEST_CHECK(RAK3172_Ring_Pop(Ring, &Item) && (Item == (Round + i)));
+        }
+
+        RAK3172_TEST_CHECK(RAK3172_Ring_Count(Ring) == 0);
+    }
+
+    RAK3172_Ring_Delete(Ring);
+}
+
+static void Test_Ring_Wait(void)
+{
+    uint8_t Item;
+    TickType_t Start;
+    RAK3172_Ring_t* Ring;
+
+    Ring = RAK3172_Ring_Create(4);
+
+    Start = xTaskGetTickCount();
+    RAK3172_TEST_CHECK(RAK3172_Ring_Wait(Ring, &Item, 20) == false);
+    RAK3172_TEST_CHECK((xTaskGetTickCount() - Start) >= 20);
+
+    // A wake up without a waiting consumer ends the next wait immediately.
+    RAK3172_Ring_Wake(Ring);
+    RAK3172_TEST_CHECK(RAK3172_Ring_Wait(Ring, &Item, portMAX_DELAY) == false);
+
+    std::thread Waker([Ring]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        RAK3172_Ring_Wake(Ring);
+    });
+    RAK3172_TEST_CHECK(RAK3172_Ring_Wait(Ring, &Item, portMAX_DELAY) == false);
+    Waker.join();
+
+    RAK3172_Ring_Push(Ring, 42);
+    RAK3172_TEST_CHECK(RAK3172_Ring_Wait(Ring, &Item, 0) && (Item == 42));
+
+    RAK3172_Ring_Delete(Ring);
+}
+
+static void Test_Ring_Threads(void)
+{
+    uint8_t Item;
+    uint32_t Received;
+    RAK3172_Ring_t* Ring;
+
+    Ring = RAK3172_Ring_Create(8);
+
+    std::thread Producer([Ring]() {
+        for(uint32_t i = 0; i < TEST_RING_ITEMS; i++)
+        {
+            while(RAK3172_Ring_Push(Ring, static_cast<uint8_t>(i)) == false)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // The entries must arrive in order and without a lost wake up of the consumer.
+    for(Received = 0; Received < TEST_RING_ITEMS; Received++)
+    {
+        if(RAK3172_Ring_Wait(Ring, &Item, 1000) == false)
+        {
+            break;
+        }
+
+        if(Item != static_cast<uint8_t>(Received))
+        {
+            break;
+        }
+    }
+
+    Producer.join();
+
+    RAK3172_TEST_CHECK(Received == TEST_RING_ITEMS);
+    RAK3172_TEST_CHECK(RAK3172_Ring_Count(Ring) == 0);
+
+    RAK3172_Ring_Delete(Ring);
+}
+
+/** @brief          Transfer the test entries with the ring from a producer thread to the calling thread.
+ *  @param Length   Length of the ring
+ *  @return         Time in nanoseconds
+ */
+static uint64_t Test_Ring_RunRing(uint8_t Length)
+{
+    uint8_t Item;
+    uint64_t Start;
+    RAK3172_Ring_t* Ring;
+
+    Ring = RAK3172_Ring_Create(Length);
+
+    Start = RAK3172_Test_Now();
+    std::thread Producer([Ring]() {
+        for(uint32_t i = 0; i < TEST_RING_ITEMS; i++)
+        {
+            while(RAK3172_Ring_Push(Ring, static_cast<uint8_t>(i)) == false)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for(uint32_t i = 0; i < TEST_RING_ITEMS; i++)
+    {
+        RAK3172_TEST_CHECK(RAK3172_Ring_Wait(Ring, &Item, 1000));
+    }
+
+    Producer.join();
+    Start = RAK3172_Test_Now() - Start;
+
+    RAK3172_Ring_Delete(Ring);
+
+    return Start;
+}
+
+/** @brief          Transfer the test entries with a FreeRTOS queue from a producer thread to the calling thread.
+ *  @param Length   Length of the queue
+ *  @return         Time in nanoseconds
+ */
+static uint64_t Test_Ring_RunQueue(uint8_t Length)
+{
+    uint8_t Item;
+    uint64_t Start;
+    QueueHandle_t Queue;
+
+    Queue = xQueueCreate(Length, sizeof(uint8_t));
+
+    Start = RAK3172_Test_Now();
+    std::thread Producer([Queue]() {
+        for(uint32_t i = 0; i < TEST_RING_ITEMS; i++)
+        {
+            uint8_t Item = static_cast<uint8_t>(i);
+
+            xQueueSend(Queue, &Item, portMAX_DELAY);
+        }
+    });
+
+    for(uint32_t i = 0; i < TEST_RING_ITEMS; i++)
+    {
+        RAK3172_TEST_CHECK(xQueueReceive(Queue, &Item, 1000) == pdPASS);
+    }
+
+    Producer.join();
+    Start = RAK3172_Test_Now() - Start;
+
+    vQueueDelete(Queue);
+
+    return Start;
+}
+
+static void Test_Ring_Benchmark(void)
+{
+    const uint8_t Lengths[] = {CONFIG_RAK3172_UART_QUEUE_LENGTH, 64};
+
+    // Both versions use the host FreeRTOS port, so the result compares the hand off and not the kernel of the target.
+    for(uint8_t Length : Lengths)
+    {
+        uint64_t Ring = Test_Ring_RunRing(Length);
+        uint64_t Queue = Test_Ring_RunQueue(Length);
+
+        printf("    %3u entries: Ring %7.1f ns/entry, xQueueSend/xQueueReceive %7.1f ns/entry\n", Length,
+               static_cast<double>(Ring) / TEST_RING_ITEMS, static_cast<double>(Queue) / TEST_RING_ITEMS);
+    }
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Ring_Basic);
+    RAK3172_TEST_RUN(Test_Ring_Wait);
+    RAK3172_TEST_RUN(Test_Ring_Threads);
+    RAK3172_TEST_RUN(Test_Ring_Benchmark);
+
+    return RAK3172_TEST_RESULT();
+}
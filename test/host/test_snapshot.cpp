@@ -0,0 +1,296 @@
+ /*
+ * test_snapshot.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the device state snapshot of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <string.h>
+
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+/** @brief Response delay of the module in milliseconds for the time to the first uplink.
+ */
+#define TEST_SNAPSHOT_DELAY                 10
+
+/** @brief          Count the queries of the simulator.
+ *  @param p_Sim    Pointer to simulator
+ *  @return         Number of "=?" commands
+ */
+static size_t Test_Snapshot_CountQueries(RAK3172_Sim_t* p_Sim)
+{
+    size_t Count = 0;
+    std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+    for(const std::string& Command : p_Sim->Received)
+    {
+        if((Command.length() > 2) && (Command.compare(Command.length() - 2, 2, "=?") == 0))
+        {
+            Count++;
+        }
+    }
+
+    return Count;
+}
+
+/** @brief          Wait until the simulator has received an uplink.
+ *  @param p_Sim    Pointer to simulator
+ *  @return         #true when the uplink was received within one second
+ */
+static bool Test_Snapshot_WaitUplink(RAK3172_Sim_t* p_Sim)
+{
+    for(uint16_t i = 0; i < 1000; i++)
+    {
+        {
+            std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+            for(const std::string& Command : p_Sim->Received)
+            {
+                if(Command.compare(0, 8, "AT+SEND=") == 0)
+                {
+                    return true;
+                }
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return false;
+}
+
+/** @brief          Start the simulator and initialize a joined device. The state of the device is saved in a snapshot and the driver
+ *                  is removed like before a deep sleep.
+ *  @param p_Sim        Pointer to simulator
+ *  @param p_Snapshot   Pointer to snapshot
+ */
+static void Test_Snapshot_Save(RAK3172_Sim_t* p_Sim, RAK3172_Snapshot_t* p_Snapshot)
+{
+    RAK3172_Info_t Info;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Sim_Start(p_Sim, UART_NUM_1, RAK_BAUD_9600);
+    p_Sim->Values["NJS"] = "1";
+    p_Sim->Values["VER"] = "RUI_4.0.5_RAK3172-E";
+    p_Sim->Values["SN"] = "AC1F09FFFE000001";
+
+    RAK3172_TEST_CHECK(RAK3172_Init(Device) == RAK3172_ERR_OK);
+
+    // The information of the module was read during the initialization.
+    Device.Info = &Info;
+    Info.Firmware = "RUI_4.0.5_RAK3172-E";
+    Info.Serial = "AC1F09FFFE000001";
+    Device.LoRaWAN.Join = RAK_JOIN_OTAA;
+    Device.LoRaWAN.isJoined = true;
+    Device.LoRaWAN.Config.Valid = RAK_LORAWAN_CFG_BAND | RAK_LORAWAN_CFG_ADR | RAK_LORAWAN_CFG_OTAA;
+    Device.LoRaWAN.Config.Band = RAK_BAND_EU868;
+    Device.LoRaWAN.Config.UseADR = true;
+    memset(Device.LoRaWAN.Config.Key1, 0x11, sizeof(Device.LoRaWAN.Config.Key1));
+    memset(Device.LoRaWAN.Config.Key2, 0x22, sizeof(Device.LoRaWAN.Config.Key2));
+    memset(Device.LoRaWAN.Config.Key3, 0x33, sizeof(Device.LoRaWAN.Config.Key3));
+
+    RAK3172_SaveSnapshot(Device, p_Snapshot);
+    RAK3172_Deinit(Device);
+
+    std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+    p_Sim->Received.clear();
+}
+
+static void Test_Snapshot_Restore(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Info_t Info;
+    RAK3172_Snapshot_t Snapshot;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Snapshot_Save(&Sim, &Snapshot);
+
+    Device.Info = &Info;
+    RAK3172_TEST_CHECK(RAK3172_WakeUp(Device, &Snapshot) == RAK3172_ERR_OK);
+
+    // The state is restored without querying the module.
+    RAK3172_Sim_Flush(&Sim);
+    RAK3172_TEST_CHECK(Test_Snapshot_CountQueries(&Sim) == 0);
+    RAK3172_TEST_CHECK(Device.Mode == RAK_MODE_LORAWAN);
+    RAK3172_TEST_CHECK(Device.LoRaWAN.Join == RAK_JOIN_OTAA);
+    RAK3172_TEST_CHECK(Device.LoRaWAN.isJoined == true);
+    RAK3172_TEST_CHECK(Device.LoRaWAN.Config.Band == RAK_BAND_EU868);
+    RAK3172_TEST_CHECK(Device.LoRaWAN.Config.UseADR == true);
+    RAK3172_TEST_CHECK(Info.Firmware == "RUI_4.0.5_RAK3172-E");
+    RAK3172_TEST_CHECK(Info.Serial == "AC1F09FFFE000001");
+
+    // The keys aren´t kept in the RTC memory, so the next configuration transaction writes them again.
+    #ifdef CONFIG_RAK3172_SNAPSHOT_WITH_KEYS
+        RAK3172_TEST_CHECK(Device.LoRaWAN.Config.Valid == (RAK_LORAWAN_CFG_BAND | RAK_LORAWAN_CFG_ADR | RAK_LORAWAN_CFG_OTAA));
+        RAK3172_TEST_CHECK(Device.LoRaWAN.Config.Key3[0] == 0x33);
+    #else
+        RAK3172_TEST_CHECK(Device.LoRaWAN.Config.Valid == (RAK_LORAWAN_CFG_BAND | RAK_LORAWAN_CFG_ADR));
+        for(size_t i = 0; i < sizeof(Snapshot.Config.Key1); i++)
+        {
+            RAK3172_TEST_CHECK((Snapshot.Config.Key1[i] == 0) && (Snapshot.Config.Key2[i] == 0) && (Snapshot.Config.Key3[i] == 0));
+        }
+    #endif
+
+    // A second wake up of an initialized driver doesn´t change anything.
+    RAK3172_TEST_CHECK(RAK3172_WakeUp(Device, &Snapshot) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_WakeUp(Device, NULL) == RAK3172_ERR_INVALID_ARG);
+
+    RAK3172_Deinit(Device);
+    RAK3172_Sim_Stop(&Sim);
+}
+
+static void Test_Snapshot_Reject(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Snapshot_t Snapshot;
+    RAK3172_Snapshot_t Corrupted;
+
+    Test_Snapshot_Save(&Sim, &Snapshot);
+
+    // Every damaged snapshot is rejected and the state is read from the module.
+    for(uint8_t Case = 0; Case < 4; Case++)
+    {
+        RAK3172_Info_t Info;
+        RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+        Corrupted = Snapshot;
+        switch(Case)
+        {
+            case 0:
+            {
+                // A flipped bit of the state (i. e. after a brown out).
+                Corrupted.isJoined = false;
+
+                break;
+            }
+            case 1:
+            {
+                Corrupted.CRC ^= 0x01;
+
+                break;
+            }
+            case 2:
+            {
+                Corrupted.Version++;
+
+                break;
+            }
+            default:
+            {
+                // Uninitialized RTC memory after a power loss.
+                memset(&Corrupted, 0xA5, sizeof(Corrupted));
+
+                break;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> Guard(Sim.Lock);
+
+            Sim.Received.clear();
+            Sim.Values["NJS"] = "0";
+        }
+
+        Device.Info = &Info;
+        RAK3172_TEST_CHECK(RAK3172_WakeUp(Device, &Corrupted) == RAK3172_ERR_OK);
+
+        RAK3172_Sim_Flush(&Sim);
+        RAK3172_TEST_CHECK(Test_Snapshot_CountQueries(&Sim) > 0);
+        RAK3172_TEST_CHECK(Device.Mode == RAK_MODE_LORAWAN);
+        RAK3172_TEST_CHECK(Device.LoRaWAN.isJoined == false);
+        RAK3172_TEST_CHECK(Device.LoRaWAN.Config.Valid == 0);
+        RAK3172_TEST_CHECK(Info.Firmware == "RUI_4.0.5_RAK3172-E");
+        RAK3172_TEST_CHECK(Info.Serial == "AC1F09FFFE000001");
+
+        RAK3172_Deinit(Device);
+    }
+
+    RAK3172_Sim_Stop(&Sim);
+}
+
+/** @brief              Wake up the driver and measure the time until the module receives the first uplink.
+ *  @param p_Sim        Pointer to simulator
+ *  @param p_Snapshot   Pointer to snapshot
+ *  @return             Time to the first uplink in microseconds
+ */
+static uint64_t Test_Snapshot_FirstUplink(RAK3172_Sim_t* p_Sim, const RAK3172_Snapshot_t* p_Snapshot)
+{
+    uint64_t Start;
+    uint64_t Duration;
+    static const uint8_t Payload[4] = {0x01, 0x02, 0x03, 0x04};
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    {
+        std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+        p_Sim->Received.clear();
+        p_Sim->Values["NJS"] = "1";
+        p_Sim->Delay = TEST_SNAPSHOT_DELAY;
+    }
+
+    Start = RAK3172_Test_Now();
+    RAK3172_TEST_CHECK(RAK3172_WakeUp(Device, p_Snapshot) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(RAK3172_LoRaWAN_Schedule(Device, 1, Payload, sizeof(Payload), RAK_UPLINK_PRIO_NORMAL) == RAK3172_ERR_OK);
+    RAK3172_TEST_CHECK(Test_Snapshot_WaitUplink(p_Sim));
+    Duration = (RAK3172_Test_Now() - Start) / 1000ULL;
+
+    {
+        std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+        p_Sim->Delay = 0;
+    }
+
+    RAK3172_Deinit(Device);
+
+    return Duration;
+}
+
+static void Test_Snapshot_Benchmark(void)
+{
+    RAK3172_Sim_t Sim;
+    uint64_t Cold;
+    uint64_t Restored;
+    RAK3172_Snapshot_t Snapshot;
+    RAK3172_Snapshot_t Invalid;
+
+    Test_Snapshot_Save(&Sim, &Snapshot);
+
+    Invalid = Snapshot;
+    Invalid.CRC ^= 0x01;
+
+    Cold = Test_Snapshot_FirstUplink(&Sim, &Invalid);
+    Restored = Test_Snapshot_FirstUplink(&Sim, &Snapshot);
+    printf("    Time to first uplink with %u ms response delay: queried %llu us / snapshot %llu us\n", TEST_SNAPSHOT_DELAY,
+        static_cast<unsigned long long>(Cold), static_cast<unsigned long long>(Restored));
+
+    // The queries of the join state and the mode are skipped.
+    RAK3172_TEST_CHECK(Restored < Cold);
+
+    RAK3172_Sim_Stop(&Sim);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Snapshot_Restore);
+    RAK3172_TEST_RUN(Test_Snapshot_Reject);
+    RAK3172_TEST_RUN(Test_Snapshot_Benchmark);
+
+    return RAK3172_TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+ /*
+ * test_writer.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the AT command writer of the RAK3172 driver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <string>
+
+#include "rak3172_alloc.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+#include "../../src/Core/rak3172_writer.h"
+
+/** @brief Length of the payload of the uplink command in bytes.
+ */
+#define TEST_WRITER_PAYLOAD_SIZE            1000
+
+/** @brief Characters written to the UART. The buffer is static, so the capture doesn´t allocate memory.
+ */
+typedef struct
+{
+    char Data[(2 * TEST_WRITER_PAYLOAD_SIZE) + 64];
+    size_t Length;
+    size_t Writes;
+} Test_Writer_Capture_t;
+
+static Test_Writer_Capture_t _Test_Writer_Capture;
+
+/** @brief          Receive handler of the simulated UART. Stores the written characters.
+ *  @param Port     UART interface
+ *  @param p_Data   Pointer to the data written by the driver
+ *  @param Length   Length of the data
+ *  @param p_Arg    Pointer to capture
+ */
+static void Test_Writer_OnWrite(uart_port_t Port, const uint8_t* p_Data, size_t Length, void* p_Arg)
+{
+    Test_Writer_Capture_t* Capture = static_cast<Test_Writer_Capture_t*>(p_Arg);
+
+    if((Capture->Length + Length) > sizeof(Capture->Data))
+    {
+        Length = sizeof(Capture->Data) - Capture->Length;
+    }
+
+    memcpy(&Capture->Data[Capture->Length], p_Data, Length);
+    Capture->Length += Length;
+    Capture->Writes++;
+}
+
+/** @brief              Clear the capture.
+ *  @param p_Capture    Pointer to capture
+ */
+static void Test_Writer_Clear(Test_Writer_Capture_t* p_Capture)
+{
+    p_Capture->Length = 0;
+    p_Capture->Writes = 0;
+}
+
+static void Test_Writer_Send(void)
+{
+    uint32_t Allocations;
+    std::string Expected;
+    RAK3172_Fragment_t Fragments[4];
+    static uint8_t Payload[TEST_WRITER_PAYLOAD_SIZE];
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Expected = "AT+SEND=1:";
+    for(size_t i = 0; i < sizeof(Payload); i++)
+    {
+        char Hex[3];
+
+        Payload[i] = static_cast<uint8_t>(i * 7);
+        snprintf(Hex, sizeof(Hex), "%02X", Payload[i]);
+        Expected += Hex;
+    }
+    Expected += "\r\n";
+
+    RAK3172_Host_UART_Attach(UART_NUM_1, Test_Writer_OnWrite, &_Test_Writer_Capture);
+    Test_Writer_Clear(&_Test_Writer_Capture);
+
+    Allocations = RAK3172_Test_GetAllocations();
+    Fragments[0] = RAK3172_Fragment_Text("AT+SEND=");
+    Fragments[1] = RAK3172_Fragment_Number(1);
+    Fragments[2] = RAK3172_Fragment_Text(":");
+    Fragments[3] = RAK3172_Fragment_Hex(Payload, sizeof(Payload));
+    RAK3172_Writer_Write(Device, Fragments, 4);
+    RAK3172_TEST_CHECK(RAK3172_Test_GetAllocations() == Allocations);
+
+    RAK3172_TEST_CHECK(std::string(_Test_Writer_Capture.Data, _Test_Writer_Capture.Length) == Expected);
+
+    // The command is written in blocks of the staging buffer.
+    RAK3172_TEST_CHECK(_Test_Writer_Capture.Writes <= ((Expected.length() / (RAK3172_WRITER_BUFFER_SIZE - 1)) + 2));
+
+    RAK3172_Host_UART_Attach(UART_NUM_1, NULL, NULL);
+}
+
+static void Test_Writer_Numbers(void)
+{
+    RAK3172_Fragment_t Fragments[5];
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    RAK3172_Host_UART_Attach(UART_NUM_1, Test_Writer_OnWrite, &_Test_Writer_Capture);
+    Test_Writer_Clear(&_Test_Writer_Capture);
+
+    Fragments[0] = RAK3172_Fragment_Text("AT+X=");
+    Fragments[1] = RAK3172_Fragment_Number(0);
+    Fragments[2] = RAK3172_Fragment_Text(":");
+    Fragments[3] = RAK3172_Fragment_Number(4294967295UL);
+    Fragments[4] = RAK3172_Fragment_Hex(NULL, 0);
+    RAK3172_Writer_Write(Device, Fragments, 5);
+
+    RAK3172_TEST_CHECK(std::string(_Test_Writer_Capture.Data, _Test_Writer_Capture.Length) == "AT+X=0:4294967295\r\n");
+
+    RAK3172_Host_UART_Attach(UART_NUM_1, NULL, NULL);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Writer_Send);
+    RAK3172_TEST_RUN(Test_Writer_Numbers);
+
+    return RAK3172_TEST_RESULT();
+}
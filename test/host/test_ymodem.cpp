@@ -0,0 +1,527 @@
+ /*
+ * test_ymodem.cpp
+ *
+ *  Copyright (C) Daniel Kampert, 2023
+ *	Website: www.kampis-elektroecke.de
+ *  File info: Host tests for the firmware update with the Ymodem protocol. The module is replaced by a Ymodem receiver.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Errors and commissions should be reported to DanielKampert@kampis-elektroecke.de.
+ */
+
+#include <vector>
+
+#include <string.h>
+
+#include "rak3172_sim.h"
+#include "rak3172_host.h"
+#include "rak3172_test.h"
+
+#include "rak3172.h"
+
+#include "../../src/Modes/Update/rak3172_ymodem_crc.h"
+
+/** @brief Control characters of the Ymodem protocol.
+ */
+#define TEST_YMODEM_SOH                     0x01
+#define TEST_YMODEM_STX                     0x02
+#define TEST_YMODEM_EOT                     0x04
+#define TEST_YMODEM_ACK                     0x06
+#define TEST_YMODEM_NAK                     0x15
+#define TEST_YMODEM_CAN                     0x18
+#define TEST_YMODEM_PADDING                 0x1A
+
+/** @brief Packet sizes of the Ymodem protocol.
+ */
+#define TEST_YMODEM_HEADER_SIZE             3
+#define TEST_YMODEM_INITIAL_SIZE            128
+#define TEST_YMODEM_PACKET_SIZE             1024
+
+/** @brief Size of the firmware image. Four full blocks and a partial block.
+ */
+#define TEST_YMODEM_IMAGE_SIZE              ((4 * TEST_YMODEM_PACKET_SIZE) + 904)
+
+/** @brief Number of data packets of the firmware image.
+ */
+#define TEST_YMODEM_PACKETS                 ((TEST_YMODEM_IMAGE_SIZE + TEST_YMODEM_PACKET_SIZE - 1) / TEST_YMODEM_PACKET_SIZE)
+
+/** @brief Number of transmissions of a packet before the driver aborts the update.
+ */
+#define TEST_YMODEM_MAX_RETRIES             10
+
+/** @brief Response delay of the receiver in milliseconds for the delay test.
+ */
+#define TEST_YMODEM_DELAY                   50
+
+/** @brief Fault of the receiver, which is injected for a data packet.
+ */
+typedef enum
+{
+    TEST_YMODEM_FAULT_NONE,                 /**< Acknowledge the packet. */
+    TEST_YMODEM_FAULT_NAK,                  /**< Request a retransmission. */
+    TEST_YMODEM_FAULT_DROP,                 /**< Receive the packet, but lose the acknowledge. */
+    TEST_YMODEM_FAULT_CANCEL,               /**< Cancel the transfer. */
+} Test_Ymodem_Fault_t;
+
+/** @brief Ymodem receiver, which replaces the module after the "AT+BOOT" command.
+ */
+typedef struct
+{
+    uint8_t Packet[TEST_YMODEM_HEADER_SIZE + TEST_YMODEM_PACKET_SIZE + 2];  /**< Packet, which is received. */
+    size_t Length;                          /**< Received bytes of the packet. */
+    size_t Size;                            /**< Expected size of the packet. */
+    uint8_t Expected;                       /**< Index of the next data packet. */
+    bool isStarted;                         /**< #true when the initial packet was received. */
+    uint8_t EOTs;                           /**< Number of received end of transmissions. */
+    bool isFinished;                        /**< #true when the transfer is finished. */
+    std::vector<uint8_t> Image;             /**< Received data including the padding. */
+    uint32_t Packets;                       /**< Number of valid data packets including the retransmissions. */
+    uint32_t Duplicates;                    /**< Number of retransmissions of acknowledged packets. */
+    uint32_t Errors;                        /**< Number of packets with an invalid header or CRC. */
+    uint8_t FaultPacket;                    /**< Index of the data packet with a fault. */
+    Test_Ymodem_Fault_t Fault;              /**< Fault for the packet. */
+    uint8_t FaultCount;                     /**< Number of transmissions with the fault. */
+    uint32_t Delay;                         /**< Delay in milliseconds before each response. */
+} Test_Ymodem_Receiver_t;
+
+static uint8_t _Test_Ymodem_Image[TEST_YMODEM_IMAGE_SIZE];
+static Test_Ymodem_Receiver_t _Test_Ymodem_Receiver;
+
+/** @brief          Transmit a response of the receiver to the driver.
+ *  @param p_Sim    Pointer to simulator
+ *  @param p_Data   Pointer to response
+ *  @param Length   Length of the response
+ */
+static void Test_Ymodem_Respond(RAK3172_Sim_t* p_Sim, const uint8_t* p_Data, size_t Length)
+{
+    Test_Ymodem_Receiver_t* Receiver = static_cast<Test_Ymodem_Receiver_t*>(p_Sim->p_Arg);
+
+    if(Receiver->Delay > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(Receiver->Delay));
+    }
+
+    RAK3172_Host_UART_Inject(p_Sim->Port, p_Data, Length);
+}
+
+/** @brief          Process a complete packet.
+ *  @param p_Sim    Pointer to simulator
+ */
+static void Test_Ymodem_Process(RAK3172_Sim_t* p_Sim)
+{
+    uint8_t Index;
+    uint16_t CRC;
+    uint16_t DataSize;
+    uint8_t Response[2];
+    Test_Ymodem_Receiver_t* Receiver = static_cast<Test_Ymodem_Receiver_t*>(p_Sim->p_Arg);
+
+    Index = Receiver->Packet[1];
+    DataSize = Receiver->Size - TEST_YMODEM_HEADER_SIZE - 2;
+    CRC = (Receiver->Packet[Receiver->Size - 2] << 8) | Receiver->Packet[Receiver->Size - 1];
+
+    if((Receiver->Packet[2] != (0xFF - Index)) || (RAK3172_Ymodem_CRC16(&Receiver->Packet[TEST_YMODEM_HEADER_SIZE], DataSize, 0) != CRC))
+    {
+        Receiver->Errors++;
+
+        Response[0] = TEST_YMODEM_NAK;
+        Test_Ymodem_Respond(p_Sim, Response, 1);
+
+        return;
+    }
+
+    // The initial packet starts the transfer.
+    if(Receiver->Packet[0] == TEST_YMODEM_SOH)
+    {
+        Receiver->isStarted = (Index == 0);
+
+        Response[0] = TEST_YMODEM_ACK;
+        Response[1] = 'C';
+        Test_Ymodem_Respond(p_Sim, Response, 2);
+
+        return;
+    }
+
+    Receiver->Packets++;
+
+    if((Index == Receiver->FaultPacket) && (Receiver->FaultCount > 0))
+    {
+        if(Receiver->Fault == TEST_YMODEM_FAULT_NAK)
+        {
+            Receiver->FaultCount--;
+
+            Response[0] = TEST_YMODEM_NAK;
+            Test_Ymodem_Respond(p_Sim, Response, 1);
+
+            return;
+        }
+        else if(Receiver->Fault == TEST_YMODEM_FAULT_CANCEL)
+        {
+            Receiver->FaultCount--;
+
+            Response[0] = TEST_YMODEM_CAN;
+            Response[1] = TEST_YMODEM_CAN;
+            Test_Ymodem_Respond(p_Sim, Response, 2);
+
+            // The module leaves the transfer and processes the commands again.
+            p_Sim->Raw = NULL;
+
+            return;
+        }
+    }
+
+    // A retransmission of an acknowledged packet is acknowledged again, but not stored.
+    if(Index == static_cast<uint8_t>(Receiver->Expected - 1))
+    {
+        Receiver->Duplicates++;
+    }
+    else if(Index == Receiver->Expected)
+    {
+        Receiver->Image.insert(Receiver->Image.end(), &Receiver->Packet[TEST_YMODEM_HEADER_SIZE], &Receiver->Packet[TEST_YMODEM_HEADER_SIZE + DataSize]);
+        Receiver->Expected++;
+    }
+    else
+    {
+        Receiver->Errors++;
+    }
+
+    // The acknowledge of the packet is lost.
+    if((Index == Receiver->FaultPacket) && (Receiver->Fault == TEST_YMODEM_FAULT_DROP) && (Receiver->FaultCount > 0))
+    {
+        Receiver->FaultCount--;
+
+        return;
+    }
+
+    Response[0] = TEST_YMODEM_ACK;
+    Test_Ymodem_Respond(p_Sim, Response, 1);
+}
+
+/** @brief          Receiver for the Ymodem transfer. Replaces the line processing of the simulator.
+ *  @param p_Sim    Pointer to simulator
+ *  @param p_Data   Pointer to the data written by the driver
+ *  @param Length   Length of the data
+ *  @return         Number of processed bytes
+ */
+static size_t Test_Ymodem_OnReceive(RAK3172_Sim_t* p_Sim, const uint8_t* p_Data, size_t Length)
+{
+    size_t i;
+    Test_Ymodem_Receiver_t* Receiver = static_cast<Test_Ymodem_Receiver_t*>(p_Sim->p_Arg);
+
+    for(i = 0; (i < Length) && (p_Sim->Raw != NULL); i++)
+    {
+        if(Receiver->Length == 0)
+        {
+            uint8_t Response[2];
+
+            if(p_Data[i] == TEST_YMODEM_EOT)
+            {
+                Receiver->EOTs++;
+
+                // The first end of transmission is rejected, the second one finishes the transfer.
+                if(Receiver->EOTs == 1)
+                {
+                    Response[0] = TEST_YMODEM_NAK;
+                    Test_Ymodem_Respond(p_Sim, Response, 1);
+                }
+                else
+                {
+                    Receiver->isFinished = true;
+                    p_Sim->Raw = NULL;
+
+                    Response[0] = TEST_YMODEM_ACK;
+                    Response[1] = 'C';
+                    Test_Ymodem_Respond(p_Sim, Response, 2);
+                }
+
+                continue;
+            }
+            else if(p_Data[i] == TEST_YMODEM_SOH)
+            {
+                Receiver->Size = TEST_YMODEM_HEADER_SIZE + TEST_YMODEM_INITIAL_SIZE + 2;
+            }
+            else if(p_Data[i] == TEST_YMODEM_STX)
+            {
+                Receiver->Size = TEST_YMODEM_HEADER_SIZE + TEST_YMODEM_PACKET_SIZE + 2;
+            }
+            else if(p_Data[i] == 'A')
+            {
+                // The bootloader leaves the transfer with the "AT+RUN" command.
+                p_Sim->Raw = NULL;
+
+                return i;
+            }
+            else
+            {
+                Receiver->Errors++;
+
+                continue;
+            }
+        }
+
+        Receiver->Packet[Receiver->Length++] = p_Data[i];
+        if(Receiver->Length == Receiver->Size)
+        {
+            Receiver->Length = 0;
+            Test_Ymodem_Process(p_Sim);
+        }
+    }
+
+    return i;
+}
+
+/** @brief          Command handler of the simulator. The module switches to the Ymodem receiver with the "AT+BOOT" command.
+ *  @param p_Sim    Pointer to simulator
+ *  @param Command  Received command
+ *  @return         #true when the command was handled
+ */
+static bool Test_Ymodem_OnCommand(RAK3172_Sim_t* p_Sim, const std::string& Command)
+{
+    if(Command == "AT+BOOT")
+    {
+        std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+        // The receiver must be active before the driver receives the status of the command.
+        p_Sim->Raw = Test_Ymodem_OnReceive;
+    }
+
+    return false;
+}
+
+/** @brief          Reader for the firmware image. Checks that the next block is read while the previous block is in flight.
+ *  @param Offset   Offset in the firmware image
+ *  @param p_Buffer Pointer to block buffer
+ *  @param Length   Length of the block
+ *  @param p_Arg    Pointer to number of ordering errors
+ *  @return         RAK3172_ERR_OK
+ */
+static RAK3172_Error_t Test_Ymodem_Read(uint32_t Offset, uint8_t* p_Buffer, uint16_t Length, void* p_Arg)
+{
+    uint32_t Block;
+
+    Block = Offset / TEST_YMODEM_PACKET_SIZE;
+
+    // The packet of the previous block was transmitted, but the packet of this block wasn´t.
+    if(_Test_Ymodem_Receiver.Packets != Block)
+    {
+        (*static_cast<uint32_t*>(p_Arg))++;
+    }
+
+    memcpy(p_Buffer, &_Test_Ymodem_Image[Offset], Length);
+
+    return RAK3172_ERR_OK;
+}
+
+/** @brief          Start the simulator and the driver and prepare the receiver.
+ *  @param p_Sim    Pointer to simulator
+ *  @param p_Device RAK3172 device object
+ */
+static void Test_Ymodem_Start(RAK3172_Sim_t* p_Sim, RAK3172_t& p_Device)
+{
+    for(size_t i = 0; i < sizeof(_Test_Ymodem_Image); i++)
+    {
+        _Test_Ymodem_Image[i] = static_cast<uint8_t>((i * 31) + (i >> 8));
+    }
+
+    _Test_Ymodem_Receiver = Test_Ymodem_Receiver_t();
+    _Test_Ymodem_Receiver.Expected = 1;
+
+    RAK3172_Sim_Start(p_Sim, UART_NUM_1, RAK_BAUD_9600);
+    RAK3172_TEST_CHECK(RAK3172_Init(p_Device) == RAK3172_ERR_OK);
+
+    p_Sim->Handler = Test_Ymodem_OnCommand;
+    p_Sim->p_Arg = &_Test_Ymodem_Receiver;
+}
+
+/** @brief          Stop the driver and the simulator. The module must have left the DFU mode and the receive task must process
+ *                  the commands again.
+ *  @param p_Sim    Pointer to simulator
+ *  @param p_Device RAK3172 device object
+ */
+static void Test_Ymodem_Stop(RAK3172_Sim_t* p_Sim, RAK3172_t& p_Device)
+{
+    RAK3172_Sim_Flush(p_Sim);
+
+    {
+        std::lock_guard<std::mutex> Guard(p_Sim->Lock);
+
+        RAK3172_TEST_CHECK(p_Sim->Received.back() == "AT+RUN");
+    }
+
+    RAK3172_TEST_CHECK(RAK3172_SendCommand(p_Device, "AT") == RAK3172_ERR_OK);
+
+    RAK3172_Deinit(p_Device);
+    RAK3172_Sim_Stop(p_Sim);
+}
+
+/** @brief Check the image, which was received by the receiver.
+ */
+static void Test_Ymodem_CheckImage(void)
+{
+    RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.Image.size() == (TEST_YMODEM_PACKETS * TEST_YMODEM_PACKET_SIZE));
+    if(_Test_Ymodem_Receiver.Image.size() != (TEST_YMODEM_PACKETS * TEST_YMODEM_PACKET_SIZE))
+    {
+        return;
+    }
+
+    RAK3172_TEST_CHECK(memcmp(_Test_Ymodem_Receiver.Image.data(), _Test_Ymodem_Image, TEST_YMODEM_IMAGE_SIZE) == 0);
+
+    // The final packet is padded.
+    for(size_t i = TEST_YMODEM_IMAGE_SIZE; i < _Test_Ymodem_Receiver.Image.size(); i++)
+    {
+        RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.Image[i] == TEST_YMODEM_PADDING);
+    }
+
+    RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.isStarted);
+    RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.isFinished);
+    RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.Errors == 0);
+}
+
+static void Test_Ymodem_Memory(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, _Test_Ymodem_Image, sizeof(_Test_Ymodem_Image), &Stats) == RAK3172_ERR_OK);
+    Test_Ymodem_CheckImage();
+    RAK3172_TEST_CHECK(Stats.Packets == TEST_YMODEM_PACKETS);
+    RAK3172_TEST_CHECK(Stats.Bytes == TEST_YMODEM_IMAGE_SIZE);
+    RAK3172_TEST_CHECK((Stats.Retries == 0) && (Stats.NAKs == 0) && (Stats.Timeouts == 0));
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+static void Test_Ymodem_Pipelined(void)
+{
+    RAK3172_Sim_t Sim;
+    uint32_t Misordered = 0;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, sizeof(_Test_Ymodem_Image), Test_Ymodem_Read, &Misordered, &Stats) == RAK3172_ERR_OK);
+    Test_Ymodem_CheckImage();
+    RAK3172_TEST_CHECK(Misordered == 0);
+    RAK3172_TEST_CHECK(Stats.Packets == TEST_YMODEM_PACKETS);
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+static void Test_Ymodem_NAK(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+    _Test_Ymodem_Receiver.FaultPacket = 2;
+    _Test_Ymodem_Receiver.Fault = TEST_YMODEM_FAULT_NAK;
+    _Test_Ymodem_Receiver.FaultCount = 1;
+
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, _Test_Ymodem_Image, sizeof(_Test_Ymodem_Image), &Stats) == RAK3172_ERR_OK);
+    Test_Ymodem_CheckImage();
+    RAK3172_TEST_CHECK(Stats.Packets == (TEST_YMODEM_PACKETS + 1));
+    RAK3172_TEST_CHECK((Stats.Retries == 1) && (Stats.NAKs == 1) && (Stats.Timeouts == 0));
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+static void Test_Ymodem_LostAck(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+    _Test_Ymodem_Receiver.FaultPacket = 3;
+    _Test_Ymodem_Receiver.Fault = TEST_YMODEM_FAULT_DROP;
+    _Test_Ymodem_Receiver.FaultCount = 1;
+
+    // The driver repeats the packet after the acknowledge timeout and the receiver drops the duplicate.
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, _Test_Ymodem_Image, sizeof(_Test_Ymodem_Image), &Stats) == RAK3172_ERR_OK);
+    Test_Ymodem_CheckImage();
+    RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.Duplicates == 1);
+    RAK3172_TEST_CHECK((Stats.Retries == 1) && (Stats.NAKs == 0) && (Stats.Timeouts == 1));
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+static void Test_Ymodem_Retries(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+    _Test_Ymodem_Receiver.FaultPacket = 1;
+    _Test_Ymodem_Receiver.Fault = TEST_YMODEM_FAULT_NAK;
+    _Test_Ymodem_Receiver.FaultCount = TEST_YMODEM_MAX_RETRIES;
+
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, _Test_Ymodem_Image, sizeof(_Test_Ymodem_Image), &Stats) == RAK3172_ERR_INVALID_RESPONSE);
+    RAK3172_TEST_CHECK(Stats.NAKs == TEST_YMODEM_MAX_RETRIES);
+    RAK3172_TEST_CHECK(Stats.Bytes == 0);
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+static void Test_Ymodem_Cancel(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+    _Test_Ymodem_Receiver.FaultPacket = 2;
+    _Test_Ymodem_Receiver.Fault = TEST_YMODEM_FAULT_CANCEL;
+    _Test_Ymodem_Receiver.FaultCount = 1;
+
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, _Test_Ymodem_Image, sizeof(_Test_Ymodem_Image), &Stats) == RAK3172_ERR_FAIL);
+    RAK3172_TEST_CHECK(Stats.Bytes == TEST_YMODEM_PACKET_SIZE);
+    RAK3172_TEST_CHECK(_Test_Ymodem_Receiver.isFinished == false);
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+static void Test_Ymodem_Delay(void)
+{
+    RAK3172_Sim_t Sim;
+    RAK3172_Update_Stats_t Stats;
+    RAK3172_t Device = RAK3172_DEFAULT_CONFIG(UART_NUM_1, 16, 17, RAK_BAUD_9600);
+
+    Test_Ymodem_Start(&Sim, Device);
+    _Test_Ymodem_Receiver.Delay = TEST_YMODEM_DELAY;
+
+    // A slow module within the acknowledge timeout doesn´t cause a retransmission.
+    RAK3172_TEST_CHECK(RAK3172_RunUpdate(Device, _Test_Ymodem_Image, sizeof(_Test_Ymodem_Image), &Stats) == RAK3172_ERR_OK);
+    Test_Ymodem_CheckImage();
+    RAK3172_TEST_CHECK((Stats.Retries == 0) && (Stats.Timeouts == 0));
+    RAK3172_TEST_CHECK(Stats.Duration >= (TEST_YMODEM_PACKETS * TEST_YMODEM_DELAY));
+
+    _Test_Ymodem_Receiver.Delay = 0;
+
+    Test_Ymodem_Stop(&Sim, Device);
+}
+
+int main(void)
+{
+    RAK3172_TEST_RUN(Test_Ymodem_Memory);
+    RAK3172_TEST_RUN(Test_Ymodem_Pipelined);
+    RAK3172_TEST_RUN(Test_Ymodem_NAK);
+    RAK3172_TEST_RUN(Test_Ymodem_LostAck);
+    RAK3172_TEST_RUN(Test_Ymodem_Retries);
+    RAK3172_TEST_RUN(Test_Ymodem_Cancel);
+    RAK3172_TEST_RUN(Test_Ymodem_Delay);
+
+    return RAK3172_TEST_RESULT();
+}